@@ -59,8 +59,10 @@
         'jpeg/data_manager.cc',
         'jpeg/data_manager.h',
         'jpeg/jpeg.cc',
+        'libyuv/include/band_thread_pool.h',
         'libyuv/include/webrtc_libyuv.h',
         'libyuv/include/scaler.h',
+        'libyuv/band_thread_pool.cc',
         'libyuv/webrtc_libyuv.cc',
         'libyuv/scaler.cc',
         'plane.h',
@@ -85,6 +87,7 @@
           'sources': [
             'i420_video_frame_unittest.cc',
             'jpeg/jpeg_unittest.cc',
+            'libyuv/band_thread_pool_unittest.cc',
             'libyuv/libyuv_unittest.cc',
             'libyuv/scaler_unittest.cc',
             'plane_unittest.cc',
@@ -10,9 +10,14 @@
 
 #include "common_video/jpeg/data_manager.h"
 
+#include <string.h>
+
 namespace webrtc
 {
 
+// Size of the first buffer allocated for an image without one.
+enum { kMinDstBufferSize = 16 * 1024 };
+
 typedef struct
 {
     jpeg_source_mgr  mgr;
@@ -83,4 +88,72 @@ termSource (j_decompress_ptr cinfo)
   //
 }
 
+typedef struct
+{
+    jpeg_destination_mgr mgr;
+    EncodedImage* image;
+} DataDstMgr;
+
+void
+jpegSetDstBuffer(j_compress_ptr cinfo, EncodedImage* image)
+{
+    DataDstMgr* dst;
+    if (cinfo->dest == NULL)
+    {  /* first time for this JPEG object? */
+        cinfo->dest = (struct jpeg_destination_mgr *)
+                   (*cinfo->mem->alloc_small) ((j_common_ptr) cinfo,
+                       JPOOL_PERMANENT, sizeof(DataDstMgr));
+    }
+
+    // Setting required functionality
+    dst = (DataDstMgr*) cinfo->dest;
+    dst->mgr.init_destination = initDst;
+    dst->mgr.empty_output_buffer = emptyOutputBuffer;
+    dst->mgr.term_destination = termDst;
+    dst->image = image;
+}
+
+
+void
+initDst(j_compress_ptr cinfo)
+{
+    DataDstMgr* dst = (DataDstMgr*)cinfo->dest;
+    EncodedImage* image = dst->image;
+    if (image->_buffer == NULL || image->_size == 0)
+    {
+        delete [] image->_buffer;
+        image->_buffer = new WebRtc_UWord8[kMinDstBufferSize];
+        image->_size = kMinDstBufferSize;
+    }
+    image->_length = 0;
+    dst->mgr.next_output_byte = image->_buffer;
+    dst->mgr.free_in_buffer = image->_size;
+}
+
+boolean
+emptyOutputBuffer(j_compress_ptr cinfo)
+{
+    // The whole buffer is full. Double its size.
+    DataDstMgr* dst = (DataDstMgr*)cinfo->dest;
+    EncodedImage* image = dst->image;
+    const WebRtc_UWord32 newSize = 2 * image->_size;
+    WebRtc_UWord8* newBuffer = new WebRtc_UWord8[newSize];
+    memcpy(newBuffer, image->_buffer, image->_size);
+    delete [] image->_buffer;
+    image->_buffer = newBuffer;
+    dst->mgr.next_output_byte = newBuffer + image->_size;
+    dst->mgr.free_in_buffer = newSize - image->_size;
+    image->_size = newSize;
+    return TRUE;
+}
+
+
+void
+termDst(j_compress_ptr cinfo)
+{
+    DataDstMgr* dst = (DataDstMgr*)cinfo->dest;
+    dst->image->_length = static_cast<WebRtc_UWord32>(
+        dst->image->_size - dst->mgr.free_in_buffer);
+}
+
 } // end of namespace webrtc
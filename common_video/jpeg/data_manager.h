@@ -9,13 +9,16 @@
  */
 
 /*
- * Jpeg source data manager
+ * Jpeg source and destination data managers
  */
 
 #ifndef WEBRTC_COMMON_VIDEO_JPEG_DATA_MANAGER
 #define WEBRTC_COMMON_VIDEO_JPEG_DATA_MANAGER
 
 #include <stdio.h>
+
+#include "common_video/interface/video_image.h"
+
 extern "C" {
 #if defined(USE_SYSTEM_LIBJPEG)
 #include <jpeglib.h>
@@ -62,6 +65,35 @@ skipInputData(j_decompress_ptr cinfo, long num_bytes);
 void
 termSource (j_decompress_ptr cinfo);
 
+
+// Destination manager:
+
+
+// Compressed data is written to image->_buffer. The buffer is replaced by a
+// larger one, allocated with new[], when it's full. image->_length is set
+// when the compression has finished.
+void
+jpegSetDstBuffer(j_compress_ptr cinfo, EncodedImage* image);
+
+
+// Initialize destination. This is called by jpeg_start_compress() before
+// any data is actually written.
+
+void
+initDst(j_compress_ptr cinfo);
+
+
+// Empty output buffer
+// This is called whenever the buffer has filled up.
+
+boolean
+emptyOutputBuffer(j_compress_ptr cinfo);
+
+
+// Terminate destination
+void
+termDst(j_compress_ptr cinfo);
+
 } // end of namespace webrtc
 
 
@@ -11,18 +11,24 @@
 #ifndef WEBRTC_COMMON_VIDEO_JPEG
 #define WEBRTC_COMMON_VIDEO_JPEG
 
+#include <vector>
+
 #include "typedefs.h"
 #include "common_video/interface/i420_video_frame.h"
 #include "common_video/interface/video_image.h"  // EncodedImage
+#include "common_video/libyuv/include/scaler.h"
 
 // jpeg forward declaration
 struct jpeg_compress_struct;
 
 namespace webrtc
 {
+struct myErrorMgr;
 
 // TODO(mikhal): Move this to LibYuv wrapper, when LibYuv will have a JPG
 // Encode.
+// The compressor is kept between images, so an encoder should be reused to
+// encode many images. An encoder must only be used by one thread at a time.
 class JpegEncoder
 {
 public:
@@ -38,6 +44,16 @@ public:
 //    - (-1)          : Error
     WebRtc_Word32 SetFileName(const char* fileName);
 
+// SetMaxResolution
+// Images that are larger are downscaled to fit before they are encoded,
+// keeping the aspect ratio. 0 (default) encodes images in their own size.
+// Input:
+//  - maxWidth, maxHeight - The largest encoded image size.
+//    Output:
+//    - 0             : OK
+//    - (-1)          : Error
+    WebRtc_Word32 SetMaxResolution(int maxWidth, int maxHeight);
+
 // Encode an I420 image. The encoded image is saved to a file
 //
 // Input:
@@ -46,12 +62,43 @@ public:
 //    Output:
 //    - 0             : OK
 //    - (-1)          : Error
+//    - (-2)          : The file could not be opened
     WebRtc_Word32 Encode(const I420VideoFrame& inputImage);
 
+// Encode an I420 image to memory.
+//
+// Input:
+//          - inputImage        : Image to be encoded
+//          - encodedImage      : Receives the JPEG image in _buffer, which
+//                                must be NULL or allocated with new[]. The
+//                                encoder takes over the buffer: one that is
+//                                too small is released with delete[] and
+//                                replaced by a larger one allocated with
+//                                new[], which the caller then owns.
+//
+//    Output:
+//    - 0             : OK
+//    - (-1)          : Error
+    WebRtc_Word32 Encode(const I420VideoFrame& inputImage,
+                         EncodedImage* encodedImage);
+
 private:
+    // Returns |inputImage|, or a copy scaled to the max resolution.
+    const I420VideoFrame* ScaleIfNeeded(const I420VideoFrame& inputImage);
+    WebRtc_Word32 Compress(const I420VideoFrame& image,
+                           EncodedImage* encodedImage);
 
     jpeg_compress_struct*   _cinfo;
+    myErrorMgr*             _error;
     char                    _fileName[257];
+    int                     _maxWidth;
+    int                     _maxHeight;
+    Scaler                  _scaler;
+    I420VideoFrame          _scaledImage;
+    // Rows padded to whole JPEG blocks, for planes whose stride is too small.
+    std::vector<WebRtc_UWord8> _paddedRows;
+    // The image that is written to file.
+    EncodedImage            _fileImage;
 };
 
 // Decodes a JPEG-stream
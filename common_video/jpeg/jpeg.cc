@@ -50,19 +50,66 @@ MyErrorExit (j_common_ptr cinfo)
     longjmp(myerr->setjmp_buffer, 1);
 }
 
+// Returns row |row| of |plane|, read as |paddedWidth| samples. Rows that
+// would be read past the stride are copied to |paddedRow|, repeating the last
+// sample.
+static JSAMPROW
+PlaneRow(const I420VideoFrame& image, PlaneType plane, int width, int row,
+         int paddedWidth, WebRtc_UWord8* paddedRow)
+{
+    const WebRtc_UWord8* src = image.buffer(plane) + row * image.stride(plane);
+    if (paddedWidth <= image.stride(plane))
+    {
+        return const_cast<JSAMPROW>(src);
+    }
+    memcpy(paddedRow, src, width);
+    memset(paddedRow + width, src[width - 1], paddedWidth - width);
+    return paddedRow;
+}
+
 JpegEncoder::JpegEncoder()
+    : _cinfo(new jpeg_compress_struct),
+      _error(new myErrorMgr),
+      _maxWidth(0),
+      _maxHeight(0)
 {
-   _cinfo = new jpeg_compress_struct;
     strcpy(_fileName, "Snapshot.jpg");
+
+    _cinfo->err = jpeg_std_error(&_error->pub);
+    _error->pub.error_exit = MyErrorExit;
+    if (setjmp(_error->setjmp_buffer))
+    {
+        // Encode() fails without a compressor.
+        jpeg_destroy_compress(_cinfo);
+        delete _cinfo;
+        _cinfo = NULL;
+        return;
+    }
+    // The compressor and its parameters are kept for all images.
+    jpeg_create_compress(_cinfo);
+    _cinfo->in_color_space = JCS_YCbCr;
+    _cinfo->input_components = 3;
+    jpeg_set_defaults(_cinfo);
+
+    _cinfo->comp_info[0].h_samp_factor = 2;   // Y
+    _cinfo->comp_info[0].v_samp_factor = 2;
+    _cinfo->comp_info[1].h_samp_factor = 1;   // U
+    _cinfo->comp_info[1].v_samp_factor = 1;
+    _cinfo->comp_info[2].h_samp_factor = 1;   // V
+    _cinfo->comp_info[2].v_samp_factor = 1;
+    _cinfo->raw_data_in = TRUE;
 }
 
 JpegEncoder::~JpegEncoder()
 {
     if (_cinfo != NULL)
     {
+        jpeg_destroy_compress(_cinfo);
         delete _cinfo;
         _cinfo = NULL;
     }
+    delete _error;
+    delete [] _fileImage._buffer;
 }
 
 
@@ -83,9 +130,48 @@ JpegEncoder::SetFileName(const char* fileName)
 }
 
 
+WebRtc_Word32
+JpegEncoder::SetMaxResolution(int maxWidth, int maxHeight)
+{
+    if (maxWidth < 0 || maxHeight < 0)
+    {
+        return -1;
+    }
+    _maxWidth = maxWidth;
+    _maxHeight = maxHeight;
+    return 0;
+}
+
+
 WebRtc_Word32
 JpegEncoder::Encode(const I420VideoFrame& inputImage)
 {
+    const WebRtc_Word32 ret = Encode(inputImage, &_fileImage);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    FILE* outFile = fopen(_fileName, "wb");
+    if (outFile == NULL)
+    {
+        return -2;
+    }
+    const size_t written = fwrite(_fileImage._buffer, 1, _fileImage._length,
+                                  outFile);
+    fclose(outFile);
+    return written == _fileImage._length ? 0 : -1;
+}
+
+
+WebRtc_Word32
+JpegEncoder::Encode(const I420VideoFrame& inputImage,
+                    EncodedImage* encodedImage)
+{
+    if (encodedImage == NULL || _cinfo == NULL)
+    {
+        return -1;
+    }
     if (inputImage.IsZeroSize())
     {
         return -1;
@@ -95,72 +181,95 @@ JpegEncoder::Encode(const I420VideoFrame& inputImage)
         return -1;
     }
 
-    FILE* outFile = NULL;
+    const I420VideoFrame* image = ScaleIfNeeded(inputImage);
+    if (image == NULL)
+    {
+        return -1;
+    }
+    if (Compress(*image, encodedImage) != 0)
+    {
+        return -1;
+    }
+    encodedImage->_encodedWidth = image->width();
+    encodedImage->_encodedHeight = image->height();
+    encodedImage->_timeStamp = inputImage.timestamp();
+    encodedImage->capture_time_ms_ = inputImage.render_time_ms();
+    encodedImage->_frameType = kKeyFrame;
+    encodedImage->_completeFrame = true;
+    return 0;
+}
+
 
+const I420VideoFrame*
+JpegEncoder::ScaleIfNeeded(const I420VideoFrame& inputImage)
+{
     const int width = inputImage.width();
     const int height = inputImage.height();
-
-    // Set error handler
-    myErrorMgr      jerr;
-    _cinfo->err = jpeg_std_error(&jerr.pub);
-    jerr.pub.error_exit = MyErrorExit;
-    // Establish the setjmp return context
-    if (setjmp(jerr.setjmp_buffer))
+    if (_maxWidth == 0 || _maxHeight == 0 ||
+        (width <= _maxWidth && height <= _maxHeight))
     {
-        // If we get here, the JPEG code has signaled an error.
-        jpeg_destroy_compress(_cinfo);
-        if (outFile != NULL)
-        {
-            fclose(outFile);
-        }
-        return -1;
+        return &inputImage;
     }
 
-    if ((outFile = fopen(_fileName, "wb")) == NULL)
+    int scaledWidth = _maxWidth;
+    int scaledHeight = _maxHeight;
+    if (width * _maxHeight > height * _maxWidth)
     {
-        return -2;
+        scaledHeight = height * _maxWidth / width;
     }
-    // Create a compression object
-    jpeg_create_compress(_cinfo);
-
-    // Setting destination file
-    jpeg_stdio_dest(_cinfo, outFile);
+    else
+    {
+        scaledWidth = width * _maxHeight / height;
+    }
+    if (scaledWidth < 1)
+    {
+        scaledWidth = 1;
+    }
+    if (scaledHeight < 1)
+    {
+        scaledHeight = 1;
+    }
+    if (_scaler.Set(width, height, scaledWidth, scaledHeight, kI420, kI420,
+                    kScaleBox) != 0 ||
+        _scaler.Scale(inputImage, &_scaledImage) != 0)
+    {
+        return NULL;
+    }
+    return &_scaledImage;
+}
 
-    // Set parameters for compression
-    _cinfo->in_color_space = JCS_YCbCr;
-    jpeg_set_defaults(_cinfo);
 
-    _cinfo->image_width = width;
-    _cinfo->image_height = height;
-    _cinfo->input_components = 3;
+WebRtc_Word32
+JpegEncoder::Compress(const I420VideoFrame& image, EncodedImage* encodedImage)
+{
+    const int width = image.width();
+    const int height = image.height();
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    // The compressor reads whole blocks of 8x8 samples of each plane.
+    const int paddedWidth = (width + 7) & ~7;
+    const int paddedChromaWidth = (chromaWidth + 7) & ~7;
+    if (_paddedRows.size() <
+        static_cast<size_t>(16 * paddedWidth + 16 * paddedChromaWidth))
+    {
+        _paddedRows.resize(16 * paddedWidth + 16 * paddedChromaWidth);
+    }
+    WebRtc_UWord8* paddedY = &_paddedRows[0];
+    WebRtc_UWord8* paddedU = paddedY + 16 * paddedWidth;
+    WebRtc_UWord8* paddedV = paddedU + 8 * paddedChromaWidth;
 
-    _cinfo->comp_info[0].h_samp_factor = 2;   // Y
-    _cinfo->comp_info[0].v_samp_factor = 2;
-    _cinfo->comp_info[1].h_samp_factor = 1;   // U
-    _cinfo->comp_info[1].v_samp_factor = 1;
-    _cinfo->comp_info[2].h_samp_factor = 1;   // V
-    _cinfo->comp_info[2].v_samp_factor = 1;
-    _cinfo->raw_data_in = TRUE;
-    // Converting to a buffer
-    // TODO(mikhal): This is a tmp implementation. Will update to use LibYuv
-    // Encode when that becomes available.
-    unsigned int length = CalcBufferSize(kI420, width, height);
-    scoped_array<uint8_t> image_buffer(new uint8_t[length]);
-    ExtractBuffer(inputImage, length, image_buffer.get());
-    int height16 = (height + 15) & ~15;
-    WebRtc_UWord8* imgPtr = image_buffer.get();
-
-    WebRtc_UWord8* origImagePtr = NULL;
-    if (height16 != height)
-    {
-        // Copy image to an adequate size buffer
-        WebRtc_UWord32 requiredSize = CalcBufferSize(kI420, width, height16);
-        origImagePtr = new WebRtc_UWord8[requiredSize];
-        memset(origImagePtr, 0, requiredSize);
-        memcpy(origImagePtr, image_buffer.get(), length);
-        imgPtr = origImagePtr;
+    // Establish the setjmp return context
+    if (setjmp(_error->setjmp_buffer))
+    {
+        // If we get here, the JPEG code has signaled an error. The compressor
+        // can still be used for the next image.
+        jpeg_abort_compress(_cinfo);
+        return -1;
     }
 
+    jpegSetDstBuffer(_cinfo, encodedImage);
+    _cinfo->image_width = width;
+    _cinfo->image_height = height;
     jpeg_start_compress(_cinfo, TRUE);
 
     JSAMPROW y[16],u[8],v[8];
@@ -170,35 +279,30 @@ JpegEncoder::Encode(const I420VideoFrame& inputImage)
     data[1] = u;
     data[2] = v;
 
-    int i, j;
-
-    for (j = 0; j < height; j += 16)
+    // Feed the planes of the image. Rows below the image repeat the last row.
+    for (int j = 0; j < height; j += 16)
     {
-        for (i = 0; i < 16; i++)
+        for (int i = 0; i < 16; i++)
+        {
+            const int row = j + i < height ? j + i : height - 1;
+            y[i] = PlaneRow(image, kYPlane, width, row, paddedWidth,
+                            paddedY + i * paddedWidth);
+        }
+        for (int i = 0; i < 8; i++)
         {
-            y[i] = (JSAMPLE*)imgPtr + width * (i + j);
-
-            if (i % 2 == 0)
-            {
-                u[i / 2] = (JSAMPLE*) imgPtr + width * height +
-                            width / 2 * ((i + j) / 2);
-                v[i / 2] = (JSAMPLE*) imgPtr + width * height +
-                            width * height / 4 + width / 2 * ((i + j) / 2);
-            }
+            const int row = j / 2 + i < chromaHeight ? j / 2 + i :
+                chromaHeight - 1;
+            u[i] = PlaneRow(image, kUPlane, chromaWidth, row,
+                            paddedChromaWidth,
+                            paddedU + i * paddedChromaWidth);
+            v[i] = PlaneRow(image, kVPlane, chromaWidth, row,
+                            paddedChromaWidth,
+                            paddedV + i * paddedChromaWidth);
         }
         jpeg_write_raw_data(_cinfo, data, 16);
     }
 
     jpeg_finish_compress(_cinfo);
-    jpeg_destroy_compress(_cinfo);
-
-    fclose(outFile);
-
-    if (origImagePtr != NULL)
-    {
-        delete [] origImagePtr;
-    }
-
     return 0;
 }
 
@@ -8,7 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include "common_video/interface/video_image.h"
@@ -17,6 +19,7 @@
 #include "gtest/gtest.h"
 #include "testsupport/fileutils.h"
 #include "modules/interface/module_common_types.h"
+#include "system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
 
@@ -64,6 +67,13 @@ class JpegTest: public testing::Test {
     return encoded_buffer;
   }
 
+  // Decodes an image from JpegEncoder, whose buffer is larger than the image.
+  int DecodeEncodedImage(const EncodedImage& encoded, I420VideoFrame* image) {
+    EncodedImage jpeg = encoded;
+    jpeg._size = jpeg._length;
+    return ConvertJpegToI420(jpeg, image);
+  }
+
   std::string input_filename_;
   std::string decoded_filename_;
   std::string encoded_filename_;
@@ -111,4 +121,124 @@ TEST_F(JpegTest, Encode) {
 
 }
 
+TEST_F(JpegTest, EncodeToMemory) {
+  encoded_buffer_ = ReadEncodedImage(input_filename_);
+  I420VideoFrame image_buffer;
+  ASSERT_EQ(0, ConvertJpegToI420(*encoded_buffer_, &image_buffer));
+  image_buffer.set_timestamp(1234);
+
+  EncodedImage encoded;
+  ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kImageWidth), encoded._encodedWidth);
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kImageHeight), encoded._encodedHeight);
+  EXPECT_EQ(1234u, encoded._timeStamp);
+  EXPECT_EQ(kKeyFrame, encoded._frameType);
+  EXPECT_LE(encoded._length, encoded._size);
+
+  I420VideoFrame decoded;
+  EXPECT_EQ(0, DecodeEncodedImage(encoded, &decoded));
+  EXPECT_EQ(kImageWidth, decoded.width());
+  EXPECT_EQ(kImageHeight, decoded.height());
+
+  // The compressor is reused, and the buffer is kept.
+  WebRtc_UWord8* buffer = encoded._buffer;
+  std::string first(reinterpret_cast<char*>(encoded._buffer),
+                    encoded._length);
+  ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  EXPECT_EQ(buffer, encoded._buffer);
+  EXPECT_EQ(first, std::string(reinterpret_cast<char*>(encoded._buffer),
+                               encoded._length));
+  delete [] encoded._buffer;
+}
+
+TEST_F(JpegTest, EncodeWithMaxResolution) {
+  encoded_buffer_ = ReadEncodedImage(input_filename_);
+  I420VideoFrame image_buffer;
+  ASSERT_EQ(0, ConvertJpegToI420(*encoded_buffer_, &image_buffer));
+
+  EXPECT_EQ(-1, encoder_->SetMaxResolution(-1, 120));
+  // The image is fitted in the max resolution, keeping the aspect ratio.
+  EXPECT_EQ(0, encoder_->SetMaxResolution(160, 160));
+  EncodedImage encoded;
+  ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  EXPECT_EQ(160u, encoded._encodedWidth);
+  EXPECT_EQ(120u, encoded._encodedHeight);
+  I420VideoFrame decoded;
+  EXPECT_EQ(0, DecodeEncodedImage(encoded, &decoded));
+  EXPECT_EQ(160, decoded.width());
+  EXPECT_EQ(120, decoded.height());
+
+  // Smaller images aren't scaled up.
+  EXPECT_EQ(0, encoder_->SetMaxResolution(1280, 720));
+  ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kImageWidth), encoded._encodedWidth);
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kImageHeight), encoded._encodedHeight);
+  delete [] encoded._buffer;
+}
+
+TEST_F(JpegTest, EncodeOddSizeWithoutStridePadding) {
+  // The planes of this image end before the whole JPEG blocks do.
+  const int kWidth = 175;
+  const int kHeight = 99;
+  I420VideoFrame image_buffer;
+  ASSERT_EQ(0, image_buffer.CreateEmptyFrame(kWidth, kHeight, kWidth,
+                                             (kWidth + 1) / 2,
+                                             (kWidth + 1) / 2));
+  memset(image_buffer.buffer(kYPlane), 200,
+         image_buffer.allocated_size(kYPlane));
+  memset(image_buffer.buffer(kUPlane), 100,
+         image_buffer.allocated_size(kUPlane));
+  memset(image_buffer.buffer(kVPlane), 50,
+         image_buffer.allocated_size(kVPlane));
+
+  EncodedImage encoded;
+  ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  I420VideoFrame decoded;
+  ASSERT_EQ(0, DecodeEncodedImage(encoded, &decoded));
+  EXPECT_EQ(kWidth, decoded.width());
+  EXPECT_EQ(kHeight, decoded.height());
+  EXPECT_NEAR(200, decoded.buffer(kYPlane)[(kHeight - 1) *
+                                           decoded.stride(kYPlane) +
+                                           kWidth - 1], 2);
+  delete [] encoded._buffer;
+}
+
+// Measures snapshots per second when an encoder is created and writes a file
+// for each snapshot, and when one encoder encodes to memory.
+TEST_F(JpegTest, SnapshotsPerSecond) {
+  encoded_buffer_ = ReadEncodedImage(input_filename_);
+  I420VideoFrame image_buffer;
+  ASSERT_EQ(0, ConvertJpegToI420(*encoded_buffer_, &image_buffer));
+  const int kSnapshots = 200;
+
+  TickTime start = TickTime::Now();
+  for (int i = 0; i < kSnapshots; ++i) {
+    JpegEncoder encoder;
+    ASSERT_EQ(0, encoder.SetFileName(encoded_filename_.c_str()));
+    ASSERT_EQ(0, encoder.Encode(image_buffer));
+  }
+  const WebRtc_Word64 file_ms = (TickTime::Now() - start).Milliseconds();
+
+  EncodedImage encoded;
+  start = TickTime::Now();
+  for (int i = 0; i < kSnapshots; ++i) {
+    ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  }
+  const WebRtc_Word64 memory_ms = (TickTime::Now() - start).Milliseconds();
+
+  ASSERT_EQ(0, encoder_->SetMaxResolution(160, 120));
+  start = TickTime::Now();
+  for (int i = 0; i < kSnapshots; ++i) {
+    ASSERT_EQ(0, encoder_->Encode(image_buffer, &encoded));
+  }
+  const WebRtc_Word64 thumbnail_ms = (TickTime::Now() - start).Milliseconds();
+  delete [] encoded._buffer;
+
+  printf("%dx%d snapshots/s: new encoder to file %.0f, reused encoder to "
+         "memory %.0f, 160x120 thumbnail %.0f\n", kImageWidth, kImageHeight,
+         kSnapshots * 1000.0 / std::max<WebRtc_Word64>(file_ms, 1),
+         kSnapshots * 1000.0 / std::max<WebRtc_Word64>(memory_ms, 1),
+         kSnapshots * 1000.0 / std::max<WebRtc_Word64>(thumbnail_ms, 1));
+}
+
 }  // namespace webrtc
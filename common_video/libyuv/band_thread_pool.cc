@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/libyuv/include/band_thread_pool.h"
+
+#include <assert.h>
+
+#include "system_wrappers/interface/condition_variable_wrapper.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+// Max time for a worker to wait before checking if the pool is stopped.
+static const unsigned long kWorkerWaitTimeMs = 100;
+
+BandThreadPool* BandThreadPool::Create(int num_threads) {
+  if (num_threads < 1) {
+    return NULL;
+  }
+  BandThreadPool* pool = new BandThreadPool(num_threads);
+  if (!pool->StartThreads()) {
+    delete pool;
+    return NULL;
+  }
+  return pool;
+}
+
+BandThreadPool::BandThreadPool(int num_threads)
+    : num_threads_(num_threads),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      work_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+      done_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+      stopped_(false),
+      task_(NULL),
+      num_bands_(0),
+      next_band_(0),
+      completed_bands_(0) {
+}
+
+BandThreadPool::~BandThreadPool() {
+  StopThreads();
+}
+
+bool BandThreadPool::StartThreads() {
+  // The thread calling Run() is one of the threads.
+  for (int i = 1; i < num_threads_; ++i) {
+    ThreadWrapper* thread = ThreadWrapper::CreateThread(WorkerThreadFunction,
+                                                        this, kHighPriority,
+                                                        "BandThreadPool");
+    if (thread == NULL) {
+      return false;
+    }
+    threads_.push_back(thread);
+    unsigned int thread_id = 0;
+    if (!thread->Start(thread_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BandThreadPool::StopThreads() {
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->SetNotAlive();
+  }
+  {
+    CriticalSectionScoped cs(crit_.get());
+    stopped_ = true;
+    work_cond_->WakeAll();
+  }
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->Stop();
+    delete threads_[i];
+  }
+  threads_.clear();
+}
+
+void BandThreadPool::Run(Task* task, int num_bands) {
+  assert(task);
+  if (num_bands < 1) {
+    return;
+  }
+  if (num_bands == 1 || threads_.empty()) {
+    for (int band = 0; band < num_bands; ++band) {
+      task->ProcessBand(band, num_bands);
+    }
+    return;
+  }
+  CriticalSectionScoped cs(crit_.get());
+  assert(task_ == NULL);
+  task_ = task;
+  num_bands_ = num_bands;
+  next_band_ = 0;
+  completed_bands_ = 0;
+  work_cond_->WakeAll();
+  ProcessBands();
+  while (completed_bands_ < num_bands_) {
+    done_cond_->SleepCS(*crit_);
+  }
+  task_ = NULL;
+}
+
+int BandThreadPool::BandStart(int band, int num_bands, int height) {
+  if (band >= num_bands) {
+    return height;
+  }
+  return (height * band / num_bands) & ~1;
+}
+
+bool BandThreadPool::WorkerThreadFunction(void* obj) {
+  return static_cast<BandThreadPool*>(obj)->WorkerProcess();
+}
+
+bool BandThreadPool::WorkerProcess() {
+  CriticalSectionScoped cs(crit_.get());
+  if (stopped_) {
+    return false;
+  }
+  if (task_ == NULL || next_band_ >= num_bands_) {
+    work_cond_->SleepCS(*crit_, kWorkerWaitTimeMs);
+  }
+  ProcessBands();
+  return true;
+}
+
+void BandThreadPool::ProcessBands() {
+  while (task_ != NULL && next_band_ < num_bands_) {
+    Task* task = task_;
+    const int band = next_band_++;
+    const int num_bands = num_bands_;
+    crit_->Leave();
+    task->ProcessBand(band, num_bands);
+    crit_->Enter();
+    if (++completed_bands_ == num_bands_) {
+      done_cond_->WakeAll();
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/libyuv/include/band_thread_pool.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+class CountingTask : public BandThreadPool::Task {
+ public:
+  explicit CountingTask(int num_bands)
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        counts_(num_bands, 0) {
+  }
+  virtual ~CountingTask() {}
+
+  virtual void ProcessBand(int band, int num_bands) {
+    CriticalSectionScoped cs(crit_.get());
+    EXPECT_EQ(static_cast<int>(counts_.size()), num_bands);
+    ++counts_[band];
+  }
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<int> counts_;
+};
+
+TEST(BandThreadPoolTest, CreateFailsWithoutThreads) {
+  EXPECT_TRUE(BandThreadPool::Create(0) == NULL);
+}
+
+TEST(BandThreadPoolTest, RunsEachBandOnce) {
+  scoped_ptr<BandThreadPool> thread_pool(BandThreadPool::Create(4));
+  ASSERT_TRUE(thread_pool.get() != NULL);
+  EXPECT_EQ(4, thread_pool->num_threads());
+  const int kNumBands[] = { 1, 3, 4, 10 };
+  for (int run = 0; run < 100; ++run) {
+    for (size_t i = 0; i < sizeof(kNumBands) / sizeof(kNumBands[0]); ++i) {
+      CountingTask task(kNumBands[i]);
+      thread_pool->Run(&task, kNumBands[i]);
+      for (int band = 0; band < kNumBands[i]; ++band) {
+        EXPECT_EQ(1, task.counts_[band]);
+      }
+    }
+  }
+}
+
+TEST(BandThreadPoolTest, BandsStartOnEvenRows) {
+  const int kHeight = 231;
+  const int kNumBands = 5;
+  EXPECT_EQ(0, BandThreadPool::BandStart(0, kNumBands, kHeight));
+  EXPECT_EQ(kHeight, BandThreadPool::BandStart(kNumBands, kNumBands, kHeight));
+  for (int band = 1; band < kNumBands; ++band) {
+    const int start = BandThreadPool::BandStart(band, kNumBands, kHeight);
+    EXPECT_EQ(0, start % 2);
+    EXPECT_LT(BandThreadPool::BandStart(band - 1, kNumBands, kHeight), start);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Thread pool splitting frame operations into horizontal bands.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_BAND_THREAD_POOL_H_
+#define WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_BAND_THREAD_POOL_H_
+
+#include <vector>
+
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "typedefs.h"
+
+namespace webrtc {
+
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+class ThreadWrapper;
+
+class BandThreadPool {
+ public:
+  class Task {
+   public:
+    // Processes band |band| out of |num_bands|. Called once per band, on
+    // any of the pool threads or the thread calling Run().
+    virtual void ProcessBand(int band, int num_bands) = 0;
+
+   protected:
+    virtual ~Task() {}
+  };
+
+  // Creates a pool running bands on |num_threads| threads, including the
+  // thread calling Run(). Returns NULL if the worker threads can't be
+  // started.
+  static BandThreadPool* Create(int num_threads);
+
+  ~BandThreadPool();
+
+  // Total number of threads, including the thread calling Run().
+  int num_threads() const { return num_threads_; }
+
+  // Runs all bands of |task| and returns when they are done. The calling
+  // thread processes bands as well. Must not be called concurrently.
+  void Run(Task* task, int num_bands);
+
+  // Returns the first row of |band| when |height| rows are split into
+  // |num_bands| bands. Bands start on even rows to keep the chroma planes of
+  // 4:2:0 frames in the same band as their luma rows.
+  static int BandStart(int band, int num_bands, int height);
+
+ private:
+  explicit BandThreadPool(int num_threads);
+
+  bool StartThreads();
+  void StopThreads();
+
+  static bool WorkerThreadFunction(void* obj);
+  bool WorkerProcess();
+
+  // Processes bands until none are left to take. Called with |crit_| held.
+  void ProcessBands();
+
+  const int num_threads_;
+  std::vector<ThreadWrapper*> threads_;
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<ConditionVariableWrapper> work_cond_;
+  scoped_ptr<ConditionVariableWrapper> done_cond_;
+  bool stopped_;
+  Task* task_;
+  int num_bands_;
+  int next_band_;
+  int completed_bands_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_BAND_THREAD_POOL_H_
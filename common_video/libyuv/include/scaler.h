@@ -17,10 +17,13 @@
 
 #include "common_video/interface/i420_video_frame.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "system_wrappers/interface/scoped_ptr.h"
 #include "typedefs.h"
 
 namespace webrtc {
 
+class BandThreadPool;
+
 // Supported scaling types
 enum ScaleMethod {
   kScalePoint,  // no interpolation
@@ -42,6 +45,14 @@ class Scaler {
           VideoType src_video_type, VideoType dst_video_type,
           ScaleMethod method);
 
+  // Split scaling into horizontal bands processed on |num_threads| threads,
+  // including the thread calling Scale(). 1 (default) scales on the calling
+  // thread only. The output may differ slightly at band edges from scaling
+  // the frame in one pass.
+  // Return value: 0 - OK
+  //              -1 - parameter error or the threads couldn't be started
+  int SetNumberOfThreads(int num_threads);
+
   // Scale frame
   // Memory is allocated by user. If dst_frame is not of sufficient size,
   // the frame will be reallocated to the appropriate size.
@@ -62,6 +73,7 @@ class Scaler {
   int           dst_width_;
   int           dst_height_;
   bool          set_;
+  scoped_ptr<BandThreadPool> thread_pool_;
 };
 
 }  // namespace webrtc
@@ -23,6 +23,8 @@
 
 namespace webrtc {
 
+class BandThreadPool;
+
 // Supported video types.
 enum VideoType {
   kUnknown,
@@ -122,6 +124,17 @@ int ConvertToI420(VideoType src_video_type,
                   int sample_size,
                   VideoRotationMode rotation,
                   I420VideoFrame* dst_frame);
+// Same as above, with the conversion split into horizontal bands run on
+// |thread_pool|. MJPG input and rotated output are converted on the calling
+// thread. |thread_pool| may be NULL.
+int ConvertToI420(VideoType src_video_type,
+                  const uint8_t* src_frame,
+                  int crop_x, int crop_y,
+                  int src_width, int src_height,
+                  int sample_size,
+                  VideoRotationMode rotation,
+                  I420VideoFrame* dst_frame,
+                  BandThreadPool* thread_pool);
 
 // Convert From I420
 // Input:
@@ -134,6 +147,13 @@ int ConvertToI420(VideoType src_video_type,
 int ConvertFromI420(const I420VideoFrame& src_frame,
                     VideoType dst_video_type, int dst_sample_size,
                     uint8_t* dst_frame);
+// Same as above, with the conversion split into horizontal bands run on
+// |thread_pool|. Planar output types are converted on the calling thread.
+// |thread_pool| may be NULL.
+int ConvertFromI420(const I420VideoFrame& src_frame,
+                    VideoType dst_video_type, int dst_sample_size,
+                    uint8_t* dst_frame,
+                    BandThreadPool* thread_pool);
 // ConvertFrom YV12.
 // Interface - same as above.
 int ConvertFromYV12(const I420VideoFrame& src_frame,
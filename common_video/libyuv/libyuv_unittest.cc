@@ -12,6 +12,7 @@
 #include <string.h>
 
 #include "common_video/interface/i420_video_frame.h"
+#include "common_video/libyuv/include/band_thread_pool.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "gtest/gtest.h"
 #include "system_wrappers/interface/tick_util.h"
@@ -295,6 +296,73 @@ TEST_F(TestLibYuv, ConvertAlignedFrame) {
   EXPECT_EQ(48.0, psnr);
 }
 
+TEST_F(TestLibYuv, MultiThreadedConvertTest) {
+  // Converting in bands must give the same result as a single pass.
+  scoped_ptr<BandThreadPool> thread_pool(BandThreadPool::Create(4));
+  ASSERT_TRUE(thread_pool.get() != NULL);
+  const VideoType kTypes[] = { kYUY2, kUYVY, kARGB, kRGB24 };
+  for (size_t i = 0; i < sizeof(kTypes) / sizeof(kTypes[0]); ++i) {
+    const int length = CalcBufferSize(kTypes[i], width_, height_);
+    scoped_array<uint8_t> out_buffer(new uint8_t[length]);
+    scoped_array<uint8_t> out_buffer_mt(new uint8_t[length]);
+    EXPECT_EQ(0, ConvertFromI420(orig_frame_, kTypes[i], 0,
+                                 out_buffer.get()));
+    EXPECT_EQ(0, ConvertFromI420(orig_frame_, kTypes[i], 0,
+                                 out_buffer_mt.get(), thread_pool.get()));
+    EXPECT_EQ(0, memcmp(out_buffer.get(), out_buffer_mt.get(), length));
+
+    I420VideoFrame res_frame;
+    I420VideoFrame res_frame_mt;
+    res_frame.CreateEmptyFrame(width_, height_, width_, (width_ + 1) / 2,
+                               (width_ + 1) / 2);
+    res_frame_mt.CreateEmptyFrame(width_, height_, width_, (width_ + 1) / 2,
+                                  (width_ + 1) / 2);
+    EXPECT_EQ(0, ConvertToI420(kTypes[i], out_buffer.get(), 0, 0,
+                               width_, height_, 0, kRotateNone, &res_frame));
+    EXPECT_EQ(0, ConvertToI420(kTypes[i], out_buffer.get(), 0, 0,
+                               width_, height_, 0, kRotateNone, &res_frame_mt,
+                               thread_pool.get()));
+    EXPECT_EQ(48.0, I420PSNR(&res_frame, &res_frame_mt));
+  }
+}
+
+TEST_F(TestLibYuv, MultiThreadedConvertBenchmark) {
+  const int kNumFrames = 20;
+  const int kSizes[][2] = { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+  const int kThreads[] = { 1, 2, 4 };
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int width = kSizes[s][0];
+    const int height = kSizes[s][1];
+    const int half_width = (width + 1) / 2;
+    scoped_array<uint8_t> yuy2_buffer(
+        new uint8_t[CalcBufferSize(kYUY2, width, height)]);
+    memset(yuy2_buffer.get(), 128, CalcBufferSize(kYUY2, width, height));
+    I420VideoFrame frame;
+    frame.CreateEmptyFrame(width, height, width, half_width, half_width);
+    for (size_t t = 0; t < sizeof(kThreads) / sizeof(kThreads[0]); ++t) {
+      scoped_ptr<BandThreadPool> thread_pool(
+          BandThreadPool::Create(kThreads[t]));
+      ASSERT_TRUE(thread_pool.get() != NULL);
+      int64_t to_i420_us = 0;
+      int64_t from_i420_us = 0;
+      for (int i = 0; i < kNumFrames; ++i) {
+        int64_t start_us = TickTime::MicrosecondTimestamp();
+        EXPECT_EQ(0, ConvertToI420(kYUY2, yuy2_buffer.get(), 0, 0,
+                                   width, height, 0, kRotateNone, &frame,
+                                   thread_pool.get()));
+        to_i420_us += TickTime::MicrosecondTimestamp() - start_us;
+        start_us = TickTime::MicrosecondTimestamp();
+        EXPECT_EQ(0, ConvertFromI420(frame, kYUY2, 0, yuy2_buffer.get(),
+                                     thread_pool.get()));
+        from_i420_us += TickTime::MicrosecondTimestamp() - start_us;
+      }
+      printf("YUY2 %dx%d, %d threads: to I420 %.2f ms, from I420 %.2f ms\n",
+             width, height, kThreads[t],
+             to_i420_us / 1000.0 / kNumFrames,
+             from_i420_us / 1000.0 / kNumFrames);
+    }
+  }
+}
 
 TEST_F(TestLibYuv, RotateTest) {
   // Use ConvertToI420 for multiple roatations - see that nothing breaks, all
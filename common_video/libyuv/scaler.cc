@@ -10,10 +10,95 @@
 
 #include "common_video/libyuv/include/scaler.h"
 
+#include <algorithm>
+
+#include "common_video/libyuv/include/band_thread_pool.h"
 #include "libyuv.h"
 
 namespace webrtc {
 
+// Bands smaller than this aren't worth handing to another thread.
+static const int kMinBandHeight = 32;
+
+// Scales one horizontal band of the destination frame from the matching
+// rows of the source frame.
+class ScaleBandTask : public BandThreadPool::Task {
+ public:
+  ScaleBandTask(const I420VideoFrame& src_frame, int src_width,
+                int src_height, I420VideoFrame* dst_frame, int dst_width,
+                int dst_height, ScaleMethod method)
+      : src_frame_(src_frame),
+        src_width_(src_width),
+        src_height_(src_height),
+        dst_frame_(dst_frame),
+        dst_width_(dst_width),
+        dst_height_(dst_height),
+        method_(method),
+        result_(0) {
+  }
+  virtual ~ScaleBandTask() {}
+
+  virtual void ProcessBand(int band, int num_bands) {
+    const int dst_start = BandThreadPool::BandStart(band, num_bands,
+                                                    dst_height_);
+    const int dst_end = BandThreadPool::BandStart(band + 1, num_bands,
+                                                  dst_height_);
+    if (dst_end <= dst_start)
+      return;
+    const int src_start = MapRow(dst_start);
+    const int src_end = (band + 1 == num_bands) ? src_height_ :
+        MapRow(dst_end);
+    if (src_end <= src_start)
+      return;
+    const int ret = libyuv::I420Scale(
+        Row(src_frame_, kYPlane, src_start),
+        src_frame_.stride(kYPlane),
+        Row(src_frame_, kUPlane, src_start / 2),
+        src_frame_.stride(kUPlane),
+        Row(src_frame_, kVPlane, src_start / 2),
+        src_frame_.stride(kVPlane),
+        src_width_, src_end - src_start,
+        Row(dst_frame_, kYPlane, dst_start),
+        dst_frame_->stride(kYPlane),
+        Row(dst_frame_, kUPlane, dst_start / 2),
+        dst_frame_->stride(kUPlane),
+        Row(dst_frame_, kVPlane, dst_start / 2),
+        dst_frame_->stride(kVPlane),
+        dst_width_, dst_end - dst_start,
+        libyuv::FilterMode(method_));
+    if (ret != 0)
+      result_ = ret;
+  }
+
+  int result() const { return result_; }
+
+ private:
+  // Returns the even source row matching destination row |dst_row|.
+  int MapRow(int dst_row) const {
+    return static_cast<int>(static_cast<int64_t>(dst_row) * src_height_ /
+                            dst_height_) & ~1;
+  }
+
+  static const uint8_t* Row(const I420VideoFrame& frame, PlaneType plane,
+                            int row) {
+    return frame.buffer(plane) + row * frame.stride(plane);
+  }
+
+  static uint8_t* Row(I420VideoFrame* frame, PlaneType plane, int row) {
+    return frame->buffer(plane) + row * frame->stride(plane);
+  }
+
+  const I420VideoFrame& src_frame_;
+  const int src_width_;
+  const int src_height_;
+  I420VideoFrame* dst_frame_;
+  const int dst_width_;
+  const int dst_height_;
+  const ScaleMethod method_;
+  // Written by several threads, only ever set to an error code.
+  volatile int result_;
+};
+
 Scaler::Scaler()
     : method_(kScaleBox),
       src_width_(0),
@@ -44,6 +129,19 @@ int Scaler::Set(int src_width, int src_height,
   return 0;
 }
 
+int Scaler::SetNumberOfThreads(int num_threads) {
+  if (num_threads < 1)
+    return -1;
+  if (num_threads == 1) {
+    thread_pool_.reset();
+    return 0;
+  }
+  if (thread_pool_.get() && thread_pool_->num_threads() == num_threads)
+    return 0;
+  thread_pool_.reset(BandThreadPool::Create(num_threads));
+  return thread_pool_.get() ? 0 : -1;
+}
+
 int Scaler::Scale(const I420VideoFrame& src_frame,
                   I420VideoFrame* dst_frame) {
   assert(dst_frame);
@@ -59,6 +157,18 @@ int Scaler::Scale(const I420VideoFrame& src_frame,
                               dst_width_, (dst_width_ + 1) / 2,
                               (dst_width_ + 1) / 2);
 
+  if (thread_pool_.get()) {
+    const int num_bands = std::min(thread_pool_->num_threads(),
+                                   std::min(src_height_, dst_height_) /
+                                   kMinBandHeight);
+    if (num_bands > 1) {
+      ScaleBandTask task(src_frame, src_width_, src_height_, dst_frame,
+                         dst_width_, dst_height_, method_);
+      thread_pool_->Run(&task, num_bands);
+      return task.result();
+    }
+  }
+
   return libyuv::I420Scale(src_frame.buffer(kYPlane),
                            src_frame.stride(kYPlane),
                            src_frame.buffer(kUPlane),
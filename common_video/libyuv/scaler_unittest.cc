@@ -116,6 +116,89 @@ TEST_F(TestScaler, ScaleSendingBufferTooSmall) {
   EXPECT_EQ(half_height_, test_frame2.height());
 }
 
+TEST_F(TestScaler, SetNumberOfThreads) {
+  EXPECT_EQ(-1, test_scaler_.SetNumberOfThreads(0));
+  EXPECT_EQ(0, test_scaler_.SetNumberOfThreads(4));
+  EXPECT_EQ(0, test_scaler_.SetNumberOfThreads(1));
+}
+
+TEST_F(TestScaler, MultiThreadedScaleTest) {
+  // Scaling in bands may only differ from a single pass at the band edges.
+  scoped_array<uint8_t> orig_buffer(new uint8_t[frame_length_]);
+  EXPECT_GT(fread(orig_buffer.get(), 1, frame_length_, source_file_), 0U);
+  test_frame_.CreateFrame(size_y_, orig_buffer.get(),
+                          size_uv_, orig_buffer.get() + size_y_,
+                          size_uv_, orig_buffer.get() + size_y_ + size_uv_,
+                          width_, height_,
+                          width_, half_width_, half_width_);
+  const int kSizes[][2] = { { 176, 144 }, { 282, 231 }, { 704, 576 } };
+  const ScaleMethod kMethods[] = { kScalePoint, kScaleBilinear, kScaleBox };
+  Scaler scaler_mt;
+  EXPECT_EQ(0, scaler_mt.SetNumberOfThreads(4));
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    for (size_t m = 0; m < sizeof(kMethods) / sizeof(kMethods[0]); ++m) {
+      EXPECT_EQ(0, test_scaler_.Set(width_, height_,
+                                    kSizes[s][0], kSizes[s][1],
+                                    kI420, kI420, kMethods[m]));
+      EXPECT_EQ(0, scaler_mt.Set(width_, height_,
+                                 kSizes[s][0], kSizes[s][1],
+                                 kI420, kI420, kMethods[m]));
+      I420VideoFrame out_frame;
+      I420VideoFrame out_frame_mt;
+      EXPECT_EQ(0, test_scaler_.Scale(test_frame_, &out_frame));
+      EXPECT_EQ(0, scaler_mt.Scale(test_frame_, &out_frame_mt));
+      EXPECT_EQ(kSizes[s][0], out_frame_mt.width());
+      EXPECT_EQ(kSizes[s][1], out_frame_mt.height());
+      EXPECT_GT(I420PSNR(&out_frame, &out_frame_mt), 35.0);
+    }
+  }
+}
+
+TEST_F(TestScaler, MultiThreadedScaleBenchmark) {
+  const int kNumFrames = 20;
+  // Source and destination sizes.
+  const int kSizes[][4] = {
+    { 1920, 1080, 1280, 720 },
+    { 1920, 1080, 640, 360 },
+    { 1280, 720, 640, 360 },
+    { 1280, 720, 320, 180 },
+    { 640, 480, 320, 240 },
+    { 640, 360, 1280, 720 },
+  };
+  const int kThreads[] = { 1, 2, 4 };
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int src_width = kSizes[s][0];
+    const int src_height = kSizes[s][1];
+    const int half_width = (src_width + 1) / 2;
+    I420VideoFrame src_frame;
+    src_frame.CreateEmptyFrame(src_width, src_height,
+                               src_width, half_width, half_width);
+    memset(src_frame.buffer(kYPlane), 128,
+           src_frame.allocated_size(kYPlane));
+    memset(src_frame.buffer(kUPlane), 128,
+           src_frame.allocated_size(kUPlane));
+    memset(src_frame.buffer(kVPlane), 128,
+           src_frame.allocated_size(kVPlane));
+    for (size_t t = 0; t < sizeof(kThreads) / sizeof(kThreads[0]); ++t) {
+      Scaler scaler;
+      EXPECT_EQ(0, scaler.SetNumberOfThreads(kThreads[t]));
+      EXPECT_EQ(0, scaler.Set(src_width, src_height,
+                              kSizes[s][2], kSizes[s][3],
+                              kI420, kI420, kScaleBox));
+      I420VideoFrame dst_frame;
+      int64_t total_us = 0;
+      for (int i = 0; i < kNumFrames; ++i) {
+        const int64_t start_us = TickTime::MicrosecondTimestamp();
+        EXPECT_EQ(0, scaler.Scale(src_frame, &dst_frame));
+        total_us += TickTime::MicrosecondTimestamp() - start_us;
+      }
+      printf("Scaling[%d %d] => [%d %d], %d threads: %.2f ms\n",
+             src_width, src_height, kSizes[s][2], kSizes[s][3], kThreads[t],
+             total_us / 1000.0 / kNumFrames);
+    }
+  }
+}
+
 //TODO (mikhal): Converge the test into one function that accepts the method.
 TEST_F(TestScaler, PointScaleTest) {
   double avg_psnr;
@@ -13,11 +13,16 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "common_video/libyuv/include/band_thread_pool.h"
 #include "libyuv.h"
 
 namespace webrtc {
 
 const int k16ByteAlignment = 16;
+// Bands smaller than this aren't worth handing to another thread.
+const int kMinConversionBandHeight = 32;
 
 VideoType RawVideoTypeToCommonVideoVideoType(RawVideoType type) {
   switch (type) {
@@ -284,6 +289,177 @@ int ConvertFromYV12(const I420VideoFrame& src_frame,
                                  ConvertVideoType(dst_video_type));
 }
 
+// Bytes per pixel of the packed video types, 0 for other types.
+static int PackedBytesPerPixel(VideoType video_type) {
+  switch (video_type) {
+    case kYUY2:
+    case kUYVY:
+    case kRGB565:
+    case kARGB4444:
+    case kARGB1555:
+      return 2;
+    case kRGB24:
+      return 3;
+    case kABGR:
+    case kARGB:
+    case kBGRA:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+static int NumberOfBands(const BandThreadPool* thread_pool, int height) {
+  if (thread_pool == NULL)
+    return 1;
+  return std::max(1, std::min(thread_pool->num_threads(),
+                              height / kMinConversionBandHeight));
+}
+
+// Converts one horizontal band of the destination I420 frame.
+class ConvertToI420BandTask : public BandThreadPool::Task {
+ public:
+  ConvertToI420BandTask(VideoType src_video_type, const uint8_t* src_frame,
+                        int crop_x, int crop_y, int src_width,
+                        int src_height, int sample_size,
+                        I420VideoFrame* dst_frame)
+      : src_video_type_(src_video_type),
+        src_frame_(src_frame),
+        crop_x_(crop_x),
+        crop_y_(crop_y),
+        src_width_(src_width),
+        src_height_(src_height),
+        sample_size_(sample_size),
+        dst_frame_(dst_frame),
+        result_(0) {
+  }
+  virtual ~ConvertToI420BandTask() {}
+
+  virtual void ProcessBand(int band, int num_bands) {
+    const int height = dst_frame_->height();
+    const int start = BandThreadPool::BandStart(band, num_bands, height);
+    const int end = BandThreadPool::BandStart(band + 1, num_bands, height);
+    if (end <= start)
+      return;
+    const int ret = libyuv::ConvertToI420(
+        src_frame_, sample_size_,
+        dst_frame_->buffer(kYPlane) + start * dst_frame_->stride(kYPlane),
+        dst_frame_->stride(kYPlane),
+        dst_frame_->buffer(kUPlane) + start / 2 * dst_frame_->stride(kUPlane),
+        dst_frame_->stride(kUPlane),
+        dst_frame_->buffer(kVPlane) + start / 2 * dst_frame_->stride(kVPlane),
+        dst_frame_->stride(kVPlane),
+        crop_x_, crop_y_ + start,
+        src_width_, src_height_,
+        dst_frame_->width(), end - start,
+        libyuv::kRotate0,
+        ConvertVideoType(src_video_type_));
+    if (ret != 0)
+      result_ = ret;
+  }
+
+  int result() const { return result_; }
+
+ private:
+  const VideoType src_video_type_;
+  const uint8_t* src_frame_;
+  const int crop_x_;
+  const int crop_y_;
+  const int src_width_;
+  const int src_height_;
+  const int sample_size_;
+  I420VideoFrame* dst_frame_;
+  // Written by several threads, only ever set to an error code.
+  volatile int result_;
+};
+
+int ConvertToI420(VideoType src_video_type,
+                  const uint8_t* src_frame,
+                  int crop_x, int crop_y,
+                  int src_width, int src_height,
+                  int sample_size,
+                  VideoRotationMode rotation,
+                  I420VideoFrame* dst_frame,
+                  BandThreadPool* thread_pool) {
+  // Bands must start on even source rows for the chroma planes of 4:2:0
+  // input to line up.
+  const int num_bands = NumberOfBands(thread_pool, dst_frame->height());
+  if (num_bands == 1 || src_video_type == kMJPG ||
+      rotation != kRotateNone || src_height <= 0 || (crop_y & 1)) {
+    return ConvertToI420(src_video_type, src_frame, crop_x, crop_y,
+                         src_width, src_height, sample_size, rotation,
+                         dst_frame);
+  }
+  ConvertToI420BandTask task(src_video_type, src_frame, crop_x, crop_y,
+                             src_width, src_height, sample_size, dst_frame);
+  thread_pool->Run(&task, num_bands);
+  return task.result();
+}
+
+// Converts one horizontal band of an I420 frame to a packed video type.
+class ConvertFromI420BandTask : public BandThreadPool::Task {
+ public:
+  ConvertFromI420BandTask(const I420VideoFrame& src_frame,
+                          VideoType dst_video_type, int dst_stride,
+                          uint8_t* dst_frame)
+      : src_frame_(src_frame),
+        dst_video_type_(dst_video_type),
+        dst_stride_(dst_stride),
+        dst_frame_(dst_frame),
+        result_(0) {
+  }
+  virtual ~ConvertFromI420BandTask() {}
+
+  virtual void ProcessBand(int band, int num_bands) {
+    const int height = src_frame_.height();
+    const int start = BandThreadPool::BandStart(band, num_bands, height);
+    const int end = BandThreadPool::BandStart(band + 1, num_bands, height);
+    if (end <= start)
+      return;
+    const int ret = libyuv::ConvertFromI420(
+        src_frame_.buffer(kYPlane) + start * src_frame_.stride(kYPlane),
+        src_frame_.stride(kYPlane),
+        src_frame_.buffer(kUPlane) + start / 2 * src_frame_.stride(kUPlane),
+        src_frame_.stride(kUPlane),
+        src_frame_.buffer(kVPlane) + start / 2 * src_frame_.stride(kVPlane),
+        src_frame_.stride(kVPlane),
+        dst_frame_ + start * dst_stride_, dst_stride_,
+        src_frame_.width(), end - start,
+        ConvertVideoType(dst_video_type_));
+    if (ret != 0)
+      result_ = ret;
+  }
+
+  int result() const { return result_; }
+
+ private:
+  const I420VideoFrame& src_frame_;
+  const VideoType dst_video_type_;
+  const int dst_stride_;
+  uint8_t* dst_frame_;
+  // Written by several threads, only ever set to an error code.
+  volatile int result_;
+};
+
+int ConvertFromI420(const I420VideoFrame& src_frame,
+                    VideoType dst_video_type, int dst_sample_size,
+                    uint8_t* dst_frame,
+                    BandThreadPool* thread_pool) {
+  const int bytes_per_pixel = PackedBytesPerPixel(dst_video_type);
+  const int num_bands = NumberOfBands(thread_pool, src_frame.height());
+  if (num_bands == 1 || bytes_per_pixel == 0) {
+    return ConvertFromI420(src_frame, dst_video_type, dst_sample_size,
+                           dst_frame);
+  }
+  // A zero sample size means a packed frame without padding.
+  const int dst_stride = (dst_sample_size > 0) ? dst_sample_size :
+      src_frame.width() * bytes_per_pixel;
+  ConvertFromI420BandTask task(src_frame, dst_video_type, dst_stride,
+                               dst_frame);
+  thread_pool->Run(&task, num_bands);
+  return task.result();
+}
+
 int MirrorI420LeftRight(const I420VideoFrame* src_frame,
                         I420VideoFrame* dst_frame) {
   // Source and destination frames should have equal resolution.
@@ -122,7 +122,8 @@ AudioCodingModuleImpl::AudioCodingModuleImpl(const WebRtc_Word32 id)
       current_send_codec_idx_(-1),
       current_receive_codec_idx_(-1),
       send_codec_registered_(false),
-      acm_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      acm_crit_sect_(CriticalSectionWrapper::CreateCriticalSection(
+          "AudioCodingModuleImpl")),
       vad_callback_(NULL),
       last_recv_audio_codec_pltype_(255),
       is_first_red_(true),
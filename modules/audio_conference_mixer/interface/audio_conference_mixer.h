@@ -79,6 +79,15 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual WebRtc_Word32 SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // Enable/disable mix-minus output. When enabled, every participant whose
+    // audio is in the mix also gets the mix without its own audio, as one of
+    // the unique frames of AudioMixerOutputReceiver::NewMixedAudio(). The
+    // id_ of such a frame is the id_ of the participant's AudioFrames. All
+    // other participants should be sent the general frame.
+    virtual WebRtc_Word32 SetMixMinusStatus(const bool enable) = 0;
+    // enabled is set to true if mix-minus output is enabled.
+    virtual WebRtc_Word32 MixMinusStatus(bool& enabled) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
@@ -59,6 +59,16 @@ void SetParticipantStatistics(ParticipantStatistics* stats,
     stats->level = 0;  // TODO(andrew): to what should this be set?
 }
 
+int16_t SaturateToInt16(int32_t value) {
+  if (value > 32767) {
+    return 32767;
+  }
+  if (value < -32768) {
+    return -32768;
+  }
+  return static_cast<int16_t>(value);
+}
+
 }  // namespace
 
 MixerParticipant::MixerParticipant()
@@ -125,6 +135,8 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       _scratchMixedParticipants(),
       _scratchVadPositiveParticipantsAmount(0),
       _scratchVadPositiveParticipants(),
+      _scratchMixAccumulator(),
+      _scratchMixMinusFrames(),
       _crit(NULL),
       _cbCrit(NULL),
       _id(id),
@@ -144,7 +156,10 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       _timeScheduler(kProcessPeriodicityInMs),
       _mixedAudioLevel(),
       _processCalls(0),
-      _limiter(NULL)
+      _limiter(NULL),
+      _mixMinus(false),
+      _mixMinusLimiters(),
+      _unusedLimiters()
 {}
 
 bool AudioConferenceMixerImpl::Init()
@@ -173,24 +188,29 @@ bool AudioConferenceMixerImpl::Init()
     if (!SetNumLimiterChannels(1))
         return false;
 
-    if(_limiter->gain_control()->set_mode(GainControl::kFixedDigital) !=
-        _limiter->kNoError)
+    return ConfigureLimiter(_limiter.get());
+}
+
+bool AudioConferenceMixerImpl::ConfigureLimiter(AudioProcessing* limiter)
+{
+    if(limiter->gain_control()->set_mode(GainControl::kFixedDigital) !=
+        limiter->kNoError)
         return false;
 
     // We smoothly limit the mixed frame to -7 dbFS. -6 would correspond to the
     // divide-by-2 but -7 is used instead to give a bit of headroom since the
     // AGC is not a hard limiter.
-    if(_limiter->gain_control()->set_target_level_dbfs(7) != _limiter->kNoError)
+    if(limiter->gain_control()->set_target_level_dbfs(7) != limiter->kNoError)
         return false;
 
-    if(_limiter->gain_control()->set_compression_gain_db(0)
-        != _limiter->kNoError)
+    if(limiter->gain_control()->set_compression_gain_db(0)
+        != limiter->kNoError)
         return false;
 
-    if(_limiter->gain_control()->enable_limiter(true) != _limiter->kNoError)
+    if(limiter->gain_control()->enable_limiter(true) != limiter->kNoError)
         return false;
 
-    if(_limiter->gain_control()->Enable(true) != _limiter->kNoError)
+    if(limiter->gain_control()->Enable(true) != limiter->kNoError)
         return false;
 
     return true;
@@ -198,6 +218,7 @@ bool AudioConferenceMixerImpl::Init()
 
 AudioConferenceMixerImpl::~AudioConferenceMixerImpl()
 {
+    ClearMixMinusLimiters();
     MemoryPool<AudioFrame>::DeleteMemoryPool(_audioFramePool);
     assert(_audioFramePool == NULL);
 }
@@ -240,6 +261,7 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
     ListWrapper mixList;
     ListWrapper rampOutList;
     ListWrapper additionalFramesList;
+    ListWrapper mixMinusList;
     MapWrapper mixedParticipantsMap;
     {
         CriticalSectionScoped cs(_cbCrit.get());
@@ -355,8 +377,16 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
         }
         else
         {
+            if(_mixMinus)
+            {
+                const ListWrapper* mixedLists[] = {
+                    &mixList, &additionalFramesList, &rampOutList };
+                MixMinusFromLists(*mixedAudio, mixedLists, 3, mixMinusList);
+                if(!LimitMixMinusAudio(mixMinusList))
+                    retval = -1;
+            }
             // Only call the limiter if we have something to mix.
-            if(!LimitMixedAudio(*mixedAudio))
+            if(!LimitMixedAudio(*mixedAudio, _limiter.get()))
                 retval = -1;
         }
 
@@ -379,12 +409,20 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
         CriticalSectionScoped cs(_cbCrit.get());
         if(_mixReceiver != NULL)
         {
-            const AudioFrame** dummy = NULL;
+            _scratchMixMinusFrames.clear();
+            ListItem* item = mixMinusList.First();
+            while(item)
+            {
+                _scratchMixMinusFrames.push_back(
+                    static_cast<const AudioFrame*>(item->GetItem()));
+                item = mixMinusList.Next(item);
+            }
             _mixReceiver->NewMixedAudio(
                 _id,
                 *mixedAudio,
-                dummy,
-                0);
+                _scratchMixMinusFrames.empty() ?
+                    NULL : &_scratchMixMinusFrames[0],
+                static_cast<WebRtc_UWord32>(_scratchMixMinusFrames.size()));
         }
 
         if((_mixerStatusCallback != NULL) &&
@@ -408,6 +446,7 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
     ClearAudioFrameList(mixList);
     ClearAudioFrameList(rampOutList);
     ClearAudioFrameList(additionalFramesList);
+    ClearAudioFrameList(mixMinusList);
     {
         CriticalSectionScoped cs(_crit.get());
         _processCalls--;
@@ -674,6 +713,24 @@ WebRtc_Word32 AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     }
 }
 
+WebRtc_Word32 AudioConferenceMixerImpl::SetMixMinusStatus(const bool enable)
+{
+    CriticalSectionScoped cs(_crit.get());
+    _mixMinus = enable;
+    if(!enable)
+    {
+        ClearMixMinusLimiters();
+    }
+    return 0;
+}
+
+WebRtc_Word32 AudioConferenceMixerImpl::MixMinusStatus(bool& enabled)
+{
+    CriticalSectionScoped cs(_crit.get());
+    enabled = _mixMinus;
+    return 0;
+}
+
 // Check all AudioFrames that are to be mixed. The highest sampling frequency
 // found is the lowest that can be used without losing information.
 WebRtc_Word32 AudioConferenceMixerImpl::GetLowestMixingFrequency()
@@ -1186,7 +1243,191 @@ WebRtc_Word32 AudioConferenceMixerImpl::MixAnonomouslyFromList(
     return 0;
 }
 
-bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio)
+void AudioConferenceMixerImpl::MixMinusFromLists(
+    AudioFrame& mixedAudio,
+    const ListWrapper** audioFrameLists,
+    int numLists,
+    ListWrapper& mixMinusList)
+{
+    WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
+                 "MixMinusFromLists(mixedAudio, audioFrameLists, %d)",
+                 numLists);
+    const int length =
+        mixedAudio.samples_per_channel_ * mixedAudio.num_channels_;
+    memset(_scratchMixAccumulator, 0,
+           sizeof(_scratchMixAccumulator[0]) * length);
+
+    // The mixed AudioFrames have been scaled and upmixed by MixFrames(), so
+    // they hold exactly what was added to the mix. Sum them once, and derive
+    // the mix of every other participant by subtracting its own audio.
+    ListWrapper mixedFrames;
+    for(int i = 0; i < numLists; i++)
+    {
+        ListItem* item = audioFrameLists[i]->First();
+        while(item)
+        {
+            AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
+            item = audioFrameLists[i]->Next(item);
+            // Frames that don't match the mix have not been added to it.
+            if(audioFrame->samples_per_channel_ !=
+                   mixedAudio.samples_per_channel_ ||
+               audioFrame->num_channels_ != mixedAudio.num_channels_)
+            {
+                continue;
+            }
+            for(int j = 0; j < length; j++)
+            {
+                _scratchMixAccumulator[j] += audioFrame->data_[j];
+            }
+            mixedFrames.PushBack(static_cast<void*>(audioFrame));
+        }
+    }
+
+    if(_numMixedParticipants != 1)
+    {
+        // Saturate the sum once instead of after every addition.
+        for(int j = 0; j < length; j++)
+        {
+            mixedAudio.data_[j] = SaturateToInt16(_scratchMixAccumulator[j]);
+        }
+    }
+
+    while(!mixedFrames.Empty())
+    {
+        ListItem* item = mixedFrames.First();
+        const AudioFrame* audioFrame =
+            static_cast<const AudioFrame*>(item->GetItem());
+        mixedFrames.Erase(item);
+
+        AudioFrame* mixMinusFrame = NULL;
+        if(_audioFramePool->PopMemory(mixMinusFrame) == -1)
+        {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            continue;
+        }
+        mixMinusFrame->CopyFrom(mixedAudio);
+        mixMinusFrame->id_ = audioFrame->id_;
+        for(int j = 0; j < length; j++)
+        {
+            mixMinusFrame->data_[j] = SaturateToInt16(
+                _scratchMixAccumulator[j] - audioFrame->data_[j]);
+        }
+        mixMinusList.PushBack(static_cast<void*>(mixMinusFrame));
+    }
+}
+
+bool AudioConferenceMixerImpl::LimitMixMinusAudio(
+    const ListWrapper& mixMinusList)
+{
+    if(_numMixedParticipants == 1)
+    {
+        return true;
+    }
+
+    // Keep the limiters of participants that are no longer mixed for reuse.
+    MapItem* limiterItem = _mixMinusLimiters.First();
+    while(limiterItem)
+    {
+        MapItem* nextLimiterItem = _mixMinusLimiters.Next(limiterItem);
+        bool isMixed = false;
+        ListItem* item = mixMinusList.First();
+        while(item && !isMixed)
+        {
+            isMixed = static_cast<AudioFrame*>(item->GetItem())->id_ ==
+                limiterItem->GetId();
+            item = mixMinusList.Next(item);
+        }
+        if(!isMixed)
+        {
+            _unusedLimiters.PushBack(limiterItem->GetItem());
+            _mixMinusLimiters.Erase(limiterItem);
+        }
+        limiterItem = nextLimiterItem;
+    }
+
+    bool success = true;
+    ListItem* item = mixMinusList.First();
+    while(item)
+    {
+        AudioFrame* mixMinusFrame = static_cast<AudioFrame*>(item->GetItem());
+        item = mixMinusList.Next(item);
+
+        AudioProcessing* limiter = NULL;
+        limiterItem = _mixMinusLimiters.Find(mixMinusFrame->id_);
+        if(limiterItem != NULL)
+        {
+            limiter = static_cast<AudioProcessing*>(limiterItem->GetItem());
+        }
+        else if(!_unusedLimiters.Empty())
+        {
+            ListItem* unusedItem = _unusedLimiters.First();
+            limiter = static_cast<AudioProcessing*>(unusedItem->GetItem());
+            _unusedLimiters.Erase(unusedItem);
+            // Forget the gain of the previous participant.
+            limiter->Initialize();
+            _mixMinusLimiters.Insert(mixMinusFrame->id_, limiter);
+        }
+        else
+        {
+            limiter = AudioProcessing::Create(_id);
+            if(limiter == NULL || !ConfigureLimiter(limiter))
+            {
+                WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                             "failed to create mix-minus limiter");
+                AudioProcessing::Destroy(limiter);
+                success = false;
+                continue;
+            }
+            _mixMinusLimiters.Insert(mixMinusFrame->id_, limiter);
+        }
+
+        if(limiter->sample_rate_hz() != mixMinusFrame->sample_rate_hz_ &&
+           limiter->set_sample_rate_hz(mixMinusFrame->sample_rate_hz_) !=
+               limiter->kNoError)
+        {
+            success = false;
+            continue;
+        }
+        if(limiter->num_input_channels() != mixMinusFrame->num_channels_ &&
+           limiter->set_num_channels(mixMinusFrame->num_channels_,
+                                     mixMinusFrame->num_channels_) !=
+               limiter->kNoError)
+        {
+            success = false;
+            continue;
+        }
+        if(!LimitMixedAudio(*mixMinusFrame, limiter))
+        {
+            success = false;
+        }
+    }
+    return success;
+}
+
+void AudioConferenceMixerImpl::ClearMixMinusLimiters()
+{
+    MapItem* limiterItem = _mixMinusLimiters.First();
+    while(limiterItem)
+    {
+        AudioProcessing::Destroy(
+            static_cast<AudioProcessing*>(limiterItem->GetItem()));
+        _mixMinusLimiters.Erase(limiterItem);
+        limiterItem = _mixMinusLimiters.First();
+    }
+    ListItem* item = _unusedLimiters.First();
+    while(item)
+    {
+        AudioProcessing::Destroy(
+            static_cast<AudioProcessing*>(item->GetItem()));
+        _unusedLimiters.Erase(item);
+        item = _unusedLimiters.First();
+    }
+}
+
+bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio,
+                                               AudioProcessing* limiter)
 {
     if(_numMixedParticipants == 1)
     {
@@ -1194,7 +1435,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio)
     }
 
     // Smoothly limit the mixed frame.
-    const int error = _limiter->ProcessStream(&mixedAudio);
+    const int error = limiter->ProcessStream(&mixedAudio);
 
     // And now we can safely restore the level. This procedure results in
     // some loss of resolution, deemed acceptable.
@@ -1208,7 +1449,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio)
     // negative value is undefined).
     mixedAudio += mixedAudio;
 
-    if(error != _limiter->kNoError)
+    if(error != limiter->kNoError)
     {
         WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
                      "Error from AudioProcessing: %d", error);
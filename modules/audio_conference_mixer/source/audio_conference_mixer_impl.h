@@ -11,10 +11,13 @@
 #ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_CONFERENCE_MIXER_IMPL_H_
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_CONFERENCE_MIXER_IMPL_H_
 
+#include <vector>
+
 #include "audio_conference_mixer.h"
 #include "engine_configurations.h"
 #include "level_indicator.h"
 #include "list_wrapper.h"
+#include "map_wrapper.h"
 #include "memory_pool.h"
 #include "module_common_types.h"
 #include "scoped_ptr.h"
@@ -80,6 +83,8 @@ public:
         MixerParticipant& participant, const bool mixable);
     virtual WebRtc_Word32 AnonymousMixabilityStatus(
         MixerParticipant& participant, bool& mixable);
+    virtual WebRtc_Word32 SetMixMinusStatus(const bool enable);
+    virtual WebRtc_Word32 MixMinusStatus(bool& enabled);
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
 
@@ -148,7 +153,21 @@ private:
     WebRtc_Word32 MixAnonomouslyFromList(AudioFrame& mixedAudio,
                                          const ListWrapper& audioFrameList);
 
-    bool LimitMixedAudio(AudioFrame& mixedAudio);
+    // Creates the mix-minus frames of the participants whose AudioFrames in
+    // the lists were added to mixedAudio by MixFromList() and
+    // MixAnonomouslyFromList(), and adds them to mixMinusList.
+    void MixMinusFromLists(AudioFrame& mixedAudio,
+                           const ListWrapper** audioFrameLists,
+                           int numLists,
+                           ListWrapper& mixMinusList);
+    // Limits the frames in mixMinusList with one limiter per participant.
+    bool LimitMixMinusAudio(const ListWrapper& mixMinusList);
+    // Destroys the limiters of all mix-minus outputs.
+    void ClearMixMinusLimiters();
+
+    // Applies the mixer's limiter settings to limiter.
+    bool ConfigureLimiter(AudioProcessing* limiter);
+    bool LimitMixedAudio(AudioFrame& mixedAudio, AudioProcessing* limiter);
 
     // Scratch memory
     // Note that the scratch memory may only be touched in the scope of
@@ -159,6 +178,10 @@ private:
     WebRtc_UWord32         _scratchVadPositiveParticipantsAmount;
     ParticipantStatistics  _scratchVadPositiveParticipants[
         kMaximumAmountOfMixedParticipants];
+    // Sum of the audio in the mix, wide enough to never saturate.
+    WebRtc_Word32          _scratchMixAccumulator[
+        AudioFrame::kMaxDataSizeSamples];
+    std::vector<const AudioFrame*> _scratchMixMinusFrames;
 
     scoped_ptr<CriticalSectionWrapper> _crit;
     scoped_ptr<CriticalSectionWrapper> _cbCrit;
@@ -202,6 +225,13 @@ private:
 
     // Used for inhibiting saturation in mixing.
     scoped_ptr<AudioProcessing> _limiter;
+
+    bool _mixMinus;
+    // Limiters of the mix-minus outputs, by AudioFrame id. Limiters of
+    // participants that are no longer mixed are kept in _unusedLimiters for
+    // reuse.
+    MapWrapper _mixMinusLimiters;
+    ListWrapper _unusedLimiters;
 };
 } // namespace webrtc
 
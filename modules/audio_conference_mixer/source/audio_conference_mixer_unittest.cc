@@ -0,0 +1,276 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_conference_mixer/interface/audio_conference_mixer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+
+// Plays a square wave with an amplitude of |level|.
+class FakeParticipant : public MixerParticipant {
+ public:
+  FakeParticipant(int id, int16_t level, bool speaking)
+      : id_(id), level_(level), speaking_(speaking) {}
+
+  virtual WebRtc_Word32 GetAudioFrame(const WebRtc_Word32 id,
+                                      AudioFrame& audio_frame) {
+    audio_frame.UpdateFrame(id_, 0, NULL, kSamplesPer10Ms, kSampleRateHz,
+                            AudioFrame::kNormalSpeech,
+                            speaking_ ? AudioFrame::kVadActive :
+                                        AudioFrame::kVadPassive);
+    for (int i = 0; i < kSamplesPer10Ms; ++i) {
+      audio_frame.data_[i] = (i / 10) % 2 ? level_ : -level_;
+    }
+    return 0;
+  }
+
+  virtual WebRtc_Word32 NeededFrequency(const WebRtc_Word32 id) {
+    return kSampleRateHz;
+  }
+
+ private:
+  int id_;
+  int16_t level_;
+  bool speaking_;
+};
+
+class MixedAudioReceiver : public AudioMixerOutputReceiver {
+ public:
+  virtual void NewMixedAudio(const WebRtc_Word32 id,
+                             const AudioFrame& general_audio_frame,
+                             const AudioFrame** unique_audio_frames,
+                             const WebRtc_UWord32 size) {
+    general_.assign(general_audio_frame.data_,
+                    general_audio_frame.data_ +
+                        general_audio_frame.samples_per_channel_);
+    unique_.clear();
+    for (WebRtc_UWord32 i = 0; i < size; ++i) {
+      const AudioFrame* frame = unique_audio_frames[i];
+      unique_[frame->id_].assign(frame->data_,
+                                 frame->data_ + frame->samples_per_channel_);
+    }
+  }
+
+  // Returns the audio to send to |participant|.
+  const std::vector<int16_t>& AudioFor(int participant) const {
+    std::map<int, std::vector<int16_t> >::const_iterator it =
+        unique_.find(participant);
+    return it == unique_.end() ? general_ : it->second;
+  }
+
+  std::vector<int16_t> general_;
+  std::map<int, std::vector<int16_t> > unique_;
+};
+
+class AudioConferenceMixerTest : public ::testing::Test {
+ protected:
+  AudioConferenceMixerTest() : mixer_(AudioConferenceMixer::Create(0)) {}
+
+  virtual void SetUp() {
+    ASSERT_TRUE(mixer_.get() != NULL);
+    EXPECT_EQ(0, mixer_->RegisterMixedStreamCallback(receiver_));
+  }
+
+  virtual void TearDown() {
+    for (size_t i = 0; i < participants_.size(); ++i) {
+      EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participants_[i], false));
+      delete participants_[i];
+    }
+    EXPECT_EQ(0, mixer_->UnRegisterMixedStreamCallback());
+  }
+
+  void AddParticipant(int16_t level, bool speaking) {
+    FakeParticipant* participant =
+        new FakeParticipant(static_cast<int>(participants_.size()), level,
+                            speaking);
+    participants_.push_back(participant);
+    EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participant, true));
+  }
+
+  // Lets the mixer ramp in the participants.
+  void Process(int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+      EXPECT_EQ(0, mixer_->Process());
+    }
+  }
+
+  scoped_ptr<AudioConferenceMixer> mixer_;
+  MixedAudioReceiver receiver_;
+  std::vector<FakeParticipant*> participants_;
+};
+
+TEST_F(AudioConferenceMixerTest, MixMinusIsDisabledByDefault) {
+  bool enabled = true;
+  EXPECT_EQ(0, mixer_->MixMinusStatus(enabled));
+  EXPECT_FALSE(enabled);
+  AddParticipant(1000, true);
+  AddParticipant(2000, true);
+  Process(2);
+  EXPECT_EQ(static_cast<size_t>(kSamplesPer10Ms), receiver_.general_.size());
+  EXPECT_TRUE(receiver_.unique_.empty());
+}
+
+TEST_F(AudioConferenceMixerTest, SingleParticipantHearsSilence) {
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(true));
+  AddParticipant(1000, true);
+  Process(2);
+  ASSERT_EQ(1u, receiver_.unique_.size());
+  const std::vector<int16_t>& own = receiver_.AudioFor(0);
+  ASSERT_EQ(static_cast<size_t>(kSamplesPer10Ms), own.size());
+  for (int i = 0; i < kSamplesPer10Ms; ++i) {
+    EXPECT_EQ(0, own[i]);
+    EXPECT_EQ(i / 10 % 2 ? 1000 : -1000, receiver_.general_[i]);
+  }
+}
+
+TEST_F(AudioConferenceMixerTest, MixMinusExcludesOwnAudio) {
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(true));
+  bool enabled = false;
+  EXPECT_EQ(0, mixer_->MixMinusStatus(enabled));
+  EXPECT_TRUE(enabled);
+  // Two speakers and three listeners, one of which fills the third slot of
+  // the mix.
+  AddParticipant(1000, true);
+  AddParticipant(4000, true);
+  for (int i = 0; i < 3; ++i) {
+    AddParticipant(0, false);
+  }
+  Process(10);
+
+  ASSERT_EQ(static_cast<size_t>(AudioConferenceMixer::
+                                    kMaximumAmountOfMixedParticipants),
+            receiver_.unique_.size());
+  // Each frame of a participant is mixed at half its level and the mix is
+  // restored after limiting. The limiter leaves these levels nearly alone.
+  const int kTolerance = 100;
+  const std::vector<int16_t>& first = receiver_.AudioFor(0);
+  const std::vector<int16_t>& second = receiver_.AudioFor(1);
+  for (int i = 0; i < kSamplesPer10Ms; ++i) {
+    const int sign = i / 10 % 2 ? 1 : -1;
+    EXPECT_NEAR(sign * 5000, receiver_.general_[i], kTolerance);
+    EXPECT_NEAR(sign * 4000, first[i], kTolerance);
+    EXPECT_NEAR(sign * 1000, second[i], kTolerance);
+  }
+  // The listeners that are not mixed share the general frame.
+  int shared = 0;
+  for (size_t i = 2; i < participants_.size(); ++i) {
+    if (&receiver_.AudioFor(static_cast<int>(i)) == &receiver_.general_) {
+      ++shared;
+    } else {
+      EXPECT_TRUE(receiver_.AudioFor(static_cast<int>(i)) ==
+                  receiver_.general_);
+    }
+  }
+  EXPECT_EQ(2, shared);
+
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(false));
+  Process(1);
+  EXPECT_TRUE(receiver_.unique_.empty());
+}
+
+// Compares the time to produce the audio of every participant with
+// mix-minus and by mixing everybody else for each participant, with one
+// limiter per participant as separate mixers would.
+TEST_F(AudioConferenceMixerTest, MixMinusVersusNaiveMixing) {
+  const int kConferenceSizes[] = { 10, 100, 1000 };
+  const int kSpeakers = 3;
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(true));
+  for (size_t size = 0; size < sizeof(kConferenceSizes) /
+           sizeof(kConferenceSizes[0]); ++size) {
+    const int participants = kConferenceSizes[size];
+    while (static_cast<int>(participants_.size()) < participants) {
+      const bool speaking = participants_.size() < kSpeakers;
+      AddParticipant(speaking ? 2000 : 0, speaking);
+    }
+    const int iterations = participants < 1000 ? 100 : 10;
+
+    TickTime start = TickTime::Now();
+    for (int i = 0; i < iterations; ++i) {
+      ASSERT_EQ(0, mixer_->Process());
+      for (int j = 0; j < participants; ++j) {
+        ASSERT_FALSE(receiver_.AudioFor(j).empty());
+      }
+    }
+    const double mix_minus_us =
+        static_cast<double>((TickTime::Now() - start).Microseconds()) /
+        iterations;
+
+    std::vector<AudioProcessing*> limiters(participants);
+    for (int j = 0; j < participants; ++j) {
+      limiters[j] = AudioProcessing::Create(j);
+      ASSERT_EQ(0, limiters[j]->set_sample_rate_hz(kSampleRateHz));
+      ASSERT_EQ(0, limiters[j]->gain_control()->set_mode(
+          GainControl::kFixedDigital));
+      ASSERT_EQ(0, limiters[j]->gain_control()->Enable(true));
+    }
+    std::vector<AudioFrame*> frames(participants);
+    for (int j = 0; j < participants; ++j) {
+      frames[j] = new AudioFrame();
+    }
+    AudioFrame mixed;
+    WebRtc_Word32 accumulator[kSamplesPer10Ms];
+    start = TickTime::Now();
+    for (int i = 0; i < iterations; ++i) {
+      for (int j = 0; j < participants; ++j) {
+        participants_[j]->GetAudioFrame(0, *frames[j]);
+      }
+      for (int j = 0; j < participants; ++j) {
+        memset(accumulator, 0, sizeof(accumulator));
+        for (int k = 0; k < participants; ++k) {
+          if (k == j) {
+            continue;
+          }
+          for (int n = 0; n < kSamplesPer10Ms; ++n) {
+            accumulator[n] += frames[k]->data_[n] >> 1;
+          }
+        }
+        mixed.UpdateFrame(j, 0, NULL, kSamplesPer10Ms, kSampleRateHz,
+                          AudioFrame::kNormalSpeech, AudioFrame::kVadActive);
+        for (int n = 0; n < kSamplesPer10Ms; ++n) {
+          mixed.data_[n] = static_cast<int16_t>(
+              std::max(-32768, std::min(32767, accumulator[n])));
+        }
+        ASSERT_EQ(0, limiters[j]->ProcessStream(&mixed));
+      }
+    }
+    const double naive_us =
+        static_cast<double>((TickTime::Now() - start).Microseconds()) /
+        iterations;
+    for (int j = 0; j < participants; ++j) {
+      AudioProcessing::Destroy(limiters[j]);
+      delete frames[j];
+    }
+
+    printf("%4d participants: mix-minus %8.1f us, naive %10.1f us per 10 ms"
+           " (%.0fx)\n", participants, mix_minus_us, naive_us,
+           naive_us / (mix_minus_us > 0 ? mix_minus_us : 1));
+  }
+}
+
+}  // namespace
+
+}  // namespace webrtc
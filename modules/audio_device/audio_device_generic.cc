@@ -72,5 +72,28 @@ bool AudioDeviceGeneric::BuiltInAECIsEnabled() const
     return false;
 }
 
+int32_t AudioDeviceGeneric::SetAudioBufferConfig(
+    const AudioBufferConfig& config)
+{
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, -1,
+        "Buffer configuration not supported on this platform");
+    return -1;
+}
+
+int32_t AudioDeviceGeneric::GetAudioBufferConfig(
+    AudioBufferConfig* config) const
+{
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, -1,
+        "Buffer configuration not supported on this platform");
+    return -1;
+}
+
+int32_t AudioDeviceGeneric::GetLatencyStats(AudioLatencyStats* stats) const
+{
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, -1,
+        "Latency statistics not supported on this platform");
+    return -1;
+}
+
 }  // namespace webrtc
 
@@ -161,6 +161,11 @@ class AudioDeviceGeneric
     virtual int32_t EnableBuiltInAEC(bool enable);
     virtual bool BuiltInAECIsEnabled() const;
 
+    // ALSA only.
+    virtual int32_t SetAudioBufferConfig(const AudioBufferConfig& config);
+    virtual int32_t GetAudioBufferConfig(AudioBufferConfig* config) const;
+    virtual int32_t GetLatencyStats(AudioLatencyStats* stats) const;
+
 public:
     virtual bool PlayoutWarning() const = 0;
     virtual bool PlayoutError() const = 0;
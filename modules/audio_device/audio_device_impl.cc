@@ -47,6 +47,7 @@
 #endif
 #include "audio_device_dummy.h"
 #include "audio_device_utility_dummy.h"
+#include "audio_device_virtual.h"
 #include "critical_section_wrapper.h"
 #include "trace.h"
 
@@ -72,6 +73,12 @@ AudioDeviceModule* CreateAudioDeviceModule(
   return AudioDeviceModuleImpl::Create(id, audioLayer);
 }
 
+AudioDeviceModule* CreateVirtualAudioDeviceModule(
+    WebRtc_Word32 id, const VirtualAudioDeviceConfig& config,
+    VirtualAudioDevice** device) {
+  return AudioDeviceModuleImpl::CreateVirtual(id, config, device);
+}
+
 
 // ============================================================================
 //                                   Static methods
@@ -116,6 +123,44 @@ AudioDeviceModule* AudioDeviceModuleImpl::Create(const WebRtc_Word32 id,
     return audioDevice;
 }
 
+// ----------------------------------------------------------------------------
+//  AudioDeviceModule::CreateVirtual()
+// ----------------------------------------------------------------------------
+
+AudioDeviceModule* AudioDeviceModuleImpl::CreateVirtual(
+    const WebRtc_Word32 id,
+    const VirtualAudioDeviceConfig& config,
+    VirtualAudioDevice** device)
+{
+    RefCountImpl<AudioDeviceModuleImpl>* audioDevice =
+        new RefCountImpl<AudioDeviceModuleImpl>(id, kVirtualAudio);
+
+    if (audioDevice->CheckPlatform() == -1)
+    {
+        delete audioDevice;
+        return NULL;
+    }
+
+    // The virtual device replaces the platform-dependent implementation.
+    AudioDeviceVirtual* virtualDevice = new AudioDeviceVirtual(id, config);
+    audioDevice->_ptrAudioDevice = virtualDevice;
+    audioDevice->_ptrAudioDeviceUtility = new AudioDeviceUtilityDummy(id);
+
+    if (audioDevice->AttachAudioBuffer() == -1)
+    {
+        delete audioDevice;
+        return NULL;
+    }
+
+    WebRtcSpl_Init();
+
+    if (device != NULL)
+    {
+        *device = virtualDevice;
+    }
+    return audioDevice;
+}
+
 // ============================================================================
 //                            Construction & Destruction
 // ============================================================================
@@ -195,6 +240,17 @@ WebRtc_Word32 AudioDeviceModuleImpl::CreatePlatformSpecificObjects()
     AudioDeviceGeneric* ptrAudioDevice(NULL);
     AudioDeviceUtility* ptrAudioDeviceUtility(NULL);
 
+    // The *Virtual* implementation is available for all platforms and builds.
+    //
+    if (_platformAudioLayer == kVirtualAudio)
+    {
+        _ptrAudioDevice = new AudioDeviceVirtual(Id(),
+                                                 VirtualAudioDeviceConfig());
+        _ptrAudioDeviceUtility = new AudioDeviceUtilityDummy(Id());
+        WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id, "Virtual Audio APIs will be utilized");
+        return 0;
+    }
+
 #if defined(WEBRTC_DUMMY_AUDIO_BUILD)
     ptrAudioDevice = new AudioDeviceDummy(Id());
     WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id, "Dummy Audio APIs will be utilized");
@@ -2029,6 +2085,48 @@ bool AudioDeviceModuleImpl::BuiltInAECIsEnabled() const
     return _ptrAudioDevice->BuiltInAECIsEnabled();
 }
 
+int32_t AudioDeviceModuleImpl::SetAudioBufferConfig(
+    const AudioBufferConfig& config)
+{
+    CHECK_INITIALIZED();
+
+    if (config.period_frames < 0 || config.buffer_frames < 0 ||
+        (config.period_frames > 0 && config.buffer_frames > 0 &&
+         config.buffer_frames < 2 * config.period_frames))
+    {
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                     "invalid buffer configuration");
+        return -1;
+    }
+
+    return _ptrAudioDevice->SetAudioBufferConfig(config);
+}
+
+int32_t AudioDeviceModuleImpl::GetAudioBufferConfig(
+    AudioBufferConfig* config) const
+{
+    CHECK_INITIALIZED();
+
+    if (config == NULL)
+    {
+        return -1;
+    }
+
+    return _ptrAudioDevice->GetAudioBufferConfig(config);
+}
+
+int32_t AudioDeviceModuleImpl::GetLatencyStats(AudioLatencyStats* stats) const
+{
+    CHECK_INITIALIZED();
+
+    if (stats == NULL)
+    {
+        return -1;
+    }
+
+    return _ptrAudioDevice->GetLatencyStats(stats);
+}
+
 // ============================================================================
 //                                 Private Methods
 // ============================================================================
@@ -2071,6 +2169,10 @@ AudioDeviceModule::AudioLayer AudioDeviceModuleImpl::PlatformAudioLayer() const
         WEBRTC_TRACE(kTraceStateInfo, kTraceAudioDevice, _id,
                      "output: kDummyAudio");
         break;
+    case kVirtualAudio:
+        WEBRTC_TRACE(kTraceStateInfo, kTraceAudioDevice, _id,
+                     "output: kVirtualAudio");
+        break;
     default:
         WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
                      "output: INVALID");
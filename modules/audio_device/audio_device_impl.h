@@ -13,6 +13,7 @@
 
 #include "audio_device.h"
 #include "audio_device_buffer.h"
+#include "modules/audio_device/include/virtual_audio_device.h"
 
 namespace webrtc
 {
@@ -52,6 +53,10 @@ public:
     static AudioDeviceModule* Create(
         const WebRtc_Word32 id,
         const AudioLayer audioLayer = kPlatformDefaultAudio);
+    static AudioDeviceModule* CreateVirtual(
+        const WebRtc_Word32 id,
+        const VirtualAudioDeviceConfig& config,
+        VirtualAudioDevice** device);
 
     // Retrieve the currently utilized audio layer
     virtual WebRtc_Word32 ActiveAudioLayer(AudioLayer* audioLayer) const;
@@ -204,6 +209,10 @@ public:
     virtual int32_t EnableBuiltInAEC(bool enable);
     virtual bool BuiltInAECIsEnabled() const;
 
+    virtual int32_t SetAudioBufferConfig(const AudioBufferConfig& config);
+    virtual int32_t GetAudioBufferConfig(AudioBufferConfig* config) const;
+    virtual int32_t GetLatencyStats(AudioLatencyStats* stats) const;
+
 public:
     WebRtc_Word32 Id() {return _id;}
 
@@ -29,7 +29,8 @@ class AudioDeviceModule : public RefCountedModule {
     kWindowsCoreAudio = 2,
     kLinuxAlsaAudio = 3,
     kLinuxPulseAudio = 4,
-    kDummyAudio = 5
+    kDummyAudio = 5,
+    kVirtualAudio = 6
   };
 
   enum WindowsDeviceType {
@@ -195,6 +196,20 @@ class AudioDeviceModule : public RefCountedModule {
   virtual int32_t EnableBuiltInAEC(bool enable) { return -1; }
   virtual bool BuiltInAECIsEnabled() const { return false; }
 
+  // Sets the period and buffer sizes used by the next InitPlayout() and
+  // InitRecording(). Only supported by the ALSA device.
+  virtual int32_t SetAudioBufferConfig(const AudioBufferConfig& config) {
+    return -1;
+  }
+  // Returns the sizes actually used by the device once initialized.
+  virtual int32_t GetAudioBufferConfig(AudioBufferConfig* config) const {
+    return -1;
+  }
+  // Returns the input-to-output latency measured since StartRecording().
+  virtual int32_t GetLatencyStats(AudioLatencyStats* stats) const {
+    return -1;
+  }
+
  protected:
   virtual ~AudioDeviceModule() {};
 };
@@ -22,6 +22,46 @@ static const int kAdmMaxGuidSize = 128;
 static const int kAdmMinPlayoutBufferSizeMs = 10;
 static const int kAdmMaxPlayoutBufferSizeMs = 250;
 
+// ----------------------------------------------------------------------------
+//  AudioBufferConfig
+// ----------------------------------------------------------------------------
+
+// Period and buffer sizes of the device, in frames. If both are zero the
+// device chooses them, and if only the period is set the buffer holds four
+// periods. With |mmap_access| the samples are read and written directly
+// in the buffer of the device instead of being copied by the driver.
+struct AudioBufferConfig
+{
+    AudioBufferConfig()
+        : period_frames(0),
+          buffer_frames(0),
+          mmap_access(false) {}
+
+    int period_frames;
+    int buffer_frames;
+    bool mmap_access;
+};
+
+// ----------------------------------------------------------------------------
+//  AudioLatencyStats
+// ----------------------------------------------------------------------------
+
+// Input-to-output latency, measured as the sum of the recording and playout
+// delays reported by the device each time 10 ms are recorded.
+struct AudioLatencyStats
+{
+    AudioLatencyStats()
+        : min_ms(0),
+          average_ms(0),
+          max_ms(0),
+          measurements(0) {}
+
+    int min_ms;
+    int average_ms;
+    int max_ms;
+    int measurements;
+};
+
 // ----------------------------------------------------------------------------
 //  AudioDeviceObserver
 // ----------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_DEVICE_INCLUDE_VIRTUAL_AUDIO_DEVICE_H_
+#define MODULES_AUDIO_DEVICE_INCLUDE_VIRTUAL_AUDIO_DEVICE_H_
+
+#include <stddef.h>
+
+#include "modules/audio_device/include/audio_device.h"
+
+namespace webrtc {
+
+// Provides the recorded audio of a virtual audio device.
+class VirtualAudioSource {
+ public:
+  // Fills |samples| with 10 ms of interleaved audio.
+  virtual void ReadRecordedData(int16_t* samples, int samples_per_channel,
+                                int channels) = 0;
+
+ protected:
+  virtual ~VirtualAudioSource() {}
+};
+
+// Receives the played audio of a virtual audio device.
+class VirtualAudioSink {
+ public:
+  // Called with 10 ms of interleaved audio.
+  virtual void WritePlayoutData(const int16_t* samples,
+                                int samples_per_channel, int channels) = 0;
+
+ protected:
+  virtual ~VirtualAudioSink() {}
+};
+
+struct VirtualAudioDeviceConfig {
+  VirtualAudioDeviceConfig()
+      : sample_rate_hz(48000),
+        recording_channels(1),
+        playout_channels(1),
+        source(NULL),
+        input_file_name(NULL),
+        sink(NULL),
+        output_file_name(NULL),
+        faster_than_realtime(false) {}
+
+  // Up to 96000 Hz and 2 channels.
+  int sample_rate_hz;
+  int recording_channels;
+  int playout_channels;
+
+  // The recorded audio is read from |source| if set, otherwise from the raw
+  // 16-bit PCM file |input_file_name|, which is looped. The default is
+  // silence.
+  VirtualAudioSource* source;
+  const char* input_file_name;
+
+  // The played audio is written to |sink| if set, otherwise to the raw 16-bit
+  // PCM file |output_file_name|. The default is to drop it.
+  VirtualAudioSink* sink;
+  const char* output_file_name;
+
+  // Runs the 10 ms callbacks back to back instead of in real time, for tests
+  // and benchmarks.
+  bool faster_than_realtime;
+};
+
+struct VirtualAudioDeviceStats {
+  // The number of 10 ms periods processed.
+  int periods;
+  // Periods which were processed more than one period late, i.e. the device
+  // would have run out of data.
+  int overruns;
+  // How late the periods were processed compared to the ideal 10 ms clock.
+  int average_jitter_us;
+  int max_jitter_us;
+};
+
+// Gives access to the virtual device of a module created by
+// CreateVirtualAudioDeviceModule().
+class VirtualAudioDevice {
+ public:
+  // Returns the statistics since playout or recording was started.
+  virtual void GetStats(VirtualAudioDeviceStats* stats) const = 0;
+
+ protected:
+  virtual ~VirtualAudioDevice() {}
+};
+
+// Creates an audio device module without any audio hardware. Recorded audio
+// is requested and played audio is delivered every 10 ms on a thread of its
+// own, driven by the monotonic clock so that it doesn't drift. If |device| is
+// not NULL it is set to the virtual device, which is owned by the module.
+// CreateAudioDeviceModule() with kVirtualAudio creates a module with the
+// default configuration.
+AudioDeviceModule* CreateVirtualAudioDeviceModule(
+    WebRtc_Word32 id, const VirtualAudioDeviceConfig& config,
+    VirtualAudioDevice** device);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_DEVICE_INCLUDE_VIRTUAL_AUDIO_DEVICE_H_
@@ -58,6 +58,7 @@ static const unsigned int ALSA_CAPTURE_CH = 2;
 static const unsigned int ALSA_CAPTURE_LATENCY = 40*1000; // in us
 static const unsigned int ALSA_PLAYOUT_WAIT_TIMEOUT = 5; // in ms
 static const unsigned int ALSA_CAPTURE_WAIT_TIMEOUT = 5; // in ms
+static const unsigned int ALSA_PERIODS_PER_BUFFER = 4;
 
 #define FUNC_GET_NUM_OF_DEVICE 0
 #define FUNC_GET_DEVICE_NAME 1
@@ -95,6 +96,8 @@ AudioDeviceLinuxALSA::AudioDeviceLinuxALSA(const WebRtc_Word32 id) :
     _recordingFramesLeft(0),
     _playoutFramesLeft(0),
     _playBufType(AudioDeviceModule::kFixedBufferSize),
+    _recMmap(false),
+    _playMmap(false),
     _initialized(false),
     _recording(false),
     _playing(false),
@@ -103,6 +106,10 @@ AudioDeviceLinuxALSA::AudioDeviceLinuxALSA(const WebRtc_Word32 id) :
     _AGC(false),
     _recordingDelay(0),
     _playoutDelay(0),
+    _latencyMinMs(0),
+    _latencyMaxMs(0),
+    _latencySumMs(0),
+    _latencyMeasurements(0),
     _playWarning(0),
     _playError(0),
     _recWarning(0),
@@ -1163,18 +1170,10 @@ WebRtc_Word32 AudioDeviceLinuxALSA::InitPlayout()
     }
 
     _playoutFramesIn10MS = _playoutFreq/100;
-    if ((errVal = LATE(snd_pcm_set_params)( _handlePlayout,
-#if defined(WEBRTC_BIG_ENDIAN)
-        SND_PCM_FORMAT_S16_BE,
-#else
-        SND_PCM_FORMAT_S16_LE, //format
-#endif
-        SND_PCM_ACCESS_RW_INTERLEAVED, //access
-        _playChannels, //channels
-        _playoutFreq, //rate
-        1, //soft_resample
-        ALSA_PLAYOUT_LATENCY //40*1000 //latency required overall latency in us
-    )) < 0)
+    if ((errVal = SetPcmParams(_handlePlayout,
+                               _playChannels,
+                               _playoutFreq,
+                               ALSA_PLAYOUT_LATENCY)) < 0)
     {   /* 0.5sec */
         _playoutFramesIn10MS = 0;
         WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
@@ -1204,6 +1203,7 @@ WebRtc_Word32 AudioDeviceLinuxALSA::InitPlayout()
                      "buffer_size:%d period_size :%d",
                      _playoutBufferSizeInFrame, _playoutPeriodSizeInFrame);
     }
+    _playMmap = _bufferConfig.mmap_access;
 
     if (_ptrAudioBuffer)
     {
@@ -1319,18 +1319,10 @@ WebRtc_Word32 AudioDeviceLinuxALSA::InitRecording()
     }
 
     _recordingFramesIn10MS = _recordingFreq/100;
-    if ((errVal = LATE(snd_pcm_set_params)(_handleRecord,
-#if defined(WEBRTC_BIG_ENDIAN)
-        SND_PCM_FORMAT_S16_BE, //format
-#else
-        SND_PCM_FORMAT_S16_LE, //format
-#endif
-        SND_PCM_ACCESS_RW_INTERLEAVED, //access
-        _recChannels, //channels
-        _recordingFreq, //rate
-        1, //soft_resample
-        ALSA_CAPTURE_LATENCY //latency in us
-    )) < 0)
+    if ((errVal = SetPcmParams(_handleRecord,
+                               _recChannels,
+                               _recordingFreq,
+                               ALSA_CAPTURE_LATENCY)) < 0)
     {
          // Fall back to another mode then.
          if (_recChannels == 1)
@@ -1338,18 +1330,10 @@ WebRtc_Word32 AudioDeviceLinuxALSA::InitRecording()
          else
            _recChannels = 1;
 
-         if ((errVal = LATE(snd_pcm_set_params)(_handleRecord,
-#if defined(WEBRTC_BIG_ENDIAN)
-             SND_PCM_FORMAT_S16_BE, //format
-#else
-             SND_PCM_FORMAT_S16_LE, //format
-#endif
-             SND_PCM_ACCESS_RW_INTERLEAVED, //access
-             _recChannels, //channels
-             _recordingFreq, //rate
-             1, //soft_resample
-             ALSA_CAPTURE_LATENCY //latency in us
-         )) < 0)
+         if ((errVal = SetPcmParams(_handleRecord,
+                                    _recChannels,
+                                    _recordingFreq,
+                                    ALSA_CAPTURE_LATENCY)) < 0)
          {
              _recordingFramesIn10MS = 0;
              WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
@@ -1378,6 +1362,7 @@ WebRtc_Word32 AudioDeviceLinuxALSA::InitRecording()
                      "buffer_size:%d period_size:%d",
                      _recordingBuffersizeInFrame, _recordingPeriodSizeInFrame);
     }
+    _recMmap = _bufferConfig.mmap_access;
 
     if (_ptrAudioBuffer)
     {
@@ -1421,6 +1406,10 @@ WebRtc_Word32 AudioDeviceLinuxALSA::StartRecording()
 
     int errVal = 0;
     _recordingFramesLeft = _recordingFramesIn10MS;
+    _latencyMinMs = 0;
+    _latencyMaxMs = 0;
+    _latencySumMs = 0;
+    _latencyMeasurements = 0;
 
     // Make sure we only create the buffer once.
     if (!_recordingBuffer)
@@ -1766,6 +1755,57 @@ WebRtc_Word32 AudioDeviceLinuxALSA::CPULoad(WebRtc_UWord16& load) const
     return -1;
 }
 
+int32_t AudioDeviceLinuxALSA::SetAudioBufferConfig(
+    const AudioBufferConfig& config)
+{
+    CriticalSectionScoped lock(&_critSect);
+
+    WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                 "SetAudioBufferConfig(period=%d, buffer=%d, mmap=%d)",
+                 config.period_frames, config.buffer_frames,
+                 config.mmap_access);
+    // Used by the next InitPlayout() and InitRecording().
+    _bufferConfig = config;
+    return 0;
+}
+
+int32_t AudioDeviceLinuxALSA::GetAudioBufferConfig(
+    AudioBufferConfig* config) const
+{
+    CriticalSectionScoped lock(&_critSect);
+
+    *config = _bufferConfig;
+    if (_playIsInitialized)
+    {
+        config->period_frames = _playoutPeriodSizeInFrame;
+        config->buffer_frames = _playoutBufferSizeInFrame;
+        config->mmap_access = _playMmap;
+    }
+    else if (_recIsInitialized)
+    {
+        config->period_frames = _recordingPeriodSizeInFrame;
+        config->buffer_frames = _recordingBuffersizeInFrame;
+        config->mmap_access = _recMmap;
+    }
+    return 0;
+}
+
+int32_t AudioDeviceLinuxALSA::GetLatencyStats(AudioLatencyStats* stats) const
+{
+    CriticalSectionScoped lock(&_critSect);
+
+    *stats = AudioLatencyStats();
+    if (_latencyMeasurements > 0)
+    {
+        stats->min_ms = _latencyMinMs;
+        stats->average_ms =
+            static_cast<int>(_latencySumMs / _latencyMeasurements);
+        stats->max_ms = _latencyMaxMs;
+        stats->measurements = _latencyMeasurements;
+    }
+    return 0;
+}
+
 bool AudioDeviceLinuxALSA::PlayoutWarning() const
 {
     return (_playWarning > 0);
@@ -1833,6 +1873,15 @@ WebRtc_Word32 AudioDeviceLinuxALSA::GetDevicesInfo(
     int enumCount(0);
     bool keepSearching(true);
 
+    // The default device is defined by the ALSA configuration and exists
+    // also without sound cards, e.g. when it is mapped to the null plugin.
+    if ((function == FUNC_GET_DEVICE_NAME ||
+        function == FUNC_GET_DEVICE_NAME_FOR_AN_ENUM) && enumDeviceNo == 0)
+    {
+        strcpy(enumDeviceName, "default");
+        return 0;
+    }
+
     // From Chromium issue 95797
     // Loop through the sound cards to get Alsa device hints.
     // Don't use snd_device_name_hint(-1,..) since there is a access violation
@@ -1850,21 +1899,6 @@ WebRtc_Word32 AudioDeviceLinuxALSA::GetDevicesInfo(
         }
 
         enumCount++; // default is 0
-        if ((function == FUNC_GET_DEVICE_NAME ||
-            function == FUNC_GET_DEVICE_NAME_FOR_AN_ENUM) && enumDeviceNo == 0)
-        {
-            strcpy(enumDeviceName, "default");
-
-            err = LATE(snd_device_name_free_hint)(hints);
-            if (err != 0)
-            {
-                WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                             "GetDevicesInfo - device name free hint error: %s",
-                             LATE(snd_strerror)(err));
-            }
-
-            return 0;
-        }
 
         for (void **list = hints; *list != NULL; ++list)
         {
@@ -2081,6 +2115,110 @@ WebRtc_Word32 AudioDeviceLinuxALSA::ErrorRecovery(WebRtc_Word32 error,
     return res;
 }
 
+int AudioDeviceLinuxALSA::SetPcmParams(snd_pcm_t* deviceHandle,
+                                       WebRtc_UWord8 channels,
+                                       WebRtc_UWord32 freq,
+                                       unsigned int latencyUs)
+{
+#if defined(WEBRTC_BIG_ENDIAN)
+    const snd_pcm_format_t format = SND_PCM_FORMAT_S16_BE;
+#else
+    const snd_pcm_format_t format = SND_PCM_FORMAT_S16_LE;
+#endif
+    const snd_pcm_access_t access = _bufferConfig.mmap_access ?
+        SND_PCM_ACCESS_MMAP_INTERLEAVED : SND_PCM_ACCESS_RW_INTERLEAVED;
+
+    if (_bufferConfig.period_frames == 0 && _bufferConfig.buffer_frames == 0)
+    {
+        // Let ALSA pick the sizes for the requested overall latency.
+        return LATE(snd_pcm_set_params)(deviceHandle,
+                                        format,
+                                        access,
+                                        channels,
+                                        freq,
+                                        1, //soft_resample
+                                        latencyUs);
+    }
+
+    snd_pcm_uframes_t periodSize = _bufferConfig.period_frames;
+    snd_pcm_uframes_t bufferSize = _bufferConfig.buffer_frames;
+    if (bufferSize == 0)
+    {
+        bufferSize = ALSA_PERIODS_PER_BUFFER * periodSize;
+    }
+    unsigned int rate = freq;
+
+    snd_pcm_hw_params_t* params = NULL;
+    int errVal = LATE(snd_pcm_hw_params_malloc)(&params);
+    if (errVal < 0)
+    {
+        return errVal;
+    }
+    if ((errVal = LATE(snd_pcm_hw_params_any)(deviceHandle, params)) >= 0 &&
+        (errVal = LATE(snd_pcm_hw_params_set_access)(
+            deviceHandle, params, access)) >= 0 &&
+        (errVal = LATE(snd_pcm_hw_params_set_format)(
+            deviceHandle, params, format)) >= 0 &&
+        (errVal = LATE(snd_pcm_hw_params_set_channels)(
+            deviceHandle, params, channels)) >= 0 &&
+        (errVal = LATE(snd_pcm_hw_params_set_rate_near)(
+            deviceHandle, params, &rate, NULL)) >= 0 &&
+        (periodSize == 0 ||
+         (errVal = LATE(snd_pcm_hw_params_set_period_size_near)(
+            deviceHandle, params, &periodSize, NULL)) >= 0) &&
+        (errVal = LATE(snd_pcm_hw_params_set_buffer_size_near)(
+            deviceHandle, params, &bufferSize)) >= 0)
+    {
+        if (rate != freq)
+        {
+            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                         "    rate %u not supported, got %u", freq, rate);
+            errVal = -EINVAL;
+        }
+        else
+        {
+            errVal = LATE(snd_pcm_hw_params)(deviceHandle, params);
+        }
+    }
+    LATE(snd_pcm_hw_params_free)(params);
+    return errVal;
+}
+
+// Returns the number of contiguous frames, at most |frames|, that can be read
+// or written at |data| in the buffer of the device, or a negative error code.
+snd_pcm_sframes_t AudioDeviceLinuxALSA::MmapBegin(snd_pcm_t* deviceHandle,
+                                                  snd_pcm_uframes_t frames,
+                                                  snd_pcm_uframes_t* offset,
+                                                  WebRtc_Word8** data)
+{
+    const snd_pcm_channel_area_t* areas = NULL;
+    int errVal = LATE(snd_pcm_mmap_begin)(deviceHandle, &areas, offset,
+                                          &frames);
+    if (errVal < 0)
+    {
+        return errVal;
+    }
+    // All channels are interleaved in the first area.
+    *data = static_cast<WebRtc_Word8*>(areas[0].addr) +
+        (areas[0].first + *offset * areas[0].step) / 8;
+    return frames;
+}
+
+snd_pcm_sframes_t AudioDeviceLinuxALSA::MmapCommit(snd_pcm_t* deviceHandle,
+                                                   snd_pcm_uframes_t offset,
+                                                   snd_pcm_uframes_t frames)
+{
+    snd_pcm_sframes_t committed = LATE(snd_pcm_mmap_commit)(deviceHandle,
+                                                            offset,
+                                                            frames);
+    if (committed >= 0 && static_cast<snd_pcm_uframes_t>(committed) != frames)
+    {
+        // The stream was stopped by an xrun since snd_pcm_mmap_begin().
+        return -EPIPE;
+    }
+    return committed;
+}
+
 // ============================================================================
 //                                  Thread Methods
 // ============================================================================
@@ -2131,12 +2269,50 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
         return true;
     }
 
+    snd_pcm_uframes_t offset = 0;
+    WebRtc_Word8* area = NULL;
+
     if (_playoutFramesLeft <= 0)
     {
         UnLock();
         _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
         Lock();
 
+        if (_playMmap &&
+            static_cast<WebRtc_UWord32>(avail_frames) >= _playoutFramesIn10MS)
+        {
+            // Copy 10 ms straight into the buffer of the device if they are
+            // contiguous there.
+            frames = MmapBegin(_handlePlayout, _playoutFramesIn10MS, &offset,
+                               &area);
+            if (frames >= 0 &&
+                frames < static_cast<snd_pcm_sframes_t>(_playoutFramesIn10MS))
+            {
+                // The 10 ms wrap around the end of the buffer. Release the
+                // area and write them through the playout buffer below.
+                MmapCommit(_handlePlayout, offset, 0);
+            }
+            else if (frames > 0)
+            {
+                _ptrAudioBuffer->GetPlayoutData(area);
+                frames = MmapCommit(_handlePlayout, offset, frames);
+                if (frames < 0)
+                {
+                    WEBRTC_TRACE(kTraceStream, kTraceAudioDevice, _id,
+                                 "playout snd_pcm_mmap_commit error: %s",
+                                 LATE(snd_strerror)(frames));
+                    ErrorRecovery(frames, _handlePlayout);
+                }
+                else if (LATE(snd_pcm_state)(_handlePlayout) ==
+                    SND_PCM_STATE_PREPARED)
+                {
+                    LATE(snd_pcm_start)(_handlePlayout);
+                }
+                UnLock();
+                return true;
+            }
+        }
+
         _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
         assert(_playoutFramesLeft == _playoutFramesIn10MS);
     }
@@ -2146,15 +2322,34 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
 
     int size = LATE(snd_pcm_frames_to_bytes)(_handlePlayout,
         _playoutFramesLeft);
-    frames = LATE(snd_pcm_writei)(
-        _handlePlayout,
-        &_playoutBuffer[_playoutBufferSizeIn10MS - size],
-        avail_frames);
+    if (_playMmap)
+    {
+        frames = MmapBegin(_handlePlayout, avail_frames, &offset, &area);
+        if (frames >= 0)
+        {
+            memcpy(area, &_playoutBuffer[_playoutBufferSizeIn10MS - size],
+                   LATE(snd_pcm_frames_to_bytes)(_handlePlayout, frames));
+            frames = MmapCommit(_handlePlayout, offset, frames);
+        }
+        if (frames > 0 &&
+            LATE(snd_pcm_state)(_handlePlayout) == SND_PCM_STATE_PREPARED)
+        {
+            LATE(snd_pcm_start)(_handlePlayout);
+        }
+    }
+    else
+    {
+        frames = LATE(snd_pcm_writei)(
+            _handlePlayout,
+            &_playoutBuffer[_playoutBufferSizeIn10MS - size],
+            avail_frames);
+    }
 
     if (frames < 0)
     {
         WEBRTC_TRACE(kTraceStream, kTraceAudioDevice, _id,
-                     "playout snd_pcm_writei error: %s",
+                     "playout %s error: %s",
+                     _playMmap ? "snd_pcm_mmap_commit" : "snd_pcm_writei",
                      LATE(snd_strerror)(frames));
         _playoutFramesLeft = 0;
         ErrorRecovery(frames, _handlePlayout);
@@ -2162,7 +2357,8 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
         return true;
     }
     else {
-        assert(frames==avail_frames);
+        // With mmap access only the contiguous part is written.
+        assert(_playMmap || frames == avail_frames);
         _playoutFramesLeft -= frames;
     }
 
@@ -2178,7 +2374,6 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
     int err;
     snd_pcm_sframes_t frames;
     snd_pcm_sframes_t avail_frames;
-    WebRtc_Word8 buffer[_recordingBufferSizeIn10MS];
 
     Lock();
 
@@ -2210,12 +2405,53 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
     if (static_cast<WebRtc_UWord32>(avail_frames) > _recordingFramesLeft)
         avail_frames = _recordingFramesLeft;
 
-    frames = LATE(snd_pcm_readi)(_handleRecord,
-        buffer, avail_frames); // frames to be written
+    int left_size = LATE(snd_pcm_frames_to_bytes)(_handleRecord,
+        _recordingFramesLeft);
+    WebRtc_Word8* buffer =
+        &_recordingBuffer[_recordingBufferSizeIn10MS - left_size];
+
+    if (_recMmap)
+    {
+        snd_pcm_uframes_t offset = 0;
+        WebRtc_Word8* area = NULL;
+        frames = MmapBegin(_handleRecord, avail_frames, &offset, &area);
+        if (frames >= 0)
+        {
+            if (frames == static_cast<snd_pcm_sframes_t>(
+                    _recordingFramesIn10MS))
+            {
+                // A full 10 ms is contiguous in the buffer of the device;
+                // hand it to the audio buffer without an extra copy.
+                _ptrAudioBuffer->SetRecordedBuffer(area,
+                                                   _recordingFramesIn10MS);
+                frames = MmapCommit(_handleRecord, offset, frames);
+                if (frames > 0)
+                {
+                    ProcessRecordedBuffer();
+                    UnLock();
+                    return true;
+                }
+            }
+            else
+            {
+                memcpy(buffer, area,
+                       LATE(snd_pcm_frames_to_bytes)(_handleRecord, frames));
+                frames = MmapCommit(_handleRecord, offset, frames);
+            }
+        }
+    }
+    else
+    {
+        frames = LATE(snd_pcm_readi)(_handleRecord,
+            buffer, avail_frames); // frames to be written
+        assert(frames < 0 || frames == avail_frames);
+    }
+
     if (frames < 0)
     {
         WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                     "capture snd_pcm_readi error: %s",
+                     "capture %s error: %s",
+                     _recMmap ? "snd_pcm_mmap_commit" : "snd_pcm_readi",
                      LATE(snd_strerror)(frames));
         ErrorRecovery(frames, _handleRecord);
         UnLock();
@@ -2223,98 +2459,111 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
     }
     else if (frames > 0)
     {
-        assert(frames == avail_frames);
-
-        int left_size = LATE(snd_pcm_frames_to_bytes)(_handleRecord,
-            _recordingFramesLeft);
-        int size = LATE(snd_pcm_frames_to_bytes)(_handleRecord, frames);
-
-        memcpy(&_recordingBuffer[_recordingBufferSizeIn10MS - left_size],
-               buffer, size);
         _recordingFramesLeft -= frames;
 
         if (!_recordingFramesLeft)
         { // buf is full
-            _recordingFramesLeft = _recordingFramesIn10MS;
-
             // store the recorded buffer (no action will be taken if the
             // #recorded samples is not a full buffer)
             _ptrAudioBuffer->SetRecordedBuffer(_recordingBuffer,
                                                _recordingFramesIn10MS);
+            ProcessRecordedBuffer();
+        }
+    }
 
-            WebRtc_UWord32 currentMicLevel = 0;
-            WebRtc_UWord32 newMicLevel = 0;
+    UnLock();
+    return true;
+}
 
-            if (AGC())
-            {
-                // store current mic level in the audio buffer if AGC is enabled
-                if (MicrophoneVolume(currentMicLevel) == 0)
-                {
-                    if (currentMicLevel == 0xffffffff)
-                        currentMicLevel = 100;
-                    // this call does not affect the actual microphone volume
-                    _ptrAudioBuffer->SetCurrentMicLevel(currentMicLevel);
-                }
-            }
+// Called with the lock held once 10 ms have been stored in the audio buffer.
+// Delivers them to the observer and updates the latency statistics.
+void AudioDeviceLinuxALSA::ProcessRecordedBuffer()
+{
+    int err;
+    _recordingFramesLeft = _recordingFramesIn10MS;
 
-            // calculate delay
-            _playoutDelay = 0;
-            _recordingDelay = 0;
-            if (_handlePlayout)
-            {
-                err = LATE(snd_pcm_delay)(_handlePlayout,
-                    &_playoutDelay); // returned delay in frames
-                if (err < 0)
-                {
-                    // TODO(xians): Shall we call ErrorRecovery() here?
-                    _playoutDelay = 0;
-                    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                                 "playout snd_pcm_delay: %s",
-                                 LATE(snd_strerror)(err));
-                }
-            }
+    WebRtc_UWord32 currentMicLevel = 0;
+    WebRtc_UWord32 newMicLevel = 0;
 
-            err = LATE(snd_pcm_delay)(_handleRecord,
-                &_recordingDelay); // returned delay in frames
-            if (err < 0)
-            {
-                // TODO(xians): Shall we call ErrorRecovery() here?
-                _recordingDelay = 0;
-                WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                             "capture snd_pcm_delay: %s",
-                             LATE(snd_strerror)(err));
-            }
+    if (AGC())
+    {
+        // store current mic level in the audio buffer if AGC is enabled
+        if (MicrophoneVolume(currentMicLevel) == 0)
+        {
+            if (currentMicLevel == 0xffffffff)
+                currentMicLevel = 100;
+            // this call does not affect the actual microphone volume
+            _ptrAudioBuffer->SetCurrentMicLevel(currentMicLevel);
+        }
+    }
+
+    // calculate delay
+    _playoutDelay = 0;
+    _recordingDelay = 0;
+    if (_handlePlayout)
+    {
+        err = LATE(snd_pcm_delay)(_handlePlayout,
+            &_playoutDelay); // returned delay in frames
+        if (err < 0)
+        {
+            // TODO(xians): Shall we call ErrorRecovery() here?
+            _playoutDelay = 0;
+            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                         "playout snd_pcm_delay: %s",
+                         LATE(snd_strerror)(err));
+        }
+    }
 
-           // TODO(xians): Shall we add 10ms buffer delay to the record delay?
-            _ptrAudioBuffer->SetVQEData(
-                _playoutDelay * 1000 / _playoutFreq,
-                _recordingDelay * 1000 / _recordingFreq, 0);
+    err = LATE(snd_pcm_delay)(_handleRecord,
+        &_recordingDelay); // returned delay in frames
+    if (err < 0)
+    {
+        // TODO(xians): Shall we call ErrorRecovery() here?
+        _recordingDelay = 0;
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                     "capture snd_pcm_delay: %s",
+                     LATE(snd_strerror)(err));
+    }
 
-            // Deliver recorded samples at specified sample rate, mic level etc.
-            // to the observer using callback.
-            UnLock();
-            _ptrAudioBuffer->DeliverRecordedData();
-            Lock();
+    const int playoutDelayMs = _playoutDelay * 1000 / _playoutFreq;
+    const int recordingDelayMs = _recordingDelay * 1000 / _recordingFreq;
 
-            if (AGC())
-            {
-                newMicLevel = _ptrAudioBuffer->NewMicLevel();
-                if (newMicLevel != 0)
-                {
-                    // The VQE will only deliver non-zero microphone levels when a
-                    // change is needed. Set this new mic level (received from the
-                    // observer as return value in the callback).
-                    if (SetMicrophoneVolume(newMicLevel) == -1)
-                        WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
-                                     "  the required modification of the "
-                                     "microphone volume failed");
-                }
-            }
-        }
+    if (_playing)
+    {
+        // The samples just recorded are played out after both delays and the
+        // 10 ms they spent in the recording buffer.
+        const int latencyMs = playoutDelayMs + recordingDelayMs + 10;
+        if (_latencyMeasurements == 0 || latencyMs < _latencyMinMs)
+            _latencyMinMs = latencyMs;
+        if (_latencyMeasurements == 0 || latencyMs > _latencyMaxMs)
+            _latencyMaxMs = latencyMs;
+        _latencySumMs += latencyMs;
+        ++_latencyMeasurements;
     }
 
+   // TODO(xians): Shall we add 10ms buffer delay to the record delay?
+    _ptrAudioBuffer->SetVQEData(playoutDelayMs, recordingDelayMs, 0);
+
+    // Deliver recorded samples at specified sample rate, mic level etc.
+    // to the observer using callback.
     UnLock();
-    return true;
+    _ptrAudioBuffer->DeliverRecordedData();
+    Lock();
+
+    if (AGC())
+    {
+        newMicLevel = _ptrAudioBuffer->NewMicLevel();
+        if (newMicLevel != 0)
+        {
+            // The VQE will only deliver non-zero microphone levels when a
+            // change is needed. Set this new mic level (received from the
+            // observer as return value in the callback).
+            if (SetMicrophoneVolume(newMicLevel) == -1)
+                WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
+                             "  the required modification of the "
+                             "microphone volume failed");
+        }
+    }
 }
 
 }  // namespace webrtc
@@ -147,6 +147,11 @@ public:
     // CPU load
     virtual WebRtc_Word32 CPULoad(WebRtc_UWord16& load) const;
 
+    // Period and buffer sizes, mmap access and latency
+    virtual int32_t SetAudioBufferConfig(const AudioBufferConfig& config);
+    virtual int32_t GetAudioBufferConfig(AudioBufferConfig* config) const;
+    virtual int32_t GetLatencyStats(AudioLatencyStats* stats) const;
+
 public:
     virtual bool PlayoutWarning() const;
     virtual bool PlayoutError() const;
@@ -167,6 +172,17 @@ private:
                                  char* enumDeviceName = NULL,
                                  const WebRtc_Word32 ednLen = 0) const;
     WebRtc_Word32 ErrorRecovery(WebRtc_Word32 error, snd_pcm_t* deviceHandle);
+    int SetPcmParams(snd_pcm_t* deviceHandle,
+                     WebRtc_UWord8 channels,
+                     WebRtc_UWord32 freq,
+                     unsigned int latencyUs);
+    snd_pcm_sframes_t MmapBegin(snd_pcm_t* deviceHandle,
+                                snd_pcm_uframes_t frames,
+                                snd_pcm_uframes_t* offset,
+                                WebRtc_Word8** data);
+    snd_pcm_sframes_t MmapCommit(snd_pcm_t* deviceHandle,
+                                 snd_pcm_uframes_t offset,
+                                 snd_pcm_uframes_t frames);
 
 private:
     void Lock() { _critSect.Enter(); };
@@ -180,6 +196,7 @@ private:
     static bool PlayThreadFunc(void*);
     bool RecThreadProcess();
     bool PlayThreadProcess();
+    void ProcessRecordedBuffer();
 
 private:
     AudioDeviceBuffer* _ptrAudioBuffer;
@@ -225,6 +242,10 @@ private:
 
     AudioDeviceModule::BufferType _playBufType;
 
+    AudioBufferConfig _bufferConfig;
+    bool _recMmap;
+    bool _playMmap;
+
 private:
     bool _initialized;
     bool _recording;
@@ -236,6 +257,12 @@ private:
     snd_pcm_sframes_t _recordingDelay;
     snd_pcm_sframes_t _playoutDelay;
 
+    // Input-to-output latency since StartRecording().
+    int _latencyMinMs;
+    int _latencyMaxMs;
+    int64_t _latencySumMs;
+    int _latencyMeasurements;
+
     WebRtc_UWord16 _playWarning;
     WebRtc_UWord16 _playError;
     WebRtc_UWord16 _recWarning;
@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "modules/audio_device/audio_device_impl.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/sleep.h"
+#include "testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+// Plays silence and counts the callbacks in both directions.
+class CountingTransport : public AudioTransport {
+ public:
+  CountingTransport()
+      : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+        recorded_callbacks_(0),
+        playout_callbacks_(0) {}
+
+  virtual int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                          const uint32_t nSamples,
+                                          const uint8_t nBytesPerSample,
+                                          const uint8_t nChannels,
+                                          const uint32_t samplesPerSec,
+                                          const uint32_t totalDelayMS,
+                                          const int32_t clockDrift,
+                                          const uint32_t currentMicLevel,
+                                          uint32_t& newMicLevel) {
+    CriticalSectionScoped lock(crit_sect_.get());
+    ++recorded_callbacks_;
+    return 0;
+  }
+
+  virtual int32_t NeedMorePlayData(const uint32_t nSamples,
+                                   const uint8_t nBytesPerSample,
+                                   const uint8_t nChannels,
+                                   const uint32_t samplesPerSec,
+                                   void* audioSamples,
+                                   uint32_t& nSamplesOut) {
+    CriticalSectionScoped lock(crit_sect_.get());
+    ++playout_callbacks_;
+    memset(audioSamples, 0, nSamples * nBytesPerSample);
+    nSamplesOut = nSamples;
+    return 0;
+  }
+
+  int recorded_callbacks() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return recorded_callbacks_;
+  }
+  int playout_callbacks() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return playout_callbacks_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  int recorded_callbacks_;
+  int playout_callbacks_;
+};
+
+}  // namespace
+
+// Runs the ALSA device against the null plugin, which discards and produces
+// samples as fast as they are asked for. The test is skipped if libasound or
+// the null plugin is not available.
+class AudioDeviceAlsaNullTest : public ::testing::Test {
+ protected:
+  AudioDeviceAlsaNullTest() : module_(NULL) {}
+
+  virtual void SetUp() {
+    // Let the default device, which is always device 0, be the null plugin.
+    config_file_ = test::OutputPath() + "alsa_null_pcm.conf";
+    FILE* file = fopen(config_file_.c_str(), "w");
+    ASSERT_TRUE(file != NULL);
+    fputs("pcm.!default {\n  type null\n}\n", file);
+    fclose(file);
+    setenv("ALSA_CONFIG_PATH", config_file_.c_str(), 1);
+
+    module_ = AudioDeviceModuleImpl::Create(
+        0, AudioDeviceModule::kLinuxAlsaAudio);
+    ASSERT_TRUE(module_ != NULL);
+    module_->AddRef();
+  }
+
+  virtual void TearDown() {
+    if (module_) {
+      module_->Terminate();
+      module_->Release();
+    }
+    unsetenv("ALSA_CONFIG_PATH");
+    remove(config_file_.c_str());
+  }
+
+  // Returns false if the null PCM can't be opened.
+  bool StartDevice(const AudioBufferConfig& config) {
+    if (module_->Init() != 0 ||
+        module_->SetPlayoutDevice(0) != 0 ||
+        module_->SetRecordingDevice(0) != 0) {
+      return false;
+    }
+    EXPECT_EQ(0, module_->SetAudioBufferConfig(config));
+    EXPECT_EQ(0, module_->RegisterAudioCallback(&transport_));
+    if (module_->InitPlayout() != 0 || module_->InitRecording() != 0) {
+      return false;
+    }
+    EXPECT_EQ(0, module_->StartPlayout());
+    EXPECT_EQ(0, module_->StartRecording());
+    return true;
+  }
+
+  void StopDevice() {
+    EXPECT_EQ(0, module_->StopRecording());
+    EXPECT_EQ(0, module_->StopPlayout());
+  }
+
+  std::string config_file_;
+  AudioDeviceModule* module_;
+  CountingTransport transport_;
+};
+
+TEST_F(AudioDeviceAlsaNullTest, MmapPlayoutAndRecording) {
+  AudioBufferConfig config;
+  config.period_frames = 480;
+  config.buffer_frames = 4 * 480;
+  config.mmap_access = true;
+  if (!StartDevice(config)) {
+    printf("ALSA null PCM not available, skipping test.\n");
+    return;
+  }
+  AudioBufferConfig used_config;
+  EXPECT_EQ(0, module_->GetAudioBufferConfig(&used_config));
+  EXPECT_TRUE(used_config.mmap_access);
+  EXPECT_EQ(480, used_config.period_frames);
+  EXPECT_EQ(4 * 480, used_config.buffer_frames);
+
+  SleepMs(200);
+  AudioLatencyStats stats;
+  EXPECT_EQ(0, module_->GetLatencyStats(&stats));
+  StopDevice();
+
+  EXPECT_GT(transport_.playout_callbacks(), 0);
+  EXPECT_GT(transport_.recorded_callbacks(), 0);
+  EXPECT_GT(stats.measurements, 0);
+  // The 10 ms in the recording buffer are always included.
+  EXPECT_GE(stats.min_ms, 10);
+  EXPECT_LE(stats.min_ms, stats.average_ms);
+  EXPECT_LE(stats.average_ms, stats.max_ms);
+}
+
+}  // namespace webrtc
@@ -1796,6 +1796,19 @@ TEST_F(AudioDeviceAPITest, PlayoutSampleRate) {
 #endif
 }
 
+TEST_F(AudioDeviceAPITest, AudioBufferConfig) {
+  AudioBufferConfig config;
+  // The buffer must hold at least two periods.
+  config.period_frames = 480;
+  config.buffer_frames = 480;
+  EXPECT_EQ(-1, audio_device_->SetAudioBufferConfig(config));
+  config.period_frames = -1;
+  config.buffer_frames = 0;
+  EXPECT_EQ(-1, audio_device_->SetAudioBufferConfig(config));
+  EXPECT_EQ(-1, audio_device_->GetAudioBufferConfig(NULL));
+  EXPECT_EQ(-1, audio_device_->GetLatencyStats(NULL));
+}
+
 TEST_F(AudioDeviceAPITest, ResetAudioDevice) {
   CheckInitialPlayoutStates();
   CheckInitialRecordingStates();
@@ -0,0 +1,695 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_device_virtual.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "system_wrappers/interface/clock.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/file_wrapper.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+#include "system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kPeriodMs = 10;
+const int kPeriodUs = kPeriodMs * 1000;
+// The delay reported to the audio processing, one period in each direction.
+const WebRtc_UWord16 kDelayMs = kPeriodMs;
+// In the faster than real time mode the thread sleeps for a millisecond after
+// this many periods, since it has a real-time priority and would otherwise
+// starve the rest of the process.
+const int kFastPeriodsPerSleep = 10;
+
+}  // namespace
+
+AudioDeviceVirtual::AudioDeviceVirtual(const WebRtc_Word32 id,
+                                       const VirtualAudioDeviceConfig& config)
+    : id_(id),
+      config_(config),
+      samples_per_channel_(config.sample_rate_hz / (1000 / kPeriodMs)),
+      clock_(Clock::GetRealTimeClock()),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      tick_event_(EventWrapper::Create()),
+      input_file_(FileWrapper::Create()),
+      output_file_(FileWrapper::Create()),
+      audio_buffer_(NULL),
+      initialized_(false),
+      playout_initialized_(false),
+      recording_initialized_(false),
+      playing_(false),
+      recording_(false),
+      speaker_initialized_(false),
+      microphone_initialized_(false),
+      agc_(false),
+      start_time_us_(0),
+      periods_(0),
+      overruns_(0),
+      total_jitter_us_(0),
+      max_jitter_us_(0) {
+  WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, id, "%s created",
+               __FUNCTION__);
+}
+
+AudioDeviceVirtual::~AudioDeviceVirtual() {
+  WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, id_, "%s destroyed",
+               __FUNCTION__);
+  Terminate();
+}
+
+void AudioDeviceVirtual::GetStats(VirtualAudioDeviceStats* stats) const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  stats->periods = periods_;
+  stats->overruns = overruns_;
+  stats->average_jitter_us =
+      periods_ > 0 ? static_cast<int>(total_jitter_us_ / periods_) : 0;
+  stats->max_jitter_us = max_jitter_us_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::ActiveAudioLayer(
+    AudioDeviceModule::AudioLayer& audioLayer) const {
+  audioLayer = AudioDeviceModule::kVirtualAudio;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::Init() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (config_.sample_rate_hz <= 0 ||
+      config_.sample_rate_hz % (1000 / kPeriodMs) != 0 ||
+      config_.recording_channels < 1 || config_.recording_channels > 2 ||
+      config_.playout_channels < 1 || config_.playout_channels > 2 ||
+      samples_per_channel_ * 2 * 2 > static_cast<int>(kMaxBufferSizeBytes)) {
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, id_,
+                 "unsupported virtual audio format: %d Hz, %d/%d channels",
+                 config_.sample_rate_hz, config_.recording_channels,
+                 config_.playout_channels);
+    return -1;
+  }
+  initialized_ = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::Terminate() {
+  StopRecording();
+  StopPlayout();
+  CriticalSectionScoped lock(crit_sect_.get());
+  speaker_initialized_ = false;
+  microphone_initialized_ = false;
+  initialized_ = false;
+  return 0;
+}
+
+bool AudioDeviceVirtual::Initialized() const {
+  return initialized_;
+}
+
+WebRtc_Word16 AudioDeviceVirtual::PlayoutDevices() {
+  return 1;
+}
+
+WebRtc_Word16 AudioDeviceVirtual::RecordingDevices() {
+  return 1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::PlayoutDeviceName(
+    WebRtc_UWord16 index,
+    char name[kAdmMaxDeviceNameSize],
+    char guid[kAdmMaxGuidSize]) {
+  if (index != 0) {
+    return -1;
+  }
+  strncpy(name, "Virtual playout device", kAdmMaxDeviceNameSize);
+  if (guid != NULL) {
+    memset(guid, 0, kAdmMaxGuidSize);
+  }
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::RecordingDeviceName(
+    WebRtc_UWord16 index,
+    char name[kAdmMaxDeviceNameSize],
+    char guid[kAdmMaxGuidSize]) {
+  if (index != 0) {
+    return -1;
+  }
+  strncpy(name, "Virtual recording device", kAdmMaxDeviceNameSize);
+  if (guid != NULL) {
+    memset(guid, 0, kAdmMaxGuidSize);
+  }
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetPlayoutDevice(WebRtc_UWord16 index) {
+  return index == 0 ? 0 : -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetPlayoutDevice(
+    AudioDeviceModule::WindowsDeviceType device) {
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetRecordingDevice(WebRtc_UWord16 index) {
+  return index == 0 ? 0 : -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetRecordingDevice(
+    AudioDeviceModule::WindowsDeviceType device) {
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::PlayoutIsAvailable(bool& available) {
+  available = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::InitPlayout() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (!initialized_ || playing_) {
+    return -1;
+  }
+  if (playout_initialized_) {
+    return 0;
+  }
+  if (config_.sink == NULL && config_.output_file_name != NULL &&
+      output_file_->OpenFile(config_.output_file_name, false) != 0) {
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, id_,
+                 "failed to open the virtual playout file %s",
+                 config_.output_file_name);
+    return -1;
+  }
+  playout_initialized_ = true;
+  return 0;
+}
+
+bool AudioDeviceVirtual::PlayoutIsInitialized() const {
+  return playout_initialized_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::RecordingIsAvailable(bool& available) {
+  available = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::InitRecording() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (!initialized_ || recording_) {
+    return -1;
+  }
+  if (recording_initialized_) {
+    return 0;
+  }
+  if (config_.source == NULL && config_.input_file_name != NULL &&
+      input_file_->OpenFile(config_.input_file_name, true, true) != 0) {
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, id_,
+                 "failed to open the virtual recording file %s",
+                 config_.input_file_name);
+    return -1;
+  }
+  recording_initialized_ = true;
+  return 0;
+}
+
+bool AudioDeviceVirtual::RecordingIsInitialized() const {
+  return recording_initialized_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StartPlayout() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (!playout_initialized_) {
+    return -1;
+  }
+  if (playing_) {
+    return 0;
+  }
+  if (!recording_ && !StartThread()) {
+    return -1;
+  }
+  playing_ = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StopPlayout() {
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+    if (!playout_initialized_) {
+      return 0;
+    }
+    playout_initialized_ = false;
+    if (!playing_) {
+      output_file_->CloseFile();
+      return 0;
+    }
+    playing_ = false;
+    if (recording_) {
+      output_file_->CloseFile();
+      return 0;
+    }
+  }
+  // The thread must not be stopped while holding the lock it needs.
+  StopThread();
+  CriticalSectionScoped lock(crit_sect_.get());
+  output_file_->CloseFile();
+  return 0;
+}
+
+bool AudioDeviceVirtual::Playing() const {
+  return playing_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StartRecording() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (!recording_initialized_) {
+    return -1;
+  }
+  if (recording_) {
+    return 0;
+  }
+  if (!playing_ && !StartThread()) {
+    return -1;
+  }
+  recording_ = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StopRecording() {
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+    if (!recording_initialized_) {
+      return 0;
+    }
+    recording_initialized_ = false;
+    if (!recording_) {
+      input_file_->CloseFile();
+      return 0;
+    }
+    recording_ = false;
+    if (playing_) {
+      input_file_->CloseFile();
+      return 0;
+    }
+  }
+  StopThread();
+  CriticalSectionScoped lock(crit_sect_.get());
+  input_file_->CloseFile();
+  return 0;
+}
+
+bool AudioDeviceVirtual::Recording() const {
+  return recording_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetAGC(bool enable) {
+  agc_ = enable;
+  return 0;
+}
+
+bool AudioDeviceVirtual::AGC() const {
+  return agc_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetWaveOutVolume(WebRtc_UWord16 volumeLeft,
+                                                   WebRtc_UWord16 volumeRight) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::WaveOutVolume(
+    WebRtc_UWord16& volumeLeft,
+    WebRtc_UWord16& volumeRight) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SpeakerIsAvailable(bool& available) {
+  available = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::InitSpeaker() {
+  if (playing_) {
+    return -1;
+  }
+  speaker_initialized_ = true;
+  return 0;
+}
+
+bool AudioDeviceVirtual::SpeakerIsInitialized() const {
+  return speaker_initialized_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneIsAvailable(bool& available) {
+  available = true;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::InitMicrophone() {
+  if (recording_) {
+    return -1;
+  }
+  microphone_initialized_ = true;
+  return 0;
+}
+
+bool AudioDeviceVirtual::MicrophoneIsInitialized() const {
+  return microphone_initialized_;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SpeakerVolumeIsAvailable(bool& available) {
+  available = false;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetSpeakerVolume(WebRtc_UWord32 volume) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SpeakerVolume(WebRtc_UWord32& volume) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MaxSpeakerVolume(
+    WebRtc_UWord32& maxVolume) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MinSpeakerVolume(
+    WebRtc_UWord32& minVolume) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SpeakerVolumeStepSize(
+    WebRtc_UWord16& stepSize) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneVolumeIsAvailable(
+    bool& available) {
+  available = false;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetMicrophoneVolume(WebRtc_UWord32 volume) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneVolume(
+    WebRtc_UWord32& volume) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MaxMicrophoneVolume(
+    WebRtc_UWord32& maxVolume) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MinMicrophoneVolume(
+    WebRtc_UWord32& minVolume) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneVolumeStepSize(
+    WebRtc_UWord16& stepSize) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SpeakerMuteIsAvailable(bool& available) {
+  available = false;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetSpeakerMute(bool enable) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SpeakerMute(bool& enabled) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneMuteIsAvailable(bool& available) {
+  available = false;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetMicrophoneMute(bool enable) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneMute(bool& enabled) const {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneBoostIsAvailable(
+    bool& available) {
+  available = false;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetMicrophoneBoost(bool enable) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::MicrophoneBoost(bool& enabled) const {
+  return -1;
+}
+
+// The channels are fixed by the configuration, so stereo can only be enabled
+// for a stereo device and disabled for a mono device.
+WebRtc_Word32 AudioDeviceVirtual::StereoPlayoutIsAvailable(bool& available) {
+  available = config_.playout_channels == 2;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetStereoPlayout(bool enable) {
+  return enable == (config_.playout_channels == 2) ? 0 : -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StereoPlayout(bool& enabled) const {
+  enabled = config_.playout_channels == 2;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StereoRecordingIsAvailable(
+    bool& available) {
+  available = config_.recording_channels == 2;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetStereoRecording(bool enable) {
+  return enable == (config_.recording_channels == 2) ? 0 : -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::StereoRecording(bool& enabled) const {
+  enabled = config_.recording_channels == 2;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::SetPlayoutBuffer(
+    const AudioDeviceModule::BufferType type,
+    WebRtc_UWord16 sizeMS) {
+  return -1;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::PlayoutBuffer(
+    AudioDeviceModule::BufferType& type,
+    WebRtc_UWord16& sizeMS) const {
+  type = AudioDeviceModule::kFixedBufferSize;
+  sizeMS = kDelayMs;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::PlayoutDelay(WebRtc_UWord16& delayMS) const {
+  delayMS = kDelayMs;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::RecordingDelay(
+    WebRtc_UWord16& delayMS) const {
+  delayMS = kDelayMs;
+  return 0;
+}
+
+WebRtc_Word32 AudioDeviceVirtual::CPULoad(WebRtc_UWord16& load) const {
+  load = 0;
+  return 0;
+}
+
+bool AudioDeviceVirtual::PlayoutWarning() const {
+  return false;
+}
+
+bool AudioDeviceVirtual::PlayoutError() const {
+  return false;
+}
+
+bool AudioDeviceVirtual::RecordingWarning() const {
+  return false;
+}
+
+bool AudioDeviceVirtual::RecordingError() const {
+  return false;
+}
+
+void AudioDeviceVirtual::ClearPlayoutWarning() {}
+
+void AudioDeviceVirtual::ClearPlayoutError() {}
+
+void AudioDeviceVirtual::ClearRecordingWarning() {}
+
+void AudioDeviceVirtual::ClearRecordingError() {}
+
+void AudioDeviceVirtual::AttachAudioBuffer(AudioDeviceBuffer* audioBuffer) {
+  CriticalSectionScoped lock(crit_sect_.get());
+  audio_buffer_ = audioBuffer;
+  audio_buffer_->SetRecordingSampleRate(config_.sample_rate_hz);
+  audio_buffer_->SetPlayoutSampleRate(config_.sample_rate_hz);
+  audio_buffer_->SetRecordingChannels(config_.recording_channels);
+  audio_buffer_->SetPlayoutChannels(config_.playout_channels);
+}
+
+bool AudioDeviceVirtual::StartThread() {
+  start_time_us_ = clock_->TimeInMicroseconds();
+  periods_ = 0;
+  overruns_ = 0;
+  total_jitter_us_ = 0;
+  max_jitter_us_ = 0;
+  // A thread running back to back must not starve the rest of the process.
+  thread_.reset(ThreadWrapper::CreateThread(
+      Run, this,
+      config_.faster_than_realtime ? kNormalPriority : kRealtimePriority,
+      "VirtualAudioThread"));
+  unsigned int thread_id = 0;
+  if (thread_.get() == NULL || !thread_->Start(thread_id)) {
+    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, id_,
+                 "failed to start the virtual audio thread");
+    thread_.reset();
+    return false;
+  }
+  if (!config_.faster_than_realtime) {
+    // The timer wakes the thread at multiples of the period from its start,
+    // so a late wake-up doesn't delay the following periods.
+    tick_event_->StartTimer(true, kPeriodMs);
+  }
+  return true;
+}
+
+void AudioDeviceVirtual::StopThread() {
+  if (thread_.get() == NULL) {
+    return;
+  }
+  thread_->SetNotAlive();
+  tick_event_->StopTimer();
+  tick_event_->Set();
+  thread_->Stop();
+  thread_.reset();
+}
+
+bool AudioDeviceVirtual::Run(void* obj) {
+  return static_cast<AudioDeviceVirtual*>(obj)->Process();
+}
+
+bool AudioDeviceVirtual::Process() {
+  tick_event_->Wait(config_.faster_than_realtime ? 1 : 2 * kPeriodMs);
+  bool playing = false;
+  bool recording = false;
+  int periods_due = kFastPeriodsPerSleep;
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+    playing = playing_;
+    recording = recording_;
+    if (!playing && !recording) {
+      return true;
+    }
+    if (config_.faster_than_realtime) {
+      periods_ += periods_due;
+    } else {
+      // Catch up with all periods that are due, which also absorbs timer
+      // wake-ups that were merged or lost.
+      const int64_t elapsed_us = clock_->TimeInMicroseconds() - start_time_us_;
+      periods_due = static_cast<int>(elapsed_us / kPeriodUs) - periods_;
+      for (int i = 0; i < periods_due; ++i) {
+        ++periods_;
+        const int64_t jitter_us = elapsed_us - periods_ * kPeriodUs;
+        total_jitter_us_ += jitter_us;
+        if (jitter_us > max_jitter_us_) {
+          max_jitter_us_ = static_cast<int>(jitter_us);
+        }
+        if (jitter_us >= kPeriodUs) {
+          ++overruns_;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < periods_due; ++i) {
+    ProcessPeriod(playing, recording);
+  }
+  return true;
+}
+
+void AudioDeviceVirtual::ProcessPeriod(bool playing, bool recording) {
+  // The callbacks are made without holding the lock, since they may call back
+  // into the module from other threads.
+  if (playing) {
+    audio_buffer_->RequestPlayoutData(samples_per_channel_);
+    audio_buffer_->GetPlayoutData(playout_buffer_);
+    WritePlayoutData();
+  }
+  // Recording may have been stopped while playing out.
+  if (recording && ReadRecordedData()) {
+    audio_buffer_->SetRecordedBuffer(recording_buffer_, samples_per_channel_);
+    audio_buffer_->SetVQEData(kDelayMs, kDelayMs, 0);
+    audio_buffer_->DeliverRecordedData();
+  }
+}
+
+bool AudioDeviceVirtual::ReadRecordedData() {
+  if (config_.source != NULL) {
+    config_.source->ReadRecordedData(recording_buffer_, samples_per_channel_,
+                                     config_.recording_channels);
+    return true;
+  }
+  const int length = samples_per_channel_ * config_.recording_channels *
+      static_cast<int>(sizeof(int16_t));
+  int bytes_read = 0;
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (!recording_) {
+    return false;
+  }
+  if (input_file_->Open()) {
+    bytes_read = std::max(input_file_->Read(recording_buffer_, length), 0);
+    if (bytes_read < length && input_file_->Rewind() == 0) {
+      // Loop the file.
+      bytes_read += std::max(input_file_->Read(
+          reinterpret_cast<int8_t*>(recording_buffer_) + bytes_read,
+          length - bytes_read), 0);
+    }
+  }
+  memset(reinterpret_cast<int8_t*>(recording_buffer_) + bytes_read, 0,
+         length - bytes_read);
+  return true;
+}
+
+void AudioDeviceVirtual::WritePlayoutData() {
+  if (config_.sink != NULL) {
+    config_.sink->WritePlayoutData(playout_buffer_, samples_per_channel_,
+                                   config_.playout_channels);
+    return;
+  }
+  CriticalSectionScoped lock(crit_sect_.get());
+  if (output_file_->Open()) {
+    output_file_->Write(playout_buffer_, samples_per_channel_ *
+                        config_.playout_channels * sizeof(int16_t));
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_VIRTUAL_H
+#define WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_VIRTUAL_H
+
+#include "audio_device_generic.h"
+#include "modules/audio_device/include/virtual_audio_device.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+class Clock;
+class CriticalSectionWrapper;
+class EventWrapper;
+class FileWrapper;
+class ThreadWrapper;
+
+// An audio device without hardware, see CreateVirtualAudioDeviceModule().
+// Playout and recording share one thread which processes both every 10 ms.
+class AudioDeviceVirtual : public AudioDeviceGeneric,
+                           public VirtualAudioDevice {
+ public:
+  AudioDeviceVirtual(const WebRtc_Word32 id,
+                     const VirtualAudioDeviceConfig& config);
+  virtual ~AudioDeviceVirtual();
+
+  // VirtualAudioDevice implementation.
+  virtual void GetStats(VirtualAudioDeviceStats* stats) const;
+
+  // Retrieve the currently utilized audio layer
+  virtual WebRtc_Word32 ActiveAudioLayer(
+      AudioDeviceModule::AudioLayer& audioLayer) const;
+
+  // Main initializaton and termination
+  virtual WebRtc_Word32 Init();
+  virtual WebRtc_Word32 Terminate();
+  virtual bool Initialized() const;
+
+  // Device enumeration
+  virtual WebRtc_Word16 PlayoutDevices();
+  virtual WebRtc_Word16 RecordingDevices();
+  virtual WebRtc_Word32 PlayoutDeviceName(WebRtc_UWord16 index,
+                                          char name[kAdmMaxDeviceNameSize],
+                                          char guid[kAdmMaxGuidSize]);
+  virtual WebRtc_Word32 RecordingDeviceName(WebRtc_UWord16 index,
+                                            char name[kAdmMaxDeviceNameSize],
+                                            char guid[kAdmMaxGuidSize]);
+
+  // Device selection
+  virtual WebRtc_Word32 SetPlayoutDevice(WebRtc_UWord16 index);
+  virtual WebRtc_Word32 SetPlayoutDevice(
+      AudioDeviceModule::WindowsDeviceType device);
+  virtual WebRtc_Word32 SetRecordingDevice(WebRtc_UWord16 index);
+  virtual WebRtc_Word32 SetRecordingDevice(
+      AudioDeviceModule::WindowsDeviceType device);
+
+  // Audio transport initialization
+  virtual WebRtc_Word32 PlayoutIsAvailable(bool& available);
+  virtual WebRtc_Word32 InitPlayout();
+  virtual bool PlayoutIsInitialized() const;
+  virtual WebRtc_Word32 RecordingIsAvailable(bool& available);
+  virtual WebRtc_Word32 InitRecording();
+  virtual bool RecordingIsInitialized() const;
+
+  // Audio transport control
+  virtual WebRtc_Word32 StartPlayout();
+  virtual WebRtc_Word32 StopPlayout();
+  virtual bool Playing() const;
+  virtual WebRtc_Word32 StartRecording();
+  virtual WebRtc_Word32 StopRecording();
+  virtual bool Recording() const;
+
+  // Microphone Automatic Gain Control (AGC)
+  virtual WebRtc_Word32 SetAGC(bool enable);
+  virtual bool AGC() const;
+
+  // Volume control based on the Windows Wave API (Windows only)
+  virtual WebRtc_Word32 SetWaveOutVolume(WebRtc_UWord16 volumeLeft,
+                                         WebRtc_UWord16 volumeRight);
+  virtual WebRtc_Word32 WaveOutVolume(WebRtc_UWord16& volumeLeft,
+                                      WebRtc_UWord16& volumeRight) const;
+
+  // Audio mixer initialization
+  virtual WebRtc_Word32 SpeakerIsAvailable(bool& available);
+  virtual WebRtc_Word32 InitSpeaker();
+  virtual bool SpeakerIsInitialized() const;
+  virtual WebRtc_Word32 MicrophoneIsAvailable(bool& available);
+  virtual WebRtc_Word32 InitMicrophone();
+  virtual bool MicrophoneIsInitialized() const;
+
+  // Speaker volume controls
+  virtual WebRtc_Word32 SpeakerVolumeIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetSpeakerVolume(WebRtc_UWord32 volume);
+  virtual WebRtc_Word32 SpeakerVolume(WebRtc_UWord32& volume) const;
+  virtual WebRtc_Word32 MaxSpeakerVolume(WebRtc_UWord32& maxVolume) const;
+  virtual WebRtc_Word32 MinSpeakerVolume(WebRtc_UWord32& minVolume) const;
+  virtual WebRtc_Word32 SpeakerVolumeStepSize(WebRtc_UWord16& stepSize) const;
+
+  // Microphone volume controls
+  virtual WebRtc_Word32 MicrophoneVolumeIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetMicrophoneVolume(WebRtc_UWord32 volume);
+  virtual WebRtc_Word32 MicrophoneVolume(WebRtc_UWord32& volume) const;
+  virtual WebRtc_Word32 MaxMicrophoneVolume(WebRtc_UWord32& maxVolume) const;
+  virtual WebRtc_Word32 MinMicrophoneVolume(WebRtc_UWord32& minVolume) const;
+  virtual WebRtc_Word32 MicrophoneVolumeStepSize(
+      WebRtc_UWord16& stepSize) const;
+
+  // Speaker mute control
+  virtual WebRtc_Word32 SpeakerMuteIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetSpeakerMute(bool enable);
+  virtual WebRtc_Word32 SpeakerMute(bool& enabled) const;
+
+  // Microphone mute control
+  virtual WebRtc_Word32 MicrophoneMuteIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetMicrophoneMute(bool enable);
+  virtual WebRtc_Word32 MicrophoneMute(bool& enabled) const;
+
+  // Microphone boost control
+  virtual WebRtc_Word32 MicrophoneBoostIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetMicrophoneBoost(bool enable);
+  virtual WebRtc_Word32 MicrophoneBoost(bool& enabled) const;
+
+  // Stereo support
+  virtual WebRtc_Word32 StereoPlayoutIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetStereoPlayout(bool enable);
+  virtual WebRtc_Word32 StereoPlayout(bool& enabled) const;
+  virtual WebRtc_Word32 StereoRecordingIsAvailable(bool& available);
+  virtual WebRtc_Word32 SetStereoRecording(bool enable);
+  virtual WebRtc_Word32 StereoRecording(bool& enabled) const;
+
+  // Delay information and control
+  virtual WebRtc_Word32 SetPlayoutBuffer(
+      const AudioDeviceModule::BufferType type, WebRtc_UWord16 sizeMS);
+  virtual WebRtc_Word32 PlayoutBuffer(AudioDeviceModule::BufferType& type,
+                                      WebRtc_UWord16& sizeMS) const;
+  virtual WebRtc_Word32 PlayoutDelay(WebRtc_UWord16& delayMS) const;
+  virtual WebRtc_Word32 RecordingDelay(WebRtc_UWord16& delayMS) const;
+
+  // CPU load
+  virtual WebRtc_Word32 CPULoad(WebRtc_UWord16& load) const;
+
+  virtual bool PlayoutWarning() const;
+  virtual bool PlayoutError() const;
+  virtual bool RecordingWarning() const;
+  virtual bool RecordingError() const;
+  virtual void ClearPlayoutWarning();
+  virtual void ClearPlayoutError();
+  virtual void ClearRecordingWarning();
+  virtual void ClearRecordingError();
+
+  virtual void AttachAudioBuffer(AudioDeviceBuffer* audioBuffer);
+
+ private:
+  static bool Run(void* obj);
+  bool Process();
+  void ProcessPeriod(bool playing, bool recording);
+  // Returns false if recording has stopped.
+  bool ReadRecordedData();
+  void WritePlayoutData();
+
+  // Starts the thread when playout or recording starts, and stops it when
+  // both have stopped.
+  bool StartThread();
+  void StopThread();
+
+  const WebRtc_Word32 id_;
+  const VirtualAudioDeviceConfig config_;
+  const int samples_per_channel_;
+  Clock* clock_;
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  scoped_ptr<EventWrapper> tick_event_;
+  scoped_ptr<ThreadWrapper> thread_;
+  scoped_ptr<FileWrapper> input_file_;
+  scoped_ptr<FileWrapper> output_file_;
+  AudioDeviceBuffer* audio_buffer_;
+
+  bool initialized_;
+  bool playout_initialized_;
+  bool recording_initialized_;
+  bool playing_;
+  bool recording_;
+  bool speaker_initialized_;
+  bool microphone_initialized_;
+  bool agc_;
+
+  // The 10 ms clock, reset when the thread starts.
+  int64_t start_time_us_;
+  int periods_;
+  int overruns_;
+  int64_t total_jitter_us_;
+  int max_jitter_us_;
+
+  int16_t recording_buffer_[kMaxBufferSizeBytes / 2];
+  int16_t playout_buffer_[kMaxBufferSizeBytes / 2];
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_VIRTUAL_H
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_device/include/virtual_audio_device.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+
+namespace {
+
+// Plays a constant value and records what it receives.
+class TestTransport : public AudioTransport {
+ public:
+  TestTransport()
+      : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+        recorded_callbacks_(0),
+        playout_callbacks_(0),
+        last_recorded_sample_(0),
+        samples_per_sec_(0) {}
+
+  virtual int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                          const uint32_t nSamples,
+                                          const uint8_t nBytesPerSample,
+                                          const uint8_t nChannels,
+                                          const uint32_t samplesPerSec,
+                                          const uint32_t totalDelayMS,
+                                          const int32_t clockDrift,
+                                          const uint32_t currentMicLevel,
+                                          uint32_t& newMicLevel) {
+    CriticalSectionScoped lock(crit_sect_.get());
+    ++recorded_callbacks_;
+    last_recorded_sample_ = static_cast<const int16_t*>(audioSamples)[0];
+    samples_per_sec_ = samplesPerSec;
+    return 0;
+  }
+
+  virtual int32_t NeedMorePlayData(const uint32_t nSamples,
+                                   const uint8_t nBytesPerSample,
+                                   const uint8_t nChannels,
+                                   const uint32_t samplesPerSec,
+                                   void* audioSamples,
+                                   uint32_t& nSamplesOut) {
+    CriticalSectionScoped lock(crit_sect_.get());
+    ++playout_callbacks_;
+    int16_t* samples = static_cast<int16_t*>(audioSamples);
+    for (uint32_t i = 0; i < nSamples * nChannels; ++i) {
+      samples[i] = 1000;
+    }
+    nSamplesOut = nSamples;
+    return 0;
+  }
+
+  int recorded_callbacks() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return recorded_callbacks_;
+  }
+  int playout_callbacks() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return playout_callbacks_;
+  }
+  int16_t last_recorded_sample() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return last_recorded_sample_;
+  }
+  uint32_t samples_per_sec() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return samples_per_sec_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  int recorded_callbacks_;
+  int playout_callbacks_;
+  int16_t last_recorded_sample_;
+  uint32_t samples_per_sec_;
+};
+
+class TestSourceAndSink : public VirtualAudioSource, public VirtualAudioSink {
+ public:
+  TestSourceAndSink() : last_played_sample_(0), samples_per_channel_(0) {}
+
+  virtual void ReadRecordedData(int16_t* samples, int samples_per_channel,
+                                int channels) {
+    for (int i = 0; i < samples_per_channel * channels; ++i) {
+      samples[i] = 500;
+    }
+  }
+
+  virtual void WritePlayoutData(const int16_t* samples,
+                                int samples_per_channel, int channels) {
+    last_played_sample_ = samples[samples_per_channel * channels - 1];
+    samples_per_channel_ = samples_per_channel;
+  }
+
+  // Only read after the device has stopped.
+  int16_t last_played_sample_;
+  int samples_per_channel_;
+};
+
+void StartDevice(AudioDeviceModule* module, AudioTransport* transport) {
+  ASSERT_EQ(0, module->RegisterAudioCallback(transport));
+  ASSERT_EQ(0, module->Init());
+  ASSERT_EQ(0, module->InitPlayout());
+  ASSERT_EQ(0, module->StartPlayout());
+  ASSERT_EQ(0, module->InitRecording());
+  ASSERT_EQ(0, module->StartRecording());
+}
+
+void StopDevice(AudioDeviceModule* module) {
+  EXPECT_EQ(0, module->StopRecording());
+  EXPECT_EQ(0, module->StopPlayout());
+  EXPECT_EQ(0, module->Terminate());
+  module->Release();
+}
+
+}  // namespace
+
+TEST(AudioDeviceVirtualTest, RunsCallbacksEvery10Ms) {
+  TestSourceAndSink source_and_sink;
+  VirtualAudioDeviceConfig config;
+  config.sample_rate_hz = 32000;
+  config.playout_channels = 2;
+  config.source = &source_and_sink;
+  config.sink = &source_and_sink;
+  VirtualAudioDevice* device = NULL;
+  AudioDeviceModule* module = CreateVirtualAudioDeviceModule(0, config,
+                                                             &device);
+  ASSERT_TRUE(module != NULL);
+  ASSERT_TRUE(device != NULL);
+  module->AddRef();
+  AudioDeviceModule::AudioLayer layer = AudioDeviceModule::kDummyAudio;
+  EXPECT_EQ(0, module->ActiveAudioLayer(&layer));
+  EXPECT_EQ(AudioDeviceModule::kVirtualAudio, layer);
+
+  TestTransport transport;
+  StartDevice(module, &transport);
+  SleepMs(300);
+  VirtualAudioDeviceStats stats;
+  device->GetStats(&stats);
+  StopDevice(module);
+
+  // The number of periods follows the clock even if the thread is late.
+  EXPECT_GE(stats.periods, 25);
+  EXPECT_LE(stats.periods, 31);
+  EXPECT_GE(transport.recorded_callbacks(), stats.periods);
+  EXPECT_GE(transport.playout_callbacks(), stats.periods);
+  EXPECT_EQ(500, transport.last_recorded_sample());
+  EXPECT_EQ(32000u, transport.samples_per_sec());
+  EXPECT_EQ(1000, source_and_sink.last_played_sample_);
+  EXPECT_EQ(320, source_and_sink.samples_per_channel_);
+  EXPECT_LE(stats.average_jitter_us, stats.max_jitter_us);
+  EXPECT_GE(stats.overruns, 0);
+  printf("Virtual audio device: %d periods, %d overruns, jitter %d us average, "
+         "%d us max\n", stats.periods, stats.overruns,
+         stats.average_jitter_us, stats.max_jitter_us);
+}
+
+TEST(AudioDeviceVirtualTest, RunsFasterThanRealTime) {
+  VirtualAudioDeviceConfig config;
+  config.faster_than_realtime = true;
+  VirtualAudioDevice* device = NULL;
+  AudioDeviceModule* module = CreateVirtualAudioDeviceModule(0, config,
+                                                             &device);
+  ASSERT_TRUE(module != NULL);
+  module->AddRef();
+  TestTransport transport;
+  StartDevice(module, &transport);
+  SleepMs(100);
+  VirtualAudioDeviceStats stats;
+  device->GetStats(&stats);
+  StopDevice(module);
+  EXPECT_GT(transport.playout_callbacks(), 100);
+  EXPECT_GT(transport.recorded_callbacks(), 100);
+  EXPECT_EQ(0, stats.overruns);
+  printf("Virtual audio device: %d periods in 100 ms\n", stats.periods);
+}
+
+TEST(AudioDeviceVirtualTest, ReadsAndWritesFiles) {
+  const char* kInputFileName = "audio_device_virtual_input.pcm";
+  const char* kOutputFileName = "audio_device_virtual_output.pcm";
+  // 15 ms of audio at 16 kHz, which is looped.
+  std::vector<int16_t> input(240, 700);
+  FILE* file = fopen(kInputFileName, "wb");
+  ASSERT_TRUE(file != NULL);
+  fwrite(&input[0], sizeof(int16_t), input.size(), file);
+  fclose(file);
+
+  VirtualAudioDeviceConfig config;
+  config.sample_rate_hz = 16000;
+  config.input_file_name = kInputFileName;
+  config.output_file_name = kOutputFileName;
+  config.faster_than_realtime = true;
+  AudioDeviceModule* module = CreateVirtualAudioDeviceModule(0, config, NULL);
+  ASSERT_TRUE(module != NULL);
+  module->AddRef();
+  TestTransport transport;
+  StartDevice(module, &transport);
+  SleepMs(50);
+  StopDevice(module);
+  EXPECT_GT(transport.recorded_callbacks(), 2);
+  EXPECT_EQ(700, transport.last_recorded_sample());
+
+  file = fopen(kOutputFileName, "rb");
+  ASSERT_TRUE(file != NULL);
+  int16_t samples[160];
+  ASSERT_EQ(160u, fread(samples, sizeof(int16_t), 160, file));
+  fclose(file);
+  EXPECT_EQ(1000, samples[0]);
+  EXPECT_EQ(1000, samples[159]);
+  remove(kInputFileName);
+  remove(kOutputFileName);
+}
+
+TEST(AudioDeviceVirtualTest, RejectsUnsupportedFormats) {
+  VirtualAudioDeviceConfig config;
+  config.recording_channels = 3;
+  AudioDeviceModule* module = CreateVirtualAudioDeviceModule(0, config, NULL);
+  ASSERT_TRUE(module != NULL);
+  module->AddRef();
+  EXPECT_EQ(-1, module->Init());
+  module->Release();
+
+  config.recording_channels = 1;
+  config.sample_rate_hz = 192000;
+  module = CreateVirtualAudioDeviceModule(0, config, NULL);
+  ASSERT_TRUE(module != NULL);
+  module->AddRef();
+  EXPECT_EQ(-1, module->Init());
+  module->Release();
+}
+
+TEST(AudioDeviceVirtualTest, CreatedByAudioLayer) {
+  AudioDeviceModule* module =
+      CreateAudioDeviceModule(0, AudioDeviceModule::kVirtualAudio);
+  ASSERT_TRUE(module != NULL);
+  module->AddRef();
+  EXPECT_EQ(0, module->Init());
+  bool available = false;
+  EXPECT_EQ(0, module->PlayoutIsAvailable(&available));
+  EXPECT_TRUE(available);
+  EXPECT_EQ(0, module->Terminate());
+  module->Release();
+}
+
+}  // namespace webrtc
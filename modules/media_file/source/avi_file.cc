@@ -23,7 +23,6 @@
 
 #include "critical_section_wrapper.h"
 #include "file_wrapper.h"
-#include "list_wrapper.h"
 #include "trace.h"
 
 // http://msdn2.microsoft.com/en-us/library/ms779636.aspx
@@ -50,11 +49,38 @@ static const WebRtc_UWord32 kAvifIsinterleaved  = 0x00000100;
 static const WebRtc_UWord32 kAvifTrustcktype    = 0x00000800;
 static const WebRtc_UWord32 kAvifWascapturefile = 0x00010000;
 
+// Data chunks are collected until this many bytes can be written at once.
+static const size_t kWriteBufferSize = 256 * 1024;
+
 template <class T>
 T MinValue(T a, T b)
 {
     return a < b ? a : b;
 }
+
+// AVI files are little endian whatever the byte order of the host.
+void StoreLE16(WebRtc_UWord8* dst, WebRtc_UWord16 value)
+{
+    dst[0] = static_cast<WebRtc_UWord8>(value);
+    dst[1] = static_cast<WebRtc_UWord8>(value >> 8);
+}
+
+void StoreLE32(WebRtc_UWord8* dst, WebRtc_UWord32 value)
+{
+    StoreLE16(dst, static_cast<WebRtc_UWord16>(value));
+    StoreLE16(dst + 2, static_cast<WebRtc_UWord16>(value >> 16));
+}
+
+WebRtc_UWord16 LoadLE16(const WebRtc_UWord8* src)
+{
+    return static_cast<WebRtc_UWord16>(src[0] | (src[1] << 8));
+}
+
+WebRtc_UWord32 LoadLE32(const WebRtc_UWord8* src)
+{
+    return LoadLE16(src) |
+        (static_cast<WebRtc_UWord32>(LoadLE16(src + 2)) << 16);
+}
 }  // namespace
 
 AviFile::AVIMAINHEADER::AVIMAINHEADER()
@@ -179,7 +205,9 @@ AviFile::AviFile()
       _videoStreamDataChunkPrefix(0),
       _audioStreamDataChunkPrefix(0),
       _created(false),
-      _indexList(new ListWrapper())
+      _indexList(),
+      _writeBuffer(),
+      _nextChunkOffset(0)
 {
   ResetComplexMembers();
 }
@@ -188,7 +216,6 @@ AviFile::~AviFile()
 {
     Close();
 
-    delete _indexList;
     delete[] _videoCodecConfigParams;
     delete _crit;
 }
@@ -369,7 +396,6 @@ WebRtc_Word32 AviFile::WriteAudio(const WebRtc_UWord8* data,
                                   WebRtc_Word32 length)
 {
     _crit->Enter();
-    size_t newBytesWritten = _bytesWritten;
 
     if (_aviMode != Write)
     {
@@ -387,40 +413,20 @@ WebRtc_Word32 AviFile::WriteAudio(const WebRtc_UWord8* data,
         return -1;
     }
 
-    // Start of chunk.
-    const WebRtc_UWord32 chunkOffset = ftell(_aviFile) - _moviListOffset;
-    _bytesWritten += PutLE32(_audioStreamDataChunkPrefix);
-    // Size is unknown at this point. Update later.
-    _bytesWritten += PutLE32(0);
-    const size_t chunkSizeMark = _bytesWritten;
-
-    _bytesWritten += PutBuffer(data, length);
-
-    const long chunkSize = PutLE32LengthFromCurrent(
-        static_cast<long>(chunkSizeMark));
-
-    // Make sure that the chunk is aligned on 2 bytes (= 1 sample).
-    if (chunkSize % 2)
+    const WebRtc_Word32 ret = WriteDataChunk(_audioStreamDataChunkPrefix, data,
+                                             length);
+    if (ret != -1)
     {
-        _bytesWritten += PutByte(0);
+        ++_audioFrames;
     }
-    // End of chunk
-
-    // Save chunk information for use when closing file.
-    AddChunkToIndexList(_audioStreamDataChunkPrefix, 0, // No flags.
-                        chunkOffset, chunkSize);
-
-    ++_audioFrames;
-    newBytesWritten = _bytesWritten - newBytesWritten;
     _crit->Leave();
-    return static_cast<WebRtc_Word32>(newBytesWritten);
+    return ret;
 }
 
 WebRtc_Word32 AviFile::WriteVideo(const WebRtc_UWord8* data,
                                   WebRtc_Word32 length)
 {
     _crit->Enter();
-    size_t newBytesWritten = _bytesWritten;
     if (_aviMode != Write)
     {
         _crit->Leave();
@@ -437,32 +443,76 @@ WebRtc_Word32 AviFile::WriteVideo(const WebRtc_UWord8* data,
         return -1;
     }
 
-    // Start of chunk.
-    const WebRtc_UWord32 chunkOffset = ftell(_aviFile) - _moviListOffset;
-    _bytesWritten += PutLE32(_videoStreamDataChunkPrefix);
-    // Size is unknown at this point. Update later.
-    _bytesWritten += PutLE32(0);
-    const size_t chunkSizeMark = _bytesWritten;
+    const WebRtc_Word32 ret = WriteDataChunk(_videoStreamDataChunkPrefix, data,
+                                             length);
+    if (ret != -1)
+    {
+        ++_videoFrames;
+    }
+    _crit->Leave();
+    return ret;
+}
+
+WebRtc_Word32 AviFile::WriteDataChunk(WebRtc_UWord32 chunkId,
+                                      const WebRtc_UWord8* data,
+                                      WebRtc_Word32 length)
+{
+    if (length < 0)
+    {
+        return -1;
+    }
+    // The size of the chunk is known up front, so unlike the headers the
+    // chunk doesn't have to be patched after writing it. Neither is the file
+    // position needed for the index.
+    const WebRtc_UWord32 chunkSize = static_cast<WebRtc_UWord32>(length);
+    // Make sure that the chunk is aligned on 2 bytes (= 1 sample).
+    const size_t padding = chunkSize % 2;
+    const size_t bytes = 2 * sizeof(WebRtc_UWord32) + chunkSize + padding;
 
-    _bytesWritten += PutBuffer(data, length);
+    const size_t start = _writeBuffer.size();
+    _writeBuffer.resize(start + bytes);
+    WebRtc_UWord8* chunk = &_writeBuffer[start];
+    StoreLE32(chunk, chunkId);
+    StoreLE32(chunk + sizeof(chunkId), chunkSize);
+    if (chunkSize > 0)
+    {
+        memcpy(chunk + 2 * sizeof(WebRtc_UWord32), data, chunkSize);
+    }
+    if (padding)
+    {
+        chunk[bytes - 1] = 0;
+    }
 
-    const long chunkSize = PutLE32LengthFromCurrent(
-        static_cast<long>(chunkSizeMark));
+    // Save chunk information for use when closing file.
+    AddChunkToIndexList(chunkId, 0, // No flags.
+                        _nextChunkOffset, chunkSize);
+    _nextChunkOffset += static_cast<WebRtc_UWord32>(bytes);
+    _bytesWritten += bytes;
 
-    // Make sure that the chunk is aligned on 2 bytes (= 1 sample).
-    if (chunkSize % 2)
+    if (_writeBuffer.size() >= kWriteBufferSize && !FlushWriteBuffer())
     {
-        //Pad one byte, to WORD align.
-        _bytesWritten += PutByte(0);
+        return -1;
     }
-     //End chunk!
-    AddChunkToIndexList(_videoStreamDataChunkPrefix, 0, // No flags.
-                        chunkOffset, static_cast<WebRtc_UWord32>(chunkSize));
+    return static_cast<WebRtc_Word32>(bytes);
+}
 
-    ++_videoFrames;
-    newBytesWritten = _bytesWritten - newBytesWritten;
-    _crit->Leave();
-    return static_cast<WebRtc_Word32>(newBytesWritten);
+bool AviFile::FlushWriteBuffer()
+{
+    if (_writeBuffer.empty())
+    {
+        return true;
+    }
+    const size_t written = PutBuffer(&_writeBuffer[0], _writeBuffer.size());
+    const bool success = written == _writeBuffer.size();
+    if (!success)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceFile, -1,
+                     "AviFile: failed to write %u bytes",
+                     static_cast<unsigned int>(_writeBuffer.size()));
+    }
+    // Keep the capacity for the following chunks.
+    _writeBuffer.clear();
+    return success;
 }
 
 WebRtc_Word32 AviFile::PrepareDataChunkHeaders()
@@ -1144,6 +1194,8 @@ WebRtc_Word32 AviFile::WriteMoviStart()
 
     const WebRtc_UWord32 moviTag = MakeFourCc('m', 'o', 'v', 'i');
     _bytesWritten += PutLE32(moviTag);
+    _nextChunkOffset = sizeof(moviTag);
+    _writeBuffer.reserve(kWriteBufferSize);
 
     return 0;
 }
@@ -1156,14 +1208,16 @@ size_t AviFile::PutByte(WebRtc_UWord8 byte)
 
 size_t AviFile::PutLE16(WebRtc_UWord16 word)
 {
-    return fwrite(&word, sizeof(WebRtc_UWord8), sizeof(WebRtc_UWord16),
-                  _aviFile);
+    WebRtc_UWord8 bytes[sizeof(word)];
+    StoreLE16(bytes, word);
+    return fwrite(bytes, sizeof(WebRtc_UWord8), sizeof(bytes), _aviFile);
 }
 
 size_t AviFile::PutLE32(WebRtc_UWord32 word)
 {
-    return fwrite(&word, sizeof(WebRtc_UWord8), sizeof(WebRtc_UWord32),
-                  _aviFile);
+    WebRtc_UWord8 bytes[sizeof(word)];
+    StoreLE32(bytes, word);
+    return fwrite(bytes, sizeof(WebRtc_UWord8), sizeof(bytes), _aviFile);
 }
 
 size_t AviFile::PutBuffer(const WebRtc_UWord8* str, size_t size)
@@ -1232,6 +1286,8 @@ void AviFile::CloseWrite()
 {
     if (_created)
     {
+        FlushWriteBuffer();
+
         // Update everything that isn't known until the file is closed. The
         // marks indicate where in the headers this update should be.
         PutLE32LengthFromCurrent(static_cast<long>(_moviSizeMark));
@@ -1303,6 +1359,7 @@ void AviFile::ResetMembers()
     _created = false;
 
     _moviListOffset = 0;
+    _nextChunkOffset = 0;
 
     _videoConfigLength = 0;
 }
@@ -1328,14 +1385,20 @@ size_t AviFile::GetByte(WebRtc_UWord8& word)
 
 size_t AviFile::GetLE16(WebRtc_UWord16& word)
 {
-    return fread(&word, sizeof(WebRtc_UWord8), sizeof(WebRtc_UWord16),
-                 _aviFile);
+    WebRtc_UWord8 bytes[sizeof(word)];
+    const size_t read = fread(bytes, sizeof(WebRtc_UWord8), sizeof(bytes),
+                              _aviFile);
+    word = LoadLE16(bytes);
+    return read;
 }
 
 size_t AviFile::GetLE32(WebRtc_UWord32& word)
 {
-    return fread(&word, sizeof(WebRtc_UWord8), sizeof(WebRtc_UWord32),
-                 _aviFile);
+    WebRtc_UWord8 bytes[sizeof(word)];
+    const size_t read = fread(bytes, sizeof(WebRtc_UWord8), sizeof(bytes),
+                              _aviFile);
+    word = LoadLE32(bytes);
+    return read;
 }
 
 size_t AviFile::GetBuffer(WebRtc_UWord8* str, size_t size)
@@ -1720,21 +1783,7 @@ WebRtc_UWord32 AviFile::StreamAndTwoCharCodeToTag(WebRtc_Word32 streamNum,
 
 void AviFile::ClearIndexList()
 {
-    while (!_indexList->Empty())
-    {
-        ListItem* listItem = _indexList->First();
-        if (listItem == 0)
-        {
-            break;
-        }
-
-        AVIINDEXENTRY* item = static_cast<AVIINDEXENTRY*>(listItem->GetItem());
-        if (item != NULL)
-        {
-            delete item;
-        }
-        _indexList->PopFront();
-    }
+    _indexList.clear();
 }
 
 void AviFile::AddChunkToIndexList(WebRtc_UWord32 inChunkId,
@@ -1742,8 +1791,7 @@ void AviFile::AddChunkToIndexList(WebRtc_UWord32 inChunkId,
                                   WebRtc_UWord32 inOffset,
                                   WebRtc_UWord32 inSize)
 {
-    _indexList->PushBack(new AVIINDEXENTRY(inChunkId, inFlags, inOffset,
-                                           inSize));
+    _indexList.push_back(AVIINDEXENTRY(inChunkId, inFlags, inOffset, inSize));
 }
 
 void AviFile::WriteIndex()
@@ -1755,19 +1803,21 @@ void AviFile::WriteIndex()
     _bytesWritten += PutLE32(0);
     const size_t idxChunkSize = _bytesWritten;
 
-    for (ListItem* listItem = _indexList->First();
-         listItem != NULL;
-         listItem = _indexList->Next(listItem))
+    // The entries are stored in a buffer that is written with a single call,
+    // like the data chunks.
+    const size_t kEntrySize = 4 * sizeof(WebRtc_UWord32);
+    std::vector<WebRtc_UWord8> index(_indexList.size() * kEntrySize);
+    for (size_t i = 0; i < _indexList.size(); ++i)
     {
-        const AVIINDEXENTRY* item =
-            static_cast<AVIINDEXENTRY*>(listItem->GetItem());
-        if (item != NULL)
-        {
-            _bytesWritten += PutLE32(item->ckid);
-            _bytesWritten += PutLE32(item->dwFlags);
-            _bytesWritten += PutLE32(item->dwChunkOffset);
-            _bytesWritten += PutLE32(item->dwChunkLength);
-        }
+        WebRtc_UWord8* entry = &index[i * kEntrySize];
+        StoreLE32(entry, _indexList[i].ckid);
+        StoreLE32(entry + 4, _indexList[i].dwFlags);
+        StoreLE32(entry + 8, _indexList[i].dwChunkOffset);
+        StoreLE32(entry + 12, _indexList[i].dwChunkLength);
+    }
+    if (!index.empty())
+    {
+        _bytesWritten += PutBuffer(&index[0], index.size());
     }
     PutLE32LengthFromCurrent(static_cast<long>(idxChunkSize));
 }
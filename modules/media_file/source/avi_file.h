@@ -15,11 +15,12 @@
 
 #include <stdio.h>
 
+#include <vector>
+
 #include "typedefs.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
-class ListWrapper;
 
 struct AVISTREAMHEADER
 {
@@ -194,6 +195,13 @@ private:
 
     void WriteIndex();
 
+    // Appends a data chunk to the movi list. The chunk is buffered and written
+    // to file together with the following chunks.
+    WebRtc_Word32 WriteDataChunk(WebRtc_UWord32 chunkId,
+                                 const WebRtc_UWord8* data,
+                                 WebRtc_Word32 length);
+    bool FlushWriteBuffer();
+
 private:
     struct AVIMAINHEADER
     {
@@ -270,7 +278,12 @@ private:
     WebRtc_UWord32 _audioStreamDataChunkPrefix;
     bool _created;
 
-    ListWrapper* _indexList; // Elements are of type AVIINDEXENTRY.
+    std::vector<AVIINDEXENTRY> _indexList;
+
+    // Data chunks that have not been written to file yet.
+    std::vector<WebRtc_UWord8> _writeBuffer;
+    // Offset of the next data chunk from the start of the movi list.
+    WebRtc_UWord32 _nextChunkOffset;
 };
 } // namespace webrtc
 
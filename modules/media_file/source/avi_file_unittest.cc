@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/media_file/source/avi_file.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kFrameRate = 30;
+const int kWidth = 352;
+const int kHeight = 288;
+const int kVideoFrames = 10 * kFrameRate;
+const int kAudioFrames = 1000;  // 10 ms each.
+const int kAudioFrameBytes = 320;
+
+// Returns a chunk of |length| bytes that depends on |seed|.
+std::vector<WebRtc_UWord8> MakeChunk(int seed, int length) {
+  std::vector<WebRtc_UWord8> chunk(length);
+  for (int i = 0; i < length; ++i) {
+    chunk[i] = static_cast<WebRtc_UWord8>(seed * 31 + i);
+  }
+  return chunk;
+}
+
+// Odd sizes, to get padded chunks.
+int VideoFrameLength(int frame) {
+  return 1000 + 37 * (frame % 100) + frame % 2;
+}
+
+class AviFileTest : public ::testing::Test {
+ protected:
+  AviFileTest()
+      : file_name_(test::OutputPath() + "avi_file_unittest.avi") {}
+
+  virtual void TearDown() {
+    remove(file_name_.c_str());
+  }
+
+  void CreateStreams(AviFile* avi_file) {
+    AVISTREAMHEADER video_header;
+    video_header.fccType = AviFile::MakeFourCc('v', 'i', 'd', 's');
+    video_header.fccHandler = AviFile::MakeFourCc('V', 'P', '8', '0');
+    video_header.dwScale = 1;
+    video_header.dwRate = kFrameRate;
+    video_header.rcFrame.right = kWidth;
+    video_header.rcFrame.bottom = kHeight;
+    BITMAPINFOHEADER bitmap_header;
+    bitmap_header.biSize = sizeof(BITMAPINFOHEADER);
+    bitmap_header.biWidth = kWidth;
+    bitmap_header.biHeight = kHeight;
+    bitmap_header.biPlanes = 1;
+    bitmap_header.biBitCount = 12;
+    bitmap_header.biCompression = video_header.fccHandler;
+    ASSERT_EQ(0, avi_file->CreateVideoStream(video_header, bitmap_header,
+                                             NULL, 0));
+
+    AVISTREAMHEADER audio_header;
+    audio_header.fccType = AviFile::MakeFourCc('a', 'u', 'd', 's');
+    audio_header.dwScale = 1;
+    audio_header.dwRate = 16000;
+    audio_header.dwSampleSize = 2;
+    WAVEFORMATEX wave_header;
+    wave_header.wFormatTag = 1;  // PCM.
+    wave_header.nChannels = 1;
+    wave_header.nSamplesPerSec = 16000;
+    wave_header.nAvgBytesPerSec = 32000;
+    wave_header.nBlockAlign = 2;
+    wave_header.wBitsPerSample = 16;
+    ASSERT_EQ(0, avi_file->CreateAudioStream(audio_header, wave_header));
+  }
+
+  const std::string file_name_;
+};
+
+TEST_F(AviFileTest, ReadsTheChunksThatWereWritten) {
+  AviFile writer;
+  CreateStreams(&writer);
+  ASSERT_EQ(0, writer.Create(file_name_.c_str()));
+  int audio_frame = 0;
+  for (int frame = 0; frame < kVideoFrames; ++frame) {
+    const std::vector<WebRtc_UWord8> video =
+        MakeChunk(frame, VideoFrameLength(frame));
+    const int length = static_cast<int>(video.size());
+    // A chunk consists of its id, its size and the data padded to 2 bytes.
+    EXPECT_EQ(8 + length + length % 2, writer.WriteVideo(&video[0], length));
+    for (; audio_frame * kFrameRate < (frame + 1) * 100; ++audio_frame) {
+      const std::vector<WebRtc_UWord8> audio =
+          MakeChunk(audio_frame, kAudioFrameBytes);
+      EXPECT_EQ(8 + kAudioFrameBytes,
+                writer.WriteAudio(&audio[0], kAudioFrameBytes));
+    }
+  }
+  ASSERT_EQ(kAudioFrames, audio_frame);
+  ASSERT_EQ(0, writer.Close());
+
+  AviFile video_reader;
+  ASSERT_EQ(0, video_reader.Open(AviFile::AVI_VIDEO, file_name_.c_str()));
+  AVISTREAMHEADER video_header;
+  BITMAPINFOHEADER bitmap_header;
+  char config[AviFile::CODEC_CONFIG_LENGTH];
+  WebRtc_Word32 config_length = sizeof(config);
+  ASSERT_EQ(0, video_reader.GetVideoStreamInfo(video_header, bitmap_header,
+                                               config, config_length));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kVideoFrames), video_header.dwLength);
+  std::vector<WebRtc_UWord8> buffer(64 * 1024);
+  for (int frame = 0; frame < kVideoFrames; ++frame) {
+    WebRtc_Word32 length = static_cast<WebRtc_Word32>(buffer.size());
+    ASSERT_EQ(0, video_reader.ReadVideo(&buffer[0], length));
+    ASSERT_EQ(VideoFrameLength(frame), length);
+    EXPECT_TRUE(MakeChunk(frame, length) ==
+                std::vector<WebRtc_UWord8>(buffer.begin(),
+                                           buffer.begin() + length));
+  }
+
+  AviFile audio_reader;
+  ASSERT_EQ(0, audio_reader.Open(AviFile::AVI_AUDIO, file_name_.c_str()));
+  for (int frame = 0; frame < kAudioFrames; ++frame) {
+    WebRtc_Word32 length = static_cast<WebRtc_Word32>(buffer.size());
+    ASSERT_EQ(0, audio_reader.ReadAudio(&buffer[0], length));
+    ASSERT_EQ(kAudioFrameBytes, length);
+    EXPECT_TRUE(MakeChunk(frame, length) ==
+                std::vector<WebRtc_UWord8>(buffer.begin(),
+                                           buffer.begin() + length));
+  }
+}
+
+// The chunk headers and the index are little endian whatever the host is.
+TEST_F(AviFileTest, WritesLittleEndianChunksAndIndex) {
+  AviFile writer;
+  CreateStreams(&writer);
+  ASSERT_EQ(0, writer.Create(file_name_.c_str()));
+  const std::vector<WebRtc_UWord8> video = MakeChunk(0, 0x0123);
+  ASSERT_EQ(8 + 0x0124, writer.WriteVideo(&video[0], 0x0123));
+  ASSERT_EQ(0, writer.Close());
+
+  std::string contents;
+  FILE* file = fopen(file_name_.c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  char buffer[1024];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, length);
+  }
+  fclose(file);
+
+  const char kChunkHeader[] = { '0', '0', 'd', 'c', 0x23, 0x01, 0, 0 };
+  const size_t chunk = contents.find(std::string(kChunkHeader,
+                                                 sizeof(kChunkHeader)));
+  ASSERT_NE(std::string::npos, chunk);
+  const size_t index = contents.rfind("idx1");
+  ASSERT_NE(std::string::npos, index);
+  // One entry: id, flags, offset and size of the chunk.
+  const char kIndex[] = { 'i', 'd', 'x', '1', 16, 0, 0, 0,
+                          '0', '0', 'd', 'c', 0, 0, 0, 0 };
+  EXPECT_EQ(std::string(kIndex, sizeof(kIndex)),
+            contents.substr(index, sizeof(kIndex)));
+  EXPECT_EQ(std::string("\x23\x01\0\0", 4),
+            contents.substr(index + sizeof(kIndex) + 4, 4));
+}
+
+}  // namespace
+
+}  // namespace webrtc
@@ -413,9 +413,11 @@ WebRtc_Word32 RTPReceiver::IncomingRTPPacket(
       TimeStamp() != rtp_header->header.timestamp;
   bool is_first_packet = is_first_packet_in_frame || HaveNotReceivedPackets();
 
+  // The clock is read once per packet.
+  const WebRtc_Word64 now_ms = clock_->TimeInMilliseconds();
   WebRtc_Word32 ret_val = rtp_media_receiver_->ParseRtpPacket(
       rtp_header, specific_payload, is_red, packet, packet_length,
-      clock_->TimeInMilliseconds(), is_first_packet);
+      now_ms, is_first_packet);
 
   if (ret_val < 0) {
     return ret_val;
@@ -433,13 +435,13 @@ WebRtc_Word32 RTPReceiver::IncomingRTPPacket(
 
   // Need to be updated after RetransmitOfOldPacket and
   // RetransmitOfOldPacketUpdateStatistics.
-  last_receive_time_ = clock_->TimeInMilliseconds();
+  last_receive_time_ = now_ms;
   last_received_payload_length_ = payload_data_length;
 
   if (!old_packet) {
     if (last_received_timestamp_ != rtp_header->header.timestamp) {
       last_received_timestamp_ = rtp_header->header.timestamp;
-      last_received_frame_time_ms_ = clock_->TimeInMilliseconds();
+      last_received_frame_time_ms_ = now_ms;
     }
     last_received_sequence_number_ = rtp_header->header.sequenceNumber;
     last_received_transmission_time_offset_ =
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_INTERFACE_DECODED_AUDIO_CACHE_H_
+#define WEBRTC_MODULES_UTILITY_INTERFACE_DECODED_AUDIO_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common_types.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/static_instance.h"
+#include "typedefs.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+
+// Mono audio of a whole file, decoded and resampled to one sample rate.
+// Immutable once it has been returned by DecodedAudioCache::Acquire().
+struct DecodedAudio {
+  std::vector<int16_t> samples;
+  int sample_rate_hz;
+  // The codec of the file.
+  CodecInst codec;
+};
+
+struct DecodedAudioCacheStats {
+  DecodedAudioCacheStats()
+      : hits(0), misses(0), rejected(0), num_entries(0), memory_bytes(0) {}
+
+  // Acquire() calls served without decoding.
+  int hits;
+  // Acquire() calls for files that weren't cached.
+  int misses;
+  // Acquire() calls that failed because the file couldn't be decoded or
+  // didn't fit in the memory bound.
+  int rejected;
+  int num_entries;
+  // Size of the decoded audio of all entries.
+  size_t memory_bytes;
+};
+
+// Decodes whole audio files, at the sample rate asked for, on the thread that
+// acquires them and shares the result between all players of the file, which
+// only keep their own position in it. Files that don't fit in the memory
+// bound are rejected, before decoding when their duration is known, and not
+// decoded again until more memory is available. Entries are reference
+// counted and freed when the last player releases them. Files must not change
+// while they are played.
+// Thread-safe.
+class DecodedAudioCache {
+ public:
+  static const size_t kDefaultMaxMemoryBytes = 64 * 1024 * 1024;
+
+  // Returns the cache shared by the process and adds a reference to it. The
+  // cache is deleted when every GetInstance() call has been matched by a call
+  // to ReturnInstance(), so all audio must be released before that.
+  static DecodedAudioCache* GetInstance();
+  static void ReturnInstance();
+
+  // The decoded audio of all entries is kept within |max_memory_bytes|.
+  explicit DecodedAudioCache(size_t max_memory_bytes = kDefaultMaxMemoryBytes);
+  ~DecodedAudioCache();
+
+  // Returns |file_name| decoded at |frequency_in_hz|, decoding the whole file
+  // if it isn't cached. |codec_inst| is only used for pre-encoded files.
+  // Returns NULL if the file can't be decoded or doesn't fit in the memory
+  // bound. The audio stays valid until it's passed to Release().
+  const DecodedAudio* Acquire(const char* file_name,
+                              FileFormats format,
+                              const CodecInst* codec_inst,
+                              int frequency_in_hz);
+
+  void Release(const DecodedAudio* audio);
+
+  // Returns the number of entries in use.
+  int NumEntries() const;
+
+  void GetStats(DecodedAudioCacheStats* stats) const;
+
+ private:
+  friend DecodedAudioCache* GetStaticInstance<DecodedAudioCache>(
+      CountOperation count_operation);
+  static DecodedAudioCache* CreateInstance() {
+    return new DecodedAudioCache();
+  }
+
+  struct Entry {
+    DecodedAudio audio;
+    std::string key;
+    int ref_count;
+  };
+  typedef std::map<std::string, Entry*> EntryMap;
+  typedef std::map<const DecodedAudio*, Entry*> AudioMap;
+  // The bytes that were available when a file was rejected.
+  typedef std::map<std::string, size_t> RejectionMap;
+
+  static size_t MemoryBytes(const DecodedAudio& audio);
+
+  // Returns the size of |file_name| decoded at |frequency_in_hz|, or 0 if the
+  // duration of the file isn't known.
+  static size_t EstimatedBytes(const char* file_name, FileFormats format,
+                               int frequency_in_hz);
+
+  // Decodes at most |max_bytes| of audio. Returns false if the file can't be
+  // decoded or is longer.
+  static bool Decode(const char* file_name, FileFormats format,
+                     const CodecInst* codec_inst, int frequency_in_hz,
+                     size_t max_bytes, DecodedAudio* audio);
+
+  const size_t max_memory_bytes_;
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  EntryMap entries_;
+  AudioMap entries_by_audio_;
+  RejectionMap rejected_;
+  DecodedAudioCacheStats stats_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_INTERFACE_DECODED_AUDIO_CACHE_H_
@@ -18,6 +18,7 @@
 #include "typedefs.h"
 
 namespace webrtc {
+class DecodedAudioCache;
 class FileCallback;
 
 class FilePlayer
@@ -32,6 +33,14 @@ public:
     static FilePlayer* CreateFilePlayer(const WebRtc_UWord32 instanceID,
                                         const FileFormats fileFormat);
 
+    // Same as CreateFilePlayer() except that files played by name are decoded
+    // once into |cache| and played from memory, so that players of the same
+    // file share the decoding. The decoding is done by StartPlayingFile().
+    // |cache| must outlive the player.
+    static FilePlayer* CreateCachedFilePlayer(const WebRtc_UWord32 instanceID,
+                                              const FileFormats fileFormat,
+                                              DecodedAudioCache* cache);
+
     static void DestroyFilePlayer(FilePlayer* player);
 
     // Read 10 ms of audio at |frequencyInHz| to |outBuffer|. |lengthInSamples|
@@ -0,0 +1,283 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "cached_file_player_impl.h"
+
+#include <string.h>
+
+#include "decoded_audio_cache.h"
+#include "trace.h"
+
+namespace webrtc {
+
+CachedFilePlayerImpl::CachedFilePlayerImpl(WebRtc_UWord32 instanceID,
+                                           FileFormats fileFormat,
+                                           DecodedAudioCache* cache)
+    : FilePlayerImpl(instanceID, fileFormat),
+      _cache(cache),
+      _callback(NULL),
+      _playing(false),
+      _audio(NULL),
+      _fileName(),
+      _codecInst(),
+      _hasCodecInst(false),
+      _loop(false),
+      _startPositionMs(0),
+      _stopPositionMs(0),
+      _notificationMs(0),
+      _position(0),
+      _startPosition(0),
+      _stopPosition(0)
+{
+}
+
+CachedFilePlayerImpl::~CachedFilePlayerImpl()
+{
+    ReleaseAudio();
+}
+
+int CachedFilePlayerImpl::Get10msAudioFromFile(
+    int16_t* outBuffer,
+    int& lengthInSamples,
+    int frequencyInHz)
+{
+    if (!_playing)
+    {
+        return FilePlayerImpl::Get10msAudioFromFile(outBuffer,
+                                                    lengthInSamples,
+                                                    frequencyInHz);
+    }
+
+    if (_position >= _stopPosition)
+    {
+        if (_loop && _startPosition < _stopPosition)
+        {
+            _position = _startPosition;
+        }
+        else
+        {
+            // Like the streaming player, return an empty frame at the end of
+            // the file and fail after that.
+            _playing = false;
+            ReleaseAudio();
+            FilePlayerImpl::StopPlayingFile();
+            if (_callback)
+            {
+                _callback->PlayFileEnded(_instanceID);
+            }
+            lengthInSamples = 0;
+            return 0;
+        }
+    }
+
+    // The cached audio is at the rate of the file. Like the streaming player,
+    // resample it 10 ms at a time to the requested rate.
+    const size_t samplesIn10Ms = _audio->sample_rate_hz / 100;
+    size_t length = _stopPosition - _position;
+    if (length > samplesIn10Ms)
+    {
+        length = samplesIn10Ms;
+    }
+    int16_t frame[MAX_AUDIO_BUFFER_IN_SAMPLES];
+    memcpy(frame, &_audio->samples[_position], length * sizeof(int16_t));
+    // The last frame of a file may be shorter than 10 ms.
+    memset(&frame[length], 0, (samplesIn10Ms - length) * sizeof(int16_t));
+    _position += length;
+
+    if (_resampler.ResetIfNeeded(_audio->sample_rate_hz, frequencyInHz,
+                                 kResamplerSynchronous) != 0)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceVoice, _instanceID,
+                     "CachedFilePlayerImpl: can't resample %d Hz to %d Hz",
+                     _audio->sample_rate_hz, frequencyInHz);
+        return -1;
+    }
+    int outLength = 0;
+    _resampler.Push(frame, static_cast<int>(samplesIn10Ms), outBuffer,
+                    MAX_AUDIO_BUFFER_IN_SAMPLES, outLength);
+    if (_scaling != 1.0)
+    {
+        for (int i = 0; i < outLength; i++)
+        {
+            outBuffer[i] = (WebRtc_Word16)(outBuffer[i] * _scaling);
+        }
+    }
+    lengthInSamples = outLength;
+    _decodedLengthInMS += 10;
+
+    if (_notificationMs)
+    {
+        WebRtc_UWord32 positionMs = 0;
+        GetPlayoutPosition(positionMs);
+        if (positionMs >= _notificationMs)
+        {
+            _notificationMs = 0;
+            if (_callback)
+            {
+                _callback->PlayNotification(_instanceID, positionMs);
+            }
+        }
+    }
+    return 0;
+}
+
+WebRtc_Word32 CachedFilePlayerImpl::RegisterModuleFileCallback(
+    FileCallback* callback)
+{
+    _callback = callback;
+    return FilePlayerImpl::RegisterModuleFileCallback(callback);
+}
+
+WebRtc_Word32 CachedFilePlayerImpl::StartPlayingFile(
+    const char* fileName,
+    bool loop,
+    WebRtc_UWord32 startPosition,
+    float volumeScaling,
+    WebRtc_UWord32 notification,
+    WebRtc_UWord32 stopPosition,
+    const CodecInst* codecInst)
+{
+    if (IsPlayingFile())
+    {
+        WEBRTC_TRACE(kTraceError, kTraceVoice, _instanceID,
+                     "CachedFilePlayerImpl::StartPlayingFile() already"
+                     " playing");
+        return -1;
+    }
+    // Open the file to check that it can be played and to get its codec.
+    if (FilePlayerImpl::StartPlayingFile(fileName, false, startPosition,
+                                         volumeScaling, 0, stopPosition,
+                                         codecInst) == -1)
+    {
+        return -1;
+    }
+    _fileModule.StopPlaying();
+    const int fileFrequencyInHz = _codec.plfreq;
+
+    _fileName = fileName;
+    _hasCodecInst = codecInst != NULL;
+    if (_hasCodecInst)
+    {
+        _codecInst = *codecInst;
+    }
+    _loop = loop;
+    _startPositionMs = startPosition;
+    _stopPositionMs = stopPosition;
+    _notificationMs = notification;
+    _playing = true;
+
+    // Decode the whole file here, on the thread starting the playout, and not
+    // in Get10msAudioFromFile() which runs on the audio thread.
+    if (!AcquireAudio(fileFrequencyInHz))
+    {
+        // The file isn't cached, for instance since it's too large. Stream it
+        // instead.
+        if (!StartStreaming())
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+WebRtc_Word32 CachedFilePlayerImpl::StopPlayingFile()
+{
+    if (!_playing)
+    {
+        return FilePlayerImpl::StopPlayingFile();
+    }
+    _playing = false;
+    ReleaseAudio();
+    FilePlayerImpl::StopPlayingFile();
+    return 0;
+}
+
+bool CachedFilePlayerImpl::IsPlayingFile() const
+{
+    return _playing || FilePlayerImpl::IsPlayingFile();
+}
+
+WebRtc_Word32 CachedFilePlayerImpl::GetPlayoutPosition(
+    WebRtc_UWord32& durationMs)
+{
+    if (!_playing)
+    {
+        return FilePlayerImpl::GetPlayoutPosition(durationMs);
+    }
+    if (_audio == NULL)
+    {
+        durationMs = _startPositionMs;
+        return 0;
+    }
+    durationMs = static_cast<WebRtc_UWord32>(
+        static_cast<uint64_t>(_position) * 1000 / _audio->sample_rate_hz);
+    return 0;
+}
+
+bool CachedFilePlayerImpl::AcquireAudio(int frequencyInHz)
+{
+    const DecodedAudio* audio = _cache->Acquire(
+        _fileName.c_str(), _fileFormat, _hasCodecInst ? &_codecInst : NULL,
+        frequencyInHz);
+    if (audio == NULL)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceVoice, _instanceID,
+                     "CachedFilePlayerImpl: failed to decode %s at %d Hz",
+                     _fileName.c_str(), frequencyInHz);
+        return false;
+    }
+
+    const size_t length = audio->samples.size();
+    _startPosition = static_cast<size_t>(
+        static_cast<uint64_t>(_startPositionMs) * frequencyInHz / 1000);
+    _stopPosition = length;
+    if (_stopPositionMs > 0)
+    {
+        _stopPosition = static_cast<size_t>(
+            static_cast<uint64_t>(_stopPositionMs) * frequencyInHz / 1000);
+    }
+    if (_stopPosition > length)
+    {
+        _stopPosition = length;
+    }
+    if (_startPosition > _stopPosition)
+    {
+        _startPosition = _stopPosition;
+    }
+
+    _position = _startPosition;
+    _audio = audio;
+    return true;
+}
+
+bool CachedFilePlayerImpl::StartStreaming()
+{
+    WebRtc_UWord32 positionMs = 0;
+    GetPlayoutPosition(positionMs);
+    _playing = false;
+    ReleaseAudio();
+    WEBRTC_TRACE(kTraceWarning, kTraceVoice, _instanceID,
+                 "CachedFilePlayerImpl: streaming %s from %u ms",
+                 _fileName.c_str(), positionMs);
+    return FilePlayerImpl::StartPlayingFile(
+        _fileName.c_str(), _loop, positionMs, _scaling, _notificationMs,
+        _stopPositionMs, _hasCodecInst ? &_codecInst : NULL) == 0;
+}
+
+void CachedFilePlayerImpl::ReleaseAudio()
+{
+    if (_audio)
+    {
+        _cache->Release(_audio);
+        _audio = NULL;
+    }
+}
+
+} // namespace webrtc
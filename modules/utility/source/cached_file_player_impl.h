@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_SOURCE_CACHED_FILE_PLAYER_IMPL_H_
+#define WEBRTC_MODULES_UTILITY_SOURCE_CACHED_FILE_PLAYER_IMPL_H_
+
+#include <string>
+
+#include "file_player_impl.h"
+
+namespace webrtc {
+class DecodedAudioCache;
+struct DecodedAudio;
+
+// Plays files from a DecodedAudioCache. The file is decoded at its own sample
+// rate when the playout starts and resampled 10 ms at a time, so the player
+// only keeps its position in the shared audio. Streams, and files that can't
+// be cached, are played by FilePlayerImpl.
+class CachedFilePlayerImpl : public FilePlayerImpl
+{
+public:
+    CachedFilePlayerImpl(WebRtc_UWord32 instanceID,
+                         FileFormats fileFormat,
+                         DecodedAudioCache* cache);
+    ~CachedFilePlayerImpl();
+
+    virtual int Get10msAudioFromFile(
+        int16_t* outBuffer,
+        int& lengthInSamples,
+        int frequencyInHz);
+    virtual WebRtc_Word32 RegisterModuleFileCallback(FileCallback* callback);
+    virtual WebRtc_Word32 StartPlayingFile(
+        const char* fileName,
+        bool loop,
+        WebRtc_UWord32 startPosition,
+        float volumeScaling,
+        WebRtc_UWord32 notification,
+        WebRtc_UWord32 stopPosition = 0,
+        const CodecInst* codecInst = NULL);
+    using FilePlayerImpl::StartPlayingFile;
+    virtual WebRtc_Word32 StopPlayingFile();
+    virtual bool IsPlayingFile() const;
+    virtual WebRtc_Word32 GetPlayoutPosition(WebRtc_UWord32& durationMs);
+
+private:
+    // Gets the file decoded at |frequencyInHz| from the cache, decoding it if
+    // it isn't cached, and moves to the start position.
+    bool AcquireAudio(int frequencyInHz);
+    // Plays the file with FilePlayerImpl from the current position. Looping
+    // restarts at that position.
+    bool StartStreaming();
+    void ReleaseAudio();
+
+    DecodedAudioCache* _cache;
+    FileCallback* _callback;
+
+    // Set while a file is played from the cache.
+    bool _playing;
+    const DecodedAudio* _audio;
+
+    std::string _fileName;
+    CodecInst _codecInst;
+    bool _hasCodecInst;
+    bool _loop;
+    WebRtc_UWord32 _startPositionMs;
+    WebRtc_UWord32 _stopPositionMs;
+    WebRtc_UWord32 _notificationMs;
+
+    // In samples of |_audio|.
+    size_t _position;
+    size_t _startPosition;
+    size_t _stopPosition;
+};
+
+} // namespace webrtc
+#endif // WEBRTC_MODULES_UTILITY_SOURCE_CACHED_FILE_PLAYER_IMPL_H_
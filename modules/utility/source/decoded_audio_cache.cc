@@ -0,0 +1,223 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "decoded_audio_cache.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "critical_section_wrapper.h"
+#include "file_player.h"
+#include "media_file.h"
+#include "trace.h"
+
+namespace webrtc {
+
+namespace {
+
+std::string CacheKey(const char* file_name, FileFormats format,
+                     const CodecInst* codec_inst, int frequency_in_hz) {
+  char parameters[128];
+  if (format == kFileFormatPreencodedFile && codec_inst != NULL) {
+    snprintf(parameters, sizeof(parameters), "|%d|%d|%s|%d|%d|%d", format,
+             frequency_in_hz, codec_inst->plname, codec_inst->plfreq,
+             codec_inst->pacsize, codec_inst->rate);
+  } else {
+    snprintf(parameters, sizeof(parameters), "|%d|%d", format,
+             frequency_in_hz);
+  }
+  return std::string(file_name) + parameters;
+}
+
+}  // namespace
+
+DecodedAudioCache* DecodedAudioCache::GetInstance() {
+  return GetStaticInstance<DecodedAudioCache>(kAddRef);
+}
+
+void DecodedAudioCache::ReturnInstance() {
+  GetStaticInstance<DecodedAudioCache>(kRelease);
+}
+
+DecodedAudioCache::DecodedAudioCache(size_t max_memory_bytes)
+    : max_memory_bytes_(max_memory_bytes),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()) {
+}
+
+DecodedAudioCache::~DecodedAudioCache() {
+  // All players must have released their audio.
+  assert(entries_.empty());
+  for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it) {
+    delete it->second;
+  }
+}
+
+const DecodedAudio* DecodedAudioCache::Acquire(const char* file_name,
+                                               FileFormats format,
+                                               const CodecInst* codec_inst,
+                                               int frequency_in_hz) {
+  if (file_name == NULL) {
+    return NULL;
+  }
+  const std::string key = CacheKey(file_name, format, codec_inst,
+                                   frequency_in_hz);
+  size_t available_bytes = 0;
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+    EntryMap::iterator it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++it->second->ref_count;
+      ++stats_.hits;
+      return &it->second->audio;
+    }
+    ++stats_.misses;
+    if (stats_.memory_bytes < max_memory_bytes_) {
+      available_bytes = max_memory_bytes_ - stats_.memory_bytes;
+    }
+    RejectionMap::const_iterator rejection = rejected_.find(key);
+    if (rejection != rejected_.end() && available_bytes <= rejection->second) {
+      // Decoding would fail again, the caller streams the file.
+      ++stats_.rejected;
+      return NULL;
+    }
+  }
+
+  // Decode without holding the lock so that other files can be acquired and
+  // released meanwhile. If the same file is decoded concurrently the first
+  // result to be inserted is used.
+  Entry* entry = new Entry();
+  if (EstimatedBytes(file_name, format, frequency_in_hz) > available_bytes ||
+      !Decode(file_name, format, codec_inst, frequency_in_hz,
+              available_bytes, &entry->audio)) {
+    WEBRTC_TRACE(kTraceWarning, kTraceUtility, -1,
+                 "DecodedAudioCache: failed to decode %s within %u bytes",
+                 file_name, static_cast<unsigned int>(available_bytes));
+    delete entry;
+    CriticalSectionScoped lock(crit_sect_.get());
+    rejected_[key] = available_bytes;
+    ++stats_.rejected;
+    return NULL;
+  }
+  entry->key = key;
+  entry->ref_count = 1;
+  const size_t bytes = MemoryBytes(entry->audio);
+
+  CriticalSectionScoped lock(crit_sect_.get());
+  std::pair<EntryMap::iterator, bool> inserted =
+      entries_.insert(std::make_pair(key, entry));
+  if (!inserted.second) {
+    delete entry;
+    entry = inserted.first->second;
+    ++entry->ref_count;
+    return &entry->audio;
+  }
+  if (stats_.memory_bytes + bytes > max_memory_bytes_) {
+    // Other files were added while decoding.
+    entries_.erase(inserted.first);
+    delete entry;
+    ++stats_.rejected;
+    return NULL;
+  }
+  rejected_.erase(key);
+  entries_by_audio_[&entry->audio] = entry;
+  ++stats_.num_entries;
+  stats_.memory_bytes += bytes;
+  return &entry->audio;
+}
+
+void DecodedAudioCache::Release(const DecodedAudio* audio) {
+  if (audio == NULL) {
+    return;
+  }
+  CriticalSectionScoped lock(crit_sect_.get());
+  AudioMap::iterator it = entries_by_audio_.find(audio);
+  if (it == entries_by_audio_.end()) {
+    assert(false);
+    return;
+  }
+  Entry* entry = it->second;
+  if (--entry->ref_count > 0) {
+    return;
+  }
+  --stats_.num_entries;
+  stats_.memory_bytes -= MemoryBytes(entry->audio);
+  entries_.erase(entry->key);
+  entries_by_audio_.erase(it);
+  delete entry;
+}
+
+int DecodedAudioCache::NumEntries() const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  return static_cast<int>(entries_.size());
+}
+
+void DecodedAudioCache::GetStats(DecodedAudioCacheStats* stats) const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  *stats = stats_;
+}
+
+size_t DecodedAudioCache::MemoryBytes(const DecodedAudio& audio) {
+  return audio.samples.size() * sizeof(audio.samples[0]);
+}
+
+size_t DecodedAudioCache::EstimatedBytes(const char* file_name,
+                                         FileFormats format,
+                                         int frequency_in_hz) {
+  MediaFile* media_file = MediaFile::CreateMediaFile(0);
+  if (media_file == NULL) {
+    return 0;
+  }
+  WebRtc_UWord32 duration_ms = 0;
+  if (media_file->FileDurationMs(file_name, duration_ms, format,
+                                 frequency_in_hz) != 0) {
+    duration_ms = 0;
+  }
+  MediaFile::DestroyMediaFile(media_file);
+  return static_cast<size_t>(static_cast<uint64_t>(duration_ms) *
+                             frequency_in_hz / 1000) * sizeof(int16_t);
+}
+
+bool DecodedAudioCache::Decode(const char* file_name,
+                               FileFormats format,
+                               const CodecInst* codec_inst,
+                               int frequency_in_hz,
+                               size_t max_bytes,
+                               DecodedAudio* audio) {
+  FilePlayer* player = FilePlayer::CreateFilePlayer(0, format);
+  if (player == NULL) {
+    return false;
+  }
+  const size_t max_samples = max_bytes / sizeof(audio->samples[0]);
+  bool decoded = false;
+  if (player->StartPlayingFile(file_name, false, 0, 1.0f, 0, 0,
+                               codec_inst) == 0) {
+    player->AudioCodec(audio->codec);
+    audio->sample_rate_hz = frequency_in_hz;
+    int16_t buffer[FilePlayer::MAX_AUDIO_BUFFER_IN_SAMPLES];
+    int length = 0;
+    // The frame returned when the end of the file is reached holds no file
+    // data.
+    while (player->Get10msAudioFromFile(buffer, length, frequency_in_hz) == 0 &&
+           length > 0 && player->IsPlayingFile()) {
+      if (audio->samples.size() + length > max_samples) {
+        audio->samples.clear();
+        break;
+      }
+      audio->samples.insert(audio->samples.end(), buffer, buffer + length);
+    }
+    // Drop the spare capacity so that the memory bound holds.
+    std::vector<int16_t>(audio->samples).swap(audio->samples);
+    decoded = !audio->samples.empty();
+  }
+  FilePlayer::DestroyFilePlayer(player);
+  return decoded;
+}
+
+}  // namespace webrtc
@@ -9,6 +9,8 @@
  */
 
 #include "file_player_impl.h"
+
+#include "cached_file_player_impl.h"
 #include "trace.h"
 
 #ifdef WEBRTC_MODULE_UTILITY_VIDEO
@@ -52,6 +54,17 @@ FilePlayer* FilePlayer::CreateFilePlayer(WebRtc_UWord32 instanceID,
     return NULL;
 }
 
+FilePlayer* FilePlayer::CreateCachedFilePlayer(WebRtc_UWord32 instanceID,
+                                               FileFormats fileFormat,
+                                               DecodedAudioCache* cache)
+{
+    if (cache == NULL || fileFormat == kFileFormatAviFile)
+    {
+        return CreateFilePlayer(instanceID, fileFormat);
+    }
+    return new CachedFilePlayerImpl(instanceID, fileFormat, cache);
+}
+
 void FilePlayer::DestroyFilePlayer(FilePlayer* player)
 {
     delete player;
@@ -63,12 +76,12 @@ FilePlayerImpl::FilePlayerImpl(const WebRtc_UWord32 instanceID,
       _fileFormat(fileFormat),
       _fileModule(*MediaFile::CreateMediaFile(instanceID)),
       _decodedLengthInMS(0),
-      _audioDecoder(instanceID),
       _codec(),
-      _numberOf10MsPerFrame(0),
-      _numberOf10MsInDecoder(0),
+      _scaling(1.0),
       _resampler(),
-      _scaling(1.0)
+      _audioDecoder(instanceID),
+      _numberOf10MsPerFrame(0),
+      _numberOf10MsInDecoder(0)
 {
     _codec.plfreq = 0;
 }
@@ -68,15 +68,16 @@ protected:
 
     WebRtc_UWord32 _decodedLengthInMS;
 
+    CodecInst _codec;
+    float _scaling;
+
+    Resampler _resampler;
+
 private:
     AudioCoder _audioDecoder;
 
-    CodecInst _codec;
     WebRtc_Word32 _numberOf10MsPerFrame;
     WebRtc_Word32 _numberOf10MsInDecoder;
-
-    Resampler _resampler;
-    float _scaling;
 };
 
 #ifdef WEBRTC_MODULE_UTILITY_VIDEO
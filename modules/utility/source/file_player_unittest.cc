@@ -0,0 +1,385 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/utility/interface/file_player.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/media_file/interface/media_file_defines.h"
+#include "modules/utility/interface/decoded_audio_cache.h"
+#include "modules/utility/interface/file_recorder.h"
+#include "system_wrappers/interface/tick_util.h"
+#include "testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kFileLengthMs = 1000;
+
+class FileCallbackCounter : public FileCallback {
+ public:
+  FileCallbackCounter()
+      : play_notifications_(0), last_notification_ms_(0), files_ended_(0) {}
+
+  virtual void PlayNotification(const WebRtc_Word32 id,
+                                const WebRtc_UWord32 durationMs) {
+    ++play_notifications_;
+    last_notification_ms_ = durationMs;
+  }
+  virtual void RecordNotification(const WebRtc_Word32 id,
+                                  const WebRtc_UWord32 durationMs) {}
+  virtual void PlayFileEnded(const WebRtc_Word32 id) { ++files_ended_; }
+  virtual void RecordFileEnded(const WebRtc_Word32 id) {}
+
+  int play_notifications_;
+  WebRtc_UWord32 last_notification_ms_;
+  int files_ended_;
+};
+
+int16_t Sample(int i, int sample_rate_hz) {
+  return static_cast<int16_t>(8000 * sin(2 * 3.14159265 * 440 * i /
+                                         sample_rate_hz));
+}
+
+// Writes |length_ms| of a tone as 16 kHz PCM.
+std::string WritePcmFile(const char* name, int length_ms) {
+  const std::string file_name = test::OutputPath() + name;
+  FILE* file = fopen(file_name.c_str(), "wb");
+  EXPECT_TRUE(file != NULL);
+  for (int i = 0; i < 16 * length_ms; ++i) {
+    const int16_t sample = Sample(i, 16000);
+    fwrite(&sample, sizeof(sample), 1, file);
+  }
+  fclose(file);
+  return file_name;
+}
+
+// Encodes |length_ms| of a tone in an iLBC file.
+std::string WriteIlbcFile(const char* name, int length_ms) {
+  const std::string file_name = test::OutputPath() + name;
+  FileRecorder* recorder =
+      FileRecorder::CreateFileRecorder(0, kFileFormatCompressedFile);
+  CodecInst codec = { 102, "ILBC", 8000, 240, 1, 13300 };
+  EXPECT_EQ(0, recorder->StartRecordingAudioFile(file_name.c_str(), codec, 0));
+  AudioFrame frame;
+  frame.sample_rate_hz_ = 8000;
+  frame.samples_per_channel_ = 80;
+  frame.num_channels_ = 1;
+  for (int i = 0; i < length_ms / 10; ++i) {
+    for (int j = 0; j < 80; ++j) {
+      frame.data_[j] = Sample(i * 80 + j, 8000);
+    }
+    EXPECT_EQ(0, recorder->RecordAudioToFile(frame));
+  }
+  recorder->StopRecording();
+  FileRecorder::DestroyFileRecorder(recorder);
+  return file_name;
+}
+
+// Plays |player| until it fails, at most |max_frames| frames.
+std::vector<int16_t> PlayToEnd(FilePlayer* player, int frequency_hz,
+                               int max_frames, int* frames) {
+  std::vector<int16_t> output;
+  int16_t buffer[FilePlayer::MAX_AUDIO_BUFFER_IN_SAMPLES];
+  *frames = 0;
+  for (; *frames < max_frames; ++*frames) {
+    int length = 0;
+    if (player->Get10msAudioFromFile(buffer, length, frequency_hz) != 0) {
+      break;
+    }
+    output.insert(output.end(), buffer, buffer + length);
+  }
+  return output;
+}
+
+}  // namespace
+
+TEST(FilePlayerTest, CachedPlayerMatchesStreamingPlayer) {
+  const std::string file_name = WritePcmFile("file_player_test.pcm",
+                                             kFileLengthMs);
+  DecodedAudioCache cache;
+  const int kFrequencies[] = { 16000, 32000 };
+  for (int i = 0; i < 2; ++i) {
+    // The streaming player only stops at |stop| when looping, so start and
+    // stop positions are compared in loop mode, at the rate of the file.
+    for (int loop = 0; loop < 2; ++loop) {
+      if (loop && kFrequencies[i] != 16000) {
+        continue;
+      }
+      const WebRtc_UWord32 start = loop ? 200 : 0;
+      const WebRtc_UWord32 stop = loop ? 700 : 0;
+      const int max_frames = loop ? 120 : 1000;
+      FilePlayer* streaming =
+          FilePlayer::CreateFilePlayer(0, kFileFormatPcm16kHzFile);
+      FilePlayer* cached = FilePlayer::CreateCachedFilePlayer(
+          0, kFileFormatPcm16kHzFile, &cache);
+      ASSERT_EQ(0, streaming->StartPlayingFile(file_name.c_str(), loop != 0,
+                                               start, 0.5f, 0, stop));
+      ASSERT_EQ(0, cached->StartPlayingFile(file_name.c_str(), loop != 0,
+                                            start, 0.5f, 0, stop));
+      EXPECT_TRUE(cached->IsPlayingFile());
+      EXPECT_EQ(16000, cached->Frequency());
+
+      int streaming_frames = 0;
+      int cached_frames = 0;
+      std::vector<int16_t> expected = PlayToEnd(streaming, kFrequencies[i],
+                                                max_frames, &streaming_frames);
+      std::vector<int16_t> output = PlayToEnd(cached, kFrequencies[i],
+                                              max_frames, &cached_frames);
+      EXPECT_EQ(streaming_frames, cached_frames);
+      EXPECT_TRUE(expected == output);
+      if (loop) {
+        EXPECT_EQ(max_frames, cached_frames);
+        EXPECT_TRUE(cached->IsPlayingFile());
+        EXPECT_EQ(1, cache.NumEntries());
+        EXPECT_EQ(0, cached->StopPlayingFile());
+      } else {
+        EXPECT_EQ(kFileLengthMs * kFrequencies[i] / 1000,
+                  static_cast<int>(output.size()));
+        EXPECT_FALSE(cached->IsPlayingFile());
+      }
+      EXPECT_EQ(0, cache.NumEntries());
+
+      FilePlayer::DestroyFilePlayer(streaming);
+      FilePlayer::DestroyFilePlayer(cached);
+    }
+  }
+  remove(file_name.c_str());
+}
+
+TEST(FilePlayerTest, CachedPlayerLoopsAndNotifies) {
+  const std::string file_name = WritePcmFile("file_player_loop_test.pcm",
+                                             kFileLengthMs);
+  DecodedAudioCache cache;
+  FilePlayer* player =
+      FilePlayer::CreateCachedFilePlayer(0, kFileFormatPcm16kHzFile, &cache);
+  FileCallbackCounter callback;
+  EXPECT_EQ(0, player->RegisterModuleFileCallback(&callback));
+  ASSERT_EQ(0, player->StartPlayingFile(file_name.c_str(), true, 0, 1.0f,
+                                        300));
+  int frames = 0;
+  std::vector<int16_t> output = PlayToEnd(player, 16000, 250, &frames);
+  EXPECT_EQ(250, frames);
+  // The tone continues after the end of the file.
+  EXPECT_EQ(output[0], output[16 * kFileLengthMs]);
+  EXPECT_EQ(output[160], output[16 * kFileLengthMs + 160]);
+  EXPECT_EQ(1, callback.play_notifications_);
+  EXPECT_EQ(300u, callback.last_notification_ms_);
+  EXPECT_EQ(0, callback.files_ended_);
+  WebRtc_UWord32 position_ms = 0;
+  EXPECT_EQ(0, player->GetPlayoutPosition(position_ms));
+  EXPECT_EQ(500u, position_ms);
+  EXPECT_EQ(1, cache.NumEntries());
+
+  // Switching the sample rate keeps the position.
+  output = PlayToEnd(player, 32000, 1, &frames);
+  ASSERT_EQ(320u, output.size());
+  EXPECT_EQ(0, player->GetPlayoutPosition(position_ms));
+  EXPECT_EQ(510u, position_ms);
+  EXPECT_EQ(1, cache.NumEntries());
+
+  EXPECT_EQ(0, player->StopPlayingFile());
+  EXPECT_EQ(0, cache.NumEntries());
+
+  // Without looping the end of the file is reported.
+  ASSERT_EQ(0, player->StartPlayingFile(file_name.c_str(), false, 0, 1.0f,
+                                        0));
+  PlayToEnd(player, 16000, 1000, &frames);
+  EXPECT_EQ(kFileLengthMs / 10 + 1, frames);
+  EXPECT_EQ(1, callback.files_ended_);
+  EXPECT_EQ(-1, player->StopPlayingFile());
+  FilePlayer::DestroyFilePlayer(player);
+  remove(file_name.c_str());
+}
+
+TEST(FilePlayerTest, CachedPlayersShareDecodedAudio) {
+  const std::string file_name = WriteIlbcFile("file_player_test.ilbc", 990);
+  DecodedAudioCache cache;
+  FilePlayer* streaming =
+      FilePlayer::CreateFilePlayer(0, kFileFormatCompressedFile);
+  FilePlayer* players[2];
+  for (int i = 0; i < 2; ++i) {
+    players[i] = FilePlayer::CreateCachedFilePlayer(
+        0, kFileFormatCompressedFile, &cache);
+    ASSERT_EQ(0, players[i]->StartPlayingFile(file_name.c_str(), false, 0,
+                                              1.0f, 0));
+    // The file is decoded when the playout starts, not by the first
+    // Get10msAudioFromFile() call on the audio thread.
+    EXPECT_EQ(1, cache.NumEntries());
+  }
+  ASSERT_EQ(0, streaming->StartPlayingFile(file_name.c_str(), false, 0, 1.0f,
+                                           0));
+  CodecInst codec;
+  EXPECT_EQ(0, players[0]->AudioCodec(codec));
+  EXPECT_STRCASEEQ("ILBC", codec.plname);
+
+  int16_t expected[FilePlayer::MAX_AUDIO_BUFFER_IN_SAMPLES];
+  int16_t buffer[FilePlayer::MAX_AUDIO_BUFFER_IN_SAMPLES];
+  int expected_length = 0;
+  int length = 0;
+  // The decoder delays the audio, so the file plays for slightly longer than
+  // it was recorded.
+  int frames = 0;
+  while (true) {
+    ASSERT_EQ(0, streaming->Get10msAudioFromFile(expected, expected_length,
+                                                 16000));
+    if (!streaming->IsPlayingFile()) {
+      break;
+    }
+    ++frames;
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_EQ(0, players[i]->Get10msAudioFromFile(buffer, length, 16000));
+      ASSERT_EQ(expected_length, length);
+      ASSERT_EQ(0, memcmp(expected, buffer, length * sizeof(int16_t)));
+    }
+  }
+  EXPECT_LE(99, frames);
+  EXPECT_EQ(1, cache.NumEntries());
+  DecodedAudioCacheStats stats;
+  cache.GetStats(&stats);
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(0, stats.rejected);
+  EXPECT_EQ(1, stats.num_entries);
+  // The audio is cached at the rate of the file.
+  EXPECT_LE(frames * 80 * sizeof(int16_t), stats.memory_bytes);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(0, players[i]->Get10msAudioFromFile(buffer, length, 16000));
+    EXPECT_EQ(0, length);
+    EXPECT_EQ(-1, players[i]->Get10msAudioFromFile(buffer, length, 16000));
+    FilePlayer::DestroyFilePlayer(players[i]);
+  }
+  EXPECT_EQ(0, cache.NumEntries());
+  FilePlayer::DestroyFilePlayer(streaming);
+  remove(file_name.c_str());
+}
+
+TEST(FilePlayerTest, CachedPlayerStreamsFilesThatDontFit) {
+  const std::string file_name = WritePcmFile("file_player_large_test.pcm",
+                                             kFileLengthMs);
+  // Room for half of the file.
+  DecodedAudioCache cache(16000);
+  FilePlayer* streaming =
+      FilePlayer::CreateFilePlayer(0, kFileFormatPcm16kHzFile);
+  FilePlayer* cached =
+      FilePlayer::CreateCachedFilePlayer(0, kFileFormatPcm16kHzFile, &cache);
+  ASSERT_EQ(0, streaming->StartPlayingFile(file_name.c_str(), false, 0, 1.0f,
+                                           0));
+  ASSERT_EQ(0, cached->StartPlayingFile(file_name.c_str(), false, 0, 1.0f,
+                                        0));
+  int streaming_frames = 0;
+  int cached_frames = 0;
+  std::vector<int16_t> expected = PlayToEnd(streaming, 16000, 1000,
+                                            &streaming_frames);
+  std::vector<int16_t> output = PlayToEnd(cached, 16000, 1000,
+                                          &cached_frames);
+  EXPECT_EQ(streaming_frames, cached_frames);
+  EXPECT_TRUE(expected == output);
+
+  DecodedAudioCacheStats stats;
+  cache.GetStats(&stats);
+  EXPECT_EQ(0, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(1, stats.rejected);
+  EXPECT_EQ(0, stats.num_entries);
+  EXPECT_EQ(0u, stats.memory_bytes);
+
+  FilePlayer::DestroyFilePlayer(streaming);
+  FilePlayer::DestroyFilePlayer(cached);
+  remove(file_name.c_str());
+}
+
+TEST(FilePlayerTest, CacheRemembersFilesThatDontFit) {
+  const std::string file_name = WritePcmFile("file_player_rejected_test.pcm",
+                                             kFileLengthMs);
+  // Room for half of the file.
+  DecodedAudioCache cache(16000);
+  EXPECT_TRUE(cache.Acquire(file_name.c_str(), kFileFormatPcm16kHzFile, NULL,
+                            16000) == NULL);
+
+  // A shorter file would fit, but the rejection is remembered and the file
+  // isn't decoded again.
+  WritePcmFile("file_player_rejected_test.pcm", kFileLengthMs / 4);
+  EXPECT_TRUE(cache.Acquire(file_name.c_str(), kFileFormatPcm16kHzFile, NULL,
+                            16000) == NULL);
+  DecodedAudioCacheStats stats;
+  cache.GetStats(&stats);
+  EXPECT_EQ(2, stats.misses);
+  EXPECT_EQ(2, stats.rejected);
+  EXPECT_EQ(0, stats.num_entries);
+
+  // Another sample rate is another entry.
+  const DecodedAudio* audio = cache.Acquire(
+      file_name.c_str(), kFileFormatPcm16kHzFile, NULL, 8000);
+  ASSERT_TRUE(audio != NULL);
+  EXPECT_EQ(8 * kFileLengthMs / 4, static_cast<int>(audio->samples.size()));
+  cache.Release(audio);
+  remove(file_name.c_str());
+}
+
+TEST(FilePlayerTest, ProcessWideCacheIsShared) {
+  DecodedAudioCache* cache = DecodedAudioCache::GetInstance();
+  ASSERT_TRUE(cache != NULL);
+  EXPECT_EQ(cache, DecodedAudioCache::GetInstance());
+  DecodedAudioCache::ReturnInstance();
+  DecodedAudioCache::ReturnInstance();
+}
+
+// Measures how many players of the same prompt one core sustains in real
+// time.
+TEST(FilePlayerTest, ConcurrentPlayersPerCore) {
+  const int kPlayers = 50;
+  const int kFrames = 100;
+  const std::string file_name = WriteIlbcFile("file_player_perf.ilbc",
+                                              kFileLengthMs);
+  DecodedAudioCache cache;
+  for (int use_cache = 0; use_cache < 2; ++use_cache) {
+    std::vector<FilePlayer*> players(kPlayers);
+    for (int i = 0; i < kPlayers; ++i) {
+      players[i] = use_cache ?
+          FilePlayer::CreateCachedFilePlayer(0, kFileFormatCompressedFile,
+                                             &cache) :
+          FilePlayer::CreateFilePlayer(0, kFileFormatCompressedFile);
+      ASSERT_EQ(0, players[i]->StartPlayingFile(file_name.c_str(), true, 0,
+                                                1.0f, 0));
+    }
+    int16_t buffer[FilePlayer::MAX_AUDIO_BUFFER_IN_SAMPLES];
+    int length = 0;
+    for (int i = 0; i < kPlayers; ++i) {
+      ASSERT_EQ(0, players[i]->Get10msAudioFromFile(buffer, length, 32000));
+    }
+    const TickTime start = TickTime::Now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+      for (int i = 0; i < kPlayers; ++i) {
+        ASSERT_EQ(0, players[i]->Get10msAudioFromFile(buffer, length, 32000));
+      }
+    }
+    const WebRtc_Word64 elapsed_us =
+        (TickTime::Now() - start).Microseconds() + 1;
+    printf("%s players: %.2f us per 10 ms, %d players per core\n",
+           use_cache ? "Cached" : "Streaming",
+           static_cast<double>(elapsed_us) / (kPlayers * kFrames),
+           static_cast<int>(10000LL * kPlayers * kFrames / elapsed_us));
+    for (int i = 0; i < kPlayers; ++i) {
+      FilePlayer::DestroyFilePlayer(players[i]);
+    }
+  }
+  EXPECT_EQ(0, cache.NumEntries());
+  remove(file_name.c_str());
+}
+
+}  // namespace webrtc
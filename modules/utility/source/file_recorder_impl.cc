@@ -377,8 +377,7 @@ class AudioFrameFileInfo
 AviRecorder::AviRecorder(WebRtc_UWord32 instanceID, FileFormats fileFormat)
     : FileRecorderImpl(instanceID, fileFormat),
       _videoOnly(false),
-      _thread( 0),
-      _timeEvent(*EventWrapper::Create()),
+      _workerPool(RecorderWorkerPool::GetInstance()),
       _critSec(CriticalSectionWrapper::CreateCriticalSection()),
       _writtenVideoFramesCounter(0),
       _writtenAudioMS(0),
@@ -387,8 +386,6 @@ AviRecorder::AviRecorder(WebRtc_UWord32 instanceID, FileFormats fileFormat)
     _videoEncoder = new VideoCoder(instanceID);
     _frameScaler = new FrameScaler();
     _videoFramesQueue = new VideoFramesQueue();
-    _thread = ThreadWrapper::CreateThread(Run, this, kNormalPriority,
-                                          "AviRecorder()");
 }
 
 AviRecorder::~AviRecorder( )
@@ -398,9 +395,8 @@ AviRecorder::~AviRecorder( )
     delete _videoEncoder;
     delete _frameScaler;
     delete _videoFramesQueue;
-    delete _thread;
-    delete &_timeEvent;
     delete _critSec;
+    RecorderWorkerPool::ReturnInstance();
 }
 
 WebRtc_Word32 AviRecorder::StartRecordingVideoFile(
@@ -435,22 +431,17 @@ WebRtc_Word32 AviRecorder::StartRecordingVideoFile(
         StopRecording();
         return -1;
     }
-    if(_videoOnly)
-    {
-        // Writing to AVI file is non-blocking.
-        // Start non-blocking timer if video only. If recording both video and
-        // audio let the pushing of audio frames be the timer.
-        _timeEvent.StartTimer(true, 1000 / _videoCodecInst.maxFramerate);
-    }
-    StartThread();
+    // Writing to AVI file is non-blocking.
+    // Run periodically if video only. If recording both video and audio let
+    // the pushing of audio frames wake up the recorder.
+    _workerPool->Register(this, _videoOnly ?
+                          1000 / _videoCodecInst.maxFramerate : 0);
     return 0;
 }
 
 WebRtc_Word32 AviRecorder::StopRecording()
 {
-    _timeEvent.StopTimer();
-
-    StopThread();
+    _workerPool->Deregister(this);
     return FileRecorderImpl::StopRecording();
 }
 
@@ -483,7 +474,8 @@ WebRtc_Word32 AviRecorder::SetUpVideoEncoder()
 
 WebRtc_Word32 AviRecorder::RecordVideoToFile(const I420VideoFrame& videoFrame)
 {
-    CriticalSectionScoped lock(_critSec);
+    // The queue is safe to use while the frames are processed, so the caller
+    // isn't blocked by the encoder.
     if(!IsRecording() || videoFrame.IsZeroSize())
     {
         return -1;
@@ -497,49 +489,6 @@ WebRtc_Word32 AviRecorder::RecordVideoToFile(const I420VideoFrame& videoFrame)
     return retVal;
 }
 
-bool AviRecorder::StartThread()
-{
-    unsigned int id;
-    if( _thread == 0)
-    {
-        return false;
-    }
-
-    return _thread->Start(id);
-}
-
-bool AviRecorder::StopThread()
-{
-    _critSec->Enter();
-
-    if(_thread)
-    {
-        _thread->SetNotAlive();
-
-        ThreadWrapper* thread = _thread;
-        _thread = NULL;
-
-        _timeEvent.Set();
-
-        _critSec->Leave();
-
-        if(thread->Stop())
-        {
-            delete thread;
-        } else {
-            return false;
-        }
-    } else {
-        _critSec->Leave();
-    }
-    return true;
-}
-
-bool AviRecorder::Run( ThreadObj threadObj)
-{
-    return static_cast<AviRecorder*>( threadObj)->Process();
-}
-
 WebRtc_Word32 AviRecorder::ProcessAudio()
 {
     if (_writtenVideoFramesCounter == 0)
@@ -602,20 +551,6 @@ WebRtc_Word32 AviRecorder::ProcessAudio()
 
 bool AviRecorder::Process()
 {
-    switch(_timeEvent.Wait(500))
-    {
-    case kEventSignaled:
-        if(_thread == NULL)
-        {
-            return false;
-        }
-        break;
-    case kEventError:
-        return false;
-    case kEventTimeout:
-        // No events triggered. No work to do.
-        return true;
-    }
     CriticalSectionScoped lock( _critSec);
 
     // Get the most recent frame to write to file (if any). Synchronize it with
@@ -788,7 +723,7 @@ WebRtc_Word32 AviRecorder::WriteEncodedAudioData(
                                                             millisecondsOfData,
                                                             TickTime::Now()));
     }
-    _timeEvent.Set();
+    _workerPool->Wake(this);
     return 0;
 }
 
@@ -20,6 +20,7 @@
 #include "engine_configurations.h"
 #include "event_wrapper.h"
 #include "file_recorder.h"
+#include "list_wrapper.h"
 #include "media_file_defines.h"
 #include "media_file.h"
 #include "module_common_types.h"
@@ -30,6 +31,7 @@
 
 #ifdef WEBRTC_MODULE_UTILITY_VIDEO
     #include "frame_scaler.h"
+    #include "recorder_worker_pool.h"
     #include "video_coder.h"
     #include "video_frames_queue.h"
 #endif
@@ -103,7 +105,7 @@ private:
 
 
 #ifdef WEBRTC_MODULE_UTILITY_VIDEO
-class AviRecorder : public FileRecorderImpl
+class AviRecorder : public FileRecorderImpl, private RecorderWorkerPool::Task
 {
 public:
     AviRecorder(WebRtc_UWord32 instanceID, FileFormats fileFormat);
@@ -126,11 +128,8 @@ protected:
         WebRtc_UWord16 millisecondsOfData,
         const TickTime* playoutTS);
 private:
-    static bool Run(ThreadObj threadObj);
-    bool Process();
-
-    bool StartThread();
-    bool StopThread();
+    // RecorderWorkerPool::Task function.
+    virtual bool Process();
 
     WebRtc_Word32 EncodeAndWriteVideoToFile(I420VideoFrame& videoFrame);
     WebRtc_Word32 ProcessAudio();
@@ -151,8 +150,8 @@ private:
     WebRtc_Word32 _videoMaxPayloadSize;
     EncodedVideoData _videoEncodedData;
 
-    ThreadWrapper* _thread;
-    EventWrapper& _timeEvent;
+    // Runs Process() while recording.
+    RecorderWorkerPool* _workerPool;
     CriticalSectionWrapper* _critSec;
     WebRtc_Word64 _writtenVideoFramesCounter;
     WebRtc_Word64 _writtenAudioMS;
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "recorder_worker_pool.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "condition_variable_wrapper.h"
+#include "cpu_info.h"
+#include "critical_section_wrapper.h"
+#include "thread_wrapper.h"
+#include "tick_util.h"
+#include "trace.h"
+
+namespace webrtc {
+
+namespace {
+
+// Recording mostly waits for the encoder, so there is no point in more
+// threads than cores.
+const int kMaxThreads = 4;
+// Wait at most this long when no task is due, to notice time jumps.
+const int kMaxWaitMs = 500;
+
+}  // namespace
+
+RecorderWorkerPool* RecorderWorkerPool::GetInstance() {
+  return GetStaticInstance<RecorderWorkerPool>(kAddRef);
+}
+
+void RecorderWorkerPool::ReturnInstance() {
+  GetStaticInstance<RecorderWorkerPool>(kRelease);
+}
+
+RecorderWorkerPool* RecorderWorkerPool::CreateInstance() {
+  const int cores = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  return new RecorderWorkerPool(std::max(1, std::min(cores, kMaxThreads)));
+}
+
+RecorderWorkerPool::RecorderWorkerPool(int num_threads)
+    : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      wake_up_(ConditionVariableWrapper::CreateConditionVariable()),
+      threads_(),
+      tasks_(),
+      stopping_(false) {
+  for (int i = 0; i < num_threads; ++i) {
+    ThreadWrapper* thread = ThreadWrapper::CreateThread(
+        Run, this, kNormalPriority, "RecorderWorkerPool");
+    unsigned int id = 0;
+    if (thread == NULL || !thread->Start(id)) {
+      WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
+                   "RecorderWorkerPool: failed to start thread %d", i);
+      delete thread;
+      continue;
+    }
+    threads_.push_back(thread);
+  }
+}
+
+RecorderWorkerPool::~RecorderWorkerPool() {
+  // All recorders must have deregistered.
+  assert(tasks_.empty());
+  {
+    CriticalSectionScoped cs(crit_sect_.get());
+    stopping_ = true;
+    for (size_t i = 0; i < threads_.size(); ++i) {
+      threads_[i]->SetNotAlive();
+    }
+    wake_up_->WakeAll();
+  }
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->Stop();
+    delete threads_[i];
+  }
+}
+
+void RecorderWorkerPool::Register(Task* task, int period_ms) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  TaskList::iterator it = Find(task);
+  if (it == tasks_.end()) {
+    TaskInfo info;
+    info.task = task;
+    info.running = false;
+    it = tasks_.insert(tasks_.end(), info);
+  }
+  it->period_ms = period_ms;
+  it->next_run_ms = TickTime::MillisecondTimestamp() + period_ms;
+  it->woken = false;
+  it->stopped = false;
+  wake_up_->WakeAll();
+}
+
+void RecorderWorkerPool::Deregister(Task* task) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  TaskList::iterator it = Find(task);
+  if (it == tasks_.end()) {
+    return;
+  }
+  it->stopped = true;
+  while (it->running) {
+    wake_up_->SleepCS(*crit_sect_);
+  }
+  tasks_.erase(it);
+}
+
+void RecorderWorkerPool::Wake(Task* task) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  TaskList::iterator it = Find(task);
+  if (it == tasks_.end() || it->stopped || it->woken) {
+    return;
+  }
+  it->woken = true;
+  wake_up_->WakeAll();
+}
+
+int RecorderWorkerPool::NumThreads() const {
+  return static_cast<int>(threads_.size());
+}
+
+bool RecorderWorkerPool::Run(void* obj) {
+  return static_cast<RecorderWorkerPool*>(obj)->Process();
+}
+
+bool RecorderWorkerPool::Process() {
+  crit_sect_->Enter();
+  if (stopping_) {
+    crit_sect_->Leave();
+    return false;
+  }
+  const WebRtc_Word64 now_ms = TickTime::MillisecondTimestamp();
+  WebRtc_Word64 wait_ms = kMaxWaitMs;
+  TaskList::iterator it = tasks_.begin();
+  for (; it != tasks_.end(); ++it) {
+    if (it->running || it->stopped) {
+      continue;
+    }
+    if (it->woken || (it->period_ms > 0 && it->next_run_ms <= now_ms)) {
+      break;
+    }
+    if (it->period_ms > 0) {
+      wait_ms = std::min(wait_ms, it->next_run_ms - now_ms);
+    }
+  }
+  if (it == tasks_.end()) {
+    wake_up_->SleepCS(*crit_sect_, static_cast<unsigned long>(wait_ms));
+    crit_sect_->Leave();
+    return true;
+  }
+
+  it->running = true;
+  it->woken = false;
+  if (it->period_ms > 0) {
+    // Like a periodic timer, skip the periods that have been missed.
+    it->next_run_ms += it->period_ms;
+    if (it->next_run_ms <= now_ms) {
+      it->next_run_ms = now_ms + it->period_ms;
+    }
+  }
+  tasks_.splice(tasks_.end(), tasks_, it);
+  Task* task = it->task;
+  crit_sect_->Leave();
+
+  const bool keep_running = task->Process();
+
+  CriticalSectionScoped cs(crit_sect_.get());
+  it->running = false;
+  if (!keep_running) {
+    it->stopped = true;
+  }
+  // Wakes up Deregister() and threads waiting for this task.
+  wake_up_->WakeAll();
+  return true;
+}
+
+RecorderWorkerPool::TaskList::iterator RecorderWorkerPool::Find(Task* task) {
+  TaskList::iterator it = tasks_.begin();
+  while (it != tasks_.end() && it->task != task) {
+    ++it;
+  }
+  return it;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_SOURCE_RECORDER_WORKER_POOL_H_
+#define WEBRTC_MODULES_UTILITY_SOURCE_RECORDER_WORKER_POOL_H_
+
+#include <list>
+#include <vector>
+
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/static_instance.h"
+#include "typedefs.h"
+
+namespace webrtc {
+
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+class ThreadWrapper;
+
+// Runs the file recorders of the process on a few shared threads, instead of
+// a thread and a timer thread per recorder.
+class RecorderWorkerPool {
+ public:
+  class Task {
+   public:
+    // Returns false to stop running the task until it's registered again.
+    virtual bool Process() = 0;
+
+   protected:
+    virtual ~Task() {}
+  };
+
+  // Returns the pool of the process. The pool is deleted when every
+  // GetInstance() call has been matched by a call to ReturnInstance(), so all
+  // tasks must be deregistered before that.
+  static RecorderWorkerPool* GetInstance();
+  static void ReturnInstance();
+
+  // Runs |task| every |period_ms| and when Wake() is called. A |period_ms| of
+  // 0 runs the task only when it's woken. A task is run on one thread at a
+  // time.
+  void Register(Task* task, int period_ms);
+  // Returns once |task| isn't running. Must not be called from the task.
+  void Deregister(Task* task);
+  // Runs |task| as soon as a thread is available.
+  void Wake(Task* task);
+
+  int NumThreads() const;
+
+ private:
+  friend RecorderWorkerPool* GetStaticInstance<RecorderWorkerPool>(
+      CountOperation count_operation);
+  static RecorderWorkerPool* CreateInstance();
+
+  struct TaskInfo {
+    Task* task;
+    int period_ms;
+    WebRtc_Word64 next_run_ms;
+    bool woken;
+    bool running;
+    bool stopped;
+  };
+  typedef std::list<TaskInfo> TaskList;
+
+  explicit RecorderWorkerPool(int num_threads);
+  ~RecorderWorkerPool();
+
+  static bool Run(void* obj);
+  bool Process();
+
+  TaskList::iterator Find(Task* task);
+
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  // Signaled when a task is woken, registered or has finished running.
+  scoped_ptr<ConditionVariableWrapper> wake_up_;
+  std::vector<ThreadWrapper*> threads_;
+  // Tasks are moved to the end when they run, so that due tasks take turns.
+  TaskList tasks_;
+  bool stopping_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_SOURCE_RECORDER_WORKER_POOL_H_
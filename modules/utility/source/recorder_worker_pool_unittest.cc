@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/utility/source/recorder_worker_pool.h"
+
+#include "gtest/gtest.h"
+#include "system_wrappers/interface/atomic32.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+
+namespace {
+
+const unsigned long kTimeoutMs = 5000;
+
+class FakeTask : public RecorderWorkerPool::Task {
+ public:
+  explicit FakeTask(int process_time_ms = 0)
+      : process_time_ms_(process_time_ms),
+        processed_(EventWrapper::Create()),
+        keep_running_(true) {}
+  virtual ~FakeTask() {}
+
+  virtual bool Process() {
+    EXPECT_EQ(1, ++running_);
+    if (process_time_ms_ > 0) {
+      SleepMs(process_time_ms_);
+    }
+    ++num_calls_;
+    --running_;
+    processed_->Set();
+    return keep_running_;
+  }
+
+  bool WaitForCall() {
+    return processed_->Wait(kTimeoutMs) == kEventSignaled;
+  }
+
+  int num_calls() const { return num_calls_.Value(); }
+  bool running() const { return running_.Value() != 0; }
+  void set_keep_running(bool keep_running) { keep_running_ = keep_running; }
+
+ private:
+  const int process_time_ms_;
+  scoped_ptr<EventWrapper> processed_;
+  Atomic32 num_calls_;
+  Atomic32 running_;
+  bool keep_running_;
+};
+
+class RecorderWorkerPoolTest : public ::testing::Test {
+ protected:
+  RecorderWorkerPoolTest() : pool_(RecorderWorkerPool::GetInstance()) {}
+  virtual ~RecorderWorkerPoolTest() {
+    RecorderWorkerPool::ReturnInstance();
+  }
+
+  RecorderWorkerPool* pool_;
+};
+
+TEST_F(RecorderWorkerPoolTest, RunsTasksPeriodically) {
+  FakeTask task;
+  pool_->Register(&task, 10);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(task.WaitForCall());
+  }
+  pool_->Deregister(&task);
+  const int num_calls = task.num_calls();
+  SleepMs(50);
+  EXPECT_EQ(num_calls, task.num_calls());
+}
+
+TEST_F(RecorderWorkerPoolTest, RunsTasksWithoutPeriodWhenWoken) {
+  FakeTask task;
+  pool_->Register(&task, 0);
+  SleepMs(50);
+  EXPECT_EQ(0, task.num_calls());
+  pool_->Wake(&task);
+  EXPECT_TRUE(task.WaitForCall());
+  EXPECT_EQ(1, task.num_calls());
+  pool_->Deregister(&task);
+  // Tasks that aren't registered can't be woken.
+  pool_->Wake(&task);
+  SleepMs(50);
+  EXPECT_EQ(1, task.num_calls());
+}
+
+TEST_F(RecorderWorkerPoolTest, DeregisterWaitsForTheTask) {
+  FakeTask task(100);
+  pool_->Register(&task, 0);
+  pool_->Wake(&task);
+  SleepMs(20);
+  pool_->Deregister(&task);
+  EXPECT_FALSE(task.running());
+  EXPECT_EQ(1, task.num_calls());
+}
+
+TEST_F(RecorderWorkerPoolTest, StopsTasksThatFail) {
+  FakeTask task;
+  task.set_keep_running(false);
+  pool_->Register(&task, 10);
+  EXPECT_TRUE(task.WaitForCall());
+  SleepMs(50);
+  EXPECT_EQ(1, task.num_calls());
+  // Registering again restarts the task.
+  task.set_keep_running(true);
+  pool_->Register(&task, 10);
+  EXPECT_TRUE(task.WaitForCall());
+  pool_->Deregister(&task);
+}
+
+TEST_F(RecorderWorkerPoolTest, TasksShareTheThreads) {
+  const int kNumTasks = 20;
+  FakeTask tasks[kNumTasks];
+  for (int i = 0; i < kNumTasks; ++i) {
+    pool_->Register(&tasks[i], 10);
+  }
+  for (int i = 0; i < kNumTasks; ++i) {
+    EXPECT_TRUE(tasks[i].WaitForCall());
+  }
+  for (int i = 0; i < kNumTasks; ++i) {
+    pool_->Deregister(&tasks[i]);
+  }
+  EXPECT_GE(pool_->NumThreads(), 1);
+  EXPECT_LE(pool_->NumThreads(), 4);
+}
+
+}  // namespace
+
+}  // namespace webrtc
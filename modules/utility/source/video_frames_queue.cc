@@ -19,47 +19,71 @@
 #include "trace.h"
 
 namespace webrtc {
+FrameRing::FrameRing(int capacity)
+    : capacity_(capacity),
+      frames_(new I420VideoFrame*[capacity]),
+      push_index_(0),
+      pop_index_(0),
+      size_(0) {
+}
+
+FrameRing::~FrameRing() {
+}
+
+bool FrameRing::Push(I420VideoFrame* frame) {
+  // The acquire keeps the slot from being written before the consumer has
+  // finished reading it.
+  if (size_.AcquireLoad() == capacity_) {
+    return false;
+  }
+  frames_[push_index_] = frame;
+  push_index_ = (push_index_ + 1) % capacity_;
+  ++size_;
+  return true;
+}
+
+I420VideoFrame* FrameRing::Pop() {
+  // The acquire makes the slot written by the producer visible.
+  if (size_.AcquireLoad() == 0) {
+    return NULL;
+  }
+  I420VideoFrame* frame = frames_[pop_index_];
+  pop_index_ = (pop_index_ + 1) % capacity_;
+  --size_;
+  return frame;
+}
+
+I420VideoFrame* FrameRing::Peek(int index) const {
+  assert(index < size_.AcquireLoad());
+  return frames_[(pop_index_ + index) % capacity_];
+}
+
+int FrameRing::Size() const {
+  return size_.AcquireLoad();
+}
+
 VideoFramesQueue::VideoFramesQueue()
-    : _incomingFrames(),
+    : _incomingFrames(KMaxNumberOfFrames),
+      _emptyFrames(KMaxNumberOfFrames),
+      _numFrames(0),
       _renderDelayMs(10)
 {
 }
 
 VideoFramesQueue::~VideoFramesQueue() {
-  while (!_incomingFrames.Empty()) {
-    ListItem* item = _incomingFrames.First();
-    if (item) {
-      I420VideoFrame* ptrFrame = static_cast<I420VideoFrame*>(item->GetItem());
-      assert(ptrFrame != NULL);
-      delete ptrFrame;
-    }
-    _incomingFrames.Erase(item);
+  while (I420VideoFrame* ptrFrame = _incomingFrames.Pop()) {
+    delete ptrFrame;
   }
-  while (!_emptyFrames.Empty()) {
-    ListItem* item = _emptyFrames.First();
-    if (item) {
-      I420VideoFrame* ptrFrame =
-        static_cast<I420VideoFrame*>(item->GetItem());
-      assert(ptrFrame != NULL);
-      delete ptrFrame;
-    }
-    _emptyFrames.Erase(item);
+  while (I420VideoFrame* ptrFrame = _emptyFrames.Pop()) {
+    delete ptrFrame;
   }
 }
 
 WebRtc_Word32 VideoFramesQueue::AddFrame(const I420VideoFrame& newFrame) {
-  I420VideoFrame* ptrFrameToAdd = NULL;
   // Try to re-use a VideoFrame. Only allocate new memory if it is necessary.
-  if (!_emptyFrames.Empty()) {
-    ListItem* item = _emptyFrames.First();
-    if (item) {
-      ptrFrameToAdd = static_cast<I420VideoFrame*>(item->GetItem());
-      _emptyFrames.Erase(item);
-    }
-  }
+  I420VideoFrame* ptrFrameToAdd = _emptyFrames.Pop();
   if (!ptrFrameToAdd) {
-    if (_emptyFrames.GetSize() + _incomingFrames.GetSize() >
-        KMaxNumberOfFrames) {
+    if (_numFrames >= KMaxNumberOfFrames) {
       WEBRTC_TRACE(kTraceWarning, kTraceVideoRenderer, -1,
                    "%s: too many frames, limit: %d", __FUNCTION__,
                    KMaxNumberOfFrames);
@@ -67,8 +91,7 @@ WebRtc_Word32 VideoFramesQueue::AddFrame(const I420VideoFrame& newFrame) {
     }
 
     WEBRTC_TRACE(kTraceMemory, kTraceVideoRenderer, -1,
-                 "%s: allocating buffer %d", __FUNCTION__,
-                 _emptyFrames.GetSize() + _incomingFrames.GetSize());
+                 "%s: allocating buffer %d", __FUNCTION__, _numFrames);
 
     ptrFrameToAdd = new I420VideoFrame();
     if (!ptrFrameToAdd) {
@@ -76,9 +99,11 @@ WebRtc_Word32 VideoFramesQueue::AddFrame(const I420VideoFrame& newFrame) {
                    "%s: could not create new frame for", __FUNCTION__);
       return -1;
     }
+    ++_numFrames;
   }
   ptrFrameToAdd->CopyFrame(newFrame);
-  _incomingFrames.PushBack(ptrFrameToAdd);
+  // Both rings can hold all frames, so this can't fail.
+  _incomingFrames.Push(ptrFrameToAdd);
   return 0;
 }
 
@@ -87,27 +112,26 @@ WebRtc_Word32 VideoFramesQueue::AddFrame(const I420VideoFrame& newFrame) {
 // Note _incomingFrames is sorted so that the oldest frame is first.
 // Recycle all frames that are older than the most recent frame.
 I420VideoFrame* VideoFramesQueue::FrameToRecord() {
-  I420VideoFrame* ptrRenderFrame = NULL;
-  ListItem* item = _incomingFrames.First();
-  while(item) {
-    I420VideoFrame* ptrOldestFrameInList =
-        static_cast<I420VideoFrame*>(item->GetItem());
-    if (ptrOldestFrameInList->render_time_ms() <=
-        TickTime::MillisecondTimestamp() + _renderDelayMs) {
-      if (ptrRenderFrame) {
-        // List is traversed beginning to end. If ptrRenderFrame is not
-        // NULL it must be the first, and thus oldest, VideoFrame in the
-        // queue. It can be recycled.
-        ReturnFrame(ptrRenderFrame);
-        _incomingFrames.PopFront();
-      }
-      item = _incomingFrames.Next(item);
-      ptrRenderFrame = ptrOldestFrameInList;
-    } else {
+  const int numFrames = _incomingFrames.Size();
+  if (numFrames == 0) {
+    return NULL;
+  }
+  const WebRtc_Word64 dueTimeMs =
+      TickTime::MillisecondTimestamp() + _renderDelayMs;
+  // The oldest frame is kept in the ring while it's being recorded.
+  I420VideoFrame* ptrRenderFrame = _incomingFrames.Peek(0);
+  if (ptrRenderFrame->render_time_ms() > dueTimeMs) {
+    return NULL;
+  }
+  for (int i = 1; i < numFrames; ++i) {
+    I420VideoFrame* ptrNextFrame = _incomingFrames.Peek(1);
+    if (ptrNextFrame->render_time_ms() > dueTimeMs) {
       // All VideoFrames following this one will be even newer. No match
       // will be found.
       break;
     }
+    ReturnFrame(_incomingFrames.Pop());
+    ptrRenderFrame = ptrNextFrame;
   }
   return ptrRenderFrame;
 }
@@ -118,7 +142,7 @@ WebRtc_Word32 VideoFramesQueue::ReturnFrame(I420VideoFrame* ptrOldFrame) {
   ptrOldFrame->set_height(0);
   ptrOldFrame->set_render_time_ms(0);
   ptrOldFrame->ResetSize();
-  _emptyFrames.PushBack(ptrOldFrame);
+  _emptyFrames.Push(ptrOldFrame);
   return 0;
 }
 
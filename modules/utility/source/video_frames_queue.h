@@ -13,13 +13,47 @@
 
 #ifdef WEBRTC_MODULE_UTILITY_VIDEO
 
+#include "atomic32.h"
 #include "common_video/interface/i420_video_frame.h"
 #include "engine_configurations.h"
-#include "list_wrapper.h"
+#include "scoped_ptr.h"
 #include "typedefs.h"
 
 namespace webrtc {
 
+// Bounded ring of frame pointers for one producer and one consumer thread.
+// Push() may be called on one thread while another thread calls Peek() and
+// Pop(), without locking.
+class FrameRing {
+ public:
+  explicit FrameRing(int capacity);
+  ~FrameRing();
+
+  // Returns false if the ring is full.
+  bool Push(I420VideoFrame* frame);
+  // Returns NULL if the ring is empty.
+  I420VideoFrame* Pop();
+  // Returns the frame |index| frames from the oldest one. |index| must be
+  // lower than Size().
+  I420VideoFrame* Peek(int index) const;
+  int Size() const;
+
+ private:
+  const int capacity_;
+  scoped_array<I420VideoFrame*> frames_;
+  // Only used by the producer.
+  int push_index_;
+  // Only used by the consumer.
+  int pop_index_;
+  // Number of frames in the ring. Updated with a barrier after a frame has
+  // been written or read and read with AcquireLoad(), which publishes the
+  // slot to the other thread.
+  Atomic32 size_;
+};
+
+// Queue of frames to record. AddFrame() is called on the thread delivering
+// the frames and FrameToRecord() on the recording thread. Neither blocks the
+// other.
 class VideoFramesQueue {
  public:
   VideoFramesQueue();
@@ -30,7 +64,8 @@ class VideoFramesQueue {
 
   // Return the most current frame. I.e. the frame with the highest
   // VideoFrame::RenderTimeMs() that is lower than
-  // TickTime::MillisecondTimestamp().
+  // TickTime::MillisecondTimestamp(). The frame is owned by the queue until
+  // the next call.
   I420VideoFrame* FrameToRecord();
 
   // Set the render delay estimate to renderDelay ms.
@@ -46,12 +81,13 @@ class VideoFramesQueue {
   // 300 frames correspond to 10 seconds worth of frames at 30 fps.
   enum {KMaxNumberOfFrames = 300};
 
-  // List of VideoFrame pointers. The list is sorted in the order of when the
-  // VideoFrame was inserted into the list. The first VideoFrame in the list
+  // Frames in the order they were added. The first VideoFrame in the ring
   // was inserted first.
-  ListWrapper    _incomingFrames;
-  // A list of frames that are free to be re-used.
-  ListWrapper    _emptyFrames;
+  FrameRing      _incomingFrames;
+  // Frames that are free to be re-used, returned by the recording thread.
+  FrameRing      _emptyFrames;
+  // Number of frames allocated by AddFrame().
+  int            _numFrames;
 
   // Estimated render delay.
   WebRtc_UWord32 _renderDelayMs;
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/utility/source/video_frames_queue.h"
+
+#include "gtest/gtest.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/sleep.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kCapacity = 8;
+const int kNumFrames = 1000;
+
+struct ProducerParams {
+  FrameRing* ring;
+  I420VideoFrame* frames;
+};
+
+// Writes each frame before it's pushed, the consumer checks that it sees
+// what was written.
+bool ProduceFrames(void* obj) {
+  ProducerParams* params = static_cast<ProducerParams*>(obj);
+  for (int i = 0; i < kNumFrames; ++i) {
+    params->frames[i].set_timestamp(i);
+    while (!params->ring->Push(&params->frames[i])) {
+      SleepMs(0);
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(FrameRingTest, KeepsOrderAndCapacity) {
+  FrameRing ring(kCapacity);
+  I420VideoFrame frames[kCapacity + 1];
+  EXPECT_TRUE(ring.Pop() == NULL);
+  for (int i = 0; i < kCapacity; ++i) {
+    EXPECT_TRUE(ring.Push(&frames[i]));
+  }
+  EXPECT_FALSE(ring.Push(&frames[kCapacity]));
+  EXPECT_EQ(kCapacity, ring.Size());
+  EXPECT_EQ(&frames[0], ring.Peek(0));
+  EXPECT_EQ(&frames[kCapacity - 1], ring.Peek(kCapacity - 1));
+
+  // Wraps around.
+  EXPECT_EQ(&frames[0], ring.Pop());
+  EXPECT_TRUE(ring.Push(&frames[kCapacity]));
+  for (int i = 1; i <= kCapacity; ++i) {
+    EXPECT_EQ(&frames[i], ring.Pop());
+  }
+  EXPECT_EQ(0, ring.Size());
+  EXPECT_TRUE(ring.Pop() == NULL);
+}
+
+TEST(FrameRingTest, PassesFramesBetweenThreads) {
+  FrameRing ring(kCapacity);
+  scoped_array<I420VideoFrame> frames(new I420VideoFrame[kNumFrames]);
+  ProducerParams params = { &ring, frames.get() };
+  scoped_ptr<ThreadWrapper> producer(ThreadWrapper::CreateThread(
+      ProduceFrames, &params, kNormalPriority, "FrameRingTest"));
+  unsigned int id = 0;
+  ASSERT_TRUE(producer->Start(id));
+
+  int received = 0;
+  while (received < kNumFrames) {
+    I420VideoFrame* frame = ring.Pop();
+    if (!frame) {
+      SleepMs(0);
+      continue;
+    }
+    ASSERT_EQ(&frames[received], frame);
+    ASSERT_EQ(static_cast<uint32_t>(received), frame->timestamp());
+    ++received;
+  }
+  EXPECT_TRUE(producer->Stop());
+  EXPECT_EQ(0, ring.Size());
+}
+
+}  // namespace webrtc
@@ -150,6 +150,16 @@ class VideoCaptureModule: public RefCountedModule {
   virtual WebRtc_Word32 EnableFrameRateCallback(const bool enable) = 0;
   virtual WebRtc_Word32 EnableNoPictureAlarm(const bool enable) = 0;
 
+  // Delivers frames the device captures as MJPEG to
+  // VideoCaptureDataCallback::OnIncomingCapturedMjpegFrame() without decoding
+  // them. Frames the callback doesn't take are decoded as before. Devices
+  // that can capture MJPEG prefer it from the next StartCapture().
+  virtual WebRtc_Word32 EnableMjpegPassthrough(const bool enable) = 0;
+
+  // Gets the frame buffer counters since the module was created.
+  virtual WebRtc_Word32 GetBufferStatistics(
+      VideoCaptureBufferStatistics& statistics) = 0;
+
 protected:
   virtual ~VideoCaptureModule() {};
 };
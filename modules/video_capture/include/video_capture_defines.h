@@ -111,6 +111,26 @@ struct VideoFrameI420
   unsigned short height;
 };
 
+// Counters of the frame buffer handling in a capture module.
+struct VideoCaptureBufferStatistics
+{
+  VideoCaptureBufferStatistics() {
+    frames = 0;
+    allocations = 0;
+    copies = 0;
+    passthrough = 0;
+  }
+
+  // Raw frames converted or copied for delivery to the data callback.
+  WebRtc_UWord32 frames;
+  // Times a frame buffer had to be (re)allocated.
+  WebRtc_UWord32 allocations;
+  // Frames copied into a frame buffer rather than converted into it.
+  WebRtc_UWord32 copies;
+  // MJPEG frames delivered without decoding.
+  WebRtc_UWord32 passthrough;
+};
+
 /* External Capture interface. Returned by Create
  and implemented by the capture module.
  */
@@ -138,6 +158,21 @@ public:
                                                 VideoCodecType codecType) = 0;
     virtual void OnCaptureDelayChanged(const WebRtc_Word32 id,
                                        const WebRtc_Word32 delay) = 0;
+    // Receives the frames of a device capturing MJPEG instead of
+    // OnIncomingCapturedFrame(), when VideoCaptureModule::
+    // EnableMjpegPassthrough() is enabled. |mjpeg| is only valid during the
+    // call. Returns false if the frame isn't taken, it's then decoded and
+    // delivered to OnIncomingCapturedFrame(). Only callbacks that override
+    // this take MJPEG.
+    virtual bool OnIncomingCapturedMjpegFrame(const WebRtc_Word32 id,
+                                              const WebRtc_UWord8* mjpeg,
+                                              const WebRtc_Word32 length,
+                                              const WebRtc_Word32 width,
+                                              const WebRtc_Word32 height,
+                                              const WebRtc_Word64 renderTimeMs)
+    {
+        return false;
+    }
 protected:
     virtual ~VideoCaptureDataCallback(){}
 };
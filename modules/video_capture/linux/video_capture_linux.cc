@@ -21,6 +21,7 @@
 #include <iostream>
 #include <new>
 
+#include "aligned_malloc.h"
 #include "ref_count.h"
 #include "trace.h"
 #include "thread_wrapper.h"
@@ -58,8 +59,11 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2(const WebRtc_Word32 id)
       _currentFrameRate(-1), 
       _captureStarted(false),
       _captureVideoType(kVideoI420), 
-      _pool(NULL)
+      _frameSize(0),
+      _pool(NULL),
+      _userPointerMode(false)
 {
+    memset(_userBuffers, 0, sizeof(_userBuffers));
 }
 
 WebRtc_Word32 VideoCaptureModuleV4L2::Init(const char* deviceUniqueIdUTF8)
@@ -119,6 +123,8 @@ VideoCaptureModuleV4L2::~VideoCaptureModuleV4L2()
     }
     if (_deviceFd != -1)
       close(_deviceFd);
+    for (int i = 0; i < kNoOfV4L2Bufffers; i++)
+        AlignedFree(_userBuffers[i].start);
 }
 
 WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
@@ -143,7 +149,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
     char device[20];
     sprintf(device, "/dev/video%d", (int) _deviceId);
 
-    if ((_deviceFd = open(device, O_RDWR | O_NONBLOCK, 0)) < 0)
+    if ((_deviceFd = OpenDevice(device)) < 0)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                    "error in opening %s errono = %d", device, errno);
@@ -151,11 +157,13 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
     }
 
     // Supported video formats in preferred order.
-    // If the requested resolution is larger than VGA, we prefer MJPEG. Go for
-    // I420 otherwise.
+    // If the requested resolution is larger than VGA, or if MJPEG frames are
+    // passed through without decoding, we prefer MJPEG. Go for I420
+    // otherwise.
     const int nFormats = 4;
     unsigned int fmts[nFormats];
-    if (capability.width > 640 || capability.height > 480) {
+    if (capability.width > 640 || capability.height > 480 ||
+        MjpegPassthrough()) {
         fmts[0] = V4L2_PIX_FMT_MJPEG;
         fmts[1] = V4L2_PIX_FMT_YUV420;
         fmts[2] = V4L2_PIX_FMT_YUYV;
@@ -175,7 +183,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
     fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceVideoCapture, _id,
                  "Video Capture enumerats supported image formats:");
-    while (ioctl(_deviceFd, VIDIOC_ENUM_FMT, &fmt) == 0) {
+    while (DeviceIoctl(VIDIOC_ENUM_FMT, &fmt) == 0) {
         WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceVideoCapture, _id,
                      "  { pixelformat = %c%c%c%c, description = '%s' }",
                      fmt.pixelformat & 0xFF, (fmt.pixelformat>>8) & 0xFF,
@@ -219,7 +227,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
         _captureVideoType = kVideoMJPEG;
 
     //set format and frame size now
-    if (ioctl(_deviceFd, VIDIOC_S_FMT, &video_fmt) < 0)
+    if (DeviceIoctl(VIDIOC_S_FMT, &video_fmt) < 0)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                    "error in VIDIOC_S_FMT, errno = %d", errno);
@@ -229,6 +237,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
     // initialize current width and height
     _currentWidth = video_fmt.fmt.pix.width;
     _currentHeight = video_fmt.fmt.pix.height;
+    _frameSize = video_fmt.fmt.pix.sizeimage;
     _captureDelay = 120;
 
     // Trying to set frame rate, before check driver capability.
@@ -236,7 +245,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
     struct v4l2_streamparm streamparms;
     memset(&streamparms, 0, sizeof(streamparms));
     streamparms.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (ioctl(_deviceFd, VIDIOC_G_PARM, &streamparms) < 0) {
+    if (DeviceIoctl(VIDIOC_G_PARM, &streamparms) < 0) {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                    "error in VIDIOC_G_PARM errno = %d", errno);
         driver_framerate_support = false;
@@ -249,7 +258,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
         streamparms.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
         streamparms.parm.capture.timeperframe.numerator = 1;
         streamparms.parm.capture.timeperframe.denominator = capability.maxFPS;
-        if (ioctl(_deviceFd, VIDIOC_S_PARM, &streamparms) < 0) {
+        if (DeviceIoctl(VIDIOC_S_PARM, &streamparms) < 0) {
           WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                    "Failed to set the framerate. errno=%d", errno);
           driver_framerate_support = false;
@@ -287,7 +296,7 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StartCapture(
     // Needed to start UVC camera - from the uvcview application
     enum v4l2_buf_type type;
     type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (ioctl(_deviceFd, VIDIOC_STREAMON, &type) == -1)
+    if (DeviceIoctl(VIDIOC_STREAMON, &type) == -1)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                      "Failed to turn on stream");
@@ -329,9 +338,91 @@ WebRtc_Word32 VideoCaptureModuleV4L2::StopCapture()
     return 0;
 }
 
+int VideoCaptureModuleV4L2::OpenDevice(const char* deviceName)
+{
+    return open(deviceName, O_RDWR | O_NONBLOCK, 0);
+}
+
+int VideoCaptureModuleV4L2::DeviceIoctl(unsigned long request, void* arg)
+{
+    return ioctl(_deviceFd, request, arg);
+}
+
 //critical section protected by the caller
 
 bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
+{
+    if (AllocateUserPointerBuffers())
+    {
+        return true;
+    }
+    WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceVideoCapture, _id,
+                 "User pointer buffers are not supported, mapping buffers");
+    return AllocateMappedBuffers();
+}
+
+bool VideoCaptureModuleV4L2::AllocateUserPointerBuffers()
+{
+    struct v4l2_requestbuffers rbuffer;
+    memset(&rbuffer, 0, sizeof(v4l2_requestbuffers));
+
+    rbuffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    rbuffer.memory = V4L2_MEMORY_USERPTR;
+    rbuffer.count = kNoOfV4L2Bufffers;
+
+    if (DeviceIoctl(VIDIOC_REQBUFS, &rbuffer) < 0)
+    {
+        return false;
+    }
+
+    if (rbuffer.count > kNoOfV4L2Bufffers)
+        rbuffer.count = kNoOfV4L2Bufffers;
+
+    // Large enough for the frame in I420 as well, so that the buffers can be
+    // kept when the capture format changes.
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t bufferSize = CalcBufferSize(kI420, _currentWidth, _currentHeight);
+    if (bufferSize < _frameSize)
+        bufferSize = _frameSize;
+    bufferSize = (bufferSize + pageSize - 1) & ~(pageSize - 1);
+
+    for (unsigned int i = 0; i < rbuffer.count; i++)
+    {
+        if (_userBuffers[i].length < bufferSize)
+        {
+            AlignedFree(_userBuffers[i].start);
+            _userBuffers[i].start = AlignedMalloc(bufferSize, pageSize);
+            _userBuffers[i].length = _userBuffers[i].start ? bufferSize : 0;
+        }
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(v4l2_buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_USERPTR;
+        buffer.index = i;
+        buffer.m.userptr = reinterpret_cast<unsigned long>(
+            _userBuffers[i].start);
+        buffer.length = _userBuffers[i].length;
+
+        if (!_userBuffers[i].start || DeviceIoctl(VIDIOC_QBUF, &buffer) < 0)
+        {
+            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture,
+                         _id, "Could not queue user buffer. errno = %d",
+                         errno);
+            // Release the queued buffers before mapping device buffers.
+            rbuffer.count = 0;
+            DeviceIoctl(VIDIOC_REQBUFS, &rbuffer);
+            return false;
+        }
+    }
+
+    _buffersAllocatedByDevice = rbuffer.count;
+    _pool = new Buffer[rbuffer.count];
+    memcpy(_pool, _userBuffers, rbuffer.count * sizeof(Buffer));
+    _userPointerMode = true;
+    return true;
+}
+
+bool VideoCaptureModuleV4L2::AllocateMappedBuffers()
 {
     struct v4l2_requestbuffers rbuffer;
     memset(&rbuffer, 0, sizeof(v4l2_requestbuffers));
@@ -340,7 +431,7 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
     rbuffer.memory = V4L2_MEMORY_MMAP;
     rbuffer.count = kNoOfV4L2Bufffers;
 
-    if (ioctl(_deviceFd, VIDIOC_REQBUFS, &rbuffer) < 0)
+    if (DeviceIoctl(VIDIOC_REQBUFS, &rbuffer) < 0)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                    "Could not get buffers from device. errno = %d", errno);
@@ -351,6 +442,7 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
         rbuffer.count = kNoOfV4L2Bufffers;
 
     _buffersAllocatedByDevice = rbuffer.count;
+    _userPointerMode = false;
 
     //Map the buffers
     _pool = new Buffer[rbuffer.count];
@@ -363,7 +455,7 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
         buffer.memory = V4L2_MEMORY_MMAP;
         buffer.index = i;
 
-        if (ioctl(_deviceFd, VIDIOC_QUERYBUF, &buffer) < 0)
+        if (DeviceIoctl(VIDIOC_QUERYBUF, &buffer) < 0)
         {
             return false;
         }
@@ -380,7 +472,7 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
 
         _pool[i].length = buffer.length;
 
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0)
+        if (DeviceIoctl(VIDIOC_QBUF, &buffer) < 0)
         {
             return false;
         }
@@ -390,16 +482,20 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
 
 bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers()
 {
-    // unmap buffers
-    for (int i = 0; i < _buffersAllocatedByDevice; i++)
-        munmap(_pool[i].start, _pool[i].length);
+    // unmap buffers, user buffers are kept for the next capture
+    if (!_userPointerMode)
+    {
+        for (int i = 0; i < _buffersAllocatedByDevice; i++)
+            munmap(_pool[i].start, _pool[i].length);
+    }
 
     delete[] _pool;
+    _pool = NULL;
 
     // turn off stream
     enum v4l2_buf_type type;
     type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (ioctl(_deviceFd, VIDIOC_STREAMOFF, &type) < 0)
+    if (DeviceIoctl(VIDIOC_STREAMOFF, &type) < 0)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
                    "VIDIOC_STREAMOFF error. errno: %d", errno);
@@ -455,9 +551,9 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
         struct v4l2_buffer buf;
         memset(&buf, 0, sizeof(struct v4l2_buffer));
         buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf.memory = V4L2_MEMORY_MMAP;
+        buf.memory = _userPointerMode ? V4L2_MEMORY_USERPTR : V4L2_MEMORY_MMAP;
         // dequeue a buffer - repeat until dequeued properly!
-        while (ioctl(_deviceFd, VIDIOC_DQBUF, &buf) < 0)
+        while (DeviceIoctl(VIDIOC_DQBUF, &buf) < 0)
         {
             if (errno != EINTR)
             {
@@ -476,7 +572,7 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
         IncomingFrame((unsigned char*) _pool[buf.index].start,
                       buf.bytesused, frameInfo);
         // enqueue the buffer again
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
+        if (DeviceIoctl(VIDIOC_QBUF, &buf) == -1)
         {
             WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
                        "Failed to enqueue capture buffer");
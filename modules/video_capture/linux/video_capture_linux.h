@@ -31,12 +31,19 @@ public:
     virtual bool CaptureStarted();
     virtual WebRtc_Word32 CaptureSettings(VideoCaptureCapability& settings);
 
+protected:
+    // Device access, overridden by tests to fake a device.
+    virtual int OpenDevice(const char* deviceName);
+    virtual int DeviceIoctl(unsigned long request, void* arg);
+
 private:
     enum {kNoOfV4L2Bufffers=4};
 
     static bool CaptureThread(void*);
     bool CaptureProcess();
     bool AllocateVideoBuffers();
+    bool AllocateUserPointerBuffers();
+    bool AllocateMappedBuffers();
     bool DeAllocateVideoBuffers();
 
     ThreadWrapper* _captureThread;
@@ -51,12 +58,21 @@ private:
     WebRtc_Word32 _currentFrameRate;
     bool _captureStarted;
     RawVideoType _captureVideoType;
+    // Size of a frame in the capture format, as reported by the device.
+    WebRtc_UWord32 _frameSize;
     struct Buffer
     {
         void *start;
         size_t length;
     };
     Buffer *_pool;
+    // True if the device captures into _userBuffers rather than into buffers
+    // mapped from the device.
+    bool _userPointerMode;
+    // Capture buffers allocated by us, kept between captures. The device
+    // writes to them directly, and unlike mapped device memory they are
+    // cached, which makes converting and decoding the frames faster.
+    Buffer _userBuffers[kNoOfV4L2Bufffers];
 };
 } // namespace videocapturemodule
 } // namespace webrtc
@@ -0,0 +1,326 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_capture/linux/video_capture_linux.h"
+
+#include <errno.h>
+#include <linux/videodev2.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <deque>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/ref_count.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/scoped_refptr.h"
+#include "system_wrappers/interface/sleep.h"
+#include "system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace videocapturemodule {
+
+namespace {
+
+const int kWidth = 1280;
+const int kHeight = 720;
+const int kTimeoutMs = 5000;
+const int kMjpegFrameLength = 1000;
+
+// Fakes a V4L2 device that supports one pixel format. The test thread makes
+// the device produce a frame with ProduceFrame(), which is written to the
+// next queued buffer like a driver would. A pipe makes the device readable.
+class FakeV4L2Capture : public VideoCaptureModuleV4L2 {
+ public:
+  FakeV4L2Capture(unsigned int pixel_format, bool user_pointers)
+      : VideoCaptureModuleV4L2(0),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        pixel_format_(pixel_format),
+        user_pointers_(user_pointers),
+        requested_mmap_(false),
+        produced_frames_(0) {
+    pipe_[0] = -1;
+    pipe_[1] = -1;
+  }
+  virtual ~FakeV4L2Capture() {
+    // Stops the capture thread before the fake device is destroyed.
+    StopCapture();
+    if (pipe_[1] != -1)
+      close(pipe_[1]);
+  }
+
+  void ProduceFrame() {
+    // Frames with the same capture time as the previous frame are dropped.
+    SleepMs(1);
+    CriticalSectionScoped cs(crit_.get());
+    ++produced_frames_;
+    const char c = 0;
+    EXPECT_EQ(1, write(pipe_[1], &c, 1));
+  }
+
+  bool requested_mmap() {
+    CriticalSectionScoped cs(crit_.get());
+    return requested_mmap_;
+  }
+
+  // The buffers the module has queued since it started.
+  std::set<const void*> user_buffers() {
+    CriticalSectionScoped cs(crit_.get());
+    return user_buffers_;
+  }
+
+  // The content of frame |n| in the buffer.
+  static WebRtc_UWord8 FrameByte(int n, int i) {
+    return static_cast<WebRtc_UWord8>(n * 7 + i / 1000);
+  }
+
+ protected:
+  virtual int OpenDevice(const char* deviceName) {
+    if (pipe(pipe_) != 0)
+      return -1;
+    return pipe_[0];
+  }
+
+  virtual int DeviceIoctl(unsigned long request, void* arg) {
+    CriticalSectionScoped cs(crit_.get());
+    switch (request) {
+      case VIDIOC_ENUM_FMT: {
+        v4l2_fmtdesc* fmt = static_cast<v4l2_fmtdesc*>(arg);
+        if (fmt->index != 0)
+          return Fail(EINVAL);
+        fmt->pixelformat = pixel_format_;
+        return 0;
+      }
+      case VIDIOC_S_FMT: {
+        v4l2_format* fmt = static_cast<v4l2_format*>(arg);
+        if (fmt->fmt.pix.pixelformat != pixel_format_)
+          return Fail(EINVAL);
+        fmt->fmt.pix.sizeimage = pixel_format_ == V4L2_PIX_FMT_YUV420 ?
+            fmt->fmt.pix.width * fmt->fmt.pix.height * 3 / 2 :
+            fmt->fmt.pix.width * fmt->fmt.pix.height;
+        size_image_ = fmt->fmt.pix.sizeimage;
+        return 0;
+      }
+      case VIDIOC_REQBUFS: {
+        v4l2_requestbuffers* rbuffer = static_cast<v4l2_requestbuffers*>(arg);
+        if (rbuffer->memory == V4L2_MEMORY_MMAP) {
+          requested_mmap_ = true;
+          return 0;
+        }
+        if (!user_pointers_)
+          return Fail(EINVAL);
+        queued_.clear();
+        return 0;
+      }
+      case VIDIOC_QBUF: {
+        v4l2_buffer* buffer = static_cast<v4l2_buffer*>(arg);
+        if (buffer->memory != V4L2_MEMORY_USERPTR ||
+            buffer->length < size_image_)
+          return Fail(EINVAL);
+        queued_.push_back(*buffer);
+        user_buffers_.insert(reinterpret_cast<void*>(buffer->m.userptr));
+        return 0;
+      }
+      case VIDIOC_DQBUF: {
+        char c;
+        if (queued_.empty() || read(pipe_[0], &c, 1) != 1)
+          return Fail(EAGAIN);
+        v4l2_buffer* buffer = static_cast<v4l2_buffer*>(arg);
+        *buffer = queued_.front();
+        queued_.pop_front();
+        WebRtc_UWord8* data =
+            reinterpret_cast<WebRtc_UWord8*>(buffer->m.userptr);
+        buffer->bytesused = pixel_format_ == V4L2_PIX_FMT_YUV420 ?
+            size_image_ : kMjpegFrameLength;
+        for (unsigned int i = 0; i < buffer->bytesused; ++i)
+          data[i] = FrameByte(produced_frames_, i);
+        return 0;
+      }
+      case VIDIOC_STREAMON:
+      case VIDIOC_STREAMOFF:
+        return 0;
+      default:
+        // No frame rate control and no mapped buffers.
+        return Fail(EINVAL);
+    }
+  }
+
+ private:
+  static int Fail(int error) {
+    errno = error;
+    return -1;
+  }
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  const unsigned int pixel_format_;
+  const bool user_pointers_;
+  int pipe_[2];
+  unsigned int size_image_;
+  bool requested_mmap_;
+  int produced_frames_;
+  std::deque<v4l2_buffer> queued_;
+  std::set<const void*> user_buffers_;
+};
+
+class FrameReceiver : public VideoCaptureDataCallback {
+ public:
+  FrameReceiver()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        frames_(0),
+        mjpeg_frames_(0),
+        last_mjpeg_(NULL) {}
+
+  virtual void OnIncomingCapturedFrame(const WebRtc_Word32 id,
+                                       I420VideoFrame& video_frame) {
+    CriticalSectionScoped cs(crit_.get());
+    ++frames_;
+    last_frame_.CopyFrame(video_frame);
+  }
+  virtual void OnIncomingCapturedEncodedFrame(const WebRtc_Word32 id,
+                                              VideoFrame& video_frame,
+                                              VideoCodecType codec_type) {
+    ADD_FAILURE() << "Unexpected encoded frame";
+  }
+  virtual void OnCaptureDelayChanged(const WebRtc_Word32 id,
+                                     const WebRtc_Word32 delay) {}
+  virtual bool OnIncomingCapturedMjpegFrame(const WebRtc_Word32 id,
+                                            const WebRtc_UWord8* mjpeg,
+                                            const WebRtc_Word32 length,
+                                            const WebRtc_Word32 width,
+                                            const WebRtc_Word32 height,
+                                            const WebRtc_Word64 render_time_ms) {
+    CriticalSectionScoped cs(crit_.get());
+    ++mjpeg_frames_;
+    EXPECT_EQ(kWidth, width);
+    EXPECT_EQ(kHeight, height);
+    last_mjpeg_ = mjpeg;
+    last_mjpeg_data_.assign(mjpeg, mjpeg + length);
+    return true;
+  }
+
+  bool WaitForFrames(int frames, int mjpeg_frames) {
+    const WebRtc_Word64 start = TickTime::MillisecondTimestamp();
+    while (TickTime::MillisecondTimestamp() - start < kTimeoutMs) {
+      {
+        CriticalSectionScoped cs(crit_.get());
+        if (frames_ >= frames && mjpeg_frames_ >= mjpeg_frames)
+          return true;
+      }
+      SleepMs(5);
+    }
+    return false;
+  }
+
+  int frames() {
+    CriticalSectionScoped cs(crit_.get());
+    return frames_;
+  }
+  const WebRtc_UWord8* last_mjpeg() {
+    CriticalSectionScoped cs(crit_.get());
+    return last_mjpeg_;
+  }
+  std::vector<WebRtc_UWord8> last_mjpeg_data() {
+    CriticalSectionScoped cs(crit_.get());
+    return last_mjpeg_data_;
+  }
+  I420VideoFrame& last_frame() { return last_frame_; }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  int frames_;
+  int mjpeg_frames_;
+  const WebRtc_UWord8* last_mjpeg_;
+  std::vector<WebRtc_UWord8> last_mjpeg_data_;
+  I420VideoFrame last_frame_;
+};
+
+VideoCaptureCapability Capability() {
+  VideoCaptureCapability capability;
+  capability.width = kWidth;
+  capability.height = kHeight;
+  capability.maxFPS = 30;
+  return capability;
+}
+
+TEST(VideoCaptureLinuxTest, CapturesIntoUserBuffers) {
+  scoped_refptr<FakeV4L2Capture> capture(
+      new RefCountImpl<FakeV4L2Capture>(V4L2_PIX_FMT_YUV420, true));
+  FrameReceiver receiver;
+  ASSERT_EQ(0, capture->RegisterCaptureDataCallback(receiver));
+  ASSERT_EQ(0, capture->StartCapture(Capability()));
+  capture->ProduceFrame();
+  ASSERT_TRUE(receiver.WaitForFrames(1, 0));
+  EXPECT_FALSE(capture->requested_mmap());
+
+  // The frame the device wrote to the buffer is delivered.
+  const I420VideoFrame& frame = receiver.last_frame();
+  EXPECT_EQ(kWidth, frame.width());
+  EXPECT_EQ(kHeight, frame.height());
+  EXPECT_EQ(FakeV4L2Capture::FrameByte(1, 0), frame.buffer(kYPlane)[0]);
+  const int last_v = (kWidth / 2) * (kHeight / 2) - 1;
+  EXPECT_EQ(FakeV4L2Capture::FrameByte(1, kWidth * kHeight * 3 / 2 - 1),
+            frame.buffer(kVPlane)[last_v]);
+
+  // The buffers are kept when the capture is restarted.
+  const std::set<const void*> buffers = capture->user_buffers();
+  EXPECT_EQ(4u, buffers.size());
+  EXPECT_EQ(0, capture->StopCapture());
+  ASSERT_EQ(0, capture->StartCapture(Capability()));
+  capture->ProduceFrame();
+  ASSERT_TRUE(receiver.WaitForFrames(2, 0));
+  EXPECT_TRUE(buffers == capture->user_buffers());
+  EXPECT_EQ(0, capture->StopCapture());
+  EXPECT_EQ(0, capture->DeRegisterCaptureDataCallback());
+}
+
+TEST(VideoCaptureLinuxTest, PassesMjpegThroughFromUserBuffers) {
+  scoped_refptr<FakeV4L2Capture> capture(
+      new RefCountImpl<FakeV4L2Capture>(V4L2_PIX_FMT_MJPEG, true));
+  FrameReceiver receiver;
+  ASSERT_EQ(0, capture->RegisterCaptureDataCallback(receiver));
+  ASSERT_EQ(0, capture->EnableMjpegPassthrough(true));
+  ASSERT_EQ(0, capture->StartCapture(Capability()));
+  for (int i = 0; i < 3; ++i) {
+    capture->ProduceFrame();
+    ASSERT_TRUE(receiver.WaitForFrames(0, i + 1));
+  }
+  EXPECT_EQ(0, capture->StopCapture());
+
+  // The frame is delivered from the capture buffer, without decoding.
+  EXPECT_EQ(0, receiver.frames());
+  EXPECT_EQ(1u, capture->user_buffers().count(receiver.last_mjpeg()));
+  const std::vector<WebRtc_UWord8> mjpeg = receiver.last_mjpeg_data();
+  ASSERT_EQ(static_cast<size_t>(kMjpegFrameLength), mjpeg.size());
+  for (int i = 0; i < kMjpegFrameLength; ++i)
+    ASSERT_EQ(FakeV4L2Capture::FrameByte(3, i), mjpeg[i]);
+
+  VideoCaptureBufferStatistics statistics;
+  EXPECT_EQ(0, capture->GetBufferStatistics(statistics));
+  EXPECT_EQ(3u, statistics.passthrough);
+  EXPECT_EQ(0u, statistics.frames);
+  EXPECT_EQ(0, capture->DeRegisterCaptureDataCallback());
+}
+
+TEST(VideoCaptureLinuxTest, MapsBuffersWithoutUserPointerSupport) {
+  scoped_refptr<FakeV4L2Capture> capture(
+      new RefCountImpl<FakeV4L2Capture>(V4L2_PIX_FMT_YUV420, false));
+  // The fake device can't map buffers either.
+  EXPECT_EQ(-1, capture->StartCapture(Capability()));
+  EXPECT_TRUE(capture->requested_mmap());
+  EXPECT_TRUE(capture->user_buffers().empty());
+}
+
+}  // namespace
+
+}  // namespace videocapturemodule
+}  // namespace webrtc
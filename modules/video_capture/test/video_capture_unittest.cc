@@ -15,6 +15,7 @@
 #include "webrtc/modules/video_capture/include/video_capture.h"
 #include "webrtc/modules/video_capture/include/video_capture_factory.h"
 #include "common_video/interface/i420_video_frame.h"
+#include "common_video/jpeg/include/jpeg.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "system_wrappers/interface/critical_section_wrapper.h"
 #include "system_wrappers/interface/scoped_ptr.h"
@@ -145,6 +146,8 @@ class TestVideoCaptureCallback : public VideoCaptureDataCallback {
       capture_delay_(0),
       last_render_time_ms_(0),
       incoming_frames_(0),
+      incoming_mjpeg_frames_(0),
+      accept_mjpeg_(true),
       timing_warnings_(0),
       rotate_frame_(webrtc::kCameraRotate0){
   }
@@ -199,6 +202,21 @@ class TestVideoCaptureCallback : public VideoCaptureDataCallback {
     capture_delay_ = delay;
   }
 
+  virtual bool OnIncomingCapturedMjpegFrame(const WebRtc_Word32 id,
+                                            const WebRtc_UWord8* mjpeg,
+                                            const WebRtc_Word32 length,
+                                            const WebRtc_Word32 width,
+                                            const WebRtc_Word32 height,
+                                            const WebRtc_Word64 renderTimeMs) {
+    CriticalSectionScoped cs(capture_cs_.get());
+    if (!accept_mjpeg_)
+      return false;
+    EXPECT_EQ(capability_.width, width);
+    EXPECT_EQ(capability_.height, height);
+    incoming_mjpeg_frames_++;
+    return true;
+  }
+
   void SetExpectedCapability(VideoCaptureCapability capability) {
     CriticalSectionScoped cs(capture_cs_.get());
     capability_= capability;
@@ -210,6 +228,14 @@ class TestVideoCaptureCallback : public VideoCaptureDataCallback {
     CriticalSectionScoped cs(capture_cs_.get());
     return incoming_frames_;
   }
+  int incoming_mjpeg_frames() {
+    CriticalSectionScoped cs(capture_cs_.get());
+    return incoming_mjpeg_frames_;
+  }
+  void set_accept_mjpeg(bool accept) {
+    CriticalSectionScoped cs(capture_cs_.get());
+    accept_mjpeg_ = accept;
+  }
 
   int capture_delay() {
     CriticalSectionScoped cs(capture_cs_.get());
@@ -245,6 +271,8 @@ class TestVideoCaptureCallback : public VideoCaptureDataCallback {
   int capture_delay_;
   WebRtc_Word64 last_render_time_ms_;
   int incoming_frames_;
+  int incoming_mjpeg_frames_;
+  bool accept_mjpeg_;
   int timing_warnings_;
   webrtc::I420VideoFrame last_frame_;
   webrtc::VideoCaptureRotation rotate_frame_;
@@ -499,6 +527,65 @@ TEST_F(VideoCaptureExternalTest, TestExternalCapture) {
   EXPECT_TRUE(capture_callback_.CompareLastFrame(test_frame_));
 }
 
+// Test that the conversion buffer is allocated once and then reused.
+TEST_F(VideoCaptureExternalTest, ReusesConversionBuffer) {
+  unsigned int length = webrtc::CalcBufferSize(webrtc::kI420,
+                                               test_frame_.width(),
+                                               test_frame_.height());
+  webrtc::scoped_array<uint8_t> test_buffer(new uint8_t[length]);
+  webrtc::ExtractBuffer(test_frame_, length, test_buffer.get());
+  const unsigned int kNumFrames = 5;
+  for (unsigned int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(0, capture_input_interface_->IncomingFrame(test_buffer.get(),
+        length, capture_callback_.capability(), 0));
+  }
+  webrtc::VideoCaptureBufferStatistics statistics;
+  EXPECT_EQ(0, capture_module_->GetBufferStatistics(statistics));
+  EXPECT_EQ(kNumFrames, statistics.frames);
+  EXPECT_EQ(1u, statistics.allocations);
+  EXPECT_EQ(0u, statistics.copies);
+}
+
+// Test that MJPEG frames are delivered without decoding when enabled.
+TEST_F(VideoCaptureExternalTest, PassesMjpegThrough) {
+  VideoCaptureCapability capability = capture_callback_.capability();
+  capability.rawType = webrtc::kVideoMJPEG;
+  capture_callback_.SetExpectedCapability(capability);
+  // Not a valid JPEG, it is never decoded.
+  uint8_t mjpeg[1000];
+  memset(mjpeg, 0, sizeof(mjpeg));
+  EXPECT_EQ(0, capture_module_->EnableMjpegPassthrough(true));
+  EXPECT_EQ(0, capture_input_interface_->IncomingFrame(mjpeg, sizeof(mjpeg),
+      capability, 0));
+  EXPECT_EQ(1, capture_callback_.incoming_mjpeg_frames());
+  EXPECT_EQ(0, capture_callback_.incoming_frames());
+  webrtc::VideoCaptureBufferStatistics statistics;
+  EXPECT_EQ(0, capture_module_->GetBufferStatistics(statistics));
+  EXPECT_EQ(1u, statistics.passthrough);
+  EXPECT_EQ(0u, statistics.frames);
+}
+
+// Test that MJPEG frames are decoded when the callback doesn't take them.
+TEST_F(VideoCaptureExternalTest, DecodesMjpegNotTakenByCallback) {
+  VideoCaptureCapability capability = capture_callback_.capability();
+  capability.rawType = webrtc::kVideoMJPEG;
+  capture_callback_.SetExpectedCapability(capability);
+  capture_callback_.set_accept_mjpeg(false);
+  webrtc::JpegEncoder encoder;
+  webrtc::EncodedImage mjpeg;
+  ASSERT_EQ(0, encoder.Encode(test_frame_, &mjpeg));
+  EXPECT_EQ(0, capture_module_->EnableMjpegPassthrough(true));
+  EXPECT_EQ(0, capture_input_interface_->IncomingFrame(mjpeg._buffer,
+      mjpeg._length, capability, 0));
+  delete [] mjpeg._buffer;
+  EXPECT_EQ(0, capture_callback_.incoming_mjpeg_frames());
+  EXPECT_EQ(1, capture_callback_.incoming_frames());
+  webrtc::VideoCaptureBufferStatistics statistics;
+  EXPECT_EQ(0, capture_module_->GetBufferStatistics(statistics));
+  EXPECT_EQ(0u, statistics.passthrough);
+  EXPECT_EQ(1u, statistics.frames);
+}
+
 // Test input of planar I420 frames.
 // NOTE: flaky, sometimes fails on the last CompareLastFrame.
 // http://code.google.com/p/webrtc/issues/detail?id=777
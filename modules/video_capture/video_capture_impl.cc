@@ -24,6 +24,13 @@ namespace webrtc
 {
 namespace videocapturemodule
 {
+// Total size of the plane buffers allocated for |frame|.
+static int AllocatedFrameSize(const I420VideoFrame& frame)
+{
+    return frame.allocated_size(kYPlane) + frame.allocated_size(kUPlane) +
+        frame.allocated_size(kVPlane);
+}
+
 VideoCaptureModule* VideoCaptureImpl::Create(
     const WebRtc_Word32 id,
     VideoCaptureExternal*& externalCapture)
@@ -39,6 +46,14 @@ const char* VideoCaptureImpl::CurrentDeviceName() const
     return _deviceUniqueId;
 }
 
+WebRtc_Word32 VideoCaptureImpl::GetBufferStatistics(
+    VideoCaptureBufferStatistics& statistics)
+{
+    CriticalSectionScoped cs(&_callBackCs);
+    statistics = _bufferStatistics;
+    return 0;
+}
+
 WebRtc_Word32 VideoCaptureImpl::ChangeUniqueId(const WebRtc_Word32 id)
 {
     _id = id;
@@ -113,6 +128,7 @@ VideoCaptureImpl::VideoCaptureImpl(const WebRtc_Word32 id)
       _noPictureAlarmCallBack(false), _captureAlarm(Cleared), _setCaptureDelay(0),
       _dataCallBack(NULL), _captureCallBack(NULL),
       _lastProcessFrameCount(TickTime::Now()), _rotateFrame(kRotateNone),
+      _mjpegPassthrough(false),
       last_capture_time_(TickTime::MillisecondTimestamp())
 
 {
@@ -250,6 +266,39 @@ WebRtc_Word32 VideoCaptureImpl::DeliverEncodedCapturedFrame(
   return 0;
 }
 
+bool VideoCaptureImpl::DeliverMjpegCapturedFrame(
+    const WebRtc_UWord8* mjpeg, WebRtc_Word32 length,
+    const VideoCaptureCapability& frameInfo, WebRtc_Word64 capture_time) {
+  const WebRtc_Word64 render_time_ms = capture_time != 0 ? capture_time :
+      TickTime::MillisecondTimestamp();
+  if (render_time_ms == last_capture_time_) {
+    // We don't allow the same capture time for two frames, drop this one.
+    UpdateFrameCount();
+    return true;
+  }
+
+  // Capture delay changed
+  if (_setCaptureDelay != _captureDelay) {
+      _setCaptureDelay = _captureDelay;
+      if (_dataCallBack) {
+        _dataCallBack->OnCaptureDelayChanged(_id, _captureDelay);
+      }
+  }
+
+  // Frames that aren't taken are counted when they have been decoded.
+  if (_dataCallBack &&
+      !_dataCallBack->OnIncomingCapturedMjpegFrame(_id, mjpeg, length,
+                                                   frameInfo.width,
+                                                   frameInfo.height,
+                                                   render_time_ms)) {
+    return false;
+  }
+  UpdateFrameCount();  // frame count used for local frame rate callback.
+  last_capture_time_ = render_time_ms;
+  ++_bufferStatistics.passthrough;
+  return true;
+}
+
 WebRtc_Word32 VideoCaptureImpl::IncomingFrame(
     WebRtc_UWord8* videoFrame,
     WebRtc_Word32 videoFrameLength,
@@ -267,7 +316,14 @@ WebRtc_Word32 VideoCaptureImpl::IncomingFrame(
     const WebRtc_Word32 width = frameInfo.width;
     const WebRtc_Word32 height = frameInfo.height;
 
-    if (frameInfo.codecType == kVideoCodecUnknown)
+    if (frameInfo.codecType == kVideoCodecUnknown &&
+        frameInfo.rawType == kVideoMJPEG && _mjpegPassthrough &&
+        DeliverMjpegCapturedFrame(videoFrame, videoFrameLength, frameInfo,
+                                  captureTime))
+    {
+        // Delivered compressed, the receiver decodes it if needed.
+    }
+    else if (frameInfo.codecType == kVideoCodecUnknown)
     {
         // Not encoded, convert to I420.
         const VideoType commonVideoType =
@@ -296,6 +352,7 @@ WebRtc_Word32 VideoCaptureImpl::IncomingFrame(
         // Setting absolute height (in case it was negative).
         // In Windows, the image starts bottom left, instead of top left.
         // Setting a negative source height, inverts the image (within LibYuv).
+        const int allocatedSize = AllocatedFrameSize(_captureFrame);
         int ret = _captureFrame.CreateEmptyFrame(target_width,
                                                  abs(target_height),
                                                  stride_y,
@@ -306,6 +363,10 @@ WebRtc_Word32 VideoCaptureImpl::IncomingFrame(
                        "Failed to allocate I420 frame.");
             return -1;
         }
+        if (AllocatedFrameSize(_captureFrame) != allocatedSize)
+        {
+            ++_bufferStatistics.allocations;
+        }
         const int conversionResult = ConvertToI420(commonVideoType,
                                                    videoFrame,
                                                    0, 0,  // No cropping
@@ -320,6 +381,7 @@ WebRtc_Word32 VideoCaptureImpl::IncomingFrame(
                        frameInfo.rawType);
             return -1;
         }
+        ++_bufferStatistics.frames;
         DeliverCapturedFrame(_captureFrame, captureTime);
     }
     else // Encoded format
@@ -354,6 +416,7 @@ WebRtc_Word32 VideoCaptureImpl::IncomingFrameI420(
   int size_u = video_frame.u_pitch * ((video_frame.height + 1) / 2);
   int size_v =  video_frame.v_pitch * ((video_frame.height + 1) / 2);
   // TODO(mikhal): Can we use Swap here? This will do a memcpy.
+  const int allocated_size = AllocatedFrameSize(_captureFrame);
   int ret = _captureFrame.CreateFrame(size_y, video_frame.y_plane,
                                       size_u, video_frame.u_plane,
                                       size_v, video_frame.v_plane,
@@ -365,6 +428,11 @@ WebRtc_Word32 VideoCaptureImpl::IncomingFrameI420(
                  "Failed to create I420VideoFrame");
     return -1;
   }
+  if (AllocatedFrameSize(_captureFrame) != allocated_size) {
+    ++_bufferStatistics.allocations;
+  }
+  ++_bufferStatistics.copies;
+  ++_bufferStatistics.frames;
 
   DeliverCapturedFrame(_captureFrame, captureTime);
 
@@ -412,6 +480,20 @@ WebRtc_Word32 VideoCaptureImpl::EnableNoPictureAlarm(const bool enable)
     return 0;
 }
 
+WebRtc_Word32 VideoCaptureImpl::EnableMjpegPassthrough(const bool enable)
+{
+    CriticalSectionScoped cs(&_apiCs);
+    CriticalSectionScoped cs2(&_callBackCs);
+    _mjpegPassthrough = enable;
+    return 0;
+}
+
+bool VideoCaptureImpl::MjpegPassthrough()
+{
+    CriticalSectionScoped cs(&_callBackCs);
+    return _mjpegPassthrough;
+}
+
 void VideoCaptureImpl::UpdateFrameCount()
 {
     if (_incomingFrameTimes[0].MicrosecondTimestamp() == 0)
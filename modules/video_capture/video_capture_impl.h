@@ -66,9 +66,13 @@ public:
 
     virtual WebRtc_Word32 EnableFrameRateCallback(const bool enable);
     virtual WebRtc_Word32 EnableNoPictureAlarm(const bool enable);
+    virtual WebRtc_Word32 EnableMjpegPassthrough(const bool enable);
 
     virtual const char* CurrentDeviceName() const;
 
+    virtual WebRtc_Word32 GetBufferStatistics(
+        VideoCaptureBufferStatistics& statistics);
+
     // Module handling
     virtual WebRtc_Word32 TimeUntilNextProcess();
     virtual WebRtc_Word32 Process();
@@ -103,6 +107,15 @@ protected:
     WebRtc_Word32 DeliverEncodedCapturedFrame(VideoFrame& captureFrame,
                                               WebRtc_Word64 capture_time,
                                               VideoCodecType codec_type);
+    // Returns false if the callback doesn't take MJPEG, the frame must then
+    // be decoded.
+    bool DeliverMjpegCapturedFrame(const WebRtc_UWord8* mjpeg,
+                                   WebRtc_Word32 length,
+                                   const VideoCaptureCapability& frameInfo,
+                                   WebRtc_Word64 capture_time);
+    // Called by platform dependent code in StartCapture() to choose the
+    // capture format.
+    bool MjpegPassthrough();
 
     WebRtc_Word32 _id; // Module ID
     char* _deviceUniqueId; // current Device unique name;
@@ -128,9 +141,13 @@ private:
     TickTime _lastProcessFrameCount;
     TickTime _incomingFrameTimes[kFrameRateCountHistorySize];// timestamp for local captured frames
     VideoRotationMode _rotateFrame; //Set if the frame should be rotated by the capture module.
+    bool _mjpegPassthrough; // true if EnableMjpegPassthrough
 
+    // Swapped with a preallocated frame of the receiver on every delivered
+    // frame, so it only needs to be reallocated when the frame size grows.
     I420VideoFrame _captureFrame;
     VideoFrame _capture_encoded_frame;
+    VideoCaptureBufferStatistics _bufferStatistics;
 
     // Used to make sure incoming timestamp is increasing for every frame.
     WebRtc_Word64 last_capture_time_;
@@ -0,0 +1,421 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/test/codec_benchmark.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+#include "common_video/libyuv/include/scaler.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "modules/video_coding/codecs/test/videoprocessor.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+#include "testsupport/frame_reader.h"
+#include "testsupport/frame_writer.h"
+#include "testsupport/metrics/video_metrics.h"
+#include "testsupport/packet_reader.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+long PeakMemoryInKb() {
+#ifdef _WIN32
+  return -1;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+#if defined(WEBRTC_MAC)
+  return usage.ru_maxrss / 1024;  // Reported in bytes.
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+
+}  // namespace
+
+void ExpandBenchmarkMatrix(const BenchmarkMatrix& matrix,
+                           std::vector<BenchmarkPoint>* points) {
+  for (size_t r = 0; r < matrix.resolutions.size(); ++r) {
+    for (size_t b = 0; b < matrix.bit_rates_in_kbps.size(); ++b) {
+      for (size_t c = 0; c < matrix.complexities.size(); ++c) {
+        for (size_t n = 0; n < matrix.number_of_cores.size(); ++n) {
+          for (size_t l = 0; l < matrix.packet_loss_probabilities.size();
+               ++l) {
+            BenchmarkPoint point;
+            point.width = matrix.resolutions[r].first;
+            point.height = matrix.resolutions[r].second;
+            point.bit_rate_in_kbps = matrix.bit_rates_in_kbps[b];
+            point.complexity = matrix.complexities[c];
+            point.number_of_cores = matrix.number_of_cores[n];
+            point.packet_loss_mode = matrix.packet_loss_mode;
+            point.packet_loss_probability =
+                matrix.packet_loss_probabilities[l];
+            point.packet_loss_burst_length = matrix.packet_loss_burst_length;
+            points->push_back(point);
+          }
+        }
+      }
+    }
+  }
+}
+
+int Percentile(std::vector<int>* values, int percentile) {
+  assert(percentile >= 0 && percentile <= 100);
+  if (values->empty()) {
+    return 0;
+  }
+  std::sort(values->begin(), values->end());
+  // Nearest rank: the smallest value such that |percentile| percent of the
+  // values are less than or equal to it.
+  size_t rank = (percentile * values->size() + 99) / 100;
+  if (rank > 0) {
+    --rank;
+  }
+  return (*values)[rank];
+}
+
+void CalculateTimingResults(const Stats& stats, BenchmarkResult* result) {
+  std::vector<int> encode_times;
+  std::vector<int> decode_times;
+  std::vector<int> latencies;
+  double total_encode_time_us = 0;
+  double total_decode_time_us = 0;
+  double total_bits = 0;
+  for (size_t i = 0; i < stats.stats_.size(); ++i) {
+    const FrameStatistic& f = stats.stats_[i];
+    if (f.encoding_successful) {
+      encode_times.push_back(f.encode_time_in_us);
+      total_encode_time_us += f.encode_time_in_us;
+      total_bits += f.bit_rate_in_kbps;
+    }
+    if (f.decoding_successful) {
+      decode_times.push_back(f.decode_time_in_us);
+      total_decode_time_us += f.decode_time_in_us;
+      latencies.push_back(f.encode_time_in_us + f.decode_time_in_us);
+    }
+  }
+  result->number_of_frames = static_cast<int>(stats.stats_.size());
+  if (total_encode_time_us > 0) {
+    result->encode_fps = encode_times.size() * 1e6 / total_encode_time_us;
+  }
+  if (total_decode_time_us > 0) {
+    result->decode_fps = decode_times.size() * 1e6 / total_decode_time_us;
+  }
+  if (!encode_times.empty()) {
+    result->average_bit_rate_in_kbps =
+        static_cast<int>(total_bits / encode_times.size() + 0.5);
+  }
+  result->encode_time_p50_us = Percentile(&encode_times, 50);
+  result->encode_time_p90_us = Percentile(&encode_times, 90);
+  result->encode_time_p99_us = Percentile(&encode_times, 99);
+  result->decode_time_p50_us = Percentile(&decode_times, 50);
+  result->decode_time_p90_us = Percentile(&decode_times, 90);
+  result->decode_time_p99_us = Percentile(&decode_times, 99);
+  result->frame_latency_p50_us = Percentile(&latencies, 50);
+  result->frame_latency_p90_us = Percentile(&latencies, 90);
+  result->frame_latency_p99_us = Percentile(&latencies, 99);
+}
+
+void WriteBenchmarkCsv(const std::vector<BenchmarkResult>& results,
+                       FILE* file) {
+  fprintf(file, "width,height,bit_rate_kbps,complexity,cores,"
+          "packet_loss_mode,packet_loss_probability,packet_loss_burst_length,"
+          "success,frames,dropped_frames,encode_fps,decode_fps,"
+          "encode_p50_us,encode_p90_us,encode_p99_us,"
+          "decode_p50_us,decode_p90_us,decode_p99_us,"
+          "latency_p50_us,latency_p90_us,latency_p99_us,"
+          "average_bit_rate_kbps,psnr,ssim,peak_memory_kb\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchmarkResult& r = results[i];
+    fprintf(file, "%d,%d,%d,%d,%d,%s,%.3f,%d,%d,%d,%d,%.2f,%.2f,"
+            "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.2f,%.4f,%ld\n",
+            r.point.width, r.point.height, r.point.bit_rate_in_kbps,
+            r.point.complexity, r.point.number_of_cores,
+            PacketLossModeToStr(r.point.packet_loss_mode),
+            r.point.packet_loss_probability,
+            r.point.packet_loss_burst_length,
+            r.success ? 1 : 0, r.number_of_frames, r.dropped_frames,
+            r.encode_fps, r.decode_fps,
+            r.encode_time_p50_us, r.encode_time_p90_us, r.encode_time_p99_us,
+            r.decode_time_p50_us, r.decode_time_p90_us, r.decode_time_p99_us,
+            r.frame_latency_p50_us, r.frame_latency_p90_us,
+            r.frame_latency_p99_us, r.average_bit_rate_in_kbps,
+            r.psnr, r.ssim, r.peak_memory_in_kb);
+  }
+}
+
+void WriteBenchmarkJson(const std::vector<BenchmarkResult>& results,
+                        FILE* file) {
+  fprintf(file, "[\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchmarkResult& r = results[i];
+    fprintf(file, "  {\"width\": %d, \"height\": %d, \"bit_rate_kbps\": %d, "
+            "\"complexity\": %d, \"cores\": %d, "
+            "\"packet_loss_mode\": \"%s\", \"packet_loss_probability\": %.3f, "
+            "\"packet_loss_burst_length\": %d, \"success\": %s, "
+            "\"frames\": %d, \"dropped_frames\": %d, "
+            "\"encode_fps\": %.2f, \"decode_fps\": %.2f, "
+            "\"encode_us\": [%d, %d, %d], \"decode_us\": [%d, %d, %d], "
+            "\"latency_us\": [%d, %d, %d], \"average_bit_rate_kbps\": %d, "
+            "\"psnr\": %.2f, \"ssim\": %.4f, \"peak_memory_kb\": %ld}%s\n",
+            r.point.width, r.point.height, r.point.bit_rate_in_kbps,
+            r.point.complexity, r.point.number_of_cores,
+            PacketLossModeToStr(r.point.packet_loss_mode),
+            r.point.packet_loss_probability,
+            r.point.packet_loss_burst_length,
+            r.success ? "true" : "false", r.number_of_frames,
+            r.dropped_frames, r.encode_fps, r.decode_fps,
+            r.encode_time_p50_us, r.encode_time_p90_us, r.encode_time_p99_us,
+            r.decode_time_p50_us, r.decode_time_p90_us, r.decode_time_p99_us,
+            r.frame_latency_p50_us, r.frame_latency_p90_us,
+            r.frame_latency_p99_us, r.average_bit_rate_in_kbps,
+            r.psnr, r.ssim, r.peak_memory_in_kb,
+            (i + 1 < results.size()) ? "," : "");
+  }
+  fprintf(file, "]\n");
+}
+
+CodecBenchmarkRunner::CodecBenchmarkRunner(VideoCodecFactory* factory,
+                                           const std::string& input_filename,
+                                           int input_width,
+                                           int input_height,
+                                           int frame_rate,
+                                           const std::string& output_dir,
+                                           int parallel_runs)
+    : factory_(factory),
+      input_filename_(input_filename),
+      input_width_(input_width),
+      input_height_(input_height),
+      frame_rate_(frame_rate),
+      output_dir_(output_dir),
+      parallel_runs_(parallel_runs > 0 ? parallel_runs : 1),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      done_event_(EventWrapper::Create()),
+      points_(NULL),
+      results_(NULL),
+      next_point_(0),
+      finished_points_(0) {
+  assert(factory);
+}
+
+CodecBenchmarkRunner::~CodecBenchmarkRunner() {}
+
+std::string CodecBenchmarkRunner::ScaledInputFilename(int width,
+                                                      int height) const {
+  if (width == input_width_ && height == input_height_) {
+    return input_filename_;
+  }
+  std::stringstream name;
+  name << output_dir_ << "/benchmark_input_" << width << "x" << height
+       << ".yuv";
+  return name.str();
+}
+
+bool CodecBenchmarkRunner::PrepareInput(int width, int height) {
+  if (width == input_width_ && height == input_height_) {
+    return true;
+  }
+  const int input_length = CalcBufferSize(kI420, input_width_, input_height_);
+  const int output_length = CalcBufferSize(kI420, width, height);
+  FrameReaderImpl reader(input_filename_, input_length);
+  FrameWriterImpl writer(ScaledInputFilename(width, height), output_length);
+  if (!reader.Init() || !writer.Init()) {
+    return false;
+  }
+  Scaler scaler;
+  if (scaler.Set(input_width_, input_height_, width, height, kI420, kI420,
+                 kScaleBox) != 0) {
+    return false;
+  }
+  scoped_array<uint8_t> input_buffer(new uint8_t[input_length]);
+  scoped_array<uint8_t> output_buffer(new uint8_t[output_length]);
+  I420VideoFrame input_frame;
+  I420VideoFrame output_frame;
+  while (reader.ReadFrame(input_buffer.get())) {
+    if (ConvertToI420(kI420, input_buffer.get(), 0, 0, input_width_,
+                      input_height_, 0, kRotateNone, &input_frame) != 0 ||
+        scaler.Scale(input_frame, &output_frame) != 0 ||
+        ExtractBuffer(output_frame, output_length, output_buffer.get()) < 0 ||
+        !writer.WriteFrame(output_buffer.get())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CodecBenchmarkRunner::Run(const std::vector<BenchmarkPoint>& points,
+                               std::vector<BenchmarkResult>* results) {
+  std::vector<std::pair<int, int> > resolutions;
+  for (size_t i = 0; i < points.size(); ++i) {
+    std::pair<int, int> resolution(points[i].width, points[i].height);
+    if (std::find(resolutions.begin(), resolutions.end(), resolution) ==
+        resolutions.end()) {
+      resolutions.push_back(resolution);
+      if (!PrepareInput(resolution.first, resolution.second)) {
+        fprintf(stderr, "Failed to scale %s to %dx%d\n",
+                input_filename_.c_str(), resolution.first, resolution.second);
+        return false;
+      }
+    }
+  }
+
+  results->assign(points.size(), BenchmarkResult());
+  points_ = &points;
+  results_ = results;
+  next_point_ = 0;
+  finished_points_ = 0;
+  if (points.empty()) {
+    return true;
+  }
+
+  std::vector<ThreadWrapper*> threads;
+  for (int i = 0; i < parallel_runs_ && i < static_cast<int>(points.size());
+       ++i) {
+    ThreadWrapper* thread = ThreadWrapper::CreateThread(
+        WorkerThread, this, kNormalPriority, "CodecBenchmarkThread");
+    unsigned int thread_id = 0;
+    if (thread == NULL || !thread->Start(thread_id)) {
+      delete thread;
+      break;
+    }
+    threads.push_back(thread);
+  }
+  if (threads.empty()) {
+    // Fall back to running everything on this thread.
+    while (WorkerProcess()) {}
+  } else {
+    done_event_->Wait(WEBRTC_EVENT_INFINITE);
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Stop();
+    delete threads[i];
+  }
+  points_ = NULL;
+  results_ = NULL;
+  return true;
+}
+
+bool CodecBenchmarkRunner::WorkerThread(void* obj) {
+  return static_cast<CodecBenchmarkRunner*>(obj)->WorkerProcess();
+}
+
+bool CodecBenchmarkRunner::WorkerProcess() {
+  size_t index;
+  {
+    CriticalSectionScoped cs(crit_sect_.get());
+    if (points_ == NULL || next_point_ >= points_->size()) {
+      return false;
+    }
+    index = next_point_++;
+  }
+  RunPoint(static_cast<int>(index), &(*results_)[index]);
+  CriticalSectionScoped cs(crit_sect_.get());
+  if (++finished_points_ == points_->size()) {
+    done_event_->Set();
+    return false;
+  }
+  return true;
+}
+
+void CodecBenchmarkRunner::RunPoint(int index, BenchmarkResult* result) {
+  const BenchmarkPoint& point = (*points_)[index];
+  result->point = point;
+
+  VideoCodec codec_settings;
+  factory_->DefaultSettings(&codec_settings);
+  codec_settings.width = point.width;
+  codec_settings.height = point.height;
+  codec_settings.startBitrate = point.bit_rate_in_kbps;
+  codec_settings.maxFramerate = frame_rate_;
+  if (codec_settings.codecType == kVideoCodecVP8) {
+    codec_settings.codecSpecific.VP8.complexity = point.complexity;
+  }
+
+  TestConfig config;
+  std::stringstream name;
+  name << "benchmark_" << index;
+  config.name = name.str();
+  config.test_number = index;
+  config.input_filename = ScaledInputFilename(point.width, point.height);
+  config.output_dir = output_dir_;
+  config.output_filename = output_dir_ + "/" + name.str() + "_out.yuv";
+  config.frame_length_in_bytes = CalcBufferSize(kI420, point.width,
+                                                point.height);
+  config.use_single_core = (point.number_of_cores == 1);
+  config.number_of_cores = point.number_of_cores;
+  config.networking_config.packet_loss_mode = point.packet_loss_mode;
+  config.networking_config.packet_loss_probability =
+      point.packet_loss_probability;
+  config.networking_config.packet_loss_burst_length =
+      point.packet_loss_burst_length;
+  config.codec_settings = &codec_settings;
+  config.verbose = false;
+
+  scoped_ptr<VideoEncoder> encoder(factory_->CreateEncoder());
+  scoped_ptr<VideoDecoder> decoder(factory_->CreateDecoder());
+  Stats stats;
+  FrameReaderImpl frame_reader(config.input_filename,
+                               config.frame_length_in_bytes);
+  FrameWriterImpl frame_writer(config.output_filename,
+                               config.frame_length_in_bytes);
+  PacketReader packet_reader;
+  PacketManipulatorImpl packet_manipulator(&packet_reader,
+                                           config.networking_config, false);
+  if (encoder.get() == NULL || decoder.get() == NULL ||
+      !frame_reader.Init() || !frame_writer.Init()) {
+    return;
+  }
+  {
+    VideoProcessorImpl processor_impl(encoder.get(), decoder.get(),
+                                      &frame_reader, &frame_writer,
+                                      &packet_manipulator, config, &stats);
+    VideoProcessor& processor = processor_impl;
+    if (!processor.Init()) {
+      return;
+    }
+    int frame_number = 0;
+    while (processor.ProcessFrame(frame_number)) {
+      ++frame_number;
+    }
+    result->dropped_frames = processor.NumberDroppedFrames();
+  }
+  encoder->Release();
+  decoder->Release();
+  frame_reader.Close();
+  frame_writer.Close();
+
+  CalculateTimingResults(stats, result);
+  QualityMetricsResult psnr_result;
+  QualityMetricsResult ssim_result;
+  if (I420MetricsFromFiles(config.input_filename.c_str(),
+                           config.output_filename.c_str(),
+                           point.width, point.height,
+                           &psnr_result, &ssim_result) == 0) {
+    result->psnr = psnr_result.average;
+    result->ssim = ssim_result.average;
+  }
+  result->peak_memory_in_kb = PeakMemoryInKb();
+  result->success = true;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_CODEC_BENCHMARK_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_CODEC_BENCHMARK_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common_types.h"
+#include "modules/video_coding/codecs/interface/video_codec_interface.h"
+#include "modules/video_coding/codecs/test/packet_manipulator.h"
+#include "modules/video_coding/codecs/test/stats.h"
+#include "system_wrappers/interface/constructor_magic.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class EventWrapper;
+
+namespace test {
+
+// Creates the encoder and decoder instances used by the benchmark. Every run
+// gets its own instances so that runs can be executed in parallel.
+class VideoCodecFactory {
+ public:
+  virtual ~VideoCodecFactory() {}
+
+  // Fills in the default settings for the codec. Width, height, bit rate,
+  // complexity and frame rate are overwritten per run.
+  virtual void DefaultSettings(VideoCodec* settings) = 0;
+  virtual VideoEncoder* CreateEncoder() = 0;
+  virtual VideoDecoder* CreateDecoder() = 0;
+};
+
+// A single configuration to encode and decode the input clip with.
+struct BenchmarkPoint {
+  BenchmarkPoint()
+      : width(0), height(0), bit_rate_in_kbps(0),
+        complexity(kComplexityNormal), number_of_cores(1),
+        packet_loss_mode(kUniform), packet_loss_probability(0.0),
+        packet_loss_burst_length(1) {
+  }
+
+  int width;
+  int height;
+  int bit_rate_in_kbps;
+  // Maps to the encoder speed setting, e.g. cpu_speed for VP8.
+  VideoCodecComplexity complexity;
+  // Number of cores the encoder and decoder are allowed to use.
+  int number_of_cores;
+  PacketLossMode packet_loss_mode;
+  double packet_loss_probability;
+  int packet_loss_burst_length;
+};
+
+// The parameters to sweep. Every combination of the values below results in
+// one BenchmarkPoint.
+struct BenchmarkMatrix {
+  BenchmarkMatrix() : packet_loss_mode(kUniform), packet_loss_burst_length(1) {}
+
+  // Pairs of (width, height).
+  std::vector<std::pair<int, int> > resolutions;
+  std::vector<int> bit_rates_in_kbps;
+  std::vector<VideoCodecComplexity> complexities;
+  std::vector<int> number_of_cores;
+  std::vector<double> packet_loss_probabilities;
+  PacketLossMode packet_loss_mode;
+  int packet_loss_burst_length;
+};
+
+// Expands |matrix| into all of its combinations, appended to |points|.
+void ExpandBenchmarkMatrix(const BenchmarkMatrix& matrix,
+                           std::vector<BenchmarkPoint>* points);
+
+// Returns the |percentile| (0 - 100) of |values| using the nearest rank
+// method. |values| is sorted as a side effect. Returns 0 if empty.
+int Percentile(std::vector<int>* values, int percentile);
+
+// Aggregated result of one BenchmarkPoint.
+struct BenchmarkResult {
+  BenchmarkResult()
+      : point(), success(false), number_of_frames(0), dropped_frames(0),
+        encode_fps(0.0), decode_fps(0.0), encode_time_p50_us(0),
+        encode_time_p90_us(0), encode_time_p99_us(0), decode_time_p50_us(0),
+        decode_time_p90_us(0), decode_time_p99_us(0), frame_latency_p50_us(0),
+        frame_latency_p90_us(0), frame_latency_p99_us(0),
+        average_bit_rate_in_kbps(0), psnr(0.0), ssim(0.0),
+        peak_memory_in_kb(-1) {
+  }
+
+  BenchmarkPoint point;
+  bool success;
+  int number_of_frames;
+  int dropped_frames;
+  double encode_fps;
+  double decode_fps;
+  int encode_time_p50_us;
+  int encode_time_p90_us;
+  int encode_time_p99_us;
+  int decode_time_p50_us;
+  int decode_time_p90_us;
+  int decode_time_p99_us;
+  // Encode plus decode time of a frame.
+  int frame_latency_p50_us;
+  int frame_latency_p90_us;
+  int frame_latency_p99_us;
+  int average_bit_rate_in_kbps;
+  double psnr;
+  double ssim;
+  // Peak resident memory of the process when the run finished, -1 if not
+  // available on this platform. With parallel runs this is an upper bound of
+  // what a single run needs.
+  long peak_memory_in_kb;
+};
+
+// Fills in the timing fields of |result| from the per frame |stats|.
+void CalculateTimingResults(const Stats& stats, BenchmarkResult* result);
+
+// Writes |results| to |file| as CSV with a header line, or as a JSON array
+// where the timing percentiles are given as [p50, p90, p99].
+void WriteBenchmarkCsv(const std::vector<BenchmarkResult>& results,
+                       FILE* file);
+void WriteBenchmarkJson(const std::vector<BenchmarkResult>& results,
+                        FILE* file);
+
+// Runs a set of BenchmarkPoints on the same input clip, spreading the runs
+// over a number of worker threads. The input clip is scaled to every
+// resolution of the sweep before the runs start.
+class CodecBenchmarkRunner {
+ public:
+  // |input_filename| is an I420 file of |input_width| x |input_height|.
+  // Scaled inputs and decoded outputs are written to |output_dir|.
+  // |parallel_runs| is the number of configurations processed at the same
+  // time.
+  CodecBenchmarkRunner(VideoCodecFactory* factory,
+                       const std::string& input_filename,
+                       int input_width,
+                       int input_height,
+                       int frame_rate,
+                       const std::string& output_dir,
+                       int parallel_runs);
+  ~CodecBenchmarkRunner();
+
+  // Runs all |points| and stores the results in the same order as |points|.
+  // Returns false if the input could not be prepared.
+  bool Run(const std::vector<BenchmarkPoint>& points,
+           std::vector<BenchmarkResult>* results);
+
+ private:
+  static bool WorkerThread(void* obj);
+  bool WorkerProcess();
+
+  // Writes the input clip scaled to |width| x |height| to |output_dir_|.
+  bool PrepareInput(int width, int height);
+  std::string ScaledInputFilename(int width, int height) const;
+  void RunPoint(int index, BenchmarkResult* result);
+
+  VideoCodecFactory* factory_;
+  const std::string input_filename_;
+  const int input_width_;
+  const int input_height_;
+  const int frame_rate_;
+  const std::string output_dir_;
+  const int parallel_runs_;
+
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  scoped_ptr<EventWrapper> done_event_;
+  const std::vector<BenchmarkPoint>* points_;
+  std::vector<BenchmarkResult>* results_;
+  size_t next_point_;
+  size_t finished_points_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodecBenchmarkRunner);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_CODEC_BENCHMARK_H_
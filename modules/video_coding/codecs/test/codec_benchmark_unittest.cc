@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/test/codec_benchmark.h"
+
+#include "gtest/gtest.h"
+#include "typedefs.h"
+
+namespace webrtc {
+namespace test {
+
+TEST(CodecBenchmarkTest, ExpandMatrix) {
+  BenchmarkMatrix matrix;
+  matrix.resolutions.push_back(std::make_pair(640, 360));
+  matrix.resolutions.push_back(std::make_pair(1280, 720));
+  matrix.bit_rates_in_kbps.push_back(500);
+  matrix.bit_rates_in_kbps.push_back(1000);
+  matrix.bit_rates_in_kbps.push_back(2000);
+  matrix.complexities.push_back(kComplexityNormal);
+  matrix.number_of_cores.push_back(1);
+  matrix.number_of_cores.push_back(4);
+  matrix.packet_loss_probabilities.push_back(0.0);
+  matrix.packet_loss_probabilities.push_back(0.05);
+  matrix.packet_loss_mode = kBurst;
+  matrix.packet_loss_burst_length = 3;
+
+  std::vector<BenchmarkPoint> points;
+  ExpandBenchmarkMatrix(matrix, &points);
+  ASSERT_EQ(2u * 3u * 1u * 2u * 2u, points.size());
+  EXPECT_EQ(640, points.front().width);
+  EXPECT_EQ(500, points.front().bit_rate_in_kbps);
+  EXPECT_EQ(1, points.front().number_of_cores);
+  EXPECT_EQ(0.0, points.front().packet_loss_probability);
+  EXPECT_EQ(1280, points.back().width);
+  EXPECT_EQ(720, points.back().height);
+  EXPECT_EQ(2000, points.back().bit_rate_in_kbps);
+  EXPECT_EQ(4, points.back().number_of_cores);
+  EXPECT_EQ(0.05, points.back().packet_loss_probability);
+  EXPECT_EQ(kBurst, points.back().packet_loss_mode);
+  EXPECT_EQ(3, points.back().packet_loss_burst_length);
+
+  // An empty dimension results in no points.
+  matrix.complexities.clear();
+  points.clear();
+  ExpandBenchmarkMatrix(matrix, &points);
+  EXPECT_TRUE(points.empty());
+}
+
+TEST(CodecBenchmarkTest, Percentile) {
+  std::vector<int> values;
+  EXPECT_EQ(0, Percentile(&values, 50));
+  for (int i = 100; i > 0; --i) {
+    values.push_back(i);
+  }
+  EXPECT_EQ(1, Percentile(&values, 0));
+  EXPECT_EQ(50, Percentile(&values, 50));
+  EXPECT_EQ(90, Percentile(&values, 90));
+  EXPECT_EQ(99, Percentile(&values, 99));
+  EXPECT_EQ(100, Percentile(&values, 100));
+}
+
+TEST(CodecBenchmarkTest, TimingResults) {
+  Stats stats;
+  for (int i = 0; i < 10; ++i) {
+    FrameStatistic& frame = stats.NewFrame(i);
+    frame.encoding_successful = true;
+    frame.decoding_successful = (i != 9);
+    frame.encode_time_in_us = 1000 * (i + 1);
+    frame.decode_time_in_us = 500;
+    frame.bit_rate_in_kbps = 300;
+  }
+  BenchmarkResult result;
+  CalculateTimingResults(stats, &result);
+  EXPECT_EQ(10, result.number_of_frames);
+  EXPECT_NEAR(10 * 1e6 / 55000, result.encode_fps, 0.01);
+  EXPECT_NEAR(9 * 1e6 / 4500, result.decode_fps, 0.01);
+  EXPECT_EQ(5000, result.encode_time_p50_us);
+  EXPECT_EQ(10000, result.encode_time_p99_us);
+  EXPECT_EQ(500, result.decode_time_p90_us);
+  EXPECT_EQ(5500, result.frame_latency_p50_us);
+  EXPECT_EQ(9500, result.frame_latency_p99_us);
+  EXPECT_EQ(300, result.average_bit_rate_in_kbps);
+}
+
+}  // namespace test
+}  // namespace webrtc
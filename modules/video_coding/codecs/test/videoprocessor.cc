@@ -87,7 +87,8 @@ bool VideoProcessorImpl::Init() {
   // Init the encoder and decoder
   WebRtc_UWord32 nbr_of_cores = 1;
   if (!config_.use_single_core) {
-    nbr_of_cores = CpuInfo::DetectNumberOfCores();
+    nbr_of_cores = config_.number_of_cores > 0 ? config_.number_of_cores :
+        CpuInfo::DetectNumberOfCores();
   }
   WebRtc_Word32 init_result =
       encoder_->InitEncode(config_.codec_settings, nbr_of_cores,
@@ -44,7 +44,8 @@ struct TestConfig {
     : name(""), description(""), test_number(0),
       input_filename(""), output_filename(""), output_dir("out"),
       networking_config(), exclude_frame_types(kExcludeOnlyFirstKeyFrame),
-      frame_length_in_bytes(-1), use_single_core(false), keyframe_interval(0),
+      frame_length_in_bytes(-1), use_single_core(false), number_of_cores(0),
+      keyframe_interval(0),
       codec_settings(NULL), verbose(true) {
   };
 
@@ -92,6 +93,11 @@ struct TestConfig {
   // Default: false.
   bool use_single_core;
 
+  // If >0 and use_single_core is false, the encoder and decoder are
+  // initialized with this number of cores instead of the detected number.
+  // Default: 0.
+  int number_of_cores;
+
   // If set to a value >0 this setting forces the encoder to create a keyframe
   // every Nth frame. Note that the encoder may create a keyframe in other
   // locations in addition to the interval that is set using this parameter.
@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "google/gflags.h"
+#include "modules/video_coding/codecs/test/codec_benchmark.h"
+#include "modules/video_coding/codecs/vp8/include/vp8.h"
+#include "modules/video_coding/main/interface/video_coding.h"
+#include "system_wrappers/interface/cpu_info.h"
+
+DEFINE_string(input_filename, "", "Input file. The source video file to be "
+              "encoded and decoded. Must be in .yuv format.");
+DEFINE_int32(width, -1, "Width in pixels of the frames in the input file.");
+DEFINE_int32(height, -1, "Height in pixels of the frames in the input file.");
+DEFINE_int32(framerate, 30, "Frame rate of the input file, in FPS.");
+DEFINE_string(output_dir, ".", "Directory where scaled inputs and decoded "
+              "outputs are written. Must already exist.");
+DEFINE_string(resolutions, "", "Comma separated list of WIDTHxHEIGHT to "
+              "encode at. Defaults to the input resolution.");
+DEFINE_string(bitrates, "500", "Comma separated list of bit rates in kbps.");
+DEFINE_string(complexities, "0", "Comma separated list of encoder "
+              "complexities, 0 (normal) to 3 (max). For VP8 this selects "
+              "cpu_speed -6 to -3.");
+DEFINE_string(cores, "1", "Comma separated list of the number of cores the "
+              "encoder and decoder may use.");
+DEFINE_string(packet_loss_probabilities, "0", "Comma separated list of packet "
+              "loss probabilities between 0.0 and 1.0.");
+DEFINE_string(packet_loss_mode, "uniform", "Packet loss mode: uniform or "
+              "burst.");
+DEFINE_int32(packet_loss_burst_length, 1, "Number of packets lost in a burst "
+             "when a packet has been decided to be lost. Must be >=1.");
+DEFINE_int32(parallel_runs, 0, "Number of configurations to run at the same "
+             "time. 0 means the number of cores divided by the largest value "
+             "of --cores.");
+DEFINE_string(format, "csv", "Output format: csv or json.");
+DEFINE_string(output_filename, "", "File to write the results to. Defaults to "
+              "stdout.");
+
+namespace {
+
+class Vp8CodecFactory : public webrtc::test::VideoCodecFactory {
+ public:
+  virtual void DefaultSettings(webrtc::VideoCodec* settings) {
+    webrtc::VideoCodingModule::Codec(webrtc::kVideoCodecVP8, settings);
+  }
+  virtual webrtc::VideoEncoder* CreateEncoder() {
+    return webrtc::VP8Encoder::Create();
+  }
+  virtual webrtc::VideoDecoder* CreateDecoder() {
+    return webrtc::VP8Decoder::Create();
+  }
+};
+
+std::vector<std::string> SplitList(const std::string& list) {
+  std::vector<std::string> items;
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    if (end > start) {
+      items.push_back(list.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return items;
+}
+
+// Fills in the matrix from the command line flags. Returns 0 if everything is
+// OK, otherwise an exit code.
+int HandleCommandLineFlags(webrtc::test::BenchmarkMatrix* matrix) {
+  if (FLAGS_input_filename == "" || FLAGS_width <= 0 || FLAGS_height <= 0) {
+    printf("%s\n", google::ProgramUsage());
+    return 1;
+  }
+  std::vector<std::string> items = SplitList(FLAGS_resolutions);
+  if (items.empty()) {
+    matrix->resolutions.push_back(std::make_pair(FLAGS_width, FLAGS_height));
+  }
+  for (size_t i = 0; i < items.size(); ++i) {
+    int width = 0;
+    int height = 0;
+    if (sscanf(items[i].c_str(), "%dx%d", &width, &height) != 2 ||
+        width <= 0 || height <= 0) {
+      fprintf(stderr, "Invalid resolution: %s\n", items[i].c_str());
+      return 2;
+    }
+    matrix->resolutions.push_back(std::make_pair(width, height));
+  }
+  items = SplitList(FLAGS_bitrates);
+  for (size_t i = 0; i < items.size(); ++i) {
+    int bit_rate = atoi(items[i].c_str());
+    if (bit_rate <= 0) {
+      fprintf(stderr, "Bit rate must be >0 kbps, was: %s\n", items[i].c_str());
+      return 3;
+    }
+    matrix->bit_rates_in_kbps.push_back(bit_rate);
+  }
+  items = SplitList(FLAGS_complexities);
+  for (size_t i = 0; i < items.size(); ++i) {
+    int complexity = atoi(items[i].c_str());
+    if (complexity < webrtc::kComplexityNormal ||
+        complexity > webrtc::kComplexityMax) {
+      fprintf(stderr, "Complexity must be 0-3, was: %s\n", items[i].c_str());
+      return 4;
+    }
+    matrix->complexities.push_back(
+        static_cast<webrtc::VideoCodecComplexity>(complexity));
+  }
+  items = SplitList(FLAGS_cores);
+  for (size_t i = 0; i < items.size(); ++i) {
+    int cores = atoi(items[i].c_str());
+    if (cores <= 0) {
+      fprintf(stderr, "Number of cores must be >0, was: %s\n",
+              items[i].c_str());
+      return 5;
+    }
+    matrix->number_of_cores.push_back(cores);
+  }
+  items = SplitList(FLAGS_packet_loss_probabilities);
+  for (size_t i = 0; i < items.size(); ++i) {
+    double probability = atof(items[i].c_str());
+    if (probability < 0.0 || probability > 1.0) {
+      fprintf(stderr, "Invalid packet loss probability. Must be 0.0 - 1.0, "
+              "was: %s\n", items[i].c_str());
+      return 6;
+    }
+    matrix->packet_loss_probabilities.push_back(probability);
+  }
+  if (FLAGS_packet_loss_mode == "uniform") {
+    matrix->packet_loss_mode = webrtc::test::kUniform;
+  } else if (FLAGS_packet_loss_mode == "burst") {
+    matrix->packet_loss_mode = webrtc::test::kBurst;
+  } else {
+    fprintf(stderr, "Unsupported packet loss mode, must be 'uniform' or "
+            "'burst'.\n");
+    return 7;
+  }
+  if (FLAGS_packet_loss_burst_length < 1) {
+    fprintf(stderr, "Invalid packet loss burst length, must be >=1, "
+            "was: %d\n", FLAGS_packet_loss_burst_length);
+    return 8;
+  }
+  matrix->packet_loss_burst_length = FLAGS_packet_loss_burst_length;
+  if (FLAGS_format != "csv" && FLAGS_format != "json") {
+    fprintf(stderr, "Unsupported format, must be 'csv' or 'json'.\n");
+    return 9;
+  }
+  return 0;
+}
+
+}  // namespace
+
+// Encodes and decodes the input file with every combination of the given
+// settings and writes encode/decode speed, latency percentiles, quality and
+// memory usage per combination.
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage = "Benchmarks a video codec over a matrix of settings.\n"
+    "Run " + program_name + " --helpshort for usage.\n"
+    "Example usage:\n" + program_name +
+    " --input_filename=filename.yuv --width=1280 --height=720"
+    " --resolutions=1280x720,640x360 --bitrates=500,1000 --cores=1,2\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  webrtc::test::BenchmarkMatrix matrix;
+  int return_code = HandleCommandLineFlags(&matrix);
+  if (return_code != 0) {
+    return return_code;
+  }
+  std::vector<webrtc::test::BenchmarkPoint> points;
+  webrtc::test::ExpandBenchmarkMatrix(matrix, &points);
+
+  int parallel_runs = FLAGS_parallel_runs;
+  if (parallel_runs <= 0) {
+    int max_cores = 1;
+    for (size_t i = 0; i < matrix.number_of_cores.size(); ++i) {
+      if (matrix.number_of_cores[i] > max_cores) {
+        max_cores = matrix.number_of_cores[i];
+      }
+    }
+    parallel_runs = webrtc::CpuInfo::DetectNumberOfCores() / max_cores;
+    if (parallel_runs < 1) {
+      parallel_runs = 1;
+    }
+  }
+
+  Vp8CodecFactory factory;
+  webrtc::test::CodecBenchmarkRunner runner(&factory, FLAGS_input_filename,
+                                            FLAGS_width, FLAGS_height,
+                                            FLAGS_framerate,
+                                            FLAGS_output_dir, parallel_runs);
+  std::vector<webrtc::test::BenchmarkResult> results;
+  if (!runner.Run(points, &results)) {
+    return 10;
+  }
+
+  FILE* output = stdout;
+  if (FLAGS_output_filename != "") {
+    output = fopen(FLAGS_output_filename.c_str(), "w");
+    if (output == NULL) {
+      fprintf(stderr, "Cannot write output file: %s\n",
+              FLAGS_output_filename.c_str());
+      return 11;
+    }
+  }
+  if (FLAGS_format == "json") {
+    webrtc::test::WriteBenchmarkJson(results, output);
+  } else {
+    webrtc::test::WriteBenchmarkCsv(results, output);
+  }
+  if (output != stdout) {
+    fclose(output);
+  }
+  return 0;
+}
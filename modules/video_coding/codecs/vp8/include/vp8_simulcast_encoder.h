@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ *  WEBRTC VP8 simulcast wrapper interface
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_INCLUDE_VP8_SIMULCAST_ENCODER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_INCLUDE_VP8_SIMULCAST_ENCODER_H_
+
+#include <vector>
+
+#include "modules/video_coding/codecs/vp8/include/vp8.h"
+
+namespace webrtc {
+
+struct EncodeTimeStatistics {
+  EncodeTimeStatistics()
+      : frames(0), average_time_us(0), max_time_us(0) {}
+
+  unsigned int frames;
+  unsigned int average_time_us;
+  unsigned int max_time_us;
+};
+
+// Encodes each stream of VideoCodec::simulcastStream with a VP8 encoder of
+// its own. Every input frame is downscaled once into a resolution pyramid,
+// each layer from the next larger one, and the layers are encoded in parallel
+// on a pool of worker threads. The encoded layers are delivered in stream
+// order, lowest resolution first, before Encode() returns.
+//
+// The target bit rate is split between the streams in order, each stream
+// getting up to its target bit rate and the highest stream the rest. Streams
+// which can't get their min bit rate are paused and start with a key frame
+// when resumed.
+//
+// Without simulcast streams the frames are passed straight to a single VP8
+// encoder.
+class VP8SimulcastEncoder : public VP8Encoder {
+ public:
+  static VP8SimulcastEncoder* Create();
+
+  virtual ~VP8SimulcastEncoder() {};
+
+  // Gets the time spent encoding each layer, lowest resolution first, in
+  // |layers|, and the time from a frame is passed to Encode() until all its
+  // layers have been delivered in |frames|. Reset by InitEncode().
+  virtual void GetStatistics(std::vector<EncodeTimeStatistics>* layers,
+                             EncodeTimeStatistics* frames) const = 0;
+};  // end of VP8SimulcastEncoder class
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_INCLUDE_VP8_SIMULCAST_ENCODER_H_
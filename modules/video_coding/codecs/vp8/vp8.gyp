@@ -73,7 +73,10 @@
         'reference_picture_selection.cc',
         'include/vp8.h',
         'include/vp8_common_types.h',
+        'include/vp8_simulcast_encoder.h',
         'vp8_impl.cc',
+        'vp8_simulcast_encoder_impl.cc',
+        'vp8_simulcast_encoder_impl.h',
       ],
       # Disable warnings to enable Win64 build, issue 1323.
       'msvs_disabled_warnings': [
@@ -114,6 +117,7 @@
           'sources': [
             'default_temporal_layers_unittest.cc',
             'reference_picture_selection_unittest.cc',
+            'vp8_simulcast_encoder_unittest.cc',
           ],
           'conditions': [
             ['build_libvpx==1', {
@@ -0,0 +1,541 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ * This file contains the WEBRTC VP8 simulcast wrapper implementation
+ *
+ */
+
+#include "modules/video_coding/codecs/vp8/vp8_simulcast_encoder_impl.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+#include "system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+// Max time to wait for a new frame before checking if the thread is stopped.
+static const int kThreadWaitTimeMs = 100;
+
+static VideoEncoder* CreateVP8Encoder() {
+  return VP8Encoder::Create();
+}
+
+VP8SimulcastEncoder* VP8SimulcastEncoder::Create() {
+  return new VP8SimulcastEncoderImpl(CreateVP8Encoder);
+}
+
+// The encoder of one stream. Keeps the encoded image of the current frame
+// until all streams are done.
+class VP8SimulcastEncoderImpl::Layer : public EncodedImageCallback {
+ public:
+  Layer(VP8SimulcastEncoderImpl* owner, VideoEncoder* stream_encoder)
+      : parent(owner),
+        encoder(stream_encoder),
+        width(0),
+        height(0),
+        input(NULL),
+        codec_specific_info(NULL),
+        frame_types(1, kDeltaFrame),
+        active(true),
+        key_frame_needed(false),
+        pending(false),
+        result(WEBRTC_VIDEO_CODEC_OK),
+        encode_time_us(0),
+        has_output(false),
+        has_codec_specific(false),
+        has_fragmentation(false) {
+  }
+
+  virtual WebRtc_Word32 Encoded(EncodedImage& encoded_image,
+                                const CodecSpecificInfo* codec_specific,
+                                const RTPFragmentationHeader* fragmentation) {
+    // The buffer is owned by |encoder| and stays valid until its next
+    // Encode() call.
+    image = encoded_image;
+    has_codec_specific = (codec_specific != NULL);
+    if (codec_specific) {
+      codec_specific_out = *codec_specific;
+    }
+    has_fragmentation = (fragmentation != NULL);
+    if (fragmentation) {
+      this->fragmentation.CopyFrom(*fragmentation);
+    }
+    has_output = true;
+    return 0;
+  }
+
+  VP8SimulcastEncoderImpl* parent;
+  scoped_ptr<VideoEncoder> encoder;
+  scoped_ptr<ThreadWrapper> thread;
+  scoped_ptr<EventWrapper> event;
+
+  int width;
+  int height;
+  Scaler scaler;
+  I420VideoFrame scaled_frame;
+  // The frame to encode, either |scaled_frame| or the frame of the next
+  // larger layer.
+  const I420VideoFrame* input;
+  const CodecSpecificInfo* codec_specific_info;
+  std::vector<VideoFrameType> frame_types;
+  // False if the stream is paused due to a low bit rate.
+  bool active;
+  bool key_frame_needed;
+  // Protected by |parent->crit_|.
+  bool pending;
+  int result;
+  int64_t encode_time_us;
+
+  bool has_output;
+  EncodedImage image;
+  bool has_codec_specific;
+  CodecSpecificInfo codec_specific_out;
+  bool has_fragmentation;
+  RTPFragmentationHeader fragmentation;
+};
+
+void VP8SimulcastEncoderImpl::TimeCounter::Update(int64_t time_us) {
+  ++frames;
+  total_time_us += time_us;
+  if (time_us > max_time_us) {
+    max_time_us = time_us;
+  }
+}
+
+void VP8SimulcastEncoderImpl::TimeCounter::GetStatistics(
+    EncodeTimeStatistics* statistics) const {
+  statistics->frames = frames;
+  statistics->average_time_us =
+      frames == 0 ? 0 : static_cast<unsigned int>(total_time_us / frames);
+  statistics->max_time_us = static_cast<unsigned int>(max_time_us);
+}
+
+VP8SimulcastEncoderImpl::VP8SimulcastEncoderImpl(
+    CreateEncoderFunction create_encoder)
+    : create_encoder_(create_encoder),
+      encoded_complete_callback_(NULL),
+      inited_(false),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      done_event_(EventWrapper::Create()),
+      outstanding_layers_(0) {
+  memset(&codec_, 0, sizeof(codec_));
+}
+
+VP8SimulcastEncoderImpl::~VP8SimulcastEncoderImpl() {
+  Release();
+}
+
+int VP8SimulcastEncoderImpl::Release() {
+  StopThreads();
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    layers_[i]->encoder->Release();
+    delete layers_[i];
+  }
+  layers_.clear();
+  inited_ = false;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP8SimulcastEncoderImpl::InitEncode(const VideoCodec* inst,
+                                        int number_of_cores,
+                                        uint32_t max_payload_size) {
+  if (inst == NULL) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  if (number_of_cores < 1) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  const int number_of_streams = inst->numberOfSimulcastStreams;
+  for (int i = 0; i < number_of_streams; ++i) {
+    const SimulcastStream& stream = inst->simulcastStream[i];
+    if (stream.width < 1 || stream.height < 1) {
+      return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+    }
+    // The pyramid is built by downscaling each layer from the next one.
+    if (i > 0 && (stream.width < inst->simulcastStream[i - 1].width ||
+                  stream.height < inst->simulcastStream[i - 1].height)) {
+      return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+    }
+  }
+  int ret_val = Release();
+  if (ret_val < 0) {
+    return ret_val;
+  }
+  codec_ = *inst;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    layer_counters_.assign(std::max(number_of_streams, 1), TimeCounter());
+    frame_counter_ = TimeCounter();
+  }
+
+  if (number_of_streams <= 1) {
+    Layer* layer = new Layer(this, create_encoder_());
+    layers_.push_back(layer);
+    layer->width = codec_.width;
+    layer->height = codec_.height;
+    if (encoded_complete_callback_) {
+      layer->encoder->RegisterEncodeCompleteCallback(
+          encoded_complete_callback_);
+    }
+    ret_val = layer->encoder->InitEncode(inst, number_of_cores,
+                                         max_payload_size);
+    if (ret_val < 0) {
+      Release();
+      return ret_val;
+    }
+    inited_ = true;
+    return ret_val;
+  }
+
+  std::vector<uint32_t> rates;
+  AllocateBitrate(codec_.startBitrate, &rates);
+  // The layers are encoded at the same time.
+  const int cores_per_layer = std::max(1, number_of_cores / number_of_streams);
+  for (int i = 0; i < number_of_streams; ++i) {
+    const SimulcastStream& stream = codec_.simulcastStream[i];
+    Layer* layer = new Layer(this, create_encoder_());
+    layers_.push_back(layer);
+    layer->width = stream.width;
+    layer->height = stream.height;
+    layer->active = (rates[i] > 0);
+
+    VideoCodec settings = codec_;
+    settings.numberOfSimulcastStreams = 0;
+    settings.width = stream.width;
+    settings.height = stream.height;
+    settings.maxBitrate = stream.maxBitrate;
+    settings.minBitrate = stream.minBitrate;
+    settings.startBitrate = rates[i];
+    if (settings.startBitrate == 0) {
+      // Paused until the bit rate allows it.
+      settings.startBitrate = std::max(stream.minBitrate, 1u);
+    }
+    if (settings.maxBitrate > 0 &&
+        settings.startBitrate > settings.maxBitrate) {
+      settings.startBitrate = settings.maxBitrate;
+    }
+    if (stream.qpMax > 0) {
+      settings.qpMax = stream.qpMax;
+    }
+    settings.codecSpecific.VP8.numberOfTemporalLayers =
+        stream.numberOfTemporalLayers;
+
+    layer->encoder->RegisterEncodeCompleteCallback(layer);
+    ret_val = layer->encoder->InitEncode(&settings, cores_per_layer,
+                                         max_payload_size);
+    if (ret_val < 0) {
+      Release();
+      return ret_val;
+    }
+    if (i == 0) {
+      // The lowest layer is encoded on the calling thread.
+      continue;
+    }
+    layer->event.reset(EventWrapper::Create());
+    layer->thread.reset(ThreadWrapper::CreateThread(LayerThreadFunction,
+                                                    layer, kHighPriority,
+                                                    "VP8SimulcastThread"));
+    unsigned int thread_id = 0;
+    if (!layer->thread->Start(thread_id)) {
+      Release();
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+  }
+  inited_ = true;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP8SimulcastEncoderImpl::Encode(
+    const I420VideoFrame& input_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const std::vector<VideoFrameType>* frame_types) {
+  if (!inited_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (input_image.IsZeroSize()) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  if (encoded_complete_callback_ == NULL) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  const int64_t start_time_us = TickTime::MicrosecondTimestamp();
+  if (layers_.size() == 1) {
+    const int ret_val = layers_[0]->encoder->Encode(input_image,
+                                                    codec_specific_info,
+                                                    frame_types);
+    const int64_t encode_time_us =
+        TickTime::MicrosecondTimestamp() - start_time_us;
+    CriticalSectionScoped cs(crit_.get());
+    layer_counters_[0].Update(encode_time_us);
+    frame_counter_.Update(encode_time_us);
+    return ret_val;
+  }
+
+  // Build the pyramid from the top, and start encoding each layer as soon as
+  // its input is ready.
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  const I420VideoFrame* source = &input_image;
+  for (int i = static_cast<int>(layers_.size()) - 1; i >= 0; --i) {
+    Layer* layer = layers_[i];
+    layer->has_output = false;
+    layer->result = WEBRTC_VIDEO_CODEC_OK;
+    if (source->width() == layer->width && source->height() == layer->height) {
+      layer->input = source;
+    } else {
+      layer->scaler.Set(source->width(), source->height(),
+                        layer->width, layer->height,
+                        kI420, kI420, kScaleBox);
+      if (layer->scaler.Scale(*source, &layer->scaled_frame) != 0) {
+        ret_val = WEBRTC_VIDEO_CODEC_ERROR;
+        break;
+      }
+      layer->scaled_frame.set_timestamp(input_image.timestamp());
+      layer->scaled_frame.set_render_time_ms(input_image.render_time_ms());
+      layer->input = &layer->scaled_frame;
+    }
+    source = layer->input;
+    if (!layer->active) {
+      continue;
+    }
+
+    VideoFrameType frame_type = kDeltaFrame;
+    if (frame_types && static_cast<int>(frame_types->size()) > i) {
+      frame_type = (*frame_types)[i];
+    } else if (frame_types && !frame_types->empty()) {
+      frame_type = (*frame_types)[0];
+    }
+    if (layer->key_frame_needed) {
+      frame_type = kKeyFrame;
+      layer->key_frame_needed = false;
+    }
+    layer->frame_types[0] = frame_type;
+    layer->codec_specific_info = codec_specific_info;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      ++outstanding_layers_;
+      layer->pending = true;
+    }
+    if (layer->thread.get()) {
+      layer->event->Set();
+    } else {
+      EncodeLayer(layer);
+    }
+  }
+
+  // Wait for the layers running on the worker threads.
+  crit_->Enter();
+  while (outstanding_layers_ > 0) {
+    crit_->Leave();
+    done_event_->Wait(kThreadWaitTimeMs);
+    crit_->Enter();
+  }
+  crit_->Leave();
+  if (ret_val != WEBRTC_VIDEO_CODEC_OK) {
+    return ret_val;
+  }
+
+  // Deliver in stream order so that all layers of a frame are sent together.
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    Layer* layer = layers_[i];
+    if (!layer->active) {
+      continue;
+    }
+    if (layer->result < 0) {
+      ret_val = layer->result;
+      continue;
+    }
+    if (!layer->has_output) {
+      continue;
+    }
+    if (!layer->has_codec_specific) {
+      memset(&layer->codec_specific_out, 0,
+             sizeof(layer->codec_specific_out));
+      layer->codec_specific_out.codecType = kVideoCodecVP8;
+      layer->codec_specific_out.codecSpecific.VP8.pictureId = -1;
+      layer->codec_specific_out.codecSpecific.VP8.tl0PicIdx = -1;
+      layer->codec_specific_out.codecSpecific.VP8.keyIdx = -1;
+    }
+    layer->codec_specific_out.codecSpecific.VP8.simulcastIdx =
+        static_cast<WebRtc_UWord8>(i);
+    encoded_complete_callback_->Encoded(
+        layer->image, &layer->codec_specific_out,
+        layer->has_fragmentation ? &layer->fragmentation : NULL);
+  }
+
+  const int64_t frame_time_us =
+      TickTime::MicrosecondTimestamp() - start_time_us;
+  CriticalSectionScoped cs(crit_.get());
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    if (layers_[i]->active) {
+      layer_counters_[i].Update(layers_[i]->encode_time_us);
+    }
+  }
+  frame_counter_.Update(frame_time_us);
+  return ret_val;
+}
+
+int VP8SimulcastEncoderImpl::RegisterEncodeCompleteCallback(
+    EncodedImageCallback* callback) {
+  encoded_complete_callback_ = callback;
+  if (layers_.size() == 1) {
+    return layers_[0]->encoder->RegisterEncodeCompleteCallback(callback);
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP8SimulcastEncoderImpl::SetChannelParameters(uint32_t packet_loss,
+                                                  int rtt) {
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    int ret = layers_[i]->encoder->SetChannelParameters(packet_loss, rtt);
+    if (ret < 0) {
+      ret_val = ret;
+    }
+  }
+  return ret_val;
+}
+
+int VP8SimulcastEncoderImpl::SetRates(uint32_t new_bitrate_kbit,
+                                      uint32_t frame_rate) {
+  if (!inited_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (layers_.size() == 1) {
+    return layers_[0]->encoder->SetRates(new_bitrate_kbit, frame_rate);
+  }
+  std::vector<uint32_t> rates;
+  AllocateBitrate(new_bitrate_kbit, &rates);
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    Layer* layer = layers_[i];
+    const bool active = (rates[i] > 0);
+    if (active && !layer->active) {
+      // The decoder of this stream has missed the frames in between.
+      layer->key_frame_needed = true;
+    }
+    layer->active = active;
+    if (!active) {
+      continue;
+    }
+    int ret_val = layer->encoder->SetRates(rates[i], frame_rate);
+    if (ret_val < 0) {
+      return ret_val;
+    }
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP8SimulcastEncoderImpl::SetPeriodicKeyFrames(bool enable) {
+  if (layers_.empty()) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    int ret = layers_[i]->encoder->SetPeriodicKeyFrames(enable);
+    if (ret < 0) {
+      ret_val = ret;
+    }
+  }
+  return ret_val;
+}
+
+void VP8SimulcastEncoderImpl::GetStatistics(
+    std::vector<EncodeTimeStatistics>* layers,
+    EncodeTimeStatistics* frames) const {
+  CriticalSectionScoped cs(crit_.get());
+  layers->resize(layer_counters_.size());
+  for (size_t i = 0; i < layer_counters_.size(); ++i) {
+    layer_counters_[i].GetStatistics(&(*layers)[i]);
+  }
+  frame_counter_.GetStatistics(frames);
+}
+
+void VP8SimulcastEncoderImpl::AllocateBitrate(
+    uint32_t bit_rate_kbit, std::vector<uint32_t>* rates) const {
+  const int number_of_streams = codec_.numberOfSimulcastStreams;
+  rates->assign(number_of_streams, 0);
+  uint32_t total_target_bitrate = 0;
+  uint32_t total_pixels = 0;
+  for (int i = 0; i < number_of_streams; ++i) {
+    total_target_bitrate += codec_.simulcastStream[i].targetBitrate;
+    total_pixels += codec_.simulcastStream[i].width *
+        codec_.simulcastStream[i].height;
+  }
+  uint32_t remaining_bitrate = bit_rate_kbit;
+  for (int i = 0; i < number_of_streams; ++i) {
+    const SimulcastStream& stream = codec_.simulcastStream[i];
+    uint32_t rate = 0;
+    if (total_target_bitrate == 0) {
+      // No targets given, split in proportion to the frame sizes.
+      rate = static_cast<uint32_t>(static_cast<uint64_t>(bit_rate_kbit) *
+          stream.width * stream.height / total_pixels);
+    } else if (i == number_of_streams - 1) {
+      rate = remaining_bitrate;
+    } else {
+      rate = std::min(remaining_bitrate, stream.targetBitrate);
+    }
+    if (stream.maxBitrate > 0) {
+      rate = std::min(rate, stream.maxBitrate);
+    }
+    if (i > 0 && (rate == 0 || rate < stream.minBitrate)) {
+      // Pause this and all higher streams. The lowest stream is always sent.
+      break;
+    }
+    (*rates)[i] = std::max(rate, 1u);
+    remaining_bitrate -= std::min(remaining_bitrate, rate);
+  }
+}
+
+bool VP8SimulcastEncoderImpl::LayerThreadFunction(void* obj) {
+  Layer* layer = static_cast<Layer*>(obj);
+  VP8SimulcastEncoderImpl* parent = layer->parent;
+  layer->event->Wait(kThreadWaitTimeMs);
+  bool pending = false;
+  {
+    CriticalSectionScoped cs(parent->crit_.get());
+    pending = layer->pending;
+  }
+  if (pending) {
+    parent->EncodeLayer(layer);
+  }
+  return true;
+}
+
+void VP8SimulcastEncoderImpl::EncodeLayer(Layer* layer) {
+  const int64_t start_time_us = TickTime::MicrosecondTimestamp();
+  layer->result = layer->encoder->Encode(*layer->input,
+                                         layer->codec_specific_info,
+                                         &layer->frame_types);
+  layer->encode_time_us = TickTime::MicrosecondTimestamp() - start_time_us;
+
+  CriticalSectionScoped cs(crit_.get());
+  layer->pending = false;
+  if (--outstanding_layers_ == 0) {
+    done_event_->Set();
+  }
+}
+
+void VP8SimulcastEncoderImpl::StopThreads() {
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    Layer* layer = layers_[i];
+    if (!layer->thread.get()) {
+      continue;
+    }
+    layer->thread->SetNotAlive();
+    layer->event->Set();
+    layer->thread->Stop();
+    layer->thread.reset();
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ * WEBRTC VP8 simulcast wrapper
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_ENCODER_IMPL_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_ENCODER_IMPL_H_
+
+#include <vector>
+
+#include "common_video/libyuv/include/scaler.h"
+#include "modules/video_coding/codecs/vp8/include/vp8_simulcast_encoder.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class EventWrapper;
+class ThreadWrapper;
+
+class VP8SimulcastEncoderImpl : public VP8SimulcastEncoder {
+ public:
+  // Creates the encoder of each stream.
+  typedef VideoEncoder* (*CreateEncoderFunction)();
+
+  explicit VP8SimulcastEncoderImpl(CreateEncoderFunction create_encoder);
+
+  virtual ~VP8SimulcastEncoderImpl();
+
+  virtual int Release();
+
+  virtual int InitEncode(const VideoCodec* codec_settings,
+                         int number_of_cores,
+                         uint32_t max_payload_size);
+
+  virtual int Encode(const I420VideoFrame& input_image,
+                     const CodecSpecificInfo* codec_specific_info,
+                     const std::vector<VideoFrameType>* frame_types);
+
+  virtual int RegisterEncodeCompleteCallback(EncodedImageCallback* callback);
+
+  virtual int SetChannelParameters(uint32_t packet_loss, int rtt);
+
+  virtual int SetRates(uint32_t new_bitrate_kbit, uint32_t frame_rate);
+
+  virtual int SetPeriodicKeyFrames(bool enable);
+
+  virtual void GetStatistics(std::vector<EncodeTimeStatistics>* layers,
+                             EncodeTimeStatistics* frames) const;
+
+ private:
+  class Layer;
+
+  struct TimeCounter {
+    TimeCounter() : frames(0), total_time_us(0), max_time_us(0) {}
+
+    void Update(int64_t time_us);
+    void GetStatistics(EncodeTimeStatistics* statistics) const;
+
+    unsigned int frames;
+    int64_t total_time_us;
+    int64_t max_time_us;
+  };
+
+  static bool LayerThreadFunction(void* obj);
+
+  // Splits |bit_rate_kbit| between the streams. Returns the rate of each
+  // stream in |rates|, 0 for streams that should be paused.
+  void AllocateBitrate(uint32_t bit_rate_kbit,
+                       std::vector<uint32_t>* rates) const;
+  // Encodes |layer| and signals |done_event_| when the last outstanding layer
+  // is done.
+  void EncodeLayer(Layer* layer);
+  void StopThreads();
+
+  CreateEncoderFunction create_encoder_;
+  EncodedImageCallback* encoded_complete_callback_;
+  VideoCodec codec_;
+  bool inited_;
+  // Lowest resolution first.
+  std::vector<Layer*> layers_;
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<EventWrapper> done_event_;
+  int outstanding_layers_;
+
+  std::vector<TimeCounter> layer_counters_;
+  TimeCounter frame_counter_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_ENCODER_IMPL_H_
@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/video_coding/codecs/vp8/vp8_simulcast_encoder_impl.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+static const int kNumStreams = 3;
+static const int kWidth = 1280;
+static const int kHeight = 720;
+
+class FakeEncoder : public VideoEncoder {
+ public:
+  FakeEncoder()
+      : callback_(NULL), width_(0), height_(0), bit_rate_(0),
+        encoded_frames_(0), last_frame_type_(kDeltaFrame) {
+    memset(buffer_, 0, sizeof(buffer_));
+  }
+
+  virtual int InitEncode(const VideoCodec* codec_settings,
+                         int number_of_cores,
+                         uint32_t max_payload_size) {
+    width_ = codec_settings->width;
+    height_ = codec_settings->height;
+    bit_rate_ = codec_settings->startBitrate;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int Encode(const I420VideoFrame& input_image,
+                     const CodecSpecificInfo* codec_specific_info,
+                     const std::vector<VideoFrameType>* frame_types) {
+    EXPECT_EQ(width_, input_image.width());
+    EXPECT_EQ(height_, input_image.height());
+    last_frame_type_ = (*frame_types)[0];
+    ++encoded_frames_;
+    EncodedImage image(buffer_, sizeof(buffer_), sizeof(buffer_));
+    image._encodedWidth = input_image.width();
+    image._encodedHeight = input_image.height();
+    image._timeStamp = input_image.timestamp();
+    image._frameType = last_frame_type_;
+    CodecSpecificInfo info;
+    memset(&info, 0, sizeof(info));
+    info.codecType = kVideoCodecVP8;
+    callback_->Encoded(image, &info, NULL);
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int RegisterEncodeCompleteCallback(EncodedImageCallback* callback) {
+    callback_ = callback;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int Release() { return WEBRTC_VIDEO_CODEC_OK; }
+
+  virtual int SetChannelParameters(uint32_t packet_loss, int rtt) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int SetRates(uint32_t new_bitrate_kbit, uint32_t frame_rate) {
+    bit_rate_ = new_bitrate_kbit;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  EncodedImageCallback* callback_;
+  int width_;
+  int height_;
+  uint32_t bit_rate_;
+  int encoded_frames_;
+  VideoFrameType last_frame_type_;
+  WebRtc_UWord8 buffer_[10];
+};
+
+static std::vector<FakeEncoder*> fake_encoders;
+
+static VideoEncoder* CreateFakeEncoder() {
+  FakeEncoder* encoder = new FakeEncoder();
+  fake_encoders.push_back(encoder);
+  return encoder;
+}
+
+class EncodedFrameCollector : public EncodedImageCallback {
+ public:
+  virtual WebRtc_Word32 Encoded(EncodedImage& encoded_image,
+                                const CodecSpecificInfo* codec_specific_info,
+                                const RTPFragmentationHeader* fragmentation) {
+    EXPECT_TRUE(codec_specific_info != NULL);
+    widths_.push_back(encoded_image._encodedWidth);
+    simulcast_indices_.push_back(
+        codec_specific_info->codecSpecific.VP8.simulcastIdx);
+    return 0;
+  }
+
+  std::vector<int> widths_;
+  std::vector<int> simulcast_indices_;
+};
+
+class TestVP8SimulcastEncoder : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    fake_encoders.clear();
+    encoder_.reset(new VP8SimulcastEncoderImpl(CreateFakeEncoder));
+    encoder_->RegisterEncodeCompleteCallback(&collector_);
+    memset(&codec_, 0, sizeof(codec_));
+    codec_.codecType = kVideoCodecVP8;
+    codec_.width = kWidth;
+    codec_.height = kHeight;
+    codec_.maxFramerate = 30;
+    codec_.startBitrate = 2000;
+    codec_.numberOfSimulcastStreams = kNumStreams;
+    for (int i = 0; i < kNumStreams; ++i) {
+      SimulcastStream& stream = codec_.simulcastStream[i];
+      stream.width = kWidth >> (kNumStreams - 1 - i);
+      stream.height = kHeight >> (kNumStreams - 1 - i);
+    }
+    codec_.simulcastStream[0].targetBitrate = 100;
+    codec_.simulcastStream[1].targetBitrate = 500;
+    codec_.simulcastStream[1].minBitrate = 200;
+    codec_.simulcastStream[2].targetBitrate = 1200;
+    codec_.simulcastStream[2].minBitrate = 900;
+    frame_.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+    frame_types_.assign(kNumStreams, kDeltaFrame);
+  }
+
+  virtual void TearDown() {
+    encoder_.reset();
+    fake_encoders.clear();
+  }
+
+  scoped_ptr<VP8SimulcastEncoderImpl> encoder_;
+  EncodedFrameCollector collector_;
+  VideoCodec codec_;
+  I420VideoFrame frame_;
+  std::vector<VideoFrameType> frame_types_;
+};
+
+TEST_F(TestVP8SimulcastEncoder, EncodesAllLayersInOrder) {
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->InitEncode(&codec_, 4, 1200));
+  ASSERT_EQ(static_cast<size_t>(kNumStreams), fake_encoders.size());
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_EQ(codec_.simulcastStream[i].width, fake_encoders[i]->width_);
+  }
+  const int kNumFrames = 10;
+  for (int n = 0; n < kNumFrames; ++n) {
+    frame_.set_timestamp(n * 3000);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(frame_, NULL, &frame_types_));
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumFrames * kNumStreams),
+            collector_.widths_.size());
+  for (size_t i = 0; i < collector_.widths_.size(); ++i) {
+    const int stream = i % kNumStreams;
+    EXPECT_EQ(stream, collector_.simulcast_indices_[i]);
+    EXPECT_EQ(codec_.simulcastStream[stream].width, collector_.widths_[i]);
+  }
+  std::vector<EncodeTimeStatistics> layers;
+  EncodeTimeStatistics frames;
+  encoder_->GetStatistics(&layers, &frames);
+  ASSERT_EQ(static_cast<size_t>(kNumStreams), layers.size());
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_EQ(static_cast<unsigned int>(kNumFrames), layers[i].frames);
+  }
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames), frames.frames);
+}
+
+TEST_F(TestVP8SimulcastEncoder, SplitsBitrateAndPausesStreams) {
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->InitEncode(&codec_, 1, 1200));
+  EXPECT_EQ(100u, fake_encoders[0]->bit_rate_);
+  EXPECT_EQ(500u, fake_encoders[1]->bit_rate_);
+  EXPECT_EQ(1400u, fake_encoders[2]->bit_rate_);
+
+  // Not enough for the min bit rate of the highest stream.
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->SetRates(700, 30));
+  EXPECT_EQ(100u, fake_encoders[0]->bit_rate_);
+  EXPECT_EQ(500u, fake_encoders[1]->bit_rate_);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->Encode(frame_, NULL, &frame_types_));
+  EXPECT_EQ(2u, collector_.widths_.size());
+  EXPECT_EQ(0, fake_encoders[2]->encoded_frames_);
+
+  // The resumed stream starts with a key frame.
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->SetRates(2500, 30));
+  EXPECT_EQ(1900u, fake_encoders[2]->bit_rate_);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->Encode(frame_, NULL, &frame_types_));
+  EXPECT_EQ(5u, collector_.widths_.size());
+  EXPECT_EQ(kKeyFrame, fake_encoders[2]->last_frame_type_);
+  EXPECT_EQ(kDeltaFrame, fake_encoders[1]->last_frame_type_);
+}
+
+TEST_F(TestVP8SimulcastEncoder, PassesThroughSingleStream) {
+  codec_.numberOfSimulcastStreams = 0;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->InitEncode(&codec_, 1, 1200));
+  ASSERT_EQ(1u, fake_encoders.size());
+  EXPECT_EQ(&collector_, fake_encoders[0]->callback_);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->Encode(frame_, NULL, &frame_types_));
+  ASSERT_EQ(1u, collector_.widths_.size());
+  EXPECT_EQ(kWidth, collector_.widths_[0]);
+}
+
+}  // namespace webrtc
@@ -17,7 +17,7 @@
 #include "webrtc/modules/video_coding/codecs/i420/main/interface/i420.h"
 #endif
 #ifdef VIDEOCODEC_VP8
-#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8_simulcast_encoder.h"
 #endif
 #include "webrtc/modules/video_coding/main/source/internal_defines.h"
 #include "webrtc/system_wrappers/interface/trace.h"
@@ -520,7 +520,7 @@ VCMGenericEncoder* VCMCodecDataBase::CreateEncoder(
   switch (type) {
 #ifdef VIDEOCODEC_VP8
     case kVideoCodecVP8:
-      return new VCMGenericEncoder(*(VP8Encoder::Create()));
+      return new VCMGenericEncoder(*(VP8SimulcastEncoder::Create()));
 #endif
 #ifdef VIDEOCODEC_I420
     case kVideoCodecI420:
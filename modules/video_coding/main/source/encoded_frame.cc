@@ -22,7 +22,8 @@ _renderTimeMs(-1),
 _payloadType(0),
 _missingFrame(false),
 _codec(kVideoCodecUnknown),
-_fragmentation()
+_fragmentation(),
+_payloadStorage(NULL)
 {
     _codecSpecificInfo.codecType = kVideoCodecUnknown;
 }
@@ -34,7 +35,8 @@ _renderTimeMs(-1),
 _payloadType(0),
 _missingFrame(false),
 _codec(kVideoCodecUnknown),
-_fragmentation()
+_fragmentation(),
+_payloadStorage(NULL)
 {
     _codecSpecificInfo.codecType = kVideoCodecUnknown;
     _buffer = NULL;
@@ -55,7 +57,8 @@ VCMEncodedFrame::VCMEncodedFrame(const VCMEncodedFrame& rhs)
     _missingFrame(rhs._missingFrame),
     _codecSpecificInfo(rhs._codecSpecificInfo),
     _codec(rhs._codec),
-    _fragmentation() {
+    _fragmentation(),
+    _payloadStorage(NULL) {
   _buffer = NULL;
   _size = 0;
   _length = 0;
@@ -76,11 +79,18 @@ VCMEncodedFrame::~VCMEncodedFrame()
 void VCMEncodedFrame::Free()
 {
     Reset();
-    if (_buffer != NULL)
+    ReleasePayload();
+}
+
+void VCMEncodedFrame::ReleasePayload()
+{
+    if (_payloadStorage != NULL && --_payloadStorage->refCount == 0)
     {
-        delete [] _buffer;
-        _buffer = NULL;
+        delete _payloadStorage;
     }
+    _payloadStorage = NULL;
+    _buffer = NULL;
+    _size = 0;
 }
 
 void VCMEncodedFrame::Reset()
@@ -178,20 +188,68 @@ VCMEncodedFrame::VerifyAndAllocate(const WebRtc_UWord32 minimumSize)
     if(minimumSize > _size)
     {
         // create buffer of sufficient size
-        WebRtc_UWord8* newBuffer = new WebRtc_UWord8[minimumSize];
-        if (newBuffer == NULL)
+        VCMPayloadStorage* newStorage = new VCMPayloadStorage(minimumSize);
+        if (newStorage == NULL)
         {
             return -1;
         }
         if(_buffer)
         {
             // copy old data
-            memcpy(newBuffer, _buffer, _size);
-            delete [] _buffer;
+            memcpy(newStorage->data, _buffer, _size);
         }
-        _buffer = newBuffer;
+        const WebRtc_UWord32 length = _length;
+        ReleasePayload();
+        _payloadStorage = newStorage;
+        _buffer = newStorage->data;
         _size = minimumSize;
+        _length = length;
+    }
+    return 0;
+}
+
+void VCMEncodedFrame::SharePayload(const VCMEncodedFrame& rhs)
+{
+    if (_payloadStorage == rhs._payloadStorage)
+    {
+        _length = rhs._length;
+        return;
+    }
+    ReleasePayload();
+    if (rhs._payloadStorage != NULL)
+    {
+        ++rhs._payloadStorage->refCount;
+        _payloadStorage = rhs._payloadStorage;
+        _buffer = rhs._buffer;
+        _size = rhs._size;
+    }
+    _length = rhs._length;
+}
+
+bool VCMEncodedFrame::PayloadShared() const
+{
+    return _payloadStorage != NULL && _payloadStorage->refCount.Value() > 1;
+}
+
+WebRtc_Word32 VCMEncodedFrame::MakePayloadWritable()
+{
+    if (!PayloadShared())
+    {
+        return 0;
+    }
+    VCMPayloadStorage* newStorage = new VCMPayloadStorage(_size);
+    if (newStorage == NULL)
+    {
+        return -1;
     }
+    memcpy(newStorage->data, _buffer, _length);
+    const WebRtc_UWord32 size = _size;
+    const WebRtc_UWord32 length = _length;
+    ReleasePayload();
+    _payloadStorage = newStorage;
+    _buffer = newStorage->data;
+    _size = size;
+    _length = length;
     return 0;
 }
 
@@ -18,10 +18,25 @@
 #include "modules/interface/module_common_types.h"
 #include "modules/video_coding/codecs/interface/video_codec_interface.h"
 #include "modules/video_coding/main/interface/video_coding_defines.h"
+#include "system_wrappers/interface/atomic32.h"
 
 namespace webrtc
 {
 
+// Reference counted storage for an encoded payload. Several frames may point
+// to the same storage as long as none of them writes to it, see
+// VCMEncodedFrame::SharePayload().
+struct VCMPayloadStorage
+{
+    explicit VCMPayloadStorage(WebRtc_UWord32 size)
+        : data(new WebRtc_UWord8[size]), size(size), refCount(1) {}
+    ~VCMPayloadStorage() { delete [] data; }
+
+    WebRtc_UWord8*  data;
+    WebRtc_UWord32  size;
+    Atomic32        refCount;
+};
+
 class VCMEncodedFrame : protected EncodedImage
 {
 public:
@@ -108,6 +123,22 @@ protected:
     */
     WebRtc_Word32 VerifyAndAllocate(const WebRtc_UWord32 minimumSize);
 
+    /**
+    * Releases the current payload and references the payload of rhs instead.
+    * No payload data is copied.
+    */
+    void SharePayload(const VCMEncodedFrame& rhs);
+    /**
+    * True if the payload is referenced by more than one frame.
+    */
+    bool PayloadShared() const;
+    /**
+    * Makes sure this frame is the only owner of its payload, copying it to a
+    * new buffer if it is shared. Must be called before writing to _buffer.
+    * Returns -1 on allocation failure.
+    */
+    WebRtc_Word32 MakePayloadWritable();
+
     void Reset();
 
     void CopyCodecSpecific(const RTPVideoHeader* header);
@@ -118,6 +149,11 @@ protected:
     CodecSpecificInfo             _codecSpecificInfo;
     webrtc::VideoCodecType        _codec;
     RTPFragmentationHeader        _fragmentation;
+
+private:
+    void ReleasePayload();
+
+    VCMPayloadStorage*            _payloadStorage;
 };
 
 } // namespace webrtc
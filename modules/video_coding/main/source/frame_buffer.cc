@@ -40,6 +40,50 @@ _latestPacketTimeMs(rhs._latestPacketTimeMs)
     _sessionInfo.UpdateDataPointers(rhs._buffer, _buffer);
 }
 
+void
+VCMFrameBuffer::ShareFrom(const VCMFrameBuffer& rhs)
+{
+    if (this == &rhs)
+    {
+        return;
+    }
+    SharePayload(rhs);
+    _timeStamp = rhs._timeStamp;
+    _encodedWidth = rhs._encodedWidth;
+    _encodedHeight = rhs._encodedHeight;
+    _frameType = rhs._frameType;
+    _completeFrame = rhs._completeFrame;
+    _renderTimeMs = rhs._renderTimeMs;
+    _payloadType = rhs._payloadType;
+    _missingFrame = rhs._missingFrame;
+    _codecSpecificInfo = rhs._codecSpecificInfo;
+    _codec = rhs._codec;
+    _fragmentation.CopyFrom(rhs._fragmentation);
+    _state = rhs._state;
+    _frameCounted = rhs._frameCounted;
+    _nackCount = rhs._nackCount;
+    _latestPacketTimeMs = rhs._latestPacketTimeMs;
+    // The packets point into the shared payload, so no pointer update is
+    // needed until the payload is detached.
+    _sessionInfo = rhs._sessionInfo;
+}
+
+bool
+VCMFrameBuffer::MakeWritable()
+{
+    if (!PayloadShared())
+    {
+        return true;
+    }
+    const WebRtc_UWord8* prevBuffer = _buffer;
+    if (MakePayloadWritable() == -1)
+    {
+        return false;
+    }
+    _sessionInfo.UpdateDataPointers(prevBuffer, _buffer);
+    return true;
+}
+
 webrtc::FrameType
 VCMFrameBuffer::FrameType() const
 {
@@ -124,6 +168,10 @@ VCMFrameBuffer::InsertPacket(const VCMPacket& packet, WebRtc_Word64 timeInMs,
     {
         return kSizeError;
     }
+    if (!MakeWritable())
+    {
+        return kSizeError;
+    }
     if (packet.dataPtr != NULL)
     {
         _payloadType = packet.payloadType;
@@ -241,6 +289,12 @@ void
 VCMFrameBuffer::MakeSessionDecodable()
 {
     WebRtc_UWord32 retVal;
+    // A complete session has nothing to remove, so a shared payload can stay
+    // shared.
+    if (!_sessionInfo.complete() && !MakeWritable())
+    {
+        return;
+    }
 #ifdef INDEPENDENT_PARTITIONS
     if (_codec != kVideoCodecVP8) {
         retVal = _sessionInfo.MakeDecodable();
@@ -332,6 +386,10 @@ VCMFrameBuffer::ExtractFromStorage(const EncodedVideoData& frameFromStorage)
     _completeFrame = frameFromStorage.completeFrame;
     _renderTimeMs = frameFromStorage.renderTimeMs;
     _codec = frameFromStorage.codec;
+    if (!MakeWritable())
+    {
+        return VCM_MEMORY;
+    }
     const WebRtc_UWord8 *prevBuffer = _buffer;
     if (VerifyAndAllocate(frameFromStorage.payloadSize) < 0)
     {
@@ -383,7 +441,7 @@ void
 VCMFrameBuffer::PrepareForDecode()
 {
 #ifdef INDEPENDENT_PARTITIONS
-    if (_codec == kVideoCodecVP8)
+    if (_codec == kVideoCodecVP8 && MakeWritable())
     {
         _length =
             _sessionInfo.BuildVP8FragmentationHeader(_buffer, _length,
@@ -28,6 +28,11 @@ public:
 
     VCMFrameBuffer(VCMFrameBuffer& rhs);
 
+    // Makes |this| a copy of |rhs| which shares the payload buffer of |rhs|
+    // instead of copying it. The payload is copied by whichever frame first
+    // writes to it.
+    void ShareFrom(const VCMFrameBuffer& rhs);
+
     virtual void Reset();
 
     VCMFrameBufferEnum InsertPacket(const VCMPacket& packet,
@@ -87,6 +92,10 @@ protected:
     void PrepareForDecode();
 
 private:
+    // Copies the payload if it is shared with another frame and updates the
+    // session packet pointers. Returns false on allocation failure.
+    bool MakeWritable();
+
     VCMFrameBufferStateEnum    _state;         // Current state of the frame
     bool                       _frameCounted;  // Was this frame counted by JB?
     VCMSessionInfo             _sessionInfo;
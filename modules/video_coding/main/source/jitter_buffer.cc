@@ -76,7 +76,8 @@ VCMJitterBuffer::VCMJitterBuffer(Clock* clock,
       receiver_id_(receiver_id),
       clock_(clock),
       running_(false),
-      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection(
+          "VCMJitterBuffer")),
       master_(master),
       frame_event_(event_factory->CreateEvent()),
       packet_event_(event_factory->CreateEvent()),
@@ -158,15 +159,20 @@ void VCMJitterBuffer::CopyFrom(const VCMJitterBuffer& rhs) {
     nack_seq_nums_.resize(rhs.nack_seq_nums_.size());
     missing_sequence_numbers_ = rhs.missing_sequence_numbers_;
     latest_received_sequence_number_ = rhs.latest_received_sequence_number_;
+    frame_list_.clear();
+    // Reuse the frames we already have and let them share the payload of the
+    // frames in |rhs|. Payloads are only copied when either side writes to
+    // them.
     for (int i = 0; i < kMaxNumberOfFrames; i++) {
-      if (frame_buffers_[i] != NULL) {
+      if (i >= max_number_of_frames_) {
         delete frame_buffers_[i];
         frame_buffers_[i] = NULL;
+        continue;
       }
-    }
-    frame_list_.clear();
-    for (int i = 0; i < max_number_of_frames_; i++) {
-      frame_buffers_[i] = new VCMFrameBuffer(*(rhs.frame_buffers_[i]));
+      if (frame_buffers_[i] == NULL) {
+        frame_buffers_[i] = new VCMFrameBuffer();
+      }
+      frame_buffers_[i]->ShareFrom(*(rhs.frame_buffers_[i]));
       if (frame_buffers_[i]->Length() > 0) {
         FrameList::reverse_iterator rit = std::find_if(
             frame_list_.rbegin(), frame_list_.rend(),
@@ -61,7 +61,8 @@ class VCMJitterBuffer {
                   bool master);
   virtual ~VCMJitterBuffer();
 
-  // Makes |this| a deep copy of |rhs|.
+  // Makes |this| a copy of |rhs|. The frames of |this| share their payload
+  // with the frames of |rhs| until either of them is written to.
   void CopyFrom(const VCMJitterBuffer& rhs);
 
   // Initializes and starts jitter buffer.
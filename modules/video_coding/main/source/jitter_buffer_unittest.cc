@@ -13,11 +13,13 @@
 #include <list>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/source/frame_buffer.h"
 #include "webrtc/modules/video_coding/main/source/jitter_buffer.h"
 #include "webrtc/modules/video_coding/main/source/media_opt_util.h"
 #include "webrtc/modules/video_coding/main/source/packet.h"
 #include "webrtc/modules/video_coding/main/test/test_util.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
 
@@ -373,6 +375,104 @@ TEST_F(TestRunningJitterBuffer, StatisticsTest) {
   EXPECT_EQ(kDefaultBitrateKbps, bitrate);
 }
 
+TEST_F(TestJitterBufferNack, CopyFromSharesPayload) {
+  VCMJitterBuffer dual_jitter_buffer(clock_.get(), &event_factory_, -1, -1,
+                                     false);
+  dual_jitter_buffer.SetNackSettings(max_nack_list_size_,
+                                     oldest_packet_to_nack_);
+  dual_jitter_buffer.Start();
+  InsertFrame(kVideoFrameKey);
+  stream_generator->GenerateFrame(kVideoFrameDelta, 2, 0,
+                                  clock_->TimeInMilliseconds());
+  EXPECT_EQ(kFirstPacket, InsertPacketAndPop(0));
+  dual_jitter_buffer.CopyFrom(*jitter_buffer_);
+
+  // Complete the delta frame in both jitter buffers. The first write to the
+  // shared frame must copy the payload rather than modify the other buffer.
+  EXPECT_EQ(kCompleteSession, InsertPacket(0));
+  VCMPacket packet;
+  ASSERT_TRUE(stream_generator->PopPacket(&packet, 0));
+  VCMEncodedFrame* frame = NULL;
+  ASSERT_EQ(VCM_OK, dual_jitter_buffer.GetFrame(packet, frame));
+  EXPECT_EQ(kCompleteSession, dual_jitter_buffer.InsertPacket(frame, packet));
+
+  // The key frame was never written to after the copy and is still shared.
+  frame = jitter_buffer_->GetCompleteFrameForDecoding(0);
+  VCMEncodedFrame* dual_frame = dual_jitter_buffer.GetFrameForDecoding();
+  ASSERT_TRUE(frame != NULL);
+  ASSERT_TRUE(dual_frame != NULL);
+  EXPECT_EQ(kVideoFrameKey, dual_frame->FrameType());
+  EXPECT_EQ(frame->TimeStamp(), dual_frame->TimeStamp());
+  EXPECT_EQ(frame->Length(), dual_frame->Length());
+  EXPECT_EQ(frame->Buffer(), dual_frame->Buffer());
+  jitter_buffer_->ReleaseFrame(frame);
+  dual_jitter_buffer.ReleaseFrame(dual_frame);
+
+  frame = jitter_buffer_->GetCompleteFrameForDecoding(0);
+  dual_frame = dual_jitter_buffer.GetCompleteFrameForDecoding(0);
+  ASSERT_TRUE(frame != NULL);
+  ASSERT_TRUE(dual_frame != NULL);
+  EXPECT_EQ(frame->TimeStamp(), dual_frame->TimeStamp());
+  EXPECT_EQ(2 * ((kFrameSize + 1) / 2), frame->Length());
+  EXPECT_EQ(frame->Length(), dual_frame->Length());
+  EXPECT_NE(frame->Buffer(), dual_frame->Buffer());
+  EXPECT_EQ(0, memcmp(frame->Buffer(), dual_frame->Buffer(), frame->Length()));
+  jitter_buffer_->ReleaseFrame(frame);
+  dual_jitter_buffer.ReleaseFrame(dual_frame);
+  dual_jitter_buffer.Stop();
+}
+
+// Measures the cost of handing the state of the primary jitter buffer over to
+// the dual jitter buffer, which is what happens when the dual decoder is
+// enabled in NACK mode.
+TEST_F(TestJitterBufferNack, DualReceiverHandoffBenchmark) {
+  const int kNumFrames = 30;
+  const int kNumIterations = 1000;
+  const int kPacketSize = 1200;
+  const int kWidths[] = {1280, 1920};
+  const int kHeights[] = {720, 1080};
+  for (int i = 0; i < 2; ++i) {
+    jitter_buffer_->Flush();
+    // Assume roughly 0.1 byte per pixel for key frames and 0.025 for delta
+    // frames.
+    const int key_frame_size = kWidths[i] * kHeights[i] / 10;
+    int frame_bytes = 0;
+    for (int j = 0; j < kNumFrames; ++j) {
+      const int frame_size = (j == 0) ? key_frame_size : key_frame_size / 4;
+      const int num_packets = (frame_size + kPacketSize - 1) / kPacketSize;
+      const uint16_t seq_num = stream_generator->NextSequenceNumber();
+      const uint32_t timestamp = 90 * clock_->TimeInMilliseconds();
+      for (int k = 0; k < num_packets; ++k) {
+        VCMPacket packet = stream_generator->GeneratePacket(
+            seq_num + k, timestamp, kPacketSize, k == 0, k == num_packets - 1,
+            (j == 0) ? kVideoFrameKey : kVideoFrameDelta);
+        VCMEncodedFrame* frame = NULL;
+        ASSERT_EQ(VCM_OK, jitter_buffer_->GetFrame(packet, frame));
+        EXPECT_GE(jitter_buffer_->InsertPacket(frame, packet), kNoError);
+      }
+      stream_generator->Init(seq_num + num_packets, timestamp,
+                             clock_->TimeInMilliseconds());
+      frame_bytes += num_packets * kPacketSize;
+      clock_->AdvanceTimeMilliseconds(kDefaultFramePeriodMs);
+    }
+
+    VCMJitterBuffer dual_jitter_buffer(clock_.get(), &event_factory_, -1, -1,
+                                       false);
+    dual_jitter_buffer.SetNackSettings(max_nack_list_size_,
+                                       oldest_packet_to_nack_);
+    dual_jitter_buffer.Start();
+    TickTime start = TickTime::Now();
+    for (int j = 0; j < kNumIterations; ++j) {
+      dual_jitter_buffer.CopyFrom(*jitter_buffer_);
+    }
+    double total_time_us = (TickTime::Now() - start).Microseconds();
+    printf("%dx%d: %d frames (%d bytes) handed over in %.2f us per switch.\n",
+           kWidths[i], kHeights[i], kNumFrames, frame_bytes,
+           total_time_us / kNumIterations);
+    dual_jitter_buffer.Stop();
+  }
+}
+
 TEST_F(TestJitterBufferNack, TestEmptyPackets) {
   // Make sure empty packets doesn't clog the jitter buffer.
   jitter_buffer_->SetNackMode(kNackHybrid, media_optimization::kLowRttNackMs,
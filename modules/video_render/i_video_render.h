@@ -94,6 +94,14 @@ public:
 
     virtual WebRtc_UWord32 RenderFrameRate(const WebRtc_UWord32 streamId) = 0;
 
+    // Only renderers that measure their drawing override this.
+    virtual WebRtc_Word32
+            GetRenderStatistics(const WebRtc_UWord32 /*streamId*/,
+                                VideoRenderStatistics& /*statistics*/) const
+    {
+        return -1;
+    }
+
     virtual WebRtc_Word32 SetStreamCropping(const WebRtc_UWord32 streamId,
                                             const float left,
                                             const float top,
@@ -225,6 +225,14 @@ public:
      */
     virtual WebRtc_UWord32 RenderFrameRate(const WebRtc_UWord32 streamId) = 0;
 
+    /*
+     *   Gets the cost of drawing the frames of this stream since it was added.
+     *   Fails if the renderer doesn't keep statistics.
+     */
+    virtual WebRtc_Word32
+            GetRenderStatistics(const WebRtc_UWord32 streamId,
+                                VideoRenderStatistics& statistics) const = 0;
+
     /*
      *   Set cropping of incoming stream
      */
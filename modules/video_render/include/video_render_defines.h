@@ -70,6 +70,25 @@ protected:
     }
 };
 
+// Cost of drawing the frames of an incoming stream.
+struct VideoRenderStatistics
+{
+  VideoRenderStatistics() {
+    frames = 0;
+    direct_frames = 0;
+    total_render_time_us = 0;
+    max_render_time_us = 0;
+  }
+
+  // Frames drawn to the window.
+  WebRtc_UWord32 frames;
+  // Frames handed to the display as I420, without color conversion.
+  WebRtc_UWord32 direct_frames;
+  // Time spent converting, copying and drawing the frames.
+  WebRtc_UWord64 total_render_time_us;
+  WebRtc_UWord32 max_render_time_us;
+};
+
 // Mobile enums
 enum StretchMode
 {
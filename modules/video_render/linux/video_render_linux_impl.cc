@@ -206,6 +206,19 @@ WebRtc_UWord32 VideoRenderLinuxImpl::RenderFrameRate(const WebRtc_UWord32 /*stre
     return -1;
 }
 
+WebRtc_Word32 VideoRenderLinuxImpl::GetRenderStatistics(
+    const WebRtc_UWord32 streamId,
+    VideoRenderStatistics& statistics) const
+{
+    CriticalSectionScoped cs(&_renderLinuxCritsect);
+
+    if (_ptrX11Render)
+    {
+        return _ptrX11Render->GetRenderStatistics(streamId, statistics);
+    }
+    return -1;
+}
+
 WebRtc_Word32 VideoRenderLinuxImpl::SetStreamCropping(
                                                       const WebRtc_UWord32 /*streamId*/,
                                                       const float /*left*/,
@@ -91,6 +91,10 @@ public:
 
     virtual WebRtc_UWord32 RenderFrameRate(const WebRtc_UWord32 streamId);
 
+    virtual WebRtc_Word32
+            GetRenderStatistics(const WebRtc_UWord32 streamId,
+                                VideoRenderStatistics& statistics) const;
+
     virtual WebRtc_Word32 SetStreamCropping(const WebRtc_UWord32 streamId,
                                             const float left, const float top,
                                             const float right,
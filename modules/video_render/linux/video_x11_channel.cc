@@ -10,20 +10,27 @@
 
 #include "video_x11_channel.h"
 
+#include <string.h>
+
 #include "critical_section_wrapper.h"
+#include "tick_util.h"
 #include "trace.h"
 
 namespace webrtc {
 
 #define DISP_MAX 128
 
+// XVideo image format of planar Y, U, V 4:2:0.
+#define XV_IMAGE_I420 0x30323449 // 'I420'
+
 static Display *dispArray[DISP_MAX];
 static int dispCount = 0;
 
 
 VideoX11Channel::VideoX11Channel(WebRtc_Word32 id) :
     _crit(*CriticalSectionWrapper::CreateCriticalSection()), _display(NULL),
-          _shminfo(), _image(NULL), _window(0L), _gc(NULL),
+          _shminfo(), _image(NULL), _xvPort(0), _xvImage(NULL), _window(0L),
+          _gc(NULL),
           _width(DEFAULT_RENDER_FRAME_WIDTH),
           _height(DEFAULT_RENDER_FRAME_HEIGHT), _outWidth(0), _outHeight(0),
           _xPos(0), _yPos(0), _prepared(false), _dispCount(0), _buffer(NULL),
@@ -82,17 +89,55 @@ WebRtc_Word32 VideoX11Channel::DeliverFrame(const I420VideoFrame& videoFrame) {
     return -1;
   }
 
-  ConvertFromI420(videoFrame, kARGB, 0, _buffer);
-
-  // Put image in window.
-  XShmPutImage(_display, _window, _gc, _image, 0, 0, _xPos, _yPos, _width,
-               _height, True);
+  const TickTime startTime = TickTime::Now();
+  if (_xvImage) {
+    // The adaptor converts and scales the planes.
+    CopyToXvImage(videoFrame);
+    XvShmPutImage(_display, _xvPort, _window, _gc, _xvImage, 0, 0, _width,
+                  _height, _xPos, _yPos, _outWidth, _outHeight, False);
+  } else {
+    ConvertFromI420(videoFrame, kARGB, 0, _buffer);
+
+    // Put image in window.
+    XShmPutImage(_display, _window, _gc, _image, 0, 0, _xPos, _yPos, _width,
+                 _height, True);
+  }
 
   // Very important for the image to update properly!
   XSync(_display, False);
+
+  const WebRtc_UWord32 renderTimeUs =
+      static_cast<WebRtc_UWord32>((TickTime::Now() - startTime).Microseconds());
+  ++_statistics.frames;
+  if (_xvImage) {
+    ++_statistics.direct_frames;
+  }
+  _statistics.total_render_time_us += renderTimeUs;
+  if (renderTimeUs > _statistics.max_render_time_us) {
+    _statistics.max_render_time_us = renderTimeUs;
+  }
   return 0;
 }
 
+void VideoX11Channel::CopyToXvImage(const I420VideoFrame& videoFrame) {
+  const PlaneType planes[3] = { kYPlane, kUPlane, kVPlane };
+  for (int i = 0; i < 3; ++i) {
+    const int width = i == 0 ? _width : (_width + 1) / 2;
+    const int height = i == 0 ? _height : (_height + 1) / 2;
+    const WebRtc_UWord8* src = videoFrame.buffer(planes[i]);
+    const int srcStride = videoFrame.stride(planes[i]);
+    char* dst = _xvImage->data + _xvImage->offsets[i];
+    const int dstStride = _xvImage->pitches[i];
+    if (srcStride == dstStride) {
+      memcpy(dst, src, srcStride * height);
+      continue;
+    }
+    for (int row = 0; row < height; ++row) {
+      memcpy(dst + row * dstStride, src + row * srcStride, width);
+    }
+  }
+}
+
 WebRtc_Word32 VideoX11Channel::GetFrameSize(WebRtc_Word32& width,
                                                 WebRtc_Word32& height)
 {
@@ -132,6 +177,11 @@ WebRtc_Word32 VideoX11Channel::Init(Window window, float left, float top,
         return -1;
     }
 
+    _xvPort = GrabXvPort();
+    WEBRTC_TRACE(kTraceInfo, kTraceVideoRenderer, _Id,
+                 "Rendering %s", _xvPort ? "I420 through XVideo" :
+                                           "ARGB through XShm");
+
     if ((1 < left || left < 0) || (1 < top || top < 0) || (1 < right || right
             < 0) || (1 < bottom || bottom < 0))
     {
@@ -215,6 +265,11 @@ WebRtc_Word32 VideoX11Channel::ReleaseWindow()
     CriticalSectionScoped cs(&_crit);
 
     RemoveRenderer();
+    if (_xvPort)
+    {
+        XvUngrabPort(_display, _xvPort, CurrentTime);
+        _xvPort = 0;
+    }
     if (_gc) {
       XFreeGC(_display, _gc);
       _gc = NULL;
@@ -250,16 +305,51 @@ WebRtc_Word32 VideoX11Channel::CreateLocalRenderer(WebRtc_Word32 width,
     _height = height;
 
     // create shared memory image
-    _image = XShmCreateImage(_display, CopyFromParent, 24, ZPixmap, NULL,
-                             &_shminfo, _width, _height); // this parameter needs to be the same for some reason.
-    _shminfo.shmid = shmget(IPC_PRIVATE, (_image->bytes_per_line
-            * _image->height), IPC_CREAT | 0777);
-    _shminfo.shmaddr = _image->data = (char*) shmat(_shminfo.shmid, 0, 0);
-    if (_image->data == reinterpret_cast<char*>(-1))
+    int imageSize = 0;
+    if (_xvPort)
+    {
+        _xvImage = XvShmCreateImage(_display, _xvPort, XV_IMAGE_I420, NULL,
+                                    _width, _height, &_shminfo);
+        // The adaptor may round the size, CopyToXvImage needs the frame size.
+        if (_xvImage &&
+            (_xvImage->width != _width || _xvImage->height != _height))
+        {
+            XFree(_xvImage);
+            _xvImage = NULL;
+        }
+        if (_xvImage)
+        {
+            imageSize = _xvImage->data_size;
+        }
+        else
+        {
+            // The port is kept, other frame sizes may still use it.
+            WEBRTC_TRACE(kTraceWarning, kTraceVideoRenderer, _Id,
+                         "No %dx%d XVideo image, rendering this size as ARGB "
+                         "through XShm", _width, _height);
+        }
+    }
+    if (!_xvImage)
+    {
+        _image = XShmCreateImage(_display, CopyFromParent, 24, ZPixmap, NULL,
+                                 &_shminfo, _width, _height); // this parameter needs to be the same for some reason.
+        imageSize = _image->bytes_per_line * _image->height;
+    }
+    _shminfo.shmid = shmget(IPC_PRIVATE, imageSize, IPC_CREAT | 0777);
+    _shminfo.shmaddr = (char*) shmat(_shminfo.shmid, 0, 0);
+    if (_shminfo.shmaddr == reinterpret_cast<char*>(-1))
     {
         return -1;
     }
-    _buffer = (unsigned char*) _image->data;
+    if (_xvImage)
+    {
+        _xvImage->data = _shminfo.shmaddr;
+    }
+    else
+    {
+        _image->data = _shminfo.shmaddr;
+        _buffer = (unsigned char*) _image->data;
+    }
     _shminfo.readOnly = False;
 
     // attach image to display
@@ -287,8 +377,17 @@ WebRtc_Word32 VideoX11Channel::RemoveRenderer()
 
     // Free the memory.
     XShmDetach(_display, &_shminfo);
-    XDestroyImage( _image );
-    _image = NULL;
+    if (_xvImage)
+    {
+        // Only frees the image struct, the data is the shared memory.
+        XFree(_xvImage);
+        _xvImage = NULL;
+    }
+    else
+    {
+        XDestroyImage( _image );
+        _image = NULL;
+    }
     shmdt(_shminfo.shmaddr);
     _shminfo.shmaddr = NULL;
     _buffer = NULL;
@@ -314,6 +413,69 @@ WebRtc_Word32 VideoX11Channel::GetStreamProperties(WebRtc_UWord32& zOrder,
     return 0;
 }
 
+void VideoX11Channel::GetStatistics(VideoRenderStatistics& statistics)
+{
+    CriticalSectionScoped cs(&_crit);
+    statistics = _statistics;
+}
+
+XvPortID VideoX11Channel::GrabXvPort()
+{
+    unsigned int version, release, requestBase, eventBase, errorBase;
+    if (XvQueryExtension(_display, &version, &release, &requestBase,
+                         &eventBase, &errorBase) != Success)
+    {
+        return 0;
+    }
+    unsigned int numAdaptors = 0;
+    XvAdaptorInfo* adaptors = NULL;
+    if (XvQueryAdaptors(_display, _window, &numAdaptors, &adaptors) != Success)
+    {
+        return 0;
+    }
+    XvPortID grabbedPort = 0;
+    for (unsigned int i = 0; i < numAdaptors && !grabbedPort; ++i)
+    {
+        if (!(adaptors[i].type & XvInputMask) ||
+            !(adaptors[i].type & XvImageMask))
+        {
+            continue;
+        }
+        for (unsigned long j = 0; j < adaptors[i].num_ports && !grabbedPort;
+             ++j)
+        {
+            const XvPortID port = adaptors[i].base_id + j;
+            // Other clients may hold some of the ports.
+            if (XvPortSupportsI420(port) &&
+                XvGrabPort(_display, port, CurrentTime) == Success)
+            {
+                grabbedPort = port;
+            }
+        }
+    }
+    XvFreeAdaptorInfo(adaptors);
+    return grabbedPort;
+}
+
+bool VideoX11Channel::XvPortSupportsI420(XvPortID port)
+{
+    int numFormats = 0;
+    XvImageFormatValues* formats = XvListImageFormats(_display, port,
+                                                      &numFormats);
+    bool supported = false;
+    for (int i = 0; i < numFormats; ++i)
+    {
+        if (formats[i].id == XV_IMAGE_I420 && formats[i].format == XvPlanar)
+        {
+            supported = true;
+        }
+    }
+    if (formats)
+    {
+        XFree(formats);
+    }
+    return supported;
+}
 
 } //namespace webrtc
 
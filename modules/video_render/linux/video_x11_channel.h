@@ -18,6 +18,7 @@
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <X11/extensions/XShm.h>
+#include <X11/extensions/Xvlib.h>
 
 namespace webrtc {
 class CriticalSectionWrapper;
@@ -47,6 +48,7 @@ public:
             GetStreamProperties(WebRtc_UWord32& zOrder, float& left,
                                 float& top, float& right, float& bottom) const;
     WebRtc_Word32 ReleaseWindow();
+    void GetStatistics(VideoRenderStatistics& statistics);
 
     bool IsPrepared()
     {
@@ -59,6 +61,12 @@ private:
             CreateLocalRenderer(WebRtc_Word32 width, WebRtc_Word32 height);
     WebRtc_Word32 RemoveRenderer();
 
+    // Returns a grabbed port of an XVideo adaptor that can scale and draw
+    // I420 images, or 0 if there is none.
+    XvPortID GrabXvPort();
+    bool XvPortSupportsI420(XvPortID port);
+    void CopyToXvImage(const I420VideoFrame& videoFrame);
+
     //FIXME a better place for this method? the GetWidthHeight no longer
     // supported by common_video.
     int GetWidthHeight(VideoType type, int bufferSize, int& width,
@@ -69,6 +77,9 @@ private:
     Display* _display;
     XShmSegmentInfo _shminfo;
     XImage* _image;
+    // Set when frames are drawn as I420 through XVideo instead of _image.
+    XvPortID _xvPort;
+    XvImage* _xvImage;
     Window _window;
     GC _gc;
     WebRtc_Word32 _width; // incoming frame width
@@ -87,6 +98,7 @@ private:
     float _bottom;
 
     WebRtc_Word32 _Id;
+    VideoRenderStatistics _statistics;
 
 };
 
@@ -150,5 +150,24 @@ WebRtc_Word32 VideoX11Render::GetIncomingStreamProperties(
     return -1;
 }
 
+WebRtc_Word32 VideoX11Render::GetRenderStatistics(
+    WebRtc_Word32 streamId,
+    VideoRenderStatistics& statistics)
+{
+    CriticalSectionScoped cs(&_critSect);
+
+    std::map<int, VideoX11Channel*>::iterator iter =
+            _streamIdToX11ChannelMap.find(streamId);
+    if (iter == _streamIdToX11ChannelMap.end() || !iter->second)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, -1,
+                     "No VideoX11Channel object exists for stream id: %d",
+                     streamId);
+        return -1;
+    }
+    iter->second->GetStatistics(statistics);
+    return 0;
+}
+
 } //namespace webrtc
 
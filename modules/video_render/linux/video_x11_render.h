@@ -45,6 +45,9 @@ public:
                                               float& left, float& top,
                                               float& right, float& bottom);
 
+    WebRtc_Word32 GetRenderStatistics(WebRtc_Word32 streamId,
+                                      VideoRenderStatistics& statistics);
+
 private:
     Window _window;
     CriticalSectionWrapper& _critSect;
@@ -44,6 +44,7 @@ using namespace webrtc;
 
 void GetTestVideoFrame(I420VideoFrame* frame,
                        WebRtc_UWord8 startColor);
+void PrintRenderStatistics(VideoRender* renderModule, const int streamId);
 int TestSingleStream(VideoRender* renderModule);
 int TestFullscreenStream(VideoRender* &renderModule,
                          void* window,
@@ -51,6 +52,7 @@ int TestFullscreenStream(VideoRender* &renderModule,
 int TestBitmapText(VideoRender* renderModule);
 int TestMultipleStreams(VideoRender* renderModule);
 int TestExternalRender(VideoRender* renderModule);
+int TestRenderStatistics(VideoRender* renderModule);
 
 #define TEST_FRAME_RATE 30
 #define TEST_TIME_SECOND 5
@@ -286,6 +288,19 @@ void GetTestVideoFrame(I420VideoFrame* frame,
     ++color;
 }
 
+void PrintRenderStatistics(VideoRender* renderModule, const int streamId) {
+    VideoRenderStatistics statistics;
+    if (renderModule->GetRenderStatistics(streamId, statistics) != 0) {
+        return;
+    }
+    printf("Stream %d: %u frames drawn, %u as I420, %.2f ms per frame, "
+           "max %.2f ms\n", streamId, statistics.frames,
+           statistics.direct_frames,
+           statistics.frames ? statistics.total_render_time_us /
+               (1000.0 * statistics.frames) : 0.0,
+           statistics.max_render_time_us / 1000.0);
+}
+
 int TestSingleStream(VideoRender* renderModule) {
     int error = 0;
     // Add settings for a stream to render
@@ -326,6 +341,7 @@ int TestSingleStream(VideoRender* renderModule) {
         renderCallback0->RenderFrame(streamId0, videoFrame0);
         SleepMs(1000/TEST_FRAME_RATE);
     }
+    PrintRenderStatistics(renderModule, streamId0);
 
 
     // Shut down
@@ -490,6 +506,10 @@ int TestMultipleStreams(VideoRender* renderModule) {
 
       SleepMs(1000/TEST_FRAME_RATE);
     }
+    PrintRenderStatistics(renderModule, streamId0);
+    PrintRenderStatistics(renderModule, streamId1);
+    PrintRenderStatistics(renderModule, streamId2);
+    PrintRenderStatistics(renderModule, streamId3);
 
     // Shut down
     printf("Closing...\n");
@@ -546,6 +566,61 @@ int TestExternalRender(VideoRender* renderModule) {
     return 0;
 }
 
+int TestRenderStatistics(VideoRender* renderModule) {
+    const int streamId0 = 0;
+    VideoRenderCallback* renderCallback0 =
+        renderModule->AddIncomingRenderStream(streamId0, 0, 0.0f, 0.0f,
+                                              1.0f, 1.0f);
+    assert(renderCallback0 != NULL);
+    assert(renderModule->StartRender(streamId0) == 0);
+
+    VideoRenderStatistics statistics;
+    if (renderModule->GetRenderStatistics(streamId0, statistics) != 0) {
+        // Only the platform renderers count the frames they draw.
+        printf("No render statistics, skipping test\n");
+        assert(renderModule->StopRender(streamId0) == 0);
+        assert(renderModule->DeleteIncomingRenderStream(streamId0) == 0);
+        return 0;
+    }
+
+    // The odd size is one an XVideo adaptor may round, the renderer then
+    // draws it through XShm and returns to XVideo for the last size.
+    const int sizes[3][2] = { { 352, 288 }, { 175, 143 }, { 352, 288 } };
+    const WebRtc_UWord32 renderDelayMs = 100;
+    const int framesPerSize = 10;
+    for (int s = 0; s < 3; s++) {
+        const int width = sizes[s][0];
+        const int half_width = (width + 1) / 2;
+        const int height = sizes[s][1];
+        I420VideoFrame videoFrame0;
+        videoFrame0.CreateEmptyFrame(width, height, width, half_width,
+                                     half_width);
+        for (int i = 0; i < framesPerSize; i++) {
+            GetTestVideoFrame(&videoFrame0, TEST_STREAM0_START_COLOR);
+            videoFrame0.set_render_time_ms(TickTime::MillisecondTimestamp() +
+                                           renderDelayMs);
+            renderCallback0->RenderFrame(streamId0, videoFrame0);
+            SleepMs(1000/TEST_FRAME_RATE);
+        }
+    }
+
+    // Sleep and let all frames be rendered before reading the statistics.
+    SleepMs(2*renderDelayMs);
+    PrintRenderStatistics(renderModule, streamId0);
+    const int error = renderModule->GetRenderStatistics(streamId0, statistics);
+
+    assert(renderModule->StopRender(streamId0) == 0);
+    assert(renderModule->DeleteIncomingRenderStream(streamId0) == 0);
+
+    if (error != 0 || statistics.frames == 0 ||
+        statistics.frames > 3 * framesPerSize ||
+        statistics.direct_frames > statistics.frames ||
+        statistics.max_render_time_us > statistics.total_render_time_us) {
+        return -1;
+    }
+    return 0;
+}
+
 void RunVideoRenderTests(void* window, VideoRenderType windowType) {
 #ifndef WEBRTC_INCLUDE_INTERNAL_VIDEO_RENDER
     windowType = kRenderExternal;
@@ -593,6 +668,12 @@ void RunVideoRenderTests(void* window, VideoRenderType windowType) {
         printf ("TestExternalRender failed\n");
     }
 
+    // ##### Test render statistics ####
+    printf("#### TestRenderStatistics ####\n");
+    if (TestRenderStatistics(renderModule) != 0) {
+        printf ("TestRenderStatistics failed\n");
+    }
+
     delete renderModule;
     renderModule = NULL;
 
@@ -735,6 +735,21 @@ WebRtc_UWord32 ModuleVideoRenderImpl::RenderFrameRate(
     return _ptrRenderer->RenderFrameRate(streamId);
 }
 
+WebRtc_Word32 ModuleVideoRenderImpl::GetRenderStatistics(
+    const WebRtc_UWord32 streamId,
+    VideoRenderStatistics& statistics) const
+{
+    CriticalSectionScoped cs(&_moduleCrit);
+
+    if (!_ptrRenderer)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                     "%s: No renderer", __FUNCTION__);
+        return -1;
+    }
+    return _ptrRenderer->GetRenderStatistics(streamId, statistics);
+}
+
 WebRtc_Word32 ModuleVideoRenderImpl::SetStreamCropping(
                                                        const WebRtc_UWord32 streamId,
                                                        const float left,
@@ -170,6 +170,10 @@ public:
      */
     virtual WebRtc_UWord32 RenderFrameRate(const WebRtc_UWord32 streamId);
 
+    virtual WebRtc_Word32
+            GetRenderStatistics(const WebRtc_UWord32 streamId,
+                                VideoRenderStatistics& statistics) const;
+
     /*
      *   Set cropping of incoming stream
      */
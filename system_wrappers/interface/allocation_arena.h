@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A bump allocator for the temporary memory of a real-time thread. A module
+// allocates its per-tick memory from the arena and resets the arena at the
+// start of each tick, e.g. every 10 ms, instead of using the heap:
+//
+//   void AudioTick() {
+//     arena_.Reset();
+//     int16_t* buffer = static_cast<int16_t*>(
+//         arena_.Allocate(samples * sizeof(int16_t)));
+//     if (!buffer) {
+//       // The arena is full, fall back to the heap.
+//     }
+//   }
+//
+// A thread can make an arena available to the modules it runs with
+// ScopedThreadArena.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_ALLOCATION_ARENA_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_ALLOCATION_ARENA_H_
+
+#include <stddef.h>
+
+#include "webrtc/system_wrappers/interface/constructor_magic.h"
+
+namespace webrtc {
+
+class AllocationArena {
+ public:
+  explicit AllocationArena(size_t capacity);
+  ~AllocationArena();
+
+  // Returns |size| bytes aligned for any type, or NULL if the arena doesn't
+  // have room for |size| bytes until the next Reset().
+  void* Allocate(size_t size);
+
+  // Frees all memory allocated from the arena.
+  void Reset();
+
+  size_t capacity() const { return capacity_; }
+  size_t BytesAllocated() const { return used_; }
+  // The largest number of bytes allocated between two resets.
+  size_t HighWaterMark() const { return high_water_mark_; }
+  // The number of allocations that didn't fit.
+  int Overflows() const { return overflows_; }
+
+  // Returns the arena set for the calling thread, or NULL.
+  static AllocationArena* ThreadArena();
+
+ private:
+  friend class ScopedThreadArena;
+  static void SetThreadArena(AllocationArena* arena);
+
+  char* buffer_;
+  size_t capacity_;
+  size_t used_;
+  size_t high_water_mark_;
+  int overflows_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationArena);
+};
+
+// Sets the arena of the calling thread for the lifetime of the object.
+class ScopedThreadArena {
+ public:
+  explicit ScopedThreadArena(AllocationArena* arena)
+      : previous_arena_(AllocationArena::ThreadArena()) {
+    AllocationArena::SetThreadArena(arena);
+  }
+  ~ScopedThreadArena() {
+    AllocationArena::SetThreadArena(previous_arena_);
+  }
+
+ private:
+  AllocationArena* previous_arena_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedThreadArena);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_ALLOCATION_ARENA_H_
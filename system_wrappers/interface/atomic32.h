@@ -43,6 +43,11 @@ class Atomic32 {
   // The function returns true if the exchange happened.
   bool CompareExchange(WebRtc_Word32 new_value, WebRtc_Word32 compare_value);
   WebRtc_Word32 Value() const;
+  // Returns the value without modifying it, with a memory barrier on each
+  // side of the load. Memory written by another thread before it changed the
+  // value is visible once the new value has been read, and the caller's
+  // earlier reads are done before the value is read.
+  WebRtc_Word32 AcquireLoad() const;
 
  private:
   // Disable the + and - operator since it's unclear what these operations
@@ -37,8 +37,43 @@ class Clock {
   // Retrieve an NTP absolute timestamp.
   virtual void CurrentNtp(uint32_t& seconds, uint32_t& fractions) = 0;
 
-  // Returns an instance of the real-time system clock implementation.
+  // Returns an instance of the real-time system clock implementation. The NTP
+  // timestamps of this clock are derived from its monotonic time, so the two
+  // are consistent with each other and don't jump if the system time is set.
   static Clock* GetRealTimeClock();
+
+  // Returns a real-time clock that is cheaper to read, but only advances once
+  // per kernel tick, typically every 1-10 ms. Use it where millisecond
+  // precision isn't needed, e.g. for timeouts. Falls back to the real-time
+  // clock where there is no coarse time source. Not affected by
+  // TickTime::UseFakeClock().
+  static Clock* GetCoarseRealTimeClock();
+};
+
+// A clock returning the time of the last call to Stamp(), which reads the
+// wrapped clock once. A thread that reads the time many times per iteration,
+// e.g. a process thread, can stamp the clock at the start of each iteration
+// and pass it to the code it runs. Not thread-safe, Stamp() and the reads must
+// be made on the same thread.
+class CachedClock : public Clock {
+ public:
+  // Stamps the clock. |clock| must outlive this clock.
+  explicit CachedClock(Clock* clock);
+
+  virtual ~CachedClock() {}
+
+  // Updates the cached time from the wrapped clock.
+  void Stamp();
+
+  virtual int64_t TimeInMilliseconds();
+  virtual int64_t TimeInMicroseconds();
+  virtual void CurrentNtp(uint32_t& seconds, uint32_t& fractions);
+
+ private:
+  Clock* clock_;
+  int64_t time_us_;
+  uint32_t ntp_seconds_;
+  uint32_t ntp_fractions_;
 };
 
 class SimulatedClock : public Clock {
@@ -22,6 +22,9 @@ class CriticalSectionWrapper {
   // Factory method, constructor disabled
   static CriticalSectionWrapper* CreateCriticalSection();
 
+  // As above, naming the critical section in the LockProfiler statistics.
+  static CriticalSectionWrapper* CreateCriticalSection(const char* name);
+
   virtual ~CriticalSectionWrapper() {}
 
   // Tries to grab lock, beginning of a critical section. Will wait for the
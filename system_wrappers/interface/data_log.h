@@ -27,6 +27,12 @@
 // trunk/tools/matlab/parseLog.m.
 //
 // Table names and column names are case sensitive.
+//
+// Tables logged at a high rate should be binary tables instead, which have
+// typed columns and are identified by ids rather than names. Binary cells are
+// copied into a preallocated row, and the file writer thread stores the rows
+// in blocks of columns, optionally compressed. ConvertBinaryToCsv() converts a
+// binary table file to the format above.
 
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_DATA_LOG_H_
 #define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_DATA_LOG_H_
@@ -112,6 +118,52 @@ class DataLog {
   // Starts a new empty row.
   // table_name is treated in a case-sensitive way.
   static int NextRow(const std::string& table_name);
+
+  // Adds a new binary table, with the name table_name, and creates the file,
+  // with the name table_name + ".bin", to which the table will be written.
+  // The blocks of rows are compressed if |compress| is true. Returns the id
+  // of the table, or -1 on error.
+  static int AddBinaryTable(const std::string& table_name, bool compress);
+
+  // Adds a new column of values of type |type| to a binary table. The column
+  // will be a multi-value-column if multi_value_length is greater than 1.
+  // Columns must be added before the first cell is inserted. Returns the
+  // index of the column, or -1 on error.
+  static int AddBinaryColumn(int table_id,
+                             const std::string& column_name,
+                             DataLogType type,
+                             int multi_value_length);
+
+  // Inserts a single value into a column of a binary table. T must be the
+  // type of the column.
+  template<class T>
+  static int InsertBinaryCell(int table_id, int column, T value) {
+    return InsertBinaryCell(table_id, column, &value, 1);
+  }
+
+  // Inserts an array of values into a multi-value-column of a binary table.
+  // T must be the type of the column and |length| its multi_value_length.
+  template<class T>
+  static int InsertBinaryCell(int table_id,
+                              int column,
+                              const T* array,
+                              int length) {
+    DataLogImpl* data_log = DataLogImpl::StaticInstance();
+    if (data_log == NULL)
+      return -1;
+    return data_log->InsertBinaryCell(table_id, column,
+                                      DataLogTypeOf<T>::kType, array, length);
+  }
+
+  // For the binary table with id table_id: Queues the current row to be
+  // written to file. Starts a new empty row.
+  static int NextBinaryRow(int table_id);
+
+  // Converts the binary table file binary_file_name to a text file,
+  // csv_file_name, in the format described above. Available also when data
+  // logging is disabled.
+  static int ConvertBinaryToCsv(const std::string& binary_file_name,
+                                const std::string& csv_file_name);
 };
 
 }  // namespace webrtc
@@ -27,6 +27,7 @@
 
 namespace webrtc {
 
+class BinaryLogTable;
 class CriticalSectionWrapper;
 class EventWrapper;
 class LogTable;
@@ -77,6 +78,33 @@ class MultiValueContainer : public Container {
   std::vector<T>  data_;
 };
 
+// The value types of binary table columns.
+enum DataLogType {
+  kDataLogInt32 = 0,
+  kDataLogUInt32 = 1,
+  kDataLogInt64 = 2,
+  kDataLogFloat = 3,
+  kDataLogDouble = 4
+};
+
+// Maps the C++ types to their DataLogType.
+template<class T> struct DataLogTypeOf;
+template<> struct DataLogTypeOf<int32_t> {
+  static const DataLogType kType = kDataLogInt32;
+};
+template<> struct DataLogTypeOf<uint32_t> {
+  static const DataLogType kType = kDataLogUInt32;
+};
+template<> struct DataLogTypeOf<int64_t> {
+  static const DataLogType kType = kDataLogInt64;
+};
+template<> struct DataLogTypeOf<float> {
+  static const DataLogType kType = kDataLogFloat;
+};
+template<> struct DataLogTypeOf<double> {
+  static const DataLogType kType = kDataLogDouble;
+};
+
 class DataLogImpl {
  public:
   ~DataLogImpl();
@@ -114,6 +142,29 @@ class DataLogImpl {
   // data_log.h for a description.
   int NextRow(const std::string& table_name);
 
+  // The implementation of the AddBinaryTable() method declared in
+  // data_log.h. See data_log.h for a description.
+  int AddBinaryTable(const std::string& table_name, bool compress);
+
+  // The implementation of the AddBinaryColumn() method declared in
+  // data_log.h. See data_log.h for a description.
+  int AddBinaryColumn(int table_id,
+                      const std::string& column_name,
+                      DataLogType type,
+                      int multi_value_length);
+
+  // Copies |length| values of type |type| into the current row of a binary
+  // table. The type and length must match the column.
+  int InsertBinaryCell(int table_id,
+                       int column,
+                       DataLogType type,
+                       const void* values,
+                       int length);
+
+  // The implementation of the NextBinaryRow() method declared in data_log.h.
+  // See data_log.h for a description.
+  int NextBinaryRow(int table_id);
+
  private:
   DataLogImpl();
 
@@ -145,6 +196,8 @@ class DataLogImpl {
   static DataLogImpl*       instance_;
   int                       counter_;
   TableMap                  tables_;
+  // Binary tables indexed by table id.
+  std::vector<BinaryLogTable*> binary_tables_;
   EventWrapper*             flush_event_;
   ThreadWrapper*            file_writer_thread_;
   RWLockWrapper*            tables_lock_;
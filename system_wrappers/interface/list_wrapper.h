@@ -11,12 +11,12 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_LIST_WRAPPER_H_
 #define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_LIST_WRAPPER_H_
 
+#include <stddef.h>
+
 #include "webrtc/system_wrappers/interface/constructor_magic.h"
 
 namespace webrtc {
 
-class CriticalSectionWrapper;
-
 class ListItem {
   friend class ListWrapper;
 
@@ -27,6 +27,11 @@ class ListItem {
   void* GetItem() const;
   unsigned int GetUnsignedItem() const;
 
+  // Items are allocated from a pool shared by all lists, so pushing and
+  // erasing items doesn't allocate memory once the pool has grown.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
  protected:
   ListItem* next_;
   ListItem* prev_;
@@ -36,6 +41,7 @@ class ListItem {
   const unsigned int  item_;
 };
 
+// Note that ListWrapper is not thread-safe.
 class ListWrapper {
  public:
   ListWrapper();
@@ -96,7 +102,6 @@ class ListWrapper {
   void PushBackImpl(ListItem* item);
   void PushFrontImpl(ListItem* item);
 
-  CriticalSectionWrapper* critical_section_;
   ListItem* first_;
   ListItem* last_;
   unsigned int size_;
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Opt-in profiling of CriticalSectionWrapper and RWLockWrapper contention.
+//
+// Only locks created while the profiler is enabled are profiled, so it should
+// be enabled before the engines are created. A lock created while the profiler
+// is disabled costs one predictable branch per Enter() and Leave().
+//
+// Profiled locks count acquisitions, acquisitions that had to wait, and keep
+// histograms of the wait and hold times. Locks can be named when created,
+// unnamed locks are identified by the address of the code creating them.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_LOCK_PROFILER_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_LOCK_PROFILER_H_
+
+#include <vector>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Bucket i of a histogram counts times in [2^(i-1), 2^i) us, bucket 0 times
+// below 1 us. The last bucket also counts all longer times.
+enum { kLockHistogramBuckets = 16 };
+
+struct LockStatistics {
+  LockStatistics();
+
+  char name[64];
+  // Exclusive acquisitions, including recursive ones.
+  uint32_t acquisitions;
+  // Exclusive acquisitions that had to wait for another thread.
+  uint32_t contended_acquisitions;
+  // Shared acquisitions of a read/write lock.
+  uint32_t shared_acquisitions;
+  uint32_t contended_shared_acquisitions;
+  int64_t total_wait_time_us;
+  int64_t total_hold_time_us;
+  uint32_t max_wait_time_us;
+  uint32_t max_hold_time_us;
+  uint32_t wait_time_histogram[kLockHistogramBuckets];
+  uint32_t hold_time_histogram[kLockHistogramBuckets];
+  // Thread holding the lock exclusively, 0 if not held.
+  uint32_t holder_thread_id;
+};
+
+class LockProfiler {
+ public:
+  // Enables or disables profiling of the locks created after this call.
+  static void Enable(bool enable);
+  static bool Enabled();
+
+  // Gets the statistics of all profiled locks, most contended first. The
+  // counters are read without taking the locks and may be slightly stale.
+  static void GetStatistics(std::vector<LockStatistics>* statistics);
+
+  // Writes the statistics of the profiled locks that have been contended to
+  // the trace, most contended first.
+  static void TraceReport();
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_LOCK_PROFILER_H_
@@ -11,7 +11,7 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_MAP_WRAPPER_H_
 #define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_MAP_WRAPPER_H_
 
-#include <map>
+#include <stddef.h>
 
 #include "webrtc/system_wrappers/interface/constructor_magic.h"
 
@@ -26,6 +26,11 @@ class MapItem {
   unsigned int GetUnsignedId();
   void SetItem(void* ptr);
 
+  // Items are allocated from a pool shared by all maps, so inserting and
+  // erasing items doesn't allocate memory once the pool has grown.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
  private:
   friend class MapWrapper;
 
@@ -33,13 +38,16 @@ class MapItem {
   void* item_pointer_;
 };
 
+// MapWrapper keeps the items in an array sorted by id. Maps of up to
+// kInlineCapacity items, e.g. temporary maps on the stack, don't allocate
+// memory for the array.
 class MapWrapper {
  public:
   MapWrapper();
   ~MapWrapper();
 
-  // Puts a pointer to anything in the map and associates it with id. Note, id
-  // needs to be unique for all items in the map.
+  // Puts a pointer to anything in the map and associates it with id. If id is
+  // already in the map, the item of id is changed to point to ptr.
   int Insert(int id, void* ptr);
 
   // Removes item from map.
@@ -67,7 +75,20 @@ class MapWrapper {
   MapItem* Find(int id) const;
 
  private:
-  std::map<int, MapItem*>    map_;
+  enum { kInlineCapacity = 16 };
+
+  // Returns the position of the first item with an id not less than id.
+  int LowerBound(int id) const;
+  // Returns the position of id, or -1 if id is not in the map.
+  int Position(int id) const;
+  void EraseAt(int position);
+
+  MapItem* inline_items_[kInlineCapacity];
+  MapItem** items_;
+  int size_;
+  int capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(MapWrapper);
 };
 
 } // namespace webrtc
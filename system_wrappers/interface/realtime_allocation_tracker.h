@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Tracks heap allocations on real-time threads, i.e. threads created by
+// ThreadWrapper with kHighestPriority or kRealtimePriority, and threads
+// tagged with SetCurrentThreadRealtime().
+//
+// Tracking is only available when built with
+// enable_realtime_allocation_tracking=1 on POSIX. The global operator new is
+// then replaced to count each allocation on a real-time thread and attribute
+// it to its call stack. Otherwise all functions are no-ops.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_REALTIME_ALLOCATION_TRACKER_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_REALTIME_ALLOCATION_TRACKER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace webrtc {
+
+enum { kRealtimeAllocationStackDepth = 12 };
+
+// The allocations made from one call stack.
+struct RealtimeAllocationSite {
+  int allocations;
+  size_t bytes;
+  // The name of the thread of the first allocation.
+  char thread_name[32];
+  int stack_depth;
+  void* stack[kRealtimeAllocationStackDepth];
+};
+
+class RealtimeAllocationTracker {
+ public:
+  // Returns true if built with allocation tracking.
+  static bool Enabled();
+
+  // Tags the calling thread as real-time. |name| is used in the report.
+  static void SetCurrentThreadRealtime(const char* name);
+  static void ClearCurrentThreadRealtime();
+  static bool IsCurrentThreadRealtime();
+
+  // Returns the number of allocations on real-time threads.
+  static int Allocations();
+
+  // Gets the call stacks that allocated on real-time threads, most
+  // allocations first.
+  static void GetAllocationSites(std::vector<RealtimeAllocationSite>* sites);
+
+  // Writes the allocation sites with symbolized call stacks to the trace.
+  static void TraceReport();
+
+  static void Reset();
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_REALTIME_ALLOCATION_TRACKER_H_
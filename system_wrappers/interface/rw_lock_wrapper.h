@@ -20,6 +20,8 @@ namespace webrtc {
 class RWLockWrapper {
  public:
   static RWLockWrapper* CreateRWLock();
+  // As above, naming the lock in the LockProfiler statistics.
+  static RWLockWrapper* CreateRWLock(const char* name);
   virtual ~RWLockWrapper() {}
 
   virtual void AcquireLockExclusive() = 0;
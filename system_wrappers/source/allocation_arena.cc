@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/allocation_arena.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace webrtc {
+
+namespace {
+
+// Alignment of the allocations, enough for any type including SSE vectors.
+const size_t kArenaAlignment = 16;
+
+#if defined(_WIN32)
+const DWORD g_arena_tls_index = TlsAlloc();
+#else
+pthread_key_t g_arena_key;
+pthread_once_t g_arena_key_once = PTHREAD_ONCE_INIT;
+
+void CreateArenaKey() {
+  pthread_key_create(&g_arena_key, NULL);
+}
+#endif
+
+}  // namespace
+
+AllocationArena::AllocationArena(size_t capacity)
+    : buffer_(new char[capacity + kArenaAlignment]),
+      capacity_(capacity),
+      used_(0),
+      high_water_mark_(0),
+      overflows_(0) {
+}
+
+AllocationArena::~AllocationArena() {
+  delete [] buffer_;
+}
+
+void* AllocationArena::Allocate(size_t size) {
+  char* aligned_buffer = reinterpret_cast<char*>(
+      (reinterpret_cast<size_t>(buffer_) + kArenaAlignment - 1) &
+      ~(kArenaAlignment - 1));
+  const size_t aligned_size =
+      (size + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+  if (aligned_size > capacity_ - used_) {
+    ++overflows_;
+    return NULL;
+  }
+  void* ptr = aligned_buffer + used_;
+  used_ += aligned_size;
+  if (used_ > high_water_mark_) {
+    high_water_mark_ = used_;
+  }
+  return ptr;
+}
+
+void AllocationArena::Reset() {
+  used_ = 0;
+}
+
+AllocationArena* AllocationArena::ThreadArena() {
+#if defined(_WIN32)
+  return static_cast<AllocationArena*>(TlsGetValue(g_arena_tls_index));
+#else
+  pthread_once(&g_arena_key_once, CreateArenaKey);
+  return static_cast<AllocationArena*>(pthread_getspecific(g_arena_key));
+#endif
+}
+
+void AllocationArena::SetThreadArena(AllocationArena* arena) {
+#if defined(_WIN32)
+  TlsSetValue(g_arena_tls_index, arena);
+#else
+  pthread_once(&g_arena_key_once, CreateArenaKey);
+  pthread_setspecific(g_arena_key, arena);
+#endif
+}
+
+}  // namespace webrtc
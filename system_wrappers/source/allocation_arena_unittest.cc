@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/allocation_arena.h"
+
+#include "gtest/gtest.h"
+
+namespace webrtc {
+
+TEST(AllocationArenaTest, AllocatesAlignedUntilFull) {
+  AllocationArena arena(100);
+  void* first = arena.Allocate(1);
+  void* second = arena.Allocate(20);
+  ASSERT_TRUE(first != NULL);
+  ASSERT_TRUE(second != NULL);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(first) % 16);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(second) % 16);
+  EXPECT_EQ(16, static_cast<char*>(second) - static_cast<char*>(first));
+  EXPECT_EQ(48u, arena.BytesAllocated());
+  // 48 + 64 bytes don't fit.
+  EXPECT_TRUE(arena.Allocate(50) == NULL);
+  EXPECT_EQ(1, arena.Overflows());
+  EXPECT_TRUE(arena.Allocate(40) != NULL);
+  EXPECT_EQ(96u, arena.HighWaterMark());
+
+  arena.Reset();
+  EXPECT_EQ(0u, arena.BytesAllocated());
+  EXPECT_EQ(first, arena.Allocate(8));
+  EXPECT_EQ(96u, arena.HighWaterMark());
+}
+
+TEST(AllocationArenaTest, ThreadArenaIsScoped) {
+  AllocationArena outer(64);
+  AllocationArena inner(64);
+  EXPECT_TRUE(AllocationArena::ThreadArena() == NULL);
+  {
+    ScopedThreadArena outer_scope(&outer);
+    EXPECT_EQ(&outer, AllocationArena::ThreadArena());
+    {
+      ScopedThreadArena inner_scope(&inner);
+      EXPECT_EQ(&inner, AllocationArena::ThreadArena());
+    }
+    EXPECT_EQ(&outer, AllocationArena::ThreadArena());
+  }
+  EXPECT_TRUE(AllocationArena::ThreadArena() == NULL);
+}
+
+}  // namespace webrtc
@@ -51,4 +51,12 @@ WebRtc_Word32 Atomic32::Value() const {
   return value_;
 }
 
+WebRtc_Word32 Atomic32::AcquireLoad() const {
+  OSMemoryBarrier();
+  const WebRtc_Word32 value = *static_cast<const volatile WebRtc_Word32*>(
+      &value_);
+  OSMemoryBarrier();
+  return value;
+}
+
 }  // namespace webrtc
@@ -55,4 +55,12 @@ WebRtc_Word32 Atomic32::Value() const {
   return value_;
 }
 
+WebRtc_Word32 Atomic32::AcquireLoad() const {
+  __sync_synchronize();
+  const WebRtc_Word32 value = *static_cast<const volatile WebRtc_Word32*>(
+      &value_);
+  __sync_synchronize();
+  return value;
+}
+
 } // namespace webrtc
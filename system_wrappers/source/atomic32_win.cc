@@ -64,4 +64,12 @@ WebRtc_Word32 Atomic32::Value() const {
   return value_;
 }
 
+WebRtc_Word32 Atomic32::AcquireLoad() const {
+  MemoryBarrier();
+  const WebRtc_Word32 value = *static_cast<const volatile WebRtc_Word32*>(
+      &value_);
+  MemoryBarrier();
+  return value;
+}
+
 }  // namespace webrtc
@@ -117,6 +117,7 @@ void get_time(WindowsHelpTimer* help_timer, FILETIME& current_time) {
 #endif
 
 class RealTimeClock : public Clock {
+ public:
   // Return a timestamp in milliseconds relative to some arbitrary source; the
   // source is fixed for this clock.
   virtual int64_t TimeInMilliseconds() {
@@ -180,35 +181,57 @@ class WindowsRealTimeClock : public RealTimeClock {
 };
 
 #elif ((defined WEBRTC_LINUX) || (defined WEBRTC_MAC))
+// Returns the system time in microseconds since January 1900.
+static int64_t NtpTimeInMicroseconds() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return 1000000LL * (tv.tv_sec + kNtpJan1970) + tv.tv_usec;
+}
+
 class UnixRealTimeClock : public RealTimeClock {
  public:
-  UnixRealTimeClock() {}
+  // The system time is read once, later NTP timestamps follow the monotonic
+  // time. This makes CurrentNtp() as cheap as TimeInMicroseconds().
+  UnixRealTimeClock()
+      : ntp_offset_us_(NtpTimeInMicroseconds() -
+                       TickTime::MicrosecondTimestamp()) {}
 
   virtual ~UnixRealTimeClock() {}
 
   // Retrieve an NTP absolute timestamp.
   virtual void CurrentNtp(uint32_t& seconds, uint32_t& fractions) {
-    double dtemp;
-    struct timeval tv;
-    struct timezone tz;
-    tz.tz_minuteswest  = 0;
-    tz.tz_dsttime = 0;
-    gettimeofday(&tv, &tz);
+    const int64_t ntp_us = TimeInMicroseconds() + ntp_offset_us_;
+    seconds = static_cast<uint32_t>(ntp_us / 1000000);
+    fractions = static_cast<uint32_t>(((ntp_us % 1000000) << 32) / 1000000);
+  }
 
-    seconds = tv.tv_sec + kNtpJan1970;
-    dtemp = tv.tv_usec / 1e6;
-    if (dtemp >= 1) {
-      dtemp -= 1;
-      seconds++;
-    } else if (dtemp < -1) {
-      dtemp += 1;
-      seconds--;
-    }
-    dtemp *= kMagicNtpFractionalUnit;
-    fractions = (WebRtc_UWord32)dtemp;
+ private:
+  // NTP time minus monotonic time, in microseconds.
+  const int64_t ntp_offset_us_;
+};
+
+#if defined(WEBRTC_LINUX) && defined(CLOCK_MONOTONIC_COARSE)
+#define WEBRTC_HAS_COARSE_CLOCK
+// Reads the kernel's time of the last tick, which doesn't need to read and
+// scale a hardware counter.
+class CoarseRealTimeClock : public UnixRealTimeClock {
+ public:
+  virtual int64_t TimeInMilliseconds() {
+    return TimeInMicroseconds() / 1000;
+  }
+
+  virtual int64_t TimeInMicroseconds() {
+    struct timespec ts;
+#ifdef WEBRTC_CLOCK_TYPE_REALTIME
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#endif
+    return 1000000LL * ts.tv_sec + ts.tv_nsec / 1000;
   }
 };
 #endif
+#endif
 
 
 #if defined(_WIN32)
@@ -230,6 +253,41 @@ Clock* Clock::GetRealTimeClock() {
 #endif
 }
 
+Clock* Clock::GetCoarseRealTimeClock() {
+#if defined(WEBRTC_HAS_COARSE_CLOCK)
+  static CoarseRealTimeClock clock;
+  return &clock;
+#else
+  return GetRealTimeClock();
+#endif
+}
+
+CachedClock::CachedClock(Clock* clock)
+    : clock_(clock),
+      time_us_(0),
+      ntp_seconds_(0),
+      ntp_fractions_(0) {
+  Stamp();
+}
+
+void CachedClock::Stamp() {
+  time_us_ = clock_->TimeInMicroseconds();
+  clock_->CurrentNtp(ntp_seconds_, ntp_fractions_);
+}
+
+int64_t CachedClock::TimeInMilliseconds() {
+  return time_us_ / 1000;
+}
+
+int64_t CachedClock::TimeInMicroseconds() {
+  return time_us_;
+}
+
+void CachedClock::CurrentNtp(uint32_t& seconds, uint32_t& fractions) {
+  seconds = ntp_seconds_;
+  fractions = ntp_fractions_;
+}
+
 SimulatedClock::SimulatedClock(int64_t initial_time_us)
     : time_us_(initial_time_us) {}
 
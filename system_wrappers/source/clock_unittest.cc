@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/clock.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#include "gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+
+namespace {
+
+int64_t NtpToMicroseconds(uint32_t seconds, uint32_t fractions) {
+  return 1000000LL * seconds +
+      ((static_cast<int64_t>(fractions) * 1000000) >> 32);
+}
+
+}  // namespace
+
+TEST(ClockTest, NtpTimeIsSystemTime) {
+  uint32_t seconds = 0;
+  uint32_t fractions = 0;
+  Clock::GetRealTimeClock()->CurrentNtp(seconds, fractions);
+  const int64_t system_seconds = time(NULL) + kNtpJan1970;
+  EXPECT_NEAR(system_seconds, static_cast<int64_t>(seconds), 1);
+}
+
+TEST(ClockTest, NtpTimeFollowsMonotonicTime) {
+  Clock* clock = Clock::GetRealTimeClock();
+  uint32_t seconds = 0;
+  uint32_t fractions = 0;
+  clock->CurrentNtp(seconds, fractions);
+  const int64_t start_us = clock->TimeInMicroseconds();
+  const int64_t start_ntp_us = NtpToMicroseconds(seconds, fractions);
+  SleepMs(20);
+  clock->CurrentNtp(seconds, fractions);
+  const int64_t elapsed_us = clock->TimeInMicroseconds() - start_us;
+  const int64_t elapsed_ntp_us =
+      NtpToMicroseconds(seconds, fractions) - start_ntp_us;
+  EXPECT_GE(elapsed_us, 20000);
+  EXPECT_NEAR(elapsed_us, elapsed_ntp_us, 100);
+}
+
+TEST(ClockTest, CoarseClockIsCloseToRealTimeClock) {
+  const int64_t coarse_ms =
+      Clock::GetCoarseRealTimeClock()->TimeInMilliseconds();
+  const int64_t now_ms = Clock::GetRealTimeClock()->TimeInMilliseconds();
+  EXPECT_LE(coarse_ms, now_ms);
+  EXPECT_GE(coarse_ms, now_ms - 20);
+}
+
+TEST(ClockTest, CachedClockAdvancesWhenStamped) {
+  SimulatedClock simulated_clock(1000);
+  CachedClock clock(&simulated_clock);
+  EXPECT_EQ(1000, clock.TimeInMicroseconds());
+  simulated_clock.AdvanceTimeMilliseconds(5);
+  EXPECT_EQ(1000, clock.TimeInMicroseconds());
+  EXPECT_EQ(1, clock.TimeInMilliseconds());
+
+  clock.Stamp();
+  EXPECT_EQ(6000, clock.TimeInMicroseconds());
+  EXPECT_EQ(6, clock.TimeInMilliseconds());
+  uint32_t seconds = 0;
+  uint32_t fractions = 0;
+  uint32_t expected_seconds = 0;
+  uint32_t expected_fractions = 0;
+  clock.CurrentNtp(seconds, fractions);
+  simulated_clock.CurrentNtp(expected_seconds, expected_fractions);
+  EXPECT_EQ(expected_seconds, seconds);
+  EXPECT_EQ(expected_fractions, fractions);
+}
+
+// Prints the number of clock reads per second.
+TEST(ClockTest, ReadBenchmark) {
+  const int kIterations = 1000000;
+  CachedClock cached_clock(Clock::GetRealTimeClock());
+  struct {
+    const char* name;
+    Clock* clock;
+  } clocks[] = {
+    { "Real-time", Clock::GetRealTimeClock() },
+    { "Coarse real-time", Clock::GetCoarseRealTimeClock() },
+    { "Cached", &cached_clock },
+  };
+  Clock* reference_clock = Clock::GetRealTimeClock();
+  for (size_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); ++i) {
+    Clock* clock = clocks[i].clock;
+    int64_t sum = 0;
+    int64_t start_us = reference_clock->TimeInMicroseconds();
+    for (int j = 0; j < kIterations; ++j) {
+      sum += clock->TimeInMicroseconds();
+    }
+    const int64_t time_elapsed_us =
+        reference_clock->TimeInMicroseconds() - start_us;
+
+    uint32_t seconds = 0;
+    uint32_t fractions = 0;
+    start_us = reference_clock->TimeInMicroseconds();
+    for (int j = 0; j < kIterations; ++j) {
+      clock->CurrentNtp(seconds, fractions);
+      sum += fractions;
+    }
+    const int64_t ntp_elapsed_us =
+        reference_clock->TimeInMicroseconds() - start_us;
+    EXPECT_NE(0, sum);
+    printf("%s clock: %.1f M TimeInMicroseconds/s, %.1f M CurrentNtp/s\n",
+           clocks[i].name, static_cast<double>(kIterations) / time_elapsed_us,
+           static_cast<double>(kIterations) / ntp_elapsed_us);
+  }
+}
+
+}  // namespace webrtc
@@ -17,6 +17,7 @@
 
 #include "webrtc/system_wrappers/source/condition_variable_event_win.h"
 #include "webrtc/system_wrappers/source/critical_section_win.h"
+#include "webrtc/system_wrappers/source/lock_profile.h"
 
 namespace webrtc {
 
@@ -67,6 +68,9 @@ bool ConditionVariableEventWin::SleepCS(CriticalSectionWrapper& crit_sect,
 
   CriticalSectionWindows* cs =
       static_cast<CriticalSectionWindows*>(&crit_sect);
+  if (cs->profile_) {
+    cs->profile_->Releasing();
+  }
   LeaveCriticalSection(&cs->crit);
   HANDLE events[2];
   events[0] = events_[WAKE];
@@ -94,6 +98,9 @@ bool ConditionVariableEventWin::SleepCS(CriticalSectionWrapper& crit_sect,
   }
 
   EnterCriticalSection(&cs->crit);
+  if (cs->profile_) {
+    cs->profile_->Acquired(-1);
+  }
   return ret_val;
 }
 
@@ -11,6 +11,7 @@
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/system_wrappers/source/condition_variable_native_win.h"
 #include "webrtc/system_wrappers/source/critical_section_win.h"
+#include "webrtc/system_wrappers/source/lock_profile.h"
 
 namespace webrtc {
 
@@ -89,8 +90,14 @@ bool ConditionVariableNativeWin::SleepCS(CriticalSectionWrapper& crit_sect,
                                          unsigned long max_time_in_ms) {
   CriticalSectionWindows* cs =
       static_cast<CriticalSectionWindows*>(&crit_sect);
+  if (cs->profile_) {
+    cs->profile_->Releasing();
+  }
   BOOL ret_val = PSleepConditionVariableCS_(&condition_variable_,
                                             &(cs->crit), max_time_in_ms);
+  if (cs->profile_) {
+    cs->profile_->Acquired(-1);
+  }
   return ret_val != 0;
 }
 
@@ -18,6 +18,7 @@
 #endif
 
 #include "critical_section_posix.h"
+#include "lock_profile.h"
 
 namespace webrtc {
 
@@ -72,7 +73,13 @@ ConditionVariablePosix::~ConditionVariablePosix() {
 void ConditionVariablePosix::SleepCS(CriticalSectionWrapper& crit_sect) {
   CriticalSectionPosix* cs = reinterpret_cast<CriticalSectionPosix*>(
       &crit_sect);
+  if (cs->profile_) {
+    cs->profile_->Releasing();
+  }
   pthread_cond_wait(&cond_, &cs->mutex_);
+  if (cs->profile_) {
+    cs->profile_->Acquired(-1);
+  }
 }
 
 bool ConditionVariablePosix::SleepCS(CriticalSectionWrapper& crit_sect,
@@ -113,10 +120,16 @@ bool ConditionVariablePosix::SleepCS(CriticalSectionWrapper& crit_sect,
       ts.tv_sec += ts.tv_nsec / NANOSECONDS_PER_SECOND;
       ts.tv_nsec %= NANOSECONDS_PER_SECOND;
     }
+    if (cs->profile_) {
+      cs->profile_->Releasing();
+    }
     const int res = pthread_cond_timedwait(&cond_, &cs->mutex_, &ts);
+    if (cs->profile_) {
+      cs->profile_->Acquired(-1);
+    }
     return (res == ETIMEDOUT) ? false : true;
   } else {
-    pthread_cond_wait(&cond_, &cs->mutex_);
+    SleepCS(crit_sect);
     return true;
   }
 }
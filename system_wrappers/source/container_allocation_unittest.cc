@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Checks that ListWrapper and MapWrapper don't allocate memory in a steady
+// state, by counting the calls to the global operator new.
+
+#include <stdlib.h>
+
+#include <new>
+
+#include "gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/list_wrapper.h"
+#include "webrtc/system_wrappers/interface/map_wrapper.h"
+
+namespace {
+
+bool g_count_allocations = false;
+int g_allocations = 0;
+
+}  // namespace
+
+#if __cplusplus >= 201103L
+#define THROW_BAD_ALLOC
+#define THROW_NOTHING noexcept
+#else
+#define THROW_BAD_ALLOC throw(std::bad_alloc)
+#define THROW_NOTHING throw()
+#endif
+
+void* operator new(size_t size) THROW_BAD_ALLOC {
+  if (g_count_allocations) {
+    ++g_allocations;
+  }
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) THROW_NOTHING {
+  free(ptr);
+}
+
+void* operator new[](size_t size) THROW_BAD_ALLOC {
+  return operator new(size);
+}
+
+void operator delete[](void* ptr) THROW_NOTHING {
+  free(ptr);
+}
+
+namespace webrtc {
+
+const int kNumParticipants = 20;
+const int kNumFrames = 100;
+
+class ContainerAllocationTest : public ::testing::Test {
+ protected:
+  ContainerAllocationTest() {
+    for (int i = 0; i < kNumParticipants; ++i) {
+      participants_[i] = i;
+    }
+  }
+
+  virtual void TearDown() {
+    g_count_allocations = false;
+  }
+
+  void StartCounting() {
+    g_allocations = 0;
+    g_count_allocations = true;
+  }
+
+  int StopCounting() {
+    g_count_allocations = false;
+    return g_allocations;
+  }
+
+  // Does what a mixer does every 10 ms: sorts the participants into
+  // temporary lists and a map of the mixed participants.
+  void MixIteration() {
+    ListWrapper mix_list;
+    ListWrapper ramp_out_list;
+    MapWrapper mixed_participants;
+    for (int i = 0; i < kNumParticipants; ++i) {
+      if (i % 4 == 0) {
+        ramp_out_list.PushBack(&participants_[i]);
+      } else {
+        mix_list.PushBack(&participants_[i]);
+        mixed_participants.Insert(i, &participants_[i]);
+      }
+    }
+    ListItem* item = mix_list.First();
+    while (item) {
+      EXPECT_TRUE(mixed_participants.Find(
+          *static_cast<int*>(item->GetItem())) != NULL);
+      item = mix_list.Next(item);
+    }
+    while (!mix_list.Empty()) {
+      mix_list.PopFront();
+    }
+    while (!ramp_out_list.Empty()) {
+      ramp_out_list.PopBack();
+    }
+    while (mixed_participants.Erase(mixed_participants.First()) == 0) {
+    }
+  }
+
+  int participants_[kNumParticipants];
+};
+
+TEST_F(ContainerAllocationTest, TemporaryContainersDontAllocate) {
+  // Fills the item pools.
+  MixIteration();
+  StartCounting();
+  for (int i = 0; i < kNumFrames; ++i) {
+    MixIteration();
+  }
+  EXPECT_EQ(0, StopCounting());
+}
+
+TEST_F(ContainerAllocationTest, FrameQueueDoesntAllocate) {
+  // A render queue: frames are pushed and the oldest frames popped.
+  ListWrapper queue;
+  for (int i = 0; i < 10; ++i) {
+    queue.PushBack(&participants_[i]);
+  }
+  StartCounting();
+  for (int i = 0; i < kNumFrames; ++i) {
+    queue.PushBack(&participants_[i % kNumParticipants]);
+    queue.PopFront();
+    queue.Insert(queue.First(), new ListItem(i));
+    queue.Erase(queue.Next(queue.First()));
+  }
+  EXPECT_EQ(0, StopCounting());
+  EXPECT_EQ(10u, queue.GetSize());
+  while (queue.PopFront() == 0) {
+  }
+}
+
+TEST_F(ContainerAllocationTest, ModuleMapDoesntAllocate) {
+  // A process thread: modules are registered and deregistered.
+  MapWrapper modules;
+  for (int i = 0; i < kNumParticipants; ++i) {
+    modules.Insert(i, &participants_[i]);
+  }
+  StartCounting();
+  for (int i = 0; i < kNumFrames; ++i) {
+    const int id = (i * 7) % kNumParticipants;
+    EXPECT_EQ(0, modules.Erase(id));
+    EXPECT_EQ(0, modules.Insert(id, &participants_[id]));
+  }
+  EXPECT_EQ(0, StopCounting());
+  EXPECT_EQ(kNumParticipants, modules.Size());
+  while (modules.Erase(modules.First()) == 0) {
+  }
+}
+
+TEST_F(ContainerAllocationTest, LargeMapKeepsOrder) {
+  MapWrapper map;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(0, map.Insert((i * 37) % 100, &participants_[0]));
+  }
+  EXPECT_EQ(100, map.Size());
+  // Inserting an existing id replaces the item.
+  EXPECT_EQ(0, map.Insert(50, &participants_[1]));
+  EXPECT_EQ(100, map.Size());
+  EXPECT_EQ(&participants_[1], map.Find(50)->GetItem());
+  int expected_id = 0;
+  for (MapItem* item = map.First(); item; item = map.Next(item)) {
+    EXPECT_EQ(expected_id++, item->GetId());
+  }
+  EXPECT_EQ(100, expected_id);
+  EXPECT_EQ(98, map.Previous(map.Last())->GetId());
+  EXPECT_TRUE(map.Previous(map.First()) == NULL);
+  while (map.Erase(map.Last()) == 0) {
+  }
+  EXPECT_EQ(0, map.Size());
+}
+
+}  // namespace webrtc
@@ -14,14 +14,26 @@
 #else
 #include "webrtc/system_wrappers/source/critical_section_posix.h"
 #endif
+#include "webrtc/system_wrappers/source/lock_profile.h"
 
 namespace webrtc {
 
 CriticalSectionWrapper* CriticalSectionWrapper::CreateCriticalSection() {
+  LockProfile* profile = LockProfile::Create(NULL, WEBRTC_LOCK_CREATOR);
 #ifdef _WIN32
-  return new CriticalSectionWindows();
+  return new CriticalSectionWindows(profile);
 #else
-  return new CriticalSectionPosix();
+  return new CriticalSectionPosix(profile);
+#endif
+}
+
+CriticalSectionWrapper* CriticalSectionWrapper::CreateCriticalSection(
+    const char* name) {
+  LockProfile* profile = LockProfile::Create(name, WEBRTC_LOCK_CREATOR);
+#ifdef _WIN32
+  return new CriticalSectionWindows(profile);
+#else
+  return new CriticalSectionPosix(profile);
 #endif
 }
 
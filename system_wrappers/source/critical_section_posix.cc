@@ -16,9 +16,12 @@
 
 #include "webrtc/system_wrappers/source/critical_section_posix.h"
 
+#include "webrtc/system_wrappers/source/lock_profile.h"
+
 namespace webrtc {
 
-CriticalSectionPosix::CriticalSectionPosix() {
+CriticalSectionPosix::CriticalSectionPosix(LockProfile* profile)
+    : profile_(profile) {
   pthread_mutexattr_t attr;
   (void) pthread_mutexattr_init(&attr);
   (void) pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
@@ -27,15 +30,29 @@ CriticalSectionPosix::CriticalSectionPosix() {
 
 CriticalSectionPosix::~CriticalSectionPosix() {
   (void) pthread_mutex_destroy(&mutex_);
+  delete profile_;
 }
 
 void
 CriticalSectionPosix::Enter() {
+  if (!profile_) {
+    (void) pthread_mutex_lock(&mutex_);
+    return;
+  }
+  if (pthread_mutex_trylock(&mutex_) == 0) {
+    profile_->Acquired(-1);
+    return;
+  }
+  const int64_t wait_start_us = LockProfile::Now();
   (void) pthread_mutex_lock(&mutex_);
+  profile_->Acquired(wait_start_us);
 }
 
 void
 CriticalSectionPosix::Leave() {
+  if (profile_) {
+    profile_->Releasing();
+  }
   (void) pthread_mutex_unlock(&mutex_);
 }
 
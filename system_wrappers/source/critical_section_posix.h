@@ -17,9 +17,13 @@
 
 namespace webrtc {
 
+class LockProfile;
+
 class CriticalSectionPosix : public CriticalSectionWrapper {
  public:
-  CriticalSectionPosix();
+  // Takes ownership of |profile|, which is NULL unless the LockProfiler is
+  // enabled.
+  explicit CriticalSectionPosix(LockProfile* profile);
 
   virtual ~CriticalSectionPosix();
 
@@ -28,6 +32,7 @@ class CriticalSectionPosix : public CriticalSectionWrapper {
 
  private:
   pthread_mutex_t mutex_;
+  LockProfile* profile_;
   friend class ConditionVariablePosix;
 };
 
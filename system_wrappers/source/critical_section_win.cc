@@ -10,23 +10,40 @@
 
 #include "webrtc/system_wrappers/source/critical_section_win.h"
 
+#include "webrtc/system_wrappers/source/lock_profile.h"
+
 namespace webrtc {
 
-CriticalSectionWindows::CriticalSectionWindows() {
+CriticalSectionWindows::CriticalSectionWindows(LockProfile* profile)
+    : profile_(profile) {
   InitializeCriticalSection(&crit);
 }
 
 CriticalSectionWindows::~CriticalSectionWindows() {
   DeleteCriticalSection(&crit);
+  delete profile_;
 }
 
 void
 CriticalSectionWindows::Enter() {
+  if (!profile_) {
+    EnterCriticalSection(&crit);
+    return;
+  }
+  if (TryEnterCriticalSection(&crit)) {
+    profile_->Acquired(-1);
+    return;
+  }
+  const int64_t wait_start_us = LockProfile::Now();
   EnterCriticalSection(&crit);
+  profile_->Acquired(wait_start_us);
 }
 
 void
 CriticalSectionWindows::Leave() {
+  if (profile_) {
+    profile_->Releasing();
+  }
   LeaveCriticalSection(&crit);
 }
 
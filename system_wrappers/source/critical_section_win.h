@@ -17,9 +17,13 @@
 
 namespace webrtc {
 
+class LockProfile;
+
 class CriticalSectionWindows : public CriticalSectionWrapper {
  public:
-  CriticalSectionWindows();
+  // Takes ownership of |profile|, which is NULL unless the LockProfiler is
+  // enabled.
+  explicit CriticalSectionWindows(LockProfile* profile);
 
   virtual ~CriticalSectionWindows();
 
@@ -28,6 +32,7 @@ class CriticalSectionWindows : public CriticalSectionWrapper {
 
  private:
   CRITICAL_SECTION crit;
+  LockProfile* profile_;
 
   friend class ConditionVariableEventWin;
   friend class ConditionVariableNativeWin;
@@ -11,6 +11,7 @@
 #include "webrtc/system_wrappers/interface/data_log.h"
 
 #include <assert.h>
+#include <string.h>
 #include <algorithm>
 #include <list>
 
@@ -19,6 +20,7 @@
 #include "webrtc/system_wrappers/interface/file_wrapper.h"
 #include "webrtc/system_wrappers/interface/rw_lock_wrapper.h"
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/source/data_log_binary.h"
 
 namespace webrtc {
 
@@ -103,6 +105,56 @@ class LogTable {
   CriticalSectionWrapper* table_lock_;
 };
 
+// A BinaryLogTable has typed columns, which are identified by their index.
+// The cells are copied into the current row, which is appended to a buffer of
+// complete rows. The buffer keeps its capacity when the rows are written, so
+// a table logging at a steady rate doesn't allocate.
+class BinaryLogTable {
+ public:
+  explicit BinaryLogTable(bool compress);
+  ~BinaryLogTable();
+
+  // Creates the file to where the table will be written.
+  int CreateLogFile(const std::string& file_name);
+
+  // Adds a column and returns its index. Fails after the first cell has been
+  // inserted.
+  int AddColumn(const std::string& column_name, DataLogType type,
+                int multi_value_length);
+
+  // Copies |length| values of type |type| into the cell of the current row
+  // at |column|.
+  int InsertCell(int column, DataLogType type, const void* values,
+                 int length);
+
+  // Appends the current row to the rows waiting to be written, and starts a
+  // new empty row. Returns true when a block of rows is ready to be written.
+  bool NextRow();
+
+  // Write all complete rows to file, or only if there is at least a block of
+  // them if |whole_blocks| is true.
+  // May not be called by two threads simultaneously. Will be called by the
+  // file_writer_thread_ when that thread is running.
+  void Flush(bool whole_blocks);
+
+ private:
+  // Fixes the row layout once the first cell is inserted.
+  void FreezeColumns();
+
+  const bool compress_;
+  std::vector<DataLogColumn> columns_;
+  std::vector<int> offsets_;
+  int row_size_;
+  bool columns_frozen_;
+  bool write_header_;
+  std::vector<uint8_t> current_row_;
+  std::vector<uint8_t> rows_[2];
+  std::vector<uint8_t>* rows_history_;
+  std::vector<uint8_t>* rows_flush_;
+  DataLogBinaryWriter writer_;
+  CriticalSectionWrapper* table_lock_;
+};
+
 Row::Row()
   : cells_(),
     cells_lock_(CriticalSectionWrapper::CreateCriticalSection()) {
@@ -272,6 +324,104 @@ void LogTable::Flush() {
   }
 }
 
+BinaryLogTable::BinaryLogTable(bool compress)
+  : compress_(compress),
+    row_size_(0),
+    columns_frozen_(false),
+    write_header_(true),
+    rows_history_(&rows_[0]),
+    rows_flush_(&rows_[1]),
+    table_lock_(CriticalSectionWrapper::CreateCriticalSection()) {
+}
+
+BinaryLogTable::~BinaryLogTable() {
+  delete table_lock_;
+}
+
+int BinaryLogTable::CreateLogFile(const std::string& file_name) {
+  return writer_.Open(file_name);
+}
+
+int BinaryLogTable::AddColumn(const std::string& column_name,
+                              DataLogType type,
+                              int multi_value_length) {
+  if (multi_value_length <= 0 || multi_value_length > 0xffff ||
+      DataLogTypeSize(type) == 0)
+    return -1;
+  CriticalSectionScoped synchronize(table_lock_);
+  if (columns_frozen_)
+    return -1;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (columns_[i].name == column_name)
+      return -1;
+  }
+  DataLogColumn column;
+  column.name = column_name;
+  column.type = type;
+  column.multi_value_length = multi_value_length;
+  columns_.push_back(column);
+  return static_cast<int>(columns_.size()) - 1;
+}
+
+void BinaryLogTable::FreezeColumns() {
+  if (columns_frozen_)
+    return;
+  columns_frozen_ = true;
+  row_size_ = DataLogRowLayout(columns_, &offsets_);
+  current_row_.assign(row_size_, 0);
+  rows_[0].reserve(kDataLogMaxBlockSize + row_size_);
+  rows_[1].reserve(kDataLogMaxBlockSize + row_size_);
+}
+
+int BinaryLogTable::InsertCell(int column, DataLogType type,
+                               const void* values, int length) {
+  CriticalSectionScoped synchronize(table_lock_);
+  FreezeColumns();
+  if (column < 0 || column >= static_cast<int>(columns_.size()) ||
+      columns_[column].type != type ||
+      columns_[column].multi_value_length != length)
+    return -1;
+  uint8_t& bits = current_row_[column / 8];
+  if (bits & (1 << (column % 8)))
+    return -1;
+  bits |= 1 << (column % 8);
+  memcpy(&current_row_[offsets_[column]], values,
+         DataLogTypeSize(type) * length);
+  return 0;
+}
+
+bool BinaryLogTable::NextRow() {
+  CriticalSectionScoped synchronize(table_lock_);
+  FreezeColumns();
+  rows_history_->insert(rows_history_->end(), current_row_.begin(),
+                        current_row_.end());
+  memset(&current_row_[0], 0, (columns_.size() + 7) / 8);
+  return rows_history_->size() >= static_cast<size_t>(kDataLogMaxBlockSize);
+}
+
+void BinaryLogTable::Flush(bool whole_blocks) {
+  {
+    CriticalSectionScoped synchronize(table_lock_);
+    if (!columns_frozen_)
+      return;
+    if (whole_blocks &&
+        rows_history_->size() < static_cast<size_t>(kDataLogMaxBlockSize))
+      return;
+    std::vector<uint8_t>* tmp = rows_flush_;
+    rows_flush_ = rows_history_;
+    rows_history_ = tmp;
+  }
+  if (write_header_) {
+    writer_.WriteHeader(columns_, compress_);
+    write_header_ = false;
+  }
+  if (!rows_flush_->empty()) {
+    writer_.WriteRows(&(*rows_flush_)[0],
+                      static_cast<int>(rows_flush_->size()) / row_size_);
+    rows_flush_->clear();
+  }
+}
+
 int DataLog::CreateLog() {
   return DataLogImpl::CreateLog();
 }
@@ -317,6 +467,31 @@ int DataLog::NextRow(const std::string& table_name) {
   return data_log->DataLogImpl::StaticInstance()->NextRow(table_name);
 }
 
+int DataLog::AddBinaryTable(const std::string& table_name, bool compress) {
+  DataLogImpl* data_log = DataLogImpl::StaticInstance();
+  if (data_log == NULL)
+    return -1;
+  return data_log->AddBinaryTable(table_name, compress);
+}
+
+int DataLog::AddBinaryColumn(int table_id,
+                             const std::string& column_name,
+                             DataLogType type,
+                             int multi_value_length) {
+  DataLogImpl* data_log = DataLogImpl::StaticInstance();
+  if (data_log == NULL)
+    return -1;
+  return data_log->AddBinaryColumn(table_id, column_name, type,
+                                   multi_value_length);
+}
+
+int DataLog::NextBinaryRow(int table_id) {
+  DataLogImpl* data_log = DataLogImpl::StaticInstance();
+  if (data_log == NULL)
+    return -1;
+  return data_log->NextBinaryRow(table_id);
+}
+
 DataLogImpl::DataLogImpl()
   : counter_(1),
     tables_(),
@@ -335,6 +510,10 @@ DataLogImpl::~DataLogImpl() {
     // For maps all iterators (except the erased) are valid after an erase
     tables_.erase(it++);
   }
+  for (size_t i = 0; i < binary_tables_.size(); ++i) {
+    binary_tables_[i]->Flush(false);
+    delete binary_tables_[i];
+  }
   delete tables_lock_;
 }
 
@@ -423,11 +602,64 @@ int DataLogImpl::NextRow(const std::string& table_name) {
   return 0;
 }
 
+int DataLogImpl::AddBinaryTable(const std::string& table_name,
+                                bool compress) {
+  BinaryLogTable* table = new BinaryLogTable(compress);
+  if (table->CreateLogFile(table_name + ".bin") == -1) {
+    delete table;
+    return -1;
+  }
+  WriteLockScoped synchronize(*tables_lock_);
+  binary_tables_.push_back(table);
+  return static_cast<int>(binary_tables_.size()) - 1;
+}
+
+int DataLogImpl::AddBinaryColumn(int table_id,
+                                 const std::string& column_name,
+                                 DataLogType type,
+                                 int multi_value_length) {
+  ReadLockScoped synchronize(*tables_lock_);
+  if (table_id < 0 || table_id >= static_cast<int>(binary_tables_.size()))
+    return -1;
+  return binary_tables_[table_id]->AddColumn(column_name, type,
+                                             multi_value_length);
+}
+
+int DataLogImpl::InsertBinaryCell(int table_id,
+                                  int column,
+                                  DataLogType type,
+                                  const void* values,
+                                  int length) {
+  ReadLockScoped synchronize(*tables_lock_);
+  if (table_id < 0 || table_id >= static_cast<int>(binary_tables_.size()))
+    return -1;
+  return binary_tables_[table_id]->InsertCell(column, type, values, length);
+}
+
+int DataLogImpl::NextBinaryRow(int table_id) {
+  ReadLockScoped synchronize(*tables_lock_);
+  if (table_id < 0 || table_id >= static_cast<int>(binary_tables_.size()))
+    return -1;
+  // Rows are written in blocks, the last rows are written when the log is
+  // deleted.
+  if (binary_tables_[table_id]->NextRow()) {
+    if (file_writer_thread_ == NULL) {
+      binary_tables_[table_id]->Flush(false);
+    } else {
+      flush_event_->Set();
+    }
+  }
+  return 0;
+}
+
 void DataLogImpl::Flush() {
   ReadLockScoped synchronize(*tables_lock_);
   for (TableMap::iterator it = tables_.begin(); it != tables_.end(); ++it) {
     it->second->Flush();
   }
+  for (size_t i = 0; i < binary_tables_.size(); ++i) {
+    binary_tables_[i]->Flush(true);
+  }
 }
 
 bool DataLogImpl::Run(void* obj) {
@@ -0,0 +1,467 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/source/data_log_binary.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "webrtc/system_wrappers/interface/data_log.h"
+#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kMagic[4] = { 'W', 'D', 'L', 'B' };
+const uint32_t kVersion = 1;
+
+// Sequences shorter than this aren't matched.
+const int kMinMatch = 4;
+// The last literals of a block, which are never part of a match.
+const int kLastLiterals = 5;
+const int kMaxOffset = 65535;
+const int kHashBits = 12;
+
+uint32_t Read32(const uint8_t* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+int Hash(uint32_t sequence) {
+  return static_cast<int>((sequence * 2654435761u) >> (32 - kHashBits));
+}
+
+// Writes |length| as the rest after a 4 bit length field that was 15.
+void WriteLength(int length, uint8_t* compressed, int* pos) {
+  while (length >= 255) {
+    compressed[(*pos)++] = 255;
+    length -= 255;
+  }
+  compressed[(*pos)++] = static_cast<uint8_t>(length);
+}
+
+// Writes a sequence of |num_literals| literals followed by a match of
+// |match_length| bytes at |offset| bytes back. A |match_length| of 0 ends the
+// block. Returns false if the sequence doesn't fit.
+bool WriteSequence(const uint8_t* literals, int num_literals, int offset,
+                   int match_length, uint8_t* compressed, int capacity,
+                   int* pos) {
+  const int max_size = 1 + num_literals / 255 + 1 + num_literals + 2 +
+      match_length / 255 + 1;
+  if (*pos + max_size > capacity) {
+    return false;
+  }
+  const int literal_field = std::min(num_literals, 15);
+  const int match_field =
+      match_length > 0 ? std::min(match_length - kMinMatch, 15) : 0;
+  compressed[(*pos)++] = static_cast<uint8_t>((literal_field << 4) |
+                                              match_field);
+  if (literal_field == 15) {
+    WriteLength(num_literals - 15, compressed, pos);
+  }
+  memcpy(compressed + *pos, literals, num_literals);
+  *pos += num_literals;
+  if (match_length == 0) {
+    return true;
+  }
+  compressed[(*pos)++] = static_cast<uint8_t>(offset & 0xff);
+  compressed[(*pos)++] = static_cast<uint8_t>(offset >> 8);
+  if (match_field == 15) {
+    WriteLength(match_length - kMinMatch - 15, compressed, pos);
+  }
+  return true;
+}
+
+// Reads the rest of a length whose 4 bit field was 15.
+bool ReadLength(const uint8_t* compressed, int size, int* pos, int* length) {
+  uint8_t byte = 255;
+  while (byte == 255) {
+    if (*pos >= size) {
+      return false;
+    }
+    byte = compressed[(*pos)++];
+    *length += byte;
+  }
+  return true;
+}
+
+bool WriteUInt32(FileWrapper* file, uint32_t value) {
+  return file->Write(&value, sizeof(value));
+}
+
+bool ReadUInt32(FileWrapper* file, uint32_t* value) {
+  return file->Read(value, sizeof(*value)) == sizeof(*value);
+}
+
+template<class T>
+void AppendValues(const uint8_t* data, int length, std::stringstream* ss) {
+  for (int i = 0; i < length; ++i) {
+    T value;
+    memcpy(&value, data + i * sizeof(T), sizeof(T));
+    *ss << value << ",";
+  }
+}
+
+void AppendValues(DataLogType type, const uint8_t* data, int length,
+                  std::stringstream* ss) {
+  switch (type) {
+    case kDataLogInt32:
+      AppendValues<int32_t>(data, length, ss);
+      break;
+    case kDataLogUInt32:
+      AppendValues<uint32_t>(data, length, ss);
+      break;
+    case kDataLogInt64:
+      AppendValues<int64_t>(data, length, ss);
+      break;
+    case kDataLogFloat:
+      AppendValues<float>(data, length, ss);
+      break;
+    case kDataLogDouble:
+      AppendValues<double>(data, length, ss);
+      break;
+  }
+}
+
+class ColumnNameLess {
+ public:
+  explicit ColumnNameLess(const std::vector<DataLogColumn>& columns)
+      : columns_(columns) {}
+  bool operator()(int a, int b) const {
+    return columns_[a].name < columns_[b].name;
+  }
+
+ private:
+  const std::vector<DataLogColumn>& columns_;
+};
+
+}  // namespace
+
+int DataLogTypeSize(DataLogType type) {
+  switch (type) {
+    case kDataLogInt32:
+    case kDataLogUInt32:
+    case kDataLogFloat:
+      return 4;
+    case kDataLogInt64:
+    case kDataLogDouble:
+      return 8;
+  }
+  return 0;
+}
+
+int DataLogRowLayout(const std::vector<DataLogColumn>& columns,
+                     std::vector<int>* offsets) {
+  int row_size = static_cast<int>(columns.size() + 7) / 8;
+  offsets->resize(columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    (*offsets)[i] = row_size;
+    row_size += DataLogTypeSize(columns[i].type) *
+        columns[i].multi_value_length;
+  }
+  return row_size;
+}
+
+int DataLogCompress(const uint8_t* data, int size, uint8_t* compressed,
+                    int capacity) {
+  int hash_table[1 << kHashBits];
+  for (int i = 0; i < (1 << kHashBits); ++i) {
+    hash_table[i] = -1;
+  }
+  const int match_limit = size - kLastLiterals;
+  int pos = 0;
+  int anchor = 0;
+  int compressed_size = 0;
+  while (pos + kMinMatch <= match_limit) {
+    const uint32_t sequence = Read32(data + pos);
+    const int hash = Hash(sequence);
+    const int candidate = hash_table[hash];
+    hash_table[hash] = pos;
+    if (candidate < 0 || pos - candidate > kMaxOffset ||
+        Read32(data + candidate) != sequence) {
+      ++pos;
+      continue;
+    }
+    int match_length = kMinMatch;
+    while (pos + match_length < match_limit &&
+           data[candidate + match_length] == data[pos + match_length]) {
+      ++match_length;
+    }
+    if (!WriteSequence(data + anchor, pos - anchor, pos - candidate,
+                       match_length, compressed, capacity,
+                       &compressed_size)) {
+      return 0;
+    }
+    pos += match_length;
+    anchor = pos;
+  }
+  if (!WriteSequence(data + anchor, size - anchor, 0, 0, compressed, capacity,
+                     &compressed_size)) {
+    return 0;
+  }
+  return compressed_size;
+}
+
+int DataLogDecompress(const uint8_t* compressed, int size, uint8_t* data,
+                      int capacity) {
+  int pos = 0;
+  int data_size = 0;
+  while (pos < size) {
+    const uint8_t token = compressed[pos++];
+    int num_literals = token >> 4;
+    if (num_literals == 15 &&
+        !ReadLength(compressed, size, &pos, &num_literals)) {
+      return -1;
+    }
+    if (num_literals > size - pos || num_literals > capacity - data_size) {
+      return -1;
+    }
+    memcpy(data + data_size, compressed + pos, num_literals);
+    pos += num_literals;
+    data_size += num_literals;
+    if (pos == size) {
+      // The last sequence has no match.
+      break;
+    }
+    if (pos + 2 > size) {
+      return -1;
+    }
+    const int offset = compressed[pos] | (compressed[pos + 1] << 8);
+    pos += 2;
+    int match_length = token & 0x0f;
+    if (match_length == 15 &&
+        !ReadLength(compressed, size, &pos, &match_length)) {
+      return -1;
+    }
+    match_length += kMinMatch;
+    if (offset == 0 || offset > data_size ||
+        match_length > capacity - data_size) {
+      return -1;
+    }
+    // The match may overlap the bytes it produces.
+    for (int i = 0; i < match_length; ++i, ++data_size) {
+      data[data_size] = data[data_size - offset];
+    }
+  }
+  return data_size;
+}
+
+DataLogBinaryWriter::DataLogBinaryWriter()
+    : file_(FileWrapper::Create()),
+      row_size_(0),
+      compress_(false) {
+}
+
+DataLogBinaryWriter::~DataLogBinaryWriter() {
+  file_->Flush();
+  file_->CloseFile();
+  delete file_;
+}
+
+int DataLogBinaryWriter::Open(const std::string& file_name) {
+  if (file_name.length() == 0 || file_->Open())
+    return -1;
+  return file_->OpenFile(file_name.c_str(),
+                         false,  // Open with read/write permissions
+                         false,  // Don't wraparound
+                         false);  // Open as a binary file
+}
+
+void DataLogBinaryWriter::WriteHeader(const std::vector<DataLogColumn>& columns,
+                                      bool compress) {
+  columns_ = columns;
+  row_size_ = DataLogRowLayout(columns_, &offsets_);
+  compress_ = compress;
+  file_->Write(kMagic, sizeof(kMagic));
+  WriteUInt32(file_, kVersion);
+  WriteUInt32(file_, static_cast<uint32_t>(columns_.size()));
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    WriteUInt32(file_, columns_[i].type);
+    WriteUInt32(file_, columns_[i].multi_value_length);
+    WriteUInt32(file_, static_cast<uint32_t>(columns_[i].name.length()));
+    if (!columns_[i].name.empty()) {
+      file_->Write(columns_[i].name.data(),
+                   static_cast<int>(columns_[i].name.length()));
+    }
+  }
+}
+
+void DataLogBinaryWriter::WriteRows(const uint8_t* rows, int num_rows) {
+  if (row_size_ == 0)
+    return;
+  const int rows_per_block =
+      std::max(1, static_cast<int>(kDataLogMaxBlockSize) / row_size_);
+  while (num_rows > 0) {
+    const int block_rows = std::min(num_rows, rows_per_block);
+    WriteBlock(rows, block_rows);
+    rows += block_rows * row_size_;
+    num_rows -= block_rows;
+  }
+}
+
+void DataLogBinaryWriter::WriteBlock(const uint8_t* rows, int num_rows) {
+  const int raw_size = num_rows * row_size_;
+  block_.resize(raw_size);
+  // Store the cell bits of all rows, then each column in turn.
+  uint8_t* block = &block_[0];
+  const int bits_size = static_cast<int>(columns_.size() + 7) / 8;
+  for (int row = 0; row < num_rows; ++row) {
+    memcpy(block, rows + row * row_size_, bits_size);
+    block += bits_size;
+  }
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    const int size = DataLogTypeSize(columns_[i].type) *
+        columns_[i].multi_value_length;
+    for (int row = 0; row < num_rows; ++row) {
+      memcpy(block, rows + row * row_size_ + offsets_[i], size);
+      block += size;
+    }
+  }
+
+  int stored_size = 0;
+  if (compress_) {
+    compressed_.resize(raw_size);
+    // Only stored compressed if smaller.
+    stored_size = DataLogCompress(&block_[0], raw_size, &compressed_[0],
+                                  raw_size - 1);
+  }
+  WriteUInt32(file_, num_rows);
+  WriteUInt32(file_, raw_size);
+  if (stored_size > 0) {
+    WriteUInt32(file_, stored_size);
+    file_->Write(&compressed_[0], stored_size);
+  } else {
+    WriteUInt32(file_, raw_size);
+    file_->Write(&block_[0], raw_size);
+  }
+}
+
+int DataLog::ConvertBinaryToCsv(const std::string& binary_file_name,
+                                const std::string& csv_file_name) {
+  scoped_ptr<FileWrapper> in(FileWrapper::Create());
+  if (in->OpenFile(binary_file_name.c_str(), true, false, false) != 0)
+    return -1;
+  char magic[sizeof(kMagic)];
+  uint32_t version = 0;
+  uint32_t num_columns = 0;
+  if (in->Read(magic, sizeof(magic)) != sizeof(magic) ||
+      memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+      !ReadUInt32(in.get(), &version) || version != kVersion ||
+      !ReadUInt32(in.get(), &num_columns))
+    return -1;
+
+  std::vector<DataLogColumn> columns(num_columns);
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    uint32_t type = 0;
+    uint32_t multi_value_length = 0;
+    uint32_t name_length = 0;
+    if (!ReadUInt32(in.get(), &type) || type > kDataLogDouble ||
+        !ReadUInt32(in.get(), &multi_value_length) ||
+        multi_value_length == 0 || multi_value_length > 0xffff ||
+        !ReadUInt32(in.get(), &name_length) ||
+        name_length > FileWrapper::kMaxFileNameSize)
+      return -1;
+    std::vector<char> name(name_length + 1);
+    if (name_length > 0 &&
+        in->Read(&name[0], name_length) != static_cast<int>(name_length))
+      return -1;
+    columns[i].name.assign(&name[0], name_length);
+    columns[i].type = static_cast<DataLogType>(type);
+    columns[i].multi_value_length = multi_value_length;
+  }
+  std::vector<int> offsets;
+  const int row_size = DataLogRowLayout(columns, &offsets);
+  const int bits_size = static_cast<int>(num_columns + 7) / 8;
+
+  // The text tables have their columns sorted by name.
+  std::vector<int> order(num_columns);
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), ColumnNameLess(columns));
+
+  scoped_ptr<FileWrapper> out(FileWrapper::Create());
+  if (out->OpenFile(csv_file_name.c_str(), false, false, true) != 0)
+    return -1;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const DataLogColumn& column = columns[order[i]];
+    if (column.multi_value_length > 1) {
+      out->WriteText("%s[%u],", column.name.c_str(),
+                     column.multi_value_length);
+      for (int j = 1; j < column.multi_value_length; ++j)
+        out->WriteText(",");
+    } else {
+      out->WriteText("%s,", column.name.c_str());
+    }
+  }
+  if (num_columns > 0)
+    out->WriteText("\n");
+
+  std::vector<uint8_t> stored;
+  std::vector<uint8_t> block;
+  std::vector<int> column_starts(num_columns);
+  uint32_t num_rows = 0;
+  while (ReadUInt32(in.get(), &num_rows)) {
+    uint32_t raw_size = 0;
+    uint32_t stored_size = 0;
+    if (!ReadUInt32(in.get(), &raw_size) ||
+        !ReadUInt32(in.get(), &stored_size) ||
+        num_rows == 0 || row_size <= 0 ||
+        raw_size % row_size != 0 || raw_size / row_size != num_rows ||
+        (num_rows > 1 && raw_size > kDataLogMaxBlockSize) ||
+        stored_size == 0 || stored_size > raw_size)
+      return -1;
+    stored.resize(stored_size);
+    block.resize(raw_size);
+    if (in->Read(&stored[0], stored_size) != static_cast<int>(stored_size))
+      return -1;
+    if (stored_size < raw_size) {
+      if (DataLogDecompress(&stored[0], stored_size, &block[0], raw_size) !=
+          static_cast<int>(raw_size))
+        return -1;
+    } else {
+      block.swap(stored);
+    }
+
+    int start = num_rows * bits_size;
+    for (uint32_t i = 0; i < num_columns; ++i) {
+      column_starts[i] = start;
+      start += num_rows * DataLogTypeSize(columns[i].type) *
+          columns[i].multi_value_length;
+    }
+    for (uint32_t row = 0; row < num_rows; ++row) {
+      std::stringstream ss;
+      const uint8_t* bits = &block[row * bits_size];
+      for (size_t i = 0; i < order.size(); ++i) {
+        const int column = order[i];
+        if (((bits[column / 8] >> (column % 8)) & 1) == 0) {
+          ss << "NaN,";
+          continue;
+        }
+        const int size = DataLogTypeSize(columns[column].type) *
+            columns[column].multi_value_length;
+        AppendValues(columns[column].type,
+                     &block[column_starts[column] + row * size],
+                     columns[column].multi_value_length, &ss);
+      }
+      out->WriteText("%s\n", ss.str().c_str());
+    }
+  }
+  out->Flush();
+  out->CloseFile();
+  return 0;
+}
+
+}  // namespace webrtc
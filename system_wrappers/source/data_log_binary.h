@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// The file format of binary DataLog tables.
+//
+// The file starts with a header:
+//   "WDLB", uint32 version, uint32 number of columns,
+//   for each column: uint32 type, uint32 multi_value_length,
+//                    uint32 name length, name.
+// followed by blocks of rows:
+//   uint32 number of rows, uint32 raw size, uint32 stored size, stored data.
+// A block is compressed if its stored size is less than its raw size. The raw
+// block holds one bit per column and row telling if the cell was inserted,
+// followed by the values of each column in turn. Integers and values are
+// stored in host byte order.
+#ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_DATA_LOG_BINARY_H_
+#define WEBRTC_SYSTEM_WRAPPERS_SOURCE_DATA_LOG_BINARY_H_
+
+#include <string>
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/data_log_impl.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class FileWrapper;
+
+// The maximum raw size of a block, unless a single row is larger.
+enum { kDataLogMaxBlockSize = 64 * 1024 };
+
+struct DataLogColumn {
+  std::string name;
+  DataLogType type;
+  int multi_value_length;
+};
+
+// Returns the size in bytes of a value of type |type|.
+int DataLogTypeSize(DataLogType type);
+
+// Returns the size in bytes of a row of |columns|. A row starts with the bits
+// telling which cells are set, followed by the values of each column. The
+// offset of each column in a row is stored in |offsets|.
+int DataLogRowLayout(const std::vector<DataLogColumn>& columns,
+                     std::vector<int>* offsets);
+
+// Compresses |size| bytes with an LZ77 coder using the LZ4 sequence format.
+// Returns the compressed size, or 0 if the data doesn't fit in |capacity|
+// bytes.
+int DataLogCompress(const uint8_t* data, int size, uint8_t* compressed,
+                    int capacity);
+
+// Decompresses |size| bytes compressed by DataLogCompress(). Returns the
+// decompressed size, or -1 if the data is corrupt or doesn't fit in
+// |capacity| bytes.
+int DataLogDecompress(const uint8_t* compressed, int size, uint8_t* data,
+                      int capacity);
+
+// Writes rows to a binary table file. Not thread-safe.
+class DataLogBinaryWriter {
+ public:
+  DataLogBinaryWriter();
+  ~DataLogBinaryWriter();
+
+  int Open(const std::string& file_name);
+
+  // Writes the header. Must be called before WriteRows().
+  void WriteHeader(const std::vector<DataLogColumn>& columns, bool compress);
+
+  // Writes |num_rows| rows in the layout returned by DataLogRowLayout().
+  void WriteRows(const uint8_t* rows, int num_rows);
+
+ private:
+  void WriteBlock(const uint8_t* rows, int num_rows);
+
+  FileWrapper* file_;
+  std::vector<DataLogColumn> columns_;
+  std::vector<int> offsets_;
+  int row_size_;
+  bool compress_;
+  std::vector<uint8_t> block_;
+  std::vector<uint8_t> compressed_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_SOURCE_DATA_LOG_BINARY_H_
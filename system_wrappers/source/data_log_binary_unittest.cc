@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/source/data_log_binary.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/data_log.h"
+
+namespace webrtc {
+
+namespace {
+
+std::string ReadFile(const char* file_name) {
+  std::string contents;
+  FILE* file = fopen(file_name, "rb");
+  if (file == NULL)
+    return contents;
+  char buffer[256];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, length);
+  }
+  fclose(file);
+  return contents;
+}
+
+void ExpectRoundTrip(const std::vector<uint8_t>& data, bool compressible) {
+  const int size = static_cast<int>(data.size());
+  // The worst case size of incompressible data.
+  const int capacity = size + size / 255 + 16;
+  std::vector<uint8_t> compressed(capacity);
+  const int compressed_size = DataLogCompress(&data[0], size, &compressed[0],
+                                              capacity);
+  ASSERT_GT(compressed_size, 0);
+  if (compressible) {
+    EXPECT_LT(compressed_size, size / 4);
+  }
+  std::vector<uint8_t> decompressed(size);
+  ASSERT_EQ(size, DataLogDecompress(&compressed[0], compressed_size,
+                                    &decompressed[0], size));
+  EXPECT_TRUE(decompressed == data);
+}
+
+}  // namespace
+
+TEST(DataLogBinaryTest, CompressionRoundTrip) {
+  std::vector<uint8_t> data;
+  // Slowly increasing timestamps, like a column of a table.
+  for (uint32_t i = 0; i < 10000; ++i) {
+    const uint32_t timestamp = 90000 + (i / 16) * 3000;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&timestamp);
+    data.insert(data.end(), bytes, bytes + sizeof(timestamp));
+  }
+  ExpectRoundTrip(data, true);
+
+  // Long runs and short inputs.
+  ExpectRoundTrip(std::vector<uint8_t>(70000, 7), true);
+  ExpectRoundTrip(std::vector<uint8_t>(1, 7), false);
+  ExpectRoundTrip(std::vector<uint8_t>(13, 7), false);
+
+  // Random data doesn't fit in less than its size.
+  data.resize(5000);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < data.size(); ++i) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast<uint8_t>(seed >> 16);
+  }
+  ExpectRoundTrip(data, false);
+  std::vector<uint8_t> compressed(data.size());
+  EXPECT_EQ(0, DataLogCompress(&data[0], static_cast<int>(data.size()),
+                               &compressed[0],
+                               static_cast<int>(data.size()) - 1));
+}
+
+TEST(DataLogBinaryTest, RejectsCorruptData) {
+  std::vector<uint8_t> data(1000, 3);
+  std::vector<uint8_t> compressed(1000);
+  const int compressed_size = DataLogCompress(&data[0], 1000, &compressed[0],
+                                              1000);
+  ASSERT_GT(compressed_size, 0);
+  // Too small output.
+  EXPECT_EQ(-1, DataLogDecompress(&compressed[0], compressed_size, &data[0],
+                                  999));
+  // A truncated input is either rejected or decompressed to less data, which
+  // the reader detects from the size of the block.
+  EXPECT_LT(DataLogDecompress(&compressed[0], 2, &data[0], 1000), 1000);
+  EXPECT_LT(DataLogDecompress(&compressed[0], compressed_size - 1, &data[0],
+                              1000), 1000);
+  // An offset before the start of the output.
+  const uint8_t bad_offset[] = { 0x10, 1, 2, 0, 0x00 };
+  EXPECT_EQ(-1, DataLogDecompress(bad_offset, sizeof(bad_offset), &data[0],
+                                  1000));
+}
+
+TEST(DataLogBinaryTest, ConvertsToCsv) {
+  std::vector<DataLogColumn> columns(3);
+  columns[0].name = "timestamp";
+  columns[0].type = kDataLogUInt32;
+  columns[0].multi_value_length = 1;
+  columns[1].name = "delay";
+  columns[1].type = kDataLogDouble;
+  columns[1].multi_value_length = 1;
+  columns[2].name = "sizes";
+  columns[2].type = kDataLogInt32;
+  columns[2].multi_value_length = 2;
+  std::vector<int> offsets;
+  const int row_size = DataLogRowLayout(columns, &offsets);
+  ASSERT_EQ(1 + 4 + 8 + 2 * 4, row_size);
+
+  std::vector<uint8_t> rows(2 * row_size, 0);
+  const uint32_t timestamps[] = { 3000, 6000 };
+  const double delay = 10.5;
+  const int32_t sizes[] = { -1, 1200 };
+  // All cells are set in the first row, the delay is missing in the second.
+  rows[0] = 7;
+  memcpy(&rows[offsets[0]], &timestamps[0], 4);
+  memcpy(&rows[offsets[1]], &delay, 8);
+  memcpy(&rows[offsets[2]], sizes, 8);
+  rows[row_size] = 5;
+  memcpy(&rows[row_size + offsets[0]], &timestamps[1], 4);
+  memcpy(&rows[row_size + offsets[2]], sizes, 8);
+
+  for (int compress = 0; compress < 2; ++compress) {
+    {
+      DataLogBinaryWriter writer;
+      ASSERT_EQ(0, writer.Open("data_log_binary_test.bin"));
+      writer.WriteHeader(columns, compress != 0);
+      writer.WriteRows(&rows[0], 1);
+      writer.WriteRows(&rows[row_size], 1);
+    }
+    ASSERT_EQ(0, DataLog::ConvertBinaryToCsv("data_log_binary_test.bin",
+                                             "data_log_binary_test.txt"));
+    EXPECT_EQ("delay,sizes[2],,timestamp,\n"
+              "10.5,-1,1200,3000,\n"
+              "NaN,-1,1200,6000,\n",
+              ReadFile("data_log_binary_test.txt"));
+  }
+  EXPECT_EQ(-1, DataLog::ConvertBinaryToCsv("data_log_binary_test.txt",
+                                             "data_log_binary_test.csv"));
+  remove("data_log_binary_test.bin");
+  remove("data_log_binary_test.txt");
+}
+
+TEST(DataLogBinaryTest, RejectsBlockWithWrongRowCount) {
+  std::vector<DataLogColumn> columns(1);
+  columns[0].name = "timestamp";
+  columns[0].type = kDataLogUInt32;
+  columns[0].multi_value_length = 1;
+  {
+    DataLogBinaryWriter writer;
+    ASSERT_EQ(0, writer.Open("data_log_binary_rows.bin"));
+    writer.WriteHeader(columns, false);
+  }
+  // 858993460 rows of 5 bytes wrap around to 4 bytes in 32 bits.
+  const uint32_t block[] = { 858993460u, 4, 4, 0 };
+  FILE* file = fopen("data_log_binary_rows.bin", "ab");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(4u, fwrite(block, sizeof(block[0]), 4, file));
+  fclose(file);
+  EXPECT_EQ(-1, DataLog::ConvertBinaryToCsv("data_log_binary_rows.bin",
+                                             "data_log_binary_rows.txt"));
+  remove("data_log_binary_rows.bin");
+  remove("data_log_binary_rows.txt");
+}
+
+}  // namespace webrtc
@@ -39,6 +39,22 @@ int DataLog::NextRow(const std::string& /*table_name*/) {
   return 0;
 }
 
+int DataLog::AddBinaryTable(const std::string& /*table_name*/,
+                            bool /*compress*/) {
+  return 0;
+}
+
+int DataLog::AddBinaryColumn(int /*table_id*/,
+                             const std::string& /*column_name*/,
+                             DataLogType /*type*/,
+                             int /*multi_value_length*/) {
+  return 0;
+}
+
+int DataLog::NextBinaryRow(int /*table_id*/) {
+  return 0;
+}
+
 DataLogImpl::DataLogImpl() {
 }
 
@@ -72,6 +88,30 @@ int DataLogImpl::NextRow(const std::string& /*table_name*/) {
   return 0;
 }
 
+int DataLogImpl::AddBinaryTable(const std::string& /*table_name*/,
+                                bool /*compress*/) {
+  return 0;
+}
+
+int DataLogImpl::AddBinaryColumn(int /*table_id*/,
+                                 const std::string& /*column_name*/,
+                                 DataLogType /*type*/,
+                                 int /*multi_value_length*/) {
+  return 0;
+}
+
+int DataLogImpl::InsertBinaryCell(int /*table_id*/,
+                                  int /*column*/,
+                                  DataLogType /*type*/,
+                                  const void* /*values*/,
+                                  int /*length*/) {
+  return 0;
+}
+
+int DataLogImpl::NextBinaryRow(int /*table_id*/) {
+  return 0;
+}
+
 void DataLogImpl::Flush() {
 }
 
@@ -281,6 +281,68 @@ TEST(TestDataLog, VerifyMultipleTables) {
   }
 }
 
+TEST(TestDataLog, VerifyBinaryTableMatchesTextTable) {
+  DataLog::CreateLog();
+  DataLog::AddTable("text_table");
+  DataLog::AddColumn("text_table", "arrival", 1);
+  DataLog::AddColumn("text_table", "timestamp", 1);
+  DataLog::AddColumn("text_table", "size", 5);
+  const int table_id = DataLog::AddBinaryTable("binary_table", true);
+  ASSERT_GE(table_id, 0);
+  const int timestamp = DataLog::AddBinaryColumn(table_id, "timestamp",
+                                                 webrtc::kDataLogInt64, 1);
+  const int arrival = DataLog::AddBinaryColumn(table_id, "arrival",
+                                               webrtc::kDataLogDouble, 1);
+  const int size = DataLog::AddBinaryColumn(table_id, "size",
+                                            webrtc::kDataLogUInt32, 5);
+  ASSERT_EQ(2, size);
+  EXPECT_EQ(-1, DataLog::AddBinaryColumn(table_id, "size",
+                                         webrtc::kDataLogUInt32, 1));
+
+  WebRtc_UWord32 sizes[5] = {1400, 1500, 1600, 1700, 1800};
+  // Enough rows for several blocks.
+  const int kNumberOfRows = 5000;
+  for (int i = 0; i < kNumberOfRows; ++i) {
+    const double arrival_time = i / 3.0;
+    const WebRtc_Word64 rtp_timestamp = 4354 + i / 8;
+    DataLog::InsertCell("text_table", "arrival", arrival_time);
+    DataLog::InsertCell("text_table", "timestamp", rtp_timestamp);
+    DataLog::InsertCell("text_table", "size", sizes, 5);
+    DataLog::NextRow("text_table");
+    EXPECT_EQ(0, DataLog::InsertBinaryCell(table_id, arrival, arrival_time));
+    EXPECT_EQ(0, DataLog::InsertBinaryCell(table_id, timestamp,
+                                           rtp_timestamp));
+    EXPECT_EQ(0, DataLog::InsertBinaryCell(table_id, size, sizes, 5));
+    DataLog::NextBinaryRow(table_id);
+  }
+  // Wrong types and lengths, and columns added after the first row.
+  EXPECT_EQ(-1, DataLog::InsertBinaryCell(table_id, arrival, 1.0f));
+  EXPECT_EQ(-1, DataLog::InsertBinaryCell(table_id, size, sizes, 4));
+  EXPECT_EQ(-1, DataLog::AddBinaryColumn(table_id, "late",
+                                         webrtc::kDataLogInt32, 1));
+  DataLog::ReturnLog();
+
+  ASSERT_EQ(0, DataLog::ConvertBinaryToCsv("binary_table.bin",
+                                           "binary_table.txt"));
+  FILE* text_table = fopen("text_table.txt", "r");
+  ASSERT_FALSE(text_table == NULL);
+  FILE* binary_table = fopen("binary_table.txt", "r");
+  ASSERT_FALSE(binary_table == NULL);
+  int lines = 0;
+  char text_line[DataLogParser::kMaxLineLength];
+  char binary_line[DataLogParser::kMaxLineLength];
+  while (fgets(text_line, sizeof(text_line), text_table) != NULL) {
+    ASSERT_FALSE(fgets(binary_line, sizeof(binary_line), binary_table) ==
+                 NULL);
+    EXPECT_STREQ(text_line, binary_line);
+    ++lines;
+  }
+  EXPECT_TRUE(fgets(binary_line, sizeof(binary_line), binary_table) == NULL);
+  EXPECT_EQ(kNumberOfRows + 1, lines);
+  fclose(text_table);
+  fclose(binary_table);
+}
+
 TEST(TestDataLogCWrapper, VerifyCWrapper) {
   // Simply call all C wrapper log functions through the C helper unittests.
   // Main purpose is to make sure that the linkage is correct.
@@ -148,11 +148,19 @@ int FileWrapperImpl::OpenFile(const char* file_name_utf8, bool read_only,
 #endif
 
   if (tmp_id != NULL) {
+    scoped_array<char> read_buffer;
+    if (read_only && !text) {
+      // Callers typically read 10 ms of audio at a time. Read ahead in large
+      // blocks to save system calls.
+      read_buffer.reset(new char[kReadBufferSize]);
+      setvbuf(tmp_id, read_buffer.get(), _IOFBF, kReadBufferSize);
+    }
     // +1 comes from copying the NULL termination character.
     memcpy(file_name_utf8_, file_name_utf8, length + 1);
     if (id_ != NULL) {
       fclose(id_);
     }
+    read_buffer_.swap(read_buffer);
     id_ = tmp_id;
     looping_ = loop;
     open_ = true;
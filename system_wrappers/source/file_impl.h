@@ -48,9 +48,14 @@ class FileWrapperImpl : public FileWrapper {
   int CloseFileImpl();
   int FlushImpl();
 
+  // Size of the stdio buffer of files opened for binary reading.
+  static const size_t kReadBufferSize = 64 * 1024;
+
   scoped_ptr<RWLockWrapper> rw_lock_;
 
   FILE* id_;
+  // Must outlive |id_|.
+  scoped_array<char> read_buffer_;
   bool open_;
   bool looping_;
   bool read_only_;
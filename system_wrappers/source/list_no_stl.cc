@@ -10,11 +10,24 @@
 
 #include "webrtc/system_wrappers/interface/list_wrapper.h"
 
-#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
+#include "webrtc/system_wrappers/source/node_pool.h"
 
 namespace webrtc {
 
+namespace {
+
+const int kMaxFreeListItems = 4096;
+
+NodePool* ListItemPool() {
+  // Created on first use and never deleted, since lists may be used during
+  // static destruction.
+  static NodePool* pool = new NodePool(sizeof(ListItem), kMaxFreeListItems);
+  return pool;
+}
+
+}  // namespace
+
 ListItem::ListItem(const void* item)
     : next_(0),
       prev_(0),
@@ -40,9 +53,16 @@ unsigned int ListItem::GetUnsignedItem() const {
   return item_;
 }
 
+void* ListItem::operator new(size_t size) {
+  return ListItemPool()->Allocate(size);
+}
+
+void ListItem::operator delete(void* ptr, size_t size) {
+  ListItemPool()->Free(ptr, size);
+}
+
 ListWrapper::ListWrapper()
-    : critical_section_(CriticalSectionWrapper::CreateCriticalSection()),
-      first_(0),
+    : first_(0),
       last_(0),
       size_(0) {
 }
@@ -56,7 +76,6 @@ ListWrapper::~ListWrapper() {
     while (Erase(First()) == 0)
     {}
   }
-  delete critical_section_;
 }
 
 bool ListWrapper::Empty() const {
@@ -69,28 +88,24 @@ unsigned int ListWrapper::GetSize() const {
 
 int ListWrapper::PushBack(const void* ptr) {
   ListItem* item = new ListItem(ptr);
-  CriticalSectionScoped lock(critical_section_);
   PushBackImpl(item);
   return 0;
 }
 
 int ListWrapper::PushBack(const unsigned int item_id) {
   ListItem* item = new ListItem(item_id);
-  CriticalSectionScoped lock(critical_section_);
   PushBackImpl(item);
   return 0;
 }
 
 int ListWrapper::PushFront(const unsigned int item_id) {
   ListItem* item = new ListItem(item_id);
-  CriticalSectionScoped lock(critical_section_);
   PushFrontImpl(item);
   return 0;
 }
 
 int ListWrapper::PushFront(const void* ptr) {
   ListItem* item = new ListItem(ptr);
-  CriticalSectionScoped lock(critical_section_);
   PushFrontImpl(item);
   return 0;
 }
@@ -135,7 +150,6 @@ int ListWrapper::Insert(ListItem* existing_previous_item, ListItem* new_item) {
   if (!existing_previous_item && !Empty()) {
     return -1;
   }
-  CriticalSectionScoped lock(critical_section_);
   if (!existing_previous_item) {
     PushBackImpl(new_item);
     return 0;
@@ -164,7 +178,6 @@ int ListWrapper::InsertBefore(ListItem* existing_next_item,
   if (!existing_next_item && !Empty()) {
     return -1;
   }
-  CriticalSectionScoped lock(critical_section_);
   if (!existing_next_item) {
     PushBackImpl(new_item);
     return 0;
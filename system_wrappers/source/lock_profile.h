@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_LOCK_PROFILE_H_
+#define WEBRTC_SYSTEM_WRAPPERS_SOURCE_LOCK_PROFILE_H_
+
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/lock_profiler.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+// The address the lock factory returns to, identifying unnamed locks.
+#if defined(__GNUC__)
+#define WEBRTC_LOCK_CREATOR __builtin_return_address(0)
+#else
+#define WEBRTC_LOCK_CREATOR NULL
+#endif
+
+namespace webrtc {
+
+// The counters of one profiled lock. Acquired() and Releasing() are called by
+// the lock implementation while the lock is held exclusively.
+class LockProfile {
+ public:
+  // Returns a profile registered with the LockProfiler, or NULL if the
+  // profiler is disabled. |creator| identifies unnamed locks.
+  static LockProfile* Create(const char* name, const void* creator);
+  ~LockProfile();
+
+  static int64_t Now() { return TickTime::MicrosecondTimestamp(); }
+
+  // Called after the lock has been acquired exclusively. |wait_start_us| is
+  // the time the caller started waiting, or -1 if it didn't wait.
+  void Acquired(int64_t wait_start_us);
+  // Called before the lock is released.
+  void Releasing();
+
+  // Called after the lock has been acquired shared.
+  void AcquiredShared(bool contended);
+
+  void GetStatistics(LockStatistics* statistics) const;
+
+ private:
+  LockProfile();
+
+  LockStatistics statistics_;
+  int depth_;
+  int64_t hold_start_us_;
+  Atomic32 shared_acquisitions_;
+  Atomic32 contended_shared_acquisitions_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_SOURCE_LOCK_PROFILE_H_
@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/lock_profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/trace.h"
+#include "webrtc/system_wrappers/source/lock_profile.h"
+
+namespace webrtc {
+
+namespace {
+
+bool g_enabled = false;
+// Created by the first call to LockProfiler::Enable(true), while profiling is
+// still disabled, and never deleted since profiled locks may outlive any
+// owner.
+CriticalSectionWrapper* g_profiles_crit = NULL;
+std::vector<LockProfile*>* g_profiles = NULL;
+
+int HistogramBucket(int64_t time_us) {
+  int bucket = 0;
+  while (time_us > 0 && bucket < kLockHistogramBuckets - 1) {
+    time_us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+bool MoreContended(const LockStatistics& a, const LockStatistics& b) {
+  if (a.contended_acquisitions + a.contended_shared_acquisitions !=
+      b.contended_acquisitions + b.contended_shared_acquisitions) {
+    return a.contended_acquisitions + a.contended_shared_acquisitions >
+        b.contended_acquisitions + b.contended_shared_acquisitions;
+  }
+  return a.total_wait_time_us > b.total_wait_time_us;
+}
+
+}  // namespace
+
+LockStatistics::LockStatistics()
+    : acquisitions(0),
+      contended_acquisitions(0),
+      shared_acquisitions(0),
+      contended_shared_acquisitions(0),
+      total_wait_time_us(0),
+      total_hold_time_us(0),
+      max_wait_time_us(0),
+      max_hold_time_us(0),
+      holder_thread_id(0) {
+  name[0] = '\0';
+  memset(wait_time_histogram, 0, sizeof(wait_time_histogram));
+  memset(hold_time_histogram, 0, sizeof(hold_time_histogram));
+}
+
+LockProfile* LockProfile::Create(const char* name, const void* creator) {
+  if (!g_enabled) {
+    return NULL;
+  }
+  LockProfile* profile = new LockProfile();
+  if (name) {
+    strncpy(profile->statistics_.name, name,
+            sizeof(profile->statistics_.name) - 1);
+  } else {
+    sprintf(profile->statistics_.name, "lock created at %p", creator);
+  }
+  CriticalSectionScoped cs(g_profiles_crit);
+  g_profiles->push_back(profile);
+  return profile;
+}
+
+LockProfile::LockProfile()
+    : depth_(0),
+      hold_start_us_(0) {
+}
+
+LockProfile::~LockProfile() {
+  CriticalSectionScoped cs(g_profiles_crit);
+  std::vector<LockProfile*>::iterator it =
+      std::find(g_profiles->begin(), g_profiles->end(), this);
+  if (it != g_profiles->end()) {
+    g_profiles->erase(it);
+  }
+}
+
+void LockProfile::Acquired(int64_t wait_start_us) {
+  ++statistics_.acquisitions;
+  if (wait_start_us >= 0) {
+    const int64_t now_us = Now();
+    const int64_t wait_time_us = now_us - wait_start_us;
+    ++statistics_.contended_acquisitions;
+    statistics_.total_wait_time_us += wait_time_us;
+    statistics_.max_wait_time_us = std::max(
+        statistics_.max_wait_time_us, static_cast<uint32_t>(wait_time_us));
+    ++statistics_.wait_time_histogram[HistogramBucket(wait_time_us)];
+    if (depth_++ == 0) {
+      hold_start_us_ = now_us;
+      statistics_.holder_thread_id = ThreadWrapper::GetThreadId();
+    }
+    return;
+  }
+  ++statistics_.wait_time_histogram[0];
+  if (depth_++ == 0) {
+    hold_start_us_ = Now();
+    statistics_.holder_thread_id = ThreadWrapper::GetThreadId();
+  }
+}
+
+void LockProfile::Releasing() {
+  if (--depth_ > 0) {
+    return;
+  }
+  const int64_t hold_time_us = Now() - hold_start_us_;
+  statistics_.total_hold_time_us += hold_time_us;
+  statistics_.max_hold_time_us = std::max(
+      statistics_.max_hold_time_us, static_cast<uint32_t>(hold_time_us));
+  ++statistics_.hold_time_histogram[HistogramBucket(hold_time_us)];
+  statistics_.holder_thread_id = 0;
+}
+
+void LockProfile::AcquiredShared(bool contended) {
+  ++shared_acquisitions_;
+  if (contended) {
+    ++contended_shared_acquisitions_;
+  }
+}
+
+void LockProfile::GetStatistics(LockStatistics* statistics) const {
+  *statistics = statistics_;
+  statistics->shared_acquisitions = shared_acquisitions_.Value();
+  statistics->contended_shared_acquisitions =
+      contended_shared_acquisitions_.Value();
+}
+
+void LockProfiler::Enable(bool enable) {
+  if (enable && !g_profiles_crit) {
+    g_profiles_crit = CriticalSectionWrapper::CreateCriticalSection();
+    g_profiles = new std::vector<LockProfile*>();
+  }
+  g_enabled = enable;
+}
+
+bool LockProfiler::Enabled() {
+  return g_enabled;
+}
+
+void LockProfiler::GetStatistics(std::vector<LockStatistics>* statistics) {
+  statistics->clear();
+  if (!g_profiles_crit) {
+    return;
+  }
+  {
+    CriticalSectionScoped cs(g_profiles_crit);
+    statistics->resize(g_profiles->size());
+    for (size_t i = 0; i < g_profiles->size(); ++i) {
+      (*g_profiles)[i]->GetStatistics(&(*statistics)[i]);
+    }
+  }
+  std::sort(statistics->begin(), statistics->end(), MoreContended);
+}
+
+void LockProfiler::TraceReport() {
+  std::vector<LockStatistics> statistics;
+  GetStatistics(&statistics);
+  for (size_t i = 0; i < statistics.size(); ++i) {
+    const LockStatistics& lock = statistics[i];
+    if (lock.contended_acquisitions == 0 &&
+        lock.contended_shared_acquisitions == 0) {
+      break;
+    }
+    WEBRTC_TRACE(kTraceStateInfo, kTraceUtility, -1,
+                 "Lock %s: %u acquisitions, %u contended, %u shared, %u "
+                 "contended shared, wait %lld us (max %u us), hold %lld us "
+                 "(max %u us), holder %u",
+                 lock.name, lock.acquisitions, lock.contended_acquisitions,
+                 lock.shared_acquisitions, lock.contended_shared_acquisitions,
+                 static_cast<long long>(lock.total_wait_time_us),
+                 lock.max_wait_time_us,
+                 static_cast<long long>(lock.total_hold_time_us),
+                 lock.max_hold_time_us, lock.holder_thread_id);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/lock_profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/rw_lock_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/source/lock_profile.h"
+
+namespace webrtc {
+
+namespace {
+
+bool FindStatistics(const char* name, LockStatistics* statistics) {
+  std::vector<LockStatistics> all_statistics;
+  LockProfiler::GetStatistics(&all_statistics);
+  for (size_t i = 0; i < all_statistics.size(); ++i) {
+    if (strcmp(all_statistics[i].name, name) == 0) {
+      *statistics = all_statistics[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+struct EnterAndLeaveParams {
+  CriticalSectionWrapper* crit_sect;
+  EventWrapper* entering;
+};
+
+bool EnterAndLeave(void* obj) {
+  EnterAndLeaveParams* params = static_cast<EnterAndLeaveParams*>(obj);
+  params->entering->Set();
+  params->crit_sect->Enter();
+  params->crit_sect->Leave();
+  return false;
+}
+
+}  // namespace
+
+class LockProfilerTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    LockProfiler::Enable(true);
+  }
+  virtual void TearDown() {
+    LockProfiler::Enable(false);
+  }
+};
+
+TEST_F(LockProfilerTest, OnlyLocksCreatedWhileEnabledAreProfiled) {
+  LockProfiler::Enable(false);
+  scoped_ptr<CriticalSectionWrapper> unprofiled(
+      CriticalSectionWrapper::CreateCriticalSection("unprofiled"));
+  LockStatistics statistics;
+  EXPECT_FALSE(FindStatistics("unprofiled", &statistics));
+
+  LockProfiler::Enable(true);
+  {
+    scoped_ptr<CriticalSectionWrapper> profiled(
+        CriticalSectionWrapper::CreateCriticalSection("profiled"));
+    EXPECT_TRUE(FindStatistics("profiled", &statistics));
+  }
+  // Deleted locks are removed.
+  EXPECT_FALSE(FindStatistics("profiled", &statistics));
+}
+
+TEST_F(LockProfilerTest, CountsRecursiveAcquisitions) {
+  scoped_ptr<CriticalSectionWrapper> crit_sect(
+      CriticalSectionWrapper::CreateCriticalSection("recursive"));
+  LockStatistics statistics;
+  crit_sect->Enter();
+  crit_sect->Enter();
+  ASSERT_TRUE(FindStatistics("recursive", &statistics));
+  EXPECT_EQ(2u, statistics.acquisitions);
+  EXPECT_EQ(ThreadWrapper::GetThreadId(), statistics.holder_thread_id);
+  crit_sect->Leave();
+  crit_sect->Leave();
+
+  ASSERT_TRUE(FindStatistics("recursive", &statistics));
+  EXPECT_EQ(2u, statistics.acquisitions);
+  EXPECT_EQ(0u, statistics.contended_acquisitions);
+  EXPECT_EQ(2u, statistics.wait_time_histogram[0]);
+  EXPECT_EQ(0u, statistics.holder_thread_id);
+  unsigned int holds = 0;
+  for (int i = 0; i < kLockHistogramBuckets; ++i) {
+    holds += statistics.hold_time_histogram[i];
+  }
+  EXPECT_EQ(1u, holds);
+}
+
+TEST_F(LockProfilerTest, MeasuresContention) {
+  // Acquires the profile the way a lock does after waiting 5 ms, so that the
+  // result doesn't depend on thread scheduling.
+  scoped_ptr<LockProfile> profile(LockProfile::Create("contended", NULL));
+  ASSERT_TRUE(profile.get() != NULL);
+  profile->Acquired(LockProfile::Now() - 5000);
+  profile->Releasing();
+  profile->Acquired(-1);
+  profile->Releasing();
+
+  LockStatistics statistics;
+  ASSERT_TRUE(FindStatistics("contended", &statistics));
+  EXPECT_EQ(2u, statistics.acquisitions);
+  EXPECT_EQ(1u, statistics.contended_acquisitions);
+  EXPECT_GE(statistics.max_wait_time_us, 5000u);
+  EXPECT_EQ(statistics.max_wait_time_us, statistics.total_wait_time_us);
+  EXPECT_EQ(1u, statistics.wait_time_histogram[0]);
+  EXPECT_EQ(0u, statistics.holder_thread_id);
+}
+
+TEST_F(LockProfilerTest, CountsEnterFromAnotherThread) {
+  scoped_ptr<CriticalSectionWrapper> crit_sect(
+      CriticalSectionWrapper::CreateCriticalSection("two threads"));
+  scoped_ptr<EventWrapper> entering(EventWrapper::Create());
+  EnterAndLeaveParams params = { crit_sect.get(), entering.get() };
+  crit_sect->Enter();
+  scoped_ptr<ThreadWrapper> thread(ThreadWrapper::CreateThread(
+      EnterAndLeave, &params, kNormalPriority, "LockProfilerTest"));
+  unsigned int id = 0;
+  ASSERT_TRUE(thread->Start(id));
+  ASSERT_EQ(kEventSignaled, entering->Wait(WEBRTC_EVENT_INFINITE));
+  crit_sect->Leave();
+  EXPECT_TRUE(thread->Stop());
+
+  // Whether the thread had to wait depends on scheduling.
+  LockStatistics statistics;
+  ASSERT_TRUE(FindStatistics("two threads", &statistics));
+  EXPECT_EQ(2u, statistics.acquisitions);
+  EXPECT_LE(statistics.contended_acquisitions, 1u);
+  EXPECT_EQ(0u, statistics.holder_thread_id);
+}
+
+TEST_F(LockProfilerTest, ConditionVariableReleasesTheLock) {
+  scoped_ptr<CriticalSectionWrapper> crit_sect(
+      CriticalSectionWrapper::CreateCriticalSection("condition"));
+  scoped_ptr<ConditionVariableWrapper> condition(
+      ConditionVariableWrapper::CreateConditionVariable());
+  CriticalSectionScoped cs(crit_sect.get());
+  condition->SleepCS(*crit_sect, 1);
+  LockStatistics statistics;
+  ASSERT_TRUE(FindStatistics("condition", &statistics));
+  EXPECT_EQ(ThreadWrapper::GetThreadId(), statistics.holder_thread_id);
+  EXPECT_EQ(2u, statistics.acquisitions);
+}
+
+TEST_F(LockProfilerTest, CountsSharedAcquisitions) {
+  scoped_ptr<RWLockWrapper> lock(RWLockWrapper::CreateRWLock("rw"));
+  {
+    ReadLockScoped read1(*lock);
+    ReadLockScoped read2(*lock);
+  }
+  {
+    WriteLockScoped write(*lock);
+  }
+  LockStatistics statistics;
+  ASSERT_TRUE(FindStatistics("rw", &statistics));
+  EXPECT_EQ(2u, statistics.shared_acquisitions);
+  EXPECT_EQ(0u, statistics.contended_shared_acquisitions);
+  EXPECT_EQ(1u, statistics.acquisitions);
+}
+
+TEST_F(LockProfilerTest, UnnamedLocksAreIdentifiedByCreator) {
+  scoped_ptr<CriticalSectionWrapper> crit_sect(
+      CriticalSectionWrapper::CreateCriticalSection());
+  std::vector<LockStatistics> statistics;
+  LockProfiler::GetStatistics(&statistics);
+  bool found = false;
+  for (size_t i = 0; i < statistics.size(); ++i) {
+    found |= strncmp(statistics[i].name, "lock created at ", 16) == 0;
+  }
+  EXPECT_TRUE(found);
+  LockProfiler::TraceReport();
+}
+
+// Prints the cost of an uncontended Enter() and Leave() pair.
+TEST_F(LockProfilerTest, OverheadBenchmark) {
+  const int kIterations = 1000000;
+  for (int profiled = 0; profiled < 2; ++profiled) {
+    LockProfiler::Enable(profiled != 0);
+    scoped_ptr<CriticalSectionWrapper> crit_sect(
+        CriticalSectionWrapper::CreateCriticalSection("benchmark"));
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < kIterations; ++i) {
+      crit_sect->Enter();
+      crit_sect->Leave();
+    }
+    const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+    printf("%s: %.1f ns per Enter and Leave\n",
+           profiled ? "Profiled" : "Not profiled",
+           1000.0 * elapsed_us / kIterations);
+  }
+}
+
+}  // namespace webrtc
@@ -10,10 +10,26 @@
 
 #include "webrtc/system_wrappers/interface/map_wrapper.h"
 
+#include <string.h>
+
 #include "webrtc/system_wrappers/interface/trace.h"
+#include "webrtc/system_wrappers/source/node_pool.h"
 
 namespace webrtc {
 
+namespace {
+
+const int kMaxFreeMapItems = 4096;
+
+NodePool* MapItemPool() {
+  // Created on first use and never deleted, since maps may be used during
+  // static destruction.
+  static NodePool* pool = new NodePool(sizeof(MapItem), kMaxFreeMapItems);
+  return pool;
+}
+
+}  // namespace
+
 MapItem::MapItem(int id, void* item)
     : item_id_(id),
       item_pointer_(item) {
@@ -38,57 +54,75 @@ void MapItem::SetItem(void* ptr) {
   item_pointer_ = ptr;
 }
 
-MapWrapper::MapWrapper() : map_() {
+void* MapItem::operator new(size_t size) {
+  return MapItemPool()->Allocate(size);
+}
+
+void MapItem::operator delete(void* ptr, size_t size) {
+  MapItemPool()->Free(ptr, size);
+}
+
+MapWrapper::MapWrapper()
+    : items_(inline_items_),
+      size_(0),
+      capacity_(kInlineCapacity) {
 }
 
 MapWrapper::~MapWrapper() {
-  if (!map_.empty()) {
+  if (size_ > 0) {
     WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1,
                  "Potential memory leak in MapWrapper");
-    // Remove all map items. Please note that std::map::clear() can't be
-    // used because each item has some dynamically allocated memory
-    // associated with it (i.e. using std::map::clear would introduce a
-    // memory leak).
+    // Remove all map items. Please note that the items only point to memory
+    // owned by the user, which may leak.
     while (Erase(First()) == 0)
     {}
   }
+  if (items_ != inline_items_) {
+    delete [] items_;
+  }
 }
 
 int MapWrapper::Size() const {
-  return (int)map_.size();
+  return size_;
 }
 
 int MapWrapper::Insert(int id, void* ptr) {
-  map_[id] = new MapItem(id, ptr);
+  const int position = LowerBound(id);
+  if (position < size_ && items_[position]->item_id_ == id) {
+    items_[position]->item_pointer_ = ptr;
+    return 0;
+  }
+  if (size_ == capacity_) {
+    MapItem** items = new MapItem*[2 * capacity_];
+    memcpy(items, items_, size_ * sizeof(MapItem*));
+    if (items_ != inline_items_) {
+      delete [] items_;
+    }
+    items_ = items;
+    capacity_ *= 2;
+  }
+  memmove(&items_[position + 1], &items_[position],
+          (size_ - position) * sizeof(MapItem*));
+  items_[position] = new MapItem(id, ptr);
+  ++size_;
   return 0;
 }
 
 MapItem* MapWrapper::First() const {
-  std::map<int, MapItem*>::const_iterator it = map_.begin();
-  if (it != map_.end()) {
-    return it->second;
-  }
-  return 0;
+  return size_ > 0 ? items_[0] : 0;
 }
 
 MapItem* MapWrapper::Last() const {
-  std::map<int, MapItem*>::const_reverse_iterator it = map_.rbegin();
-  if (it != map_.rend()) {
-    return it->second;
-  }
-  return 0;
+  return size_ > 0 ? items_[size_ - 1] : 0;
 }
 
 MapItem* MapWrapper::Next(MapItem* item) const {
   if (item == 0) {
     return 0;
   }
-  std::map<int, MapItem*>::const_iterator it = map_.find(item->item_id_);
-  if (it != map_.end()) {
-    it++;
-    if (it != map_.end()) {
-      return it->second;
-    }
+  const int position = Position(item->item_id_);
+  if (position >= 0 && position + 1 < size_) {
+    return items_[position + 1];
   }
   return 0;
 }
@@ -97,20 +131,17 @@ MapItem* MapWrapper::Previous(MapItem* item) const {
   if (item == 0) {
     return 0;
   }
-
-  std::map<int, MapItem*>::const_iterator it = map_.find(item->item_id_);
-  if ((it != map_.end()) &&
-      (it != map_.begin())) {
-    --it;
-    return it->second;
+  const int position = Position(item->item_id_);
+  if (position > 0) {
+    return items_[position - 1];
   }
   return 0;
 }
 
 MapItem* MapWrapper::Find(int id) const {
-  std::map<int, MapItem*>::const_iterator it = map_.find(id);
-  if (it != map_.end()) {
-    return it->second;
+  const int position = Position(id);
+  if (position >= 0) {
+    return items_[position];
   }
   return 0;
 }
@@ -119,23 +150,46 @@ int MapWrapper::Erase(MapItem* item) {
   if (item == 0) {
     return -1;
   }
-  std::map<int, MapItem*>::iterator it = map_.find(item->item_id_);
-  if (it != map_.end()) {
-    delete it->second;
-    map_.erase(it);
-    return 0;
-  }
-  return -1;
+  return Erase(item->item_id_);
 }
 
 int MapWrapper::Erase(const int id) {
-  std::map<int, MapItem*>::iterator it = map_.find(id);
-  if (it != map_.end()) {
-    delete it->second;
-    map_.erase(it);
-    return 0;
+  const int position = Position(id);
+  if (position < 0) {
+    return -1;
+  }
+  EraseAt(position);
+  return 0;
+}
+
+int MapWrapper::LowerBound(int id) const {
+  int first = 0;
+  int count = size_;
+  while (count > 0) {
+    const int step = count / 2;
+    if (items_[first + step]->item_id_ < id) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+int MapWrapper::Position(int id) const {
+  const int position = LowerBound(id);
+  if (position < size_ && items_[position]->item_id_ == id) {
+    return position;
   }
   return -1;
 }
 
-} // namespace webrtc
+void MapWrapper::EraseAt(int position) {
+  delete items_[position];
+  memmove(&items_[position], &items_[position + 1],
+          (size_ - position - 1) * sizeof(MapItem*));
+  --size_;
+}
+
+}  // namespace webrtc
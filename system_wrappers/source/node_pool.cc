@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/source/node_pool.h"
+
+#include <assert.h>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+NodePool::NodePool(size_t node_size, int max_free_nodes)
+    : node_size_(node_size),
+      max_free_nodes_(max_free_nodes),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      free_nodes_(NULL),
+      num_free_nodes_(0),
+      heap_allocations_(0) {
+  assert(node_size_ >= sizeof(FreeNode));
+}
+
+NodePool::~NodePool() {
+  while (free_nodes_) {
+    FreeNode* node = free_nodes_;
+    free_nodes_ = node->next;
+    ::operator delete(node);
+  }
+  delete crit_sect_;
+}
+
+void* NodePool::Allocate(size_t size) {
+  if (size == node_size_) {
+    CriticalSectionScoped lock(crit_sect_);
+    if (free_nodes_) {
+      FreeNode* node = free_nodes_;
+      free_nodes_ = node->next;
+      --num_free_nodes_;
+      return node;
+    }
+    ++heap_allocations_;
+    return ::operator new(node_size_);
+  }
+  return ::operator new(size);
+}
+
+void NodePool::Free(void* node, size_t size) {
+  if (!node) {
+    return;
+  }
+  if (size == node_size_) {
+    CriticalSectionScoped lock(crit_sect_);
+    if (num_free_nodes_ < max_free_nodes_) {
+      FreeNode* free_node = static_cast<FreeNode*>(node);
+      free_node->next = free_nodes_;
+      free_nodes_ = free_node;
+      ++num_free_nodes_;
+      return;
+    }
+  }
+  ::operator delete(node);
+}
+
+int NodePool::HeapAllocations() const {
+  CriticalSectionScoped lock(crit_sect_);
+  return heap_allocations_;
+}
+
+}  // namespace webrtc
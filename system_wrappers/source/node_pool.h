@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_NODE_POOL_H_
+#define WEBRTC_SYSTEM_WRAPPERS_SOURCE_NODE_POOL_H_
+
+#include <stddef.h>
+
+#include "webrtc/system_wrappers/interface/constructor_magic.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+
+// A thread-safe free list of fixed size nodes, used for the items of the list
+// and map wrappers. Freed nodes are kept for reuse, up to |max_free_nodes|,
+// so a steady state of inserts and erases doesn't touch the heap.
+class NodePool {
+ public:
+  NodePool(size_t node_size, int max_free_nodes);
+  ~NodePool();
+
+  // Returns a node of |size| bytes. Other sizes than the node size, e.g. of
+  // derived items, are passed on to the heap.
+  void* Allocate(size_t size);
+  void Free(void* node, size_t size);
+
+  // Returns the number of nodes allocated from the heap.
+  int HeapAllocations() const;
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  const size_t node_size_;
+  const int max_free_nodes_;
+  CriticalSectionWrapper* crit_sect_;
+  FreeNode* free_nodes_;
+  int num_free_nodes_;
+  int heap_allocations_;
+
+  DISALLOW_COPY_AND_ASSIGN(NodePool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_SOURCE_NODE_POOL_H_
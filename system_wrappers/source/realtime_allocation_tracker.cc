@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/realtime_allocation_tracker.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(WEBRTC_ANDROID)
+#include <execinfo.h>
+#endif
+
+#include <algorithm>
+#include <new>
+
+#include "webrtc/system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kMaxAllocationSites = 256;
+
+// The state of a real-time thread.
+struct RealtimeThreadState {
+  char name[32];
+  // Set while an allocation is recorded, to ignore allocations made by the
+  // tracker itself.
+  bool recording;
+};
+
+pthread_key_t g_thread_key;
+pthread_once_t g_thread_key_once = PTHREAD_ONCE_INIT;
+
+// The allocation sites are kept in a static table, since recording an
+// allocation must not allocate.
+pthread_mutex_t g_sites_mutex = PTHREAD_MUTEX_INITIALIZER;
+RealtimeAllocationSite g_sites[kMaxAllocationSites];
+int g_num_sites = 0;
+int g_allocations = 0;
+
+void CreateThreadKey() {
+  pthread_key_create(&g_thread_key, NULL);
+}
+
+RealtimeThreadState* CurrentThreadState() {
+  pthread_once(&g_thread_key_once, CreateThreadKey);
+  return static_cast<RealtimeThreadState*>(pthread_getspecific(g_thread_key));
+}
+
+bool MoreAllocations(const RealtimeAllocationSite& a,
+                     const RealtimeAllocationSite& b) {
+  return a.allocations > b.allocations;
+}
+
+__attribute__((noinline)) void RecordAllocation(size_t size) {
+  RealtimeThreadState* state = CurrentThreadState();
+  if (!state || state->recording) {
+    return;
+  }
+  state->recording = true;
+
+  // Skips this function and the operator new.
+  const int kSkippedFrames = 2;
+  void* stack[kRealtimeAllocationStackDepth + kSkippedFrames];
+  int depth = 0;
+#if !defined(WEBRTC_ANDROID)
+  depth = backtrace(stack, kRealtimeAllocationStackDepth + kSkippedFrames);
+#endif
+  depth = std::max(depth - kSkippedFrames, 0);
+  void** caller_stack = stack + kSkippedFrames;
+
+  pthread_mutex_lock(&g_sites_mutex);
+  ++g_allocations;
+  RealtimeAllocationSite* site = NULL;
+  for (int i = 0; i < g_num_sites; ++i) {
+    if (g_sites[i].stack_depth == depth &&
+        memcmp(g_sites[i].stack, caller_stack, depth * sizeof(void*)) == 0) {
+      site = &g_sites[i];
+      break;
+    }
+  }
+  if (!site && g_num_sites < kMaxAllocationSites) {
+    site = &g_sites[g_num_sites++];
+    memset(site, 0, sizeof(*site));
+    memcpy(site->thread_name, state->name, sizeof(site->thread_name));
+    site->stack_depth = depth;
+    memcpy(site->stack, caller_stack, depth * sizeof(void*));
+  }
+  if (site) {
+    ++site->allocations;
+    site->bytes += size;
+  }
+  pthread_mutex_unlock(&g_sites_mutex);
+
+  state->recording = false;
+}
+
+}  // namespace
+
+bool RealtimeAllocationTracker::Enabled() {
+  return true;
+}
+
+void RealtimeAllocationTracker::SetCurrentThreadRealtime(const char* name) {
+  RealtimeThreadState* state = CurrentThreadState();
+  if (!state) {
+    // Not recorded, since the thread isn't tagged yet.
+    state = new RealtimeThreadState();
+    state->recording = false;
+  }
+  memset(state->name, 0, sizeof(state->name));
+  if (name) {
+    strncpy(state->name, name, sizeof(state->name) - 1);
+  }
+  pthread_setspecific(g_thread_key, state);
+}
+
+void RealtimeAllocationTracker::ClearCurrentThreadRealtime() {
+  RealtimeThreadState* state = CurrentThreadState();
+  pthread_setspecific(g_thread_key, NULL);
+  delete state;
+}
+
+bool RealtimeAllocationTracker::IsCurrentThreadRealtime() {
+  return CurrentThreadState() != NULL;
+}
+
+int RealtimeAllocationTracker::Allocations() {
+  pthread_mutex_lock(&g_sites_mutex);
+  const int allocations = g_allocations;
+  pthread_mutex_unlock(&g_sites_mutex);
+  return allocations;
+}
+
+void RealtimeAllocationTracker::GetAllocationSites(
+    std::vector<RealtimeAllocationSite>* sites) {
+  pthread_mutex_lock(&g_sites_mutex);
+  sites->assign(g_sites, g_sites + g_num_sites);
+  pthread_mutex_unlock(&g_sites_mutex);
+  std::sort(sites->begin(), sites->end(), MoreAllocations);
+}
+
+void RealtimeAllocationTracker::TraceReport() {
+  std::vector<RealtimeAllocationSite> sites;
+  GetAllocationSites(&sites);
+  WEBRTC_TRACE(kTraceStateInfo, kTraceUtility, -1,
+               "%d allocations on real-time threads from %u call stacks",
+               Allocations(), static_cast<unsigned int>(sites.size()));
+  for (size_t i = 0; i < sites.size(); ++i) {
+    const RealtimeAllocationSite& site = sites[i];
+    WEBRTC_TRACE(kTraceStateInfo, kTraceUtility, -1,
+                 "%d allocations, %u bytes on thread %s:", site.allocations,
+                 static_cast<unsigned int>(site.bytes), site.thread_name);
+#if !defined(WEBRTC_ANDROID)
+    char** symbols = backtrace_symbols(site.stack, site.stack_depth);
+    for (int frame = 0; symbols && frame < site.stack_depth; ++frame) {
+      WEBRTC_TRACE(kTraceStateInfo, kTraceUtility, -1, "  %s",
+                   symbols[frame]);
+    }
+    free(symbols);
+#endif
+  }
+}
+
+void RealtimeAllocationTracker::Reset() {
+  pthread_mutex_lock(&g_sites_mutex);
+  g_num_sites = 0;
+  g_allocations = 0;
+  pthread_mutex_unlock(&g_sites_mutex);
+}
+
+}  // namespace webrtc
+
+#if __cplusplus >= 201103L
+#define THROW_BAD_ALLOC
+#define THROW_NOTHING noexcept
+#else
+#define THROW_BAD_ALLOC throw(std::bad_alloc)
+#define THROW_NOTHING throw()
+#endif
+
+void* operator new(size_t size) THROW_BAD_ALLOC {
+  webrtc::RecordAllocation(size);
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) THROW_BAD_ALLOC {
+  webrtc::RecordAllocation(size);
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) THROW_NOTHING {
+  free(ptr);
+}
+
+void operator delete[](void* ptr) THROW_NOTHING {
+  free(ptr);
+}
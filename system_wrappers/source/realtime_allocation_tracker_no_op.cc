@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/realtime_allocation_tracker.h"
+
+namespace webrtc {
+
+bool RealtimeAllocationTracker::Enabled() {
+  return false;
+}
+
+void RealtimeAllocationTracker::SetCurrentThreadRealtime(const char* name) {
+}
+
+void RealtimeAllocationTracker::ClearCurrentThreadRealtime() {
+}
+
+bool RealtimeAllocationTracker::IsCurrentThreadRealtime() {
+  return false;
+}
+
+int RealtimeAllocationTracker::Allocations() {
+  return 0;
+}
+
+void RealtimeAllocationTracker::GetAllocationSites(
+    std::vector<RealtimeAllocationSite>* sites) {
+  sites->clear();
+}
+
+void RealtimeAllocationTracker::TraceReport() {
+}
+
+void RealtimeAllocationTracker::Reset() {
+}
+
+}  // namespace webrtc
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/realtime_allocation_tracker.h"
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+// Prevents the compiler from removing the allocations.
+int* volatile g_allocated = NULL;
+
+// Keeps running until stopped, since a thread that ends by itself before
+// Start() returns can't be stopped.
+bool AllocateAndSleep(void* obj) {
+  *static_cast<bool*>(obj) =
+      RealtimeAllocationTracker::IsCurrentThreadRealtime();
+  g_allocated = new int(1);
+  delete g_allocated;
+  SleepMs(1);
+  return true;
+}
+
+}  // namespace
+
+class RealtimeAllocationTrackerTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    RealtimeAllocationTracker::Reset();
+  }
+  virtual void TearDown() {
+    RealtimeAllocationTracker::ClearCurrentThreadRealtime();
+  }
+};
+
+TEST_F(RealtimeAllocationTrackerTest, CountsAllocationsOnTaggedThread) {
+  g_allocated = new int(0);
+  delete g_allocated;
+  EXPECT_EQ(0, RealtimeAllocationTracker::Allocations());
+
+  RealtimeAllocationTracker::SetCurrentThreadRealtime("TestThread");
+  EXPECT_EQ(RealtimeAllocationTracker::Enabled(),
+            RealtimeAllocationTracker::IsCurrentThreadRealtime());
+  for (int i = 0; i < 3; ++i) {
+    g_allocated = new int(i);
+    delete g_allocated;
+  }
+  RealtimeAllocationTracker::ClearCurrentThreadRealtime();
+  g_allocated = new int(0);
+  delete g_allocated;
+
+  std::vector<RealtimeAllocationSite> sites;
+  RealtimeAllocationTracker::GetAllocationSites(&sites);
+  if (!RealtimeAllocationTracker::Enabled()) {
+    EXPECT_EQ(0, RealtimeAllocationTracker::Allocations());
+    EXPECT_TRUE(sites.empty());
+    return;
+  }
+  EXPECT_EQ(3, RealtimeAllocationTracker::Allocations());
+  ASSERT_EQ(1u, sites.size());
+  EXPECT_EQ(3, sites[0].allocations);
+  EXPECT_EQ(3 * sizeof(int), sites[0].bytes);
+  EXPECT_STREQ("TestThread", sites[0].thread_name);
+  EXPECT_GT(sites[0].stack_depth, 0);
+  RealtimeAllocationTracker::TraceReport();
+}
+
+TEST_F(RealtimeAllocationTrackerTest, TagsRealtimeThreads) {
+  bool realtime = false;
+  scoped_ptr<ThreadWrapper> thread(ThreadWrapper::CreateThread(
+      AllocateAndSleep, &realtime, kRealtimePriority, "RealtimeThread"));
+  unsigned int id = 0;
+  ASSERT_TRUE(thread->Start(id));
+  EXPECT_TRUE(thread->Stop());
+  EXPECT_EQ(RealtimeAllocationTracker::Enabled(), realtime);
+  if (RealtimeAllocationTracker::Enabled()) {
+    EXPECT_GE(RealtimeAllocationTracker::Allocations(), 1);
+  }
+}
+
+}  // namespace webrtc
@@ -16,6 +16,7 @@
 #include "webrtc/system_wrappers/source/rw_lock_generic.h"
 #include "webrtc/system_wrappers/source/rw_lock_win.h"
 #else
+#include "webrtc/system_wrappers/source/lock_profile.h"
 #include "webrtc/system_wrappers/source/rw_lock_posix.h"
 #endif
 
@@ -23,14 +24,23 @@ namespace webrtc {
 
 RWLockWrapper* RWLockWrapper::CreateRWLock() {
 #ifdef _WIN32
-  // Native implementation is faster, so use that if available.
+  return CreateRWLock(NULL);
+#else
+  return RWLockPosix::Create(LockProfile::Create(NULL, WEBRTC_LOCK_CREATOR));
+#endif
+}
+
+RWLockWrapper* RWLockWrapper::CreateRWLock(const char* name) {
+#ifdef _WIN32
+  // Native implementation is faster, so use that if available. The Windows
+  // locks are not profiled.
   RWLockWrapper* lock = RWLockWin::Create();
   if (lock) {
     return lock;
   }
   return new RWLockGeneric();
 #else
-  return RWLockPosix::Create();
+  return RWLockPosix::Create(LockProfile::Create(name, WEBRTC_LOCK_CREATOR));
 #endif
 }
 
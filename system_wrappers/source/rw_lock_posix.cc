@@ -10,17 +10,22 @@
 
 #include "webrtc/system_wrappers/source/rw_lock_posix.h"
 
+#include "webrtc/system_wrappers/source/lock_profile.h"
+
 namespace webrtc {
 
-RWLockPosix::RWLockPosix() : lock_() {
+RWLockPosix::RWLockPosix(LockProfile* profile)
+    : lock_(),
+      profile_(profile) {
 }
 
 RWLockPosix::~RWLockPosix() {
   pthread_rwlock_destroy(&lock_);
+  delete profile_;
 }
 
-RWLockPosix* RWLockPosix::Create() {
-  RWLockPosix* ret_val = new RWLockPosix();
+RWLockPosix* RWLockPosix::Create(LockProfile* profile) {
+  RWLockPosix* ret_val = new RWLockPosix(profile);
   if (!ret_val->Init()) {
     delete ret_val;
     return NULL;
@@ -33,15 +38,36 @@ bool RWLockPosix::Init() {
 }
 
 void RWLockPosix::AcquireLockExclusive() {
+  if (!profile_) {
+    pthread_rwlock_wrlock(&lock_);
+    return;
+  }
+  if (pthread_rwlock_trywrlock(&lock_) == 0) {
+    profile_->Acquired(-1);
+    return;
+  }
+  const int64_t wait_start_us = LockProfile::Now();
   pthread_rwlock_wrlock(&lock_);
+  profile_->Acquired(wait_start_us);
 }
 
 void RWLockPosix::ReleaseLockExclusive() {
+  if (profile_) {
+    profile_->Releasing();
+  }
   pthread_rwlock_unlock(&lock_);
 }
 
 void RWLockPosix::AcquireLockShared() {
-  pthread_rwlock_rdlock(&lock_);
+  if (!profile_) {
+    pthread_rwlock_rdlock(&lock_);
+    return;
+  }
+  const bool contended = pthread_rwlock_tryrdlock(&lock_) != 0;
+  if (contended) {
+    pthread_rwlock_rdlock(&lock_);
+  }
+  profile_->AcquiredShared(contended);
 }
 
 void RWLockPosix::ReleaseLockShared() {
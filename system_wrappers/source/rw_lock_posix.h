@@ -17,9 +17,13 @@
 
 namespace webrtc {
 
+class LockProfile;
+
 class RWLockPosix : public RWLockWrapper {
  public:
-  static RWLockPosix* Create();
+  // Takes ownership of |profile|, which is NULL unless the LockProfiler is
+  // enabled.
+  static RWLockPosix* Create(LockProfile* profile);
   virtual ~RWLockPosix();
 
   virtual void AcquireLockExclusive();
@@ -29,10 +33,11 @@ class RWLockPosix : public RWLockWrapper {
   virtual void ReleaseLockShared();
 
  private:
-  RWLockPosix();
+  explicit RWLockPosix(LockProfile* profile);
   bool Init();
 
   pthread_rwlock_t lock_;
+  LockProfile* profile_;
 };
 
 }  // namespace webrtc
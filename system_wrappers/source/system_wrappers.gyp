@@ -23,6 +23,7 @@
       },
       'sources': [
         '../interface/aligned_malloc.h',
+        '../interface/allocation_arena.h',
         '../interface/atomic32.h',
         '../interface/clock.h',
         '../interface/compile_assert.h',
@@ -38,8 +39,10 @@
         '../interface/file_wrapper.h',
         '../interface/fix_interlocked_exchange_pointer_win.h',
         '../interface/list_wrapper.h',
+        '../interface/lock_profiler.h',
         '../interface/logging.h',
         '../interface/map_wrapper.h',
+        '../interface/realtime_allocation_tracker.h',
         '../interface/ref_count.h',
         '../interface/rw_lock_wrapper.h',
         '../interface/scoped_ptr.h',
@@ -53,6 +56,7 @@
         '../interface/trace.h',
         '../interface/trace_event.h',
         'aligned_malloc.cc',
+        'allocation_arena.cc',
         'atomic32_mac.cc',
         'atomic32_posix.cc',
         'atomic32_win.cc',
@@ -72,6 +76,8 @@
         'critical_section_win.cc',
         'critical_section_win.h',
         'data_log.cc',
+        'data_log_binary.cc',
+        'data_log_binary.h',
         'data_log_c.cc',
         'data_log_no_op.cc',
         'event.cc',
@@ -83,9 +89,15 @@
         'file_impl.cc',
         'file_impl.h',
         'list_no_stl.cc',
+        'lock_profile.h',
+        'lock_profiler.cc',
         'logging.cc',
         'logging_no_op.cc',
         'map.cc',
+        'node_pool.cc',
+        'node_pool.h',
+        'realtime_allocation_tracker.cc',
+        'realtime_allocation_tracker_no_op.cc',
         'rw_lock.cc',
         'rw_lock_generic.cc',
         'rw_lock_generic.h',
@@ -116,6 +128,11 @@
         }, {
           'sources!': [ 'data_log.cc', ],
         },],
+        ['enable_realtime_allocation_tracking==1 and OS!="win"', {
+          'sources!': [ 'realtime_allocation_tracker_no_op.cc', ],
+        }, {
+          'sources!': [ 'realtime_allocation_tracker.cc', ],
+        },],
         ['enable_tracing==1', {
           'sources!': [
             'logging_no_op.cc',
@@ -19,12 +19,18 @@
       ],
       'sources': [
         'aligned_malloc_unittest.cc',
+        'allocation_arena_unittest.cc',
+        'clock_unittest.cc',
         'condition_variable_unittest.cc',
+        'container_allocation_unittest.cc',
         'critical_section_unittest.cc',
         'event_tracer_unittest.cc',
         'list_unittest.cc',
+        'lock_profiler_unittest.cc',
         'logging_unittest.cc',
         'map_unittest.cc',
+        'realtime_allocation_tracker_unittest.cc',
+        'data_log_binary_unittest.cc',
         'data_log_unittest.cc',
         'data_log_unittest_disabled.cc',
         'data_log_helpers_unittest.cc',
@@ -44,6 +50,10 @@
         ['os_posix==0', {
           'sources!': [ 'thread_posix_unittest.cc', ],
         }],
+        ['enable_realtime_allocation_tracking==1 and OS!="win"', {
+          # Both replace the global operator new.
+          'sources!': [ 'container_allocation_unittest.cc', ],
+        }],
       ],
       # Disable warnings to enable Win64 build, issue 1323.
       'msvs_disabled_warnings': [
@@ -60,6 +60,7 @@
 
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/realtime_allocation_tracker.h"
 #include "webrtc/system_wrappers/interface/sleep.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
@@ -326,6 +327,11 @@ void ThreadPosix::Run() {
     WEBRTC_TRACE(kTraceStateInfo, kTraceUtility, -1,
                  "Thread without name started");
   }
+  const bool realtime =
+      prio_ == kRealtimePriority || prio_ == kHighestPriority;
+  if (realtime) {
+    RealtimeAllocationTracker::SetCurrentThreadRealtime(name_);
+  }
   bool alive = true;
   bool run = true;
   while (alive) {
@@ -336,6 +342,9 @@ void ThreadPosix::Run() {
     }
     alive = alive_;
   }
+  if (realtime) {
+    RealtimeAllocationTracker::ClearCurrentThreadRealtime();
+  }
 
   if (set_thread_name_) {
     // Don't set the name for the trace thread because it may cause a
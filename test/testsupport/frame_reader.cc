@@ -10,7 +10,18 @@
 
 #include "testsupport/frame_reader.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -78,5 +89,120 @@ bool FrameReaderImpl::ReadFrame(WebRtc_UWord8* source_buffer) {
   return true;
 }
 
+MappedFrameReader::MappedFrameReader(std::string input_filename,
+                                     size_t frame_length_in_bytes)
+    : input_filename_(input_filename),
+      frame_length_in_bytes_(frame_length_in_bytes),
+      number_of_frames_(0),
+      next_frame_(0),
+      data_(NULL),
+      size_(0) {
+}
+
+MappedFrameReader::~MappedFrameReader() {
+  Close();
+}
+
+bool MappedFrameReader::Init() {
+  if (frame_length_in_bytes_ <= 0) {
+    fprintf(stderr, "Frame length must be >0, was %zu\n",
+            frame_length_in_bytes_);
+    return false;
+  }
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(input_filename_.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    fprintf(stderr, "Couldn't open input file for reading: %s\n",
+            input_filename_.c_str());
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    fprintf(stderr, "Found empty file: %s\n", input_filename_.c_str());
+    CloseHandle(file);
+    return false;
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping != NULL) {
+    data_ = static_cast<const WebRtc_UWord8*>(
+        MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    // The view keeps the mapping and the file open.
+    CloseHandle(mapping);
+  }
+  CloseHandle(file);
+#else
+  int fd = open(input_filename_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "Couldn't open input file for reading: %s\n",
+            input_filename_.c_str());
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    fprintf(stderr, "Found empty file: %s\n", input_filename_.c_str());
+    close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+  void* data = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open.
+  close(fd);
+  if (data != MAP_FAILED) {
+    data_ = static_cast<const WebRtc_UWord8*>(data);
+    // The frames are mostly read in order.
+    madvise(data, size_, MADV_SEQUENTIAL);
+  }
+#endif
+  if (data_ == NULL) {
+    fprintf(stderr, "Couldn't map input file: %s\n", input_filename_.c_str());
+    Close();
+    return false;
+  }
+  number_of_frames_ = static_cast<int>(size_ / frame_length_in_bytes_);
+  next_frame_ = 0;
+  return true;
+}
+
+void MappedFrameReader::Close() {
+  if (data_ != NULL) {
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<WebRtc_UWord8*>(data_), size_);
+#endif
+  }
+  data_ = NULL;
+  size_ = 0;
+}
+
+bool MappedFrameReader::ReadFrame(WebRtc_UWord8* source_buffer) {
+  assert(source_buffer);
+  if (data_ == NULL) {
+    fprintf(stderr, "FrameReader is not initialized (input file is NULL)\n");
+    return false;
+  }
+  const WebRtc_UWord8* frame = GetFrame(next_frame_);
+  if (frame == NULL) {
+    // Like FrameReaderImpl, copy what is left of the file.
+    const size_t offset =
+        std::min(next_frame_ * frame_length_in_bytes_, size_);
+    memcpy(source_buffer, data_ + offset, size_ - offset);
+    next_frame_ = number_of_frames_ + 1;
+    return false;  // No more frames to process.
+  }
+  memcpy(source_buffer, frame, frame_length_in_bytes_);
+  ++next_frame_;
+  return true;
+}
+
+const WebRtc_UWord8* MappedFrameReader::GetFrame(int frame_number) const {
+  if (data_ == NULL || frame_number < 0 || frame_number >= number_of_frames_)
+    return NULL;
+  return data_ + frame_number * frame_length_in_bytes_;
+}
+
 }  // namespace test
 }  // namespace webrtc
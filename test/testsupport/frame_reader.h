@@ -67,6 +67,33 @@ class FrameReaderImpl : public FrameReader {
   FILE* input_file_;
 };
 
+// A frame reader mapping the whole file into memory, which also gives random
+// access to the frames without copying them. Frames can be read by several
+// threads at the same time through GetFrame().
+class MappedFrameReader : public FrameReader {
+ public:
+  // Parameters are the same as for FrameReaderImpl.
+  MappedFrameReader(std::string input_filename, size_t frame_length_in_bytes);
+  virtual ~MappedFrameReader();
+  bool Init();
+  bool ReadFrame(WebRtc_UWord8* source_buffer);
+  void Close();
+  size_t FrameLength() { return frame_length_in_bytes_; }
+  int NumberOfFrames() { return number_of_frames_; }
+
+  // Returns the frame at |frame_number|, or NULL if there is no such frame.
+  // The frame is valid until Close() is called.
+  const WebRtc_UWord8* GetFrame(int frame_number) const;
+
+ private:
+  std::string input_filename_;
+  size_t frame_length_in_bytes_;
+  int number_of_frames_;
+  int next_frame_;
+  const WebRtc_UWord8* data_;
+  size_t size_;
+};
+
 }  // namespace test
 }  // namespace webrtc
 
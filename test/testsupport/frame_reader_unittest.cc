@@ -68,5 +68,45 @@ TEST_F(FrameReaderTest, ReadFrameUninitialized) {
   ASSERT_FALSE(file_reader.ReadFrame(buffer));
 }
 
+TEST_F(FrameReaderTest, MappedReadFrame) {
+  MappedFrameReader frame_reader(kInputFilename, kFrameLength);
+  ASSERT_TRUE(frame_reader.Init());
+  ASSERT_EQ(0, frame_reader.NumberOfFrames());
+  EXPECT_TRUE(frame_reader.GetFrame(0) == NULL);
+  WebRtc_UWord8 buffer[3];
+  ASSERT_FALSE(frame_reader.ReadFrame(buffer));  // No more files to read.
+  ASSERT_EQ(kInputFileContents[0], buffer[0]);
+  ASSERT_EQ(kInputFileContents[1], buffer[1]);
+  ASSERT_EQ(kInputFileContents[2], buffer[2]);
+}
+
+TEST_F(FrameReaderTest, MappedGetFrame) {
+  const size_t kShortFrameLength = 1;
+  MappedFrameReader frame_reader(kInputFilename, kShortFrameLength);
+  ASSERT_TRUE(frame_reader.Init());
+  ASSERT_EQ(3, frame_reader.NumberOfFrames());
+  ASSERT_TRUE(frame_reader.GetFrame(2) != NULL);
+  EXPECT_EQ(kInputFileContents[2], *frame_reader.GetFrame(2));
+  EXPECT_EQ(kInputFileContents[0], *frame_reader.GetFrame(0));
+  EXPECT_TRUE(frame_reader.GetFrame(3) == NULL);
+  EXPECT_TRUE(frame_reader.GetFrame(-1) == NULL);
+
+  WebRtc_UWord8 buffer;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(frame_reader.ReadFrame(&buffer));
+    EXPECT_EQ(kInputFileContents[i], buffer);
+  }
+  EXPECT_FALSE(frame_reader.ReadFrame(&buffer));
+  frame_reader.Close();
+  EXPECT_TRUE(frame_reader.GetFrame(0) == NULL);
+}
+
+TEST_F(FrameReaderTest, MappedInitFailsForMissingFile) {
+  MappedFrameReader frame_reader("no_such_file.tmp", kFrameLength);
+  EXPECT_FALSE(frame_reader.Init());
+  WebRtc_UWord8 buffer[3];
+  EXPECT_FALSE(frame_reader.ReadFrame(buffer));
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "webrtc/system_wrappers/interface/data_log.h"
+#include "tools/simple_command_line_parser.h"
+
+/*
+ * A command-line tool converting a binary DataLog table file to the text
+ * format of the DataLog text tables, which can be read by e.g. Matlab.
+ * Usage:
+ * data_log_to_csv --input_file=<table_name.bin> --output_file=<table_name.txt>
+ */
+int main(int argc, char** argv) {
+  std::string program_name = argv[0];
+  std::string usage = "Converts a binary DataLog table to a text table.\n"
+    "Example usage:\n" + program_name +
+    " --input_file=table_1.bin --output_file=table_1.txt\n"
+    "Command line flags:\n"
+    "  - input_file(string): The binary table file. Default: table.bin\n"
+    "  - output_file(string): The text file to write. Default: table.txt\n";
+
+  webrtc::test::CommandLineParser parser;
+
+  // Init the parser and set the usage message
+  parser.Init(argc, argv);
+  parser.SetUsageMessage(usage);
+
+  parser.SetFlag("input_file", "table.bin");
+  parser.SetFlag("output_file", "table.txt");
+  parser.SetFlag("help", "false");
+
+  parser.ProcessFlags();
+  if (parser.GetFlag("help") == "true") {
+    parser.PrintUsageMessage();
+  }
+  parser.PrintEnteredFlags();
+
+  if (webrtc::DataLog::ConvertBinaryToCsv(parser.GetFlag("input_file"),
+                                          parser.GetFlag("output_file")) != 0) {
+    fprintf(stderr, "Error: %s is not a valid binary DataLog table!\n",
+            parser.GetFlag("input_file").c_str());
+    return -1;
+  }
+  fprintf(stdout, "Successful conversion of the binary table!\n");
+  return 0;
+}
@@ -41,6 +41,7 @@
  * Usage:
  * frame_analyzer --reference_file=<name_of_file> --test_file=<name_of_file>
  * --stats_file=<name_of_file> --width=<frame_width> --height=<frame_height>
+ * [--threads=<number_of_threads>]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -56,7 +57,9 @@ int main(int argc, char** argv) {
       "  - reference_file(string): The reference YUV file to compare against."
       " Default: ref.yuv\n"
       "  - test_file(string): The test YUV file to run the analysis for."
-      " Default: test_file.yuv\n";
+      " Default: test_file.yuv\n"
+      "  - threads(int): The number of threads running the analysis, 0 for "
+      "one per core. Default: 0\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -69,6 +72,7 @@ int main(int argc, char** argv) {
   parser.SetFlag("stats_file", "stats.txt");
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
+  parser.SetFlag("threads", "0");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -79,6 +83,7 @@ int main(int argc, char** argv) {
 
   int width = strtol((parser.GetFlag("width")).c_str(), NULL, 10);
   int height = strtol((parser.GetFlag("height")).c_str(), NULL, 10);
+  int threads = strtol((parser.GetFlag("threads")).c_str(), NULL, 10);
 
   if (width <= 0 || height <= 0) {
     fprintf(stderr, "Error: width or height cannot be <= 0!\n");
@@ -90,7 +95,7 @@ int main(int argc, char** argv) {
   webrtc::test::RunAnalysis(parser.GetFlag("reference_file").c_str(),
                             parser.GetFlag("test_file").c_str(),
                             parser.GetFlag("stats_file").c_str(), width, height,
-                            &results);
+                            threads, &results);
 
   webrtc::test::PrintAnalysisResults(&results);
   webrtc::test::PrintMaxRepeatedAndSkippedFrames(
@@ -15,6 +15,13 @@
 #include <cstdlib>
 #include <string>
 
+#include "testsupport/frame_reader.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
 #define STATS_LINE_LENGTH 32
 
 namespace webrtc {
@@ -22,6 +29,94 @@ namespace test {
 
 using std::string;
 
+namespace {
+
+// Calculates the metrics of a list of frame pairs on a number of threads. Each
+// thread takes the next frame pair to analyze and stores the result at the
+// index of the pair, so the order of the results doesn't depend on the order
+// in which the threads finish.
+class FrameMetricsCalculator {
+ public:
+  FrameMetricsCalculator(const std::vector<FramePair>& frame_pairs, int width,
+                         int height, AnalysisResult* results)
+      : frame_pairs_(frame_pairs),
+        number_of_frames_(static_cast<int>(frame_pairs.size())),
+        width_(width),
+        height_(height),
+        results_(results),
+        next_frame_(0),
+        frames_done_(0),
+        done_event_(EventWrapper::Create()),
+        idle_event_(EventWrapper::Create()) {
+  }
+
+  void Run(int number_of_threads) {
+    std::vector<ThreadWrapper*> threads;
+    for (int i = 0; i < number_of_threads && i < number_of_frames_; ++i) {
+      ThreadWrapper* thread = ThreadWrapper::CreateThread(
+          Process, this, kNormalPriority, "FrameMetricsThread");
+      unsigned int thread_id = 0;
+      if (thread == NULL || !thread->Start(thread_id)) {
+        delete thread;
+        break;
+      }
+      threads.push_back(thread);
+    }
+    if (threads.empty()) {
+      while (frames_done_.Value() < number_of_frames_) {
+        ProcessNextFrame();
+      }
+      return;
+    }
+    if (frames_done_.Value() < number_of_frames_) {
+      done_event_->Wait(WEBRTC_EVENT_INFINITE);
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i]->Stop();
+      delete threads[i];
+    }
+  }
+
+ private:
+  static bool Process(void* obj) {
+    return static_cast<FrameMetricsCalculator*>(obj)->ProcessNextFrame();
+  }
+
+  // Always returns true, the threads are stopped when all frames are done.
+  bool ProcessNextFrame() {
+    const int index = ++next_frame_ - 1;
+    if (index >= number_of_frames_) {
+      idle_event_->Wait(10);
+      return true;
+    }
+    const FramePair& frame_pair = frame_pairs_[index];
+    AnalysisResult* result = &results_[index];
+    result->frame_number = frame_pair.frame_number;
+    result->psnr_value = CalculateMetrics(kPSNR, frame_pair.reference_frame,
+                                          frame_pair.test_frame, width_,
+                                          height_);
+    result->ssim_value = CalculateMetrics(kSSIM, frame_pair.reference_frame,
+                                          frame_pair.test_frame, width_,
+                                          height_);
+    if (++frames_done_ == number_of_frames_) {
+      done_event_->Set();
+    }
+    return true;
+  }
+
+  const std::vector<FramePair>& frame_pairs_;
+  const int number_of_frames_;
+  const int width_;
+  const int height_;
+  AnalysisResult* results_;
+  Atomic32 next_frame_;
+  Atomic32 frames_done_;
+  scoped_ptr<EventWrapper> done_event_;
+  scoped_ptr<EventWrapper> idle_event_;
+};
+
+}  // namespace
+
 int GetI420FrameSize(int width, int height) {
   int half_width = (width + 1) >> 1;
   int half_height = (height + 1) >> 1;
@@ -172,18 +267,42 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
   return result;
 }
 
+void CalculateMetricsForFrames(const std::vector<FramePair>& frame_pairs,
+                               int width, int height, int number_of_threads,
+                               ResultsContainer* results) {
+  if (frame_pairs.empty()) {
+    return;
+  }
+  if (number_of_threads <= 0) {
+    number_of_threads = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  }
+  const size_t first_result = results->frames.size();
+  results->frames.resize(first_result + frame_pairs.size());
+  FrameMetricsCalculator calculator(frame_pairs, width, height,
+                                    &results->frames[first_result]);
+  // A single thread analyzes the frames on the calling thread.
+  calculator.Run(number_of_threads > 1 ? number_of_threads : 0);
+}
+
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
-                 ResultsContainer* results) {
+                 int number_of_threads, ResultsContainer* results) {
   int size = GetI420FrameSize(width, height);
   FILE* stats_file = fopen(stats_file_name, "r");
 
+  // Map both files instead of reading each frame, the frames are compared in
+  // place.
+  MappedFrameReader test_file(test_file_name, size);
+  MappedFrameReader reference_file(reference_file_name, size);
+  if (!test_file.Init() || !reference_file.Init()) {
+    fclose(stats_file);
+    return;
+  }
+
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
 
-  // Allocate buffers for test and reference frames.
-  uint8* test_frame = new uint8[size];
-  uint8* reference_frame = new uint8[size];
+  std::vector<FramePair> frame_pairs;
   int previous_frame_number = -1;
 
   // While there are entries in the stats file.
@@ -201,32 +320,25 @@ void RunAnalysis(const char* reference_file_name, const char* test_file_name,
     assert(extracted_test_frame != -1);
     assert(decoded_frame_number != -1);
 
-    ExtractFrameFromI420(test_file_name, width, height, extracted_test_frame,
-                         test_frame);
-    ExtractFrameFromI420(reference_file_name, width, height,
-                         decoded_frame_number, reference_frame);
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = CalculateMetrics(kPSNR, reference_frame, test_frame,
-                                          width, height);
-    double result_ssim = CalculateMetrics(kSSIM, reference_frame, test_frame,
-                                          width, height);
-
+    FramePair frame_pair;
+    frame_pair.frame_number = decoded_frame_number;
+    frame_pair.test_frame = test_file.GetFrame(extracted_test_frame);
+    frame_pair.reference_frame = reference_file.GetFrame(decoded_frame_number);
     previous_frame_number = decoded_frame_number;
-
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
-
-    results->frames.push_back(result);
+    if (frame_pair.test_frame == NULL || frame_pair.reference_frame == NULL) {
+      fprintf(stdout, "Frame %d or reference frame %d is missing\n",
+              extracted_test_frame, decoded_frame_number);
+      continue;
+    }
+    frame_pairs.push_back(frame_pair);
   }
 
+  // Calculate the PSNR and SSIM.
+  CalculateMetricsForFrames(frame_pairs, width, height, number_of_threads,
+                            results);
+
   // Cleanup.
   fclose(stats_file);
-  delete[] test_frame;
-  delete[] reference_frame;
 }
 
 void PrintMaxRepeatedAndSkippedFrames(const char* stats_file_name) {
@@ -32,6 +32,13 @@ struct ResultsContainer {
 
 enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 
+// A reference frame and the test frame to compare it with.
+struct FramePair {
+  int frame_number;  // The number reported in the AnalysisResult.
+  const uint8* reference_frame;
+  const uint8* test_frame;
+};
+
 // A function to run the PSNR and SSIM analysis on the test file. The test file
 // comprises the frames that were captured during the quality measurement test.
 // There may be missing or duplicate frames. Also the frames start at a random
@@ -45,9 +52,19 @@ enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 // tools/barcode_tools/barcode_decoder.py. This script decodes the barcodes
 // integrated in every video and generates the stats file. If three was some
 // problem with the decoding there would be 'Barcode error' instead of yyyy.
+// The frames are analyzed on |number_of_threads| threads, or one thread per
+// core if |number_of_threads| is 0. The results are in the order of the stats
+// file regardless of the number of threads.
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
-                 ResultsContainer* results);
+                 int number_of_threads, ResultsContainer* results);
+
+// Computes PSNR and SSIM for each of |frame_pairs| on |number_of_threads|
+// threads, or one thread per core if |number_of_threads| is 0. The results are
+// appended to |results| in the order of |frame_pairs|.
+void CalculateMetricsForFrames(const std::vector<FramePair>& frame_pairs,
+                               int width, int height, int number_of_threads,
+                               ResultsContainer* results);
 
 // Compute PSNR or SSIM for an I420 frame (all planes). When we are calculating
 // PSNR values, the max return value (in the case where the test and reference
@@ -14,39 +14,45 @@
 #include <string>
 #include <vector>
 
+#include "testsupport/frame_reader.h"
 #include "tools/frame_analyzer/video_quality_analysis.h"
 #include "tools/simple_command_line_parser.h"
 
 void CompareFiles(const char* reference_file_name, const char* test_file_name,
-                  const char* results_file_name, int width, int height) {
-  FILE* ref_file = fopen(reference_file_name, "rb");
-  FILE* test_file = fopen(test_file_name, "rb");
-  FILE* results_file = fopen(results_file_name, "w");
-
+                  const char* results_file_name, int width, int height,
+                  int number_of_threads) {
   int size = webrtc::test::GetI420FrameSize(width, height);
 
-  // Allocate buffers for test and reference frames.
-  uint8* test_frame = new uint8[size];
-  uint8* ref_frame = new uint8[size];
+  // Map both files, the frames are compared in place.
+  webrtc::test::MappedFrameReader ref_file(reference_file_name, size);
+  webrtc::test::MappedFrameReader test_file(test_file_name, size);
+  if (!ref_file.Init() || !test_file.Init()) {
+    return;
+  }
+  FILE* results_file = fopen(results_file_name, "w");
 
-  int frame_counter = 0;
+  std::vector<webrtc::test::FramePair> frame_pairs;
+  for (int frame_counter = 0;
+       frame_counter < ref_file.NumberOfFrames() &&
+       frame_counter < test_file.NumberOfFrames();
+       ++frame_counter) {
+    webrtc::test::FramePair frame_pair;
+    frame_pair.frame_number = frame_counter;
+    frame_pair.reference_frame = ref_file.GetFrame(frame_counter);
+    frame_pair.test_frame = test_file.GetFrame(frame_counter);
+    frame_pairs.push_back(frame_pair);
+  }
 
-  while (webrtc::test::GetNextI420Frame(ref_file, width, height, ref_frame) &&
-         webrtc::test::GetNextI420Frame(test_file, width, height, test_frame)) {
-    // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::CalculateMetrics(
-        webrtc::test::kPSNR, ref_frame, test_frame, width, height);
-    double result_ssim = webrtc::test::CalculateMetrics(
-        webrtc::test::kSSIM, ref_frame, test_frame, width, height);
-    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
-            result_psnr, result_ssim);
-    ++frame_counter;
+  // Calculate the PSNR and SSIM.
+  webrtc::test::ResultsContainer results;
+  webrtc::test::CalculateMetricsForFrames(frame_pairs, width, height,
+                                          number_of_threads, &results);
+  std::vector<webrtc::test::AnalysisResult>::iterator iter;
+  for (iter = results.frames.begin(); iter != results.frames.end(); ++iter) {
+    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n",
+            iter->frame_number, iter->psnr_value, iter->ssim_value);
   }
-  delete[] test_frame;
-  delete[] ref_frame;
 
-  fclose(ref_file);
-  fclose(test_file);
   fclose(results_file);
 }
 
@@ -64,7 +70,7 @@ void CompareFiles(const char* reference_file_name, const char* test_file_name,
  * Usage:
  * psnr_ssim_analyzer --reference_file=<name_of_file> --test_file=<name_of_file>
  * --results_file=<name_of_file> --width=<width_of_frames>
- * --height=<height_of_frames>
+ * --height=<height_of_frames> [--threads=<number_of_threads>]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -82,7 +88,9 @@ int main(int argc, char** argv) {
       "  - test_file(string): The test YUV file to run the analysis for."
       " Default: test_file.yuv\n"
       "  - results_file(string): The full name of the file where the results "
-      "will be written. Default: results.txt\n";
+      "will be written. Default: results.txt\n"
+      "  - threads(int): The number of threads running the analysis, 0 for "
+      "one per core. Default: 0\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -96,6 +104,7 @@ int main(int argc, char** argv) {
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
   parser.SetFlag("results_file", "results.txt");
+  parser.SetFlag("threads", "0");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -106,6 +115,7 @@ int main(int argc, char** argv) {
 
   int width = strtol((parser.GetFlag("width")).c_str(), NULL, 10);
   int height = strtol((parser.GetFlag("height")).c_str(), NULL, 10);
+  int threads = strtol((parser.GetFlag("threads")).c_str(), NULL, 10);
 
   if (width <= 0 || height <= 0) {
     fprintf(stderr, "Error: width or height cannot be <= 0!\n");
@@ -114,5 +124,6 @@ int main(int argc, char** argv) {
 
   CompareFiles(parser.GetFlag("reference_file").c_str(),
                parser.GetFlag("test_file").c_str(),
-               parser.GetFlag("results_file").c_str(), width, height);
+               parser.GetFlag("results_file").c_str(), width, height,
+               threads);
 }
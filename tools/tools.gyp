@@ -24,6 +24,8 @@
       'type': 'static_library',
       'dependencies': [
         '<(DEPTH)/third_party/libyuv/libyuv.gyp:libyuv',
+        '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
+        '<(webrtc_root)/test/test.gyp:test_support',
       ],
       'include_dirs': [
         'frame_analyzer',
@@ -35,6 +37,7 @@
       },
       'export_dependent_settings': [
         '<(DEPTH)/third_party/libyuv/libyuv.gyp:libyuv',
+        '<(webrtc_root)/test/test.gyp:test_support',
       ],
       'sources': [
         'frame_analyzer/video_quality_analysis.h',
@@ -102,6 +105,17 @@
         'frame_editing/frame_editing.cc',
       ],
     }, # frame_editing
+    {
+      'target_name': 'data_log_to_csv',
+      'type': 'executable',
+      'dependencies': [
+        'command_line_parser',
+        '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'sources': [
+        'data_log_converter/data_log_to_csv.cc',
+      ],
+    }, # data_log_to_csv
   ],
   'conditions': [
     ['include_tests==1', {
@@ -90,6 +90,40 @@ struct ViEVideoFrameI420 {
   unsigned short height;
 };
 
+// Counters of the buffer handling of captured frames, from the capture
+// device to the frame consumers.
+struct CaptureBufferStatistics {
+  CaptureBufferStatistics()
+      : frames_captured(0),
+        frames_dropped(0),
+        buffer_allocations(0),
+        frame_copies(0) {}
+
+  // Frames received from the capture device.
+  unsigned int frames_captured;
+  // Frames overwritten before delivery since all capture buffers were full.
+  unsigned int frames_dropped;
+  // Times a frame buffer was allocated or grown, including the capture
+  // buffers allocated when capture is started.
+  unsigned int buffer_allocations;
+  // Full frame copies, e.g. of external I420 frames, for effect filters and
+  // for delivering a frame to more than one consumer.
+  unsigned int frame_copies;
+};
+
+// Time spent delivering captured frames to one consumer, e.g. a channel
+// encoding the frames or a renderer.
+struct CaptureDeliveryStatistics {
+  CaptureDeliveryStatistics()
+      : frames(0),
+        average_delivery_time_us(0),
+        max_delivery_time_us(0) {}
+
+  unsigned int frames;
+  unsigned int average_delivery_time_us;
+  unsigned int max_delivery_time_us;
+};
+
 // This class declares an abstract interface to be used when implementing
 // a user-defined capture device. This interface is not meant to be
 // implemented by the user. Instead, the user should call AllocateCaptureDevice
@@ -245,6 +279,19 @@ class WEBRTC_DLLEXPORT ViECapture {
   // Removes an already registered instance of ViECaptureObserver.
   virtual int DeregisterObserver(const int capture_id) = 0;
 
+  // Gets the buffer counters of a capture device since it was allocated.
+  virtual int GetCaptureBufferStatistics(
+      const int capture_id,
+      CaptureBufferStatistics& statistics) = 0;
+
+  // Gets the delivery time of captured frames to the consumer |observer_id|,
+  // i.e. the channel or render id the capture device is connected to. A slow
+  // consumer delays the delivery to the consumers after it.
+  virtual int GetCaptureDeliveryStatistics(
+      const int capture_id,
+      const int observer_id,
+      CaptureDeliveryStatistics& statistics) = 0;
+
  protected:
   ViECapture() {}
   virtual ~ViECapture() {}
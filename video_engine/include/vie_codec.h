@@ -64,6 +64,34 @@ class WEBRTC_DLLEXPORT ViEDecoderObserver {
   virtual ~ViEDecoderObserver() {}
 };
 
+// Statistics of one stage of the pipelined encoder, see
+// ViECodec::SetEncoderPipelineStatus().
+struct EncoderPipelineStageStatistics {
+  EncoderPipelineStageStatistics()
+      : frames(0),
+        average_queue_time_us(0),
+        average_process_time_us(0),
+        max_process_time_us(0) {}
+
+  // Number of frames processed by the stage.
+  unsigned int frames;
+  // Average time a frame waited in the queue in front of the stage.
+  unsigned int average_queue_time_us;
+  unsigned int average_process_time_us;
+  unsigned int max_process_time_us;
+};
+
+struct EncoderPipelineStatistics {
+  EncoderPipelineStatistics() : dropped_frames(0) {}
+
+  EncoderPipelineStageStatistics preprocess;
+  EncoderPipelineStageStatistics encode;
+  // Packetization and FEC.
+  EncoderPipelineStageStatistics packetize;
+  // Number of captured frames dropped because the pipeline was full.
+  unsigned int dropped_frames;
+};
+
 class WEBRTC_DLLEXPORT ViECodec {
  public:
   // Factory for the ViECodec sub‐API and increases an internal reference
@@ -166,11 +194,44 @@ class WEBRTC_DLLEXPORT ViECodec {
   // request.
   virtual int SendKeyFrame(const int video_channel) = 0;
 
+  // This function sets how key frame requests from the receivers of
+  // |video_channel| are answered. Requests for the same SSRC arriving less
+  // than |min_interval_ms| after an answered request are suppressed. If
+  // |reference_recovery| is true and VP8 feedback mode is enabled, requests
+  // are answered by a frame predicted only from a reference frame acknowledged
+  // by the receiver, instead of a key frame, once an RPSI has been received.
+  virtual int SetKeyFrameRequestPolicy(const int video_channel,
+                                       const int min_interval_ms,
+                                       const bool reference_recovery) = 0;
+
+  // Gets the number of key frame requests received on |video_channel|, the
+  // number suppressed and the number answered with a refresh frame.
+  virtual int GetKeyFrameRequestStatistics(
+      const int video_channel,
+      unsigned int& requests_received,
+      unsigned int& requests_suppressed,
+      unsigned int& refresh_frames) const = 0;
+
   // This function makes the decoder wait for a key frame before starting to
   // decode the incoming video stream.
   virtual int WaitForFirstKeyFrame(const int video_channel,
                                    const bool wait) = 0;
 
+  // Enables running preprocessing, encoding and packetization of the
+  // captured frames on separate threads, with up to |queue_size| frames
+  // waiting in front of each stage. This lets the stages of consecutive
+  // frames overlap at the cost of added delay. Captured frames are dropped
+  // if the pipeline can't keep up. Disabled by default.
+  virtual int SetEncoderPipelineStatus(const int video_channel,
+                                       const bool enable,
+                                       const int queue_size = 2) = 0;
+
+  // Gets the per stage statistics of the pipelined encoder. Fails if the
+  // pipeline isn't enabled.
+  virtual int GetEncoderPipelineStatistics(
+      const int video_channel,
+      EncoderPipelineStatistics& statistics) const = 0;
+
  protected:
   ViECodec() {}
   virtual ~ViECodec() {}
@@ -175,6 +175,23 @@ class WEBRTC_DLLEXPORT ViEFile {
   virtual int GetCaptureDeviceSnapshot(const int capture_id,
                                        ViEPicture& picture) = 0;
 
+  // The function takes a snapshot of the last rendered image for a video
+  // channel and encodes it as JPEG in |picture|. Images larger than
+  // |max_width| x |max_height| are downscaled to fit, keeping the aspect
+  // ratio. 0 keeps the size of the image. The picture is released with
+  // FreePicture().
+  virtual int GetRenderSnapshotJpeg(const int video_channel,
+                                    ViEPicture& picture,
+                                    const int max_width,
+                                    const int max_height) = 0;
+
+  // The function takes a snapshot of the last captured image by a specified
+  // capture device and encodes it as JPEG, like GetRenderSnapshotJpeg().
+  virtual int GetCaptureDeviceSnapshotJpeg(const int capture_id,
+                                           ViEPicture& picture,
+                                           const int max_width,
+                                           const int max_height) = 0;
+
   virtual int FreePicture(ViEPicture& picture) = 0;
 
   // This function sets a jpg image to render before the first received video
@@ -314,6 +314,30 @@ class WEBRTC_DLLEXPORT ViERTP_RTCP {
   virtual int StopRTPDump(const int video_channel,
                           RTPDirections direction) = 0;
 
+  // This function forwards the RTP packets received on |video_channel| to the
+  // transport of |destination_channel|, with the SSRC, sequence numbers and
+  // timestamps rewritten to the send stream of |destination_channel|. RTCP
+  // isn't forwarded: NACKs received on |destination_channel| are answered
+  // with the forwarded packets, and PLI and FIR are turned into a key frame
+  // request on |video_channel|. The forwarded packets are decoded on
+  // |video_channel| as long as one of its destinations was added with
+  // |decode| true. A channel can be the destination of one channel only.
+  virtual int StartRTPForwarding(const int video_channel,
+                                 const int destination_channel,
+                                 const bool decode) = 0;
+
+  // This function stops forwarding RTP packets from |video_channel| to
+  // |destination_channel|.
+  virtual int StopRTPForwarding(const int video_channel,
+                                const int destination_channel) = 0;
+
+  // This function gets the number of packets and bytes forwarded from
+  // |video_channel|, counted once per destination.
+  virtual int GetRTPForwardingStatistics(
+      const int video_channel,
+      unsigned int& packets_forwarded,
+      unsigned int& bytes_forwarded) const = 0;
+
   // Registers an instance of a user implementation of the ViERTPObserver.
   virtual int RegisterRTPObserver(const int video_channel,
                                   ViERTPObserver& observer) = 0;
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video_engine/key_frame_request_aggregator.h"
+
+#include "video_engine/vie_defines.h"
+
+namespace webrtc {
+
+KeyFrameRequestAggregator::KeyFrameRequestAggregator()
+    : min_interval_ms_(kViEMinKeyRequestIntervalMs),
+      reference_recovery_(false),
+      requests_received_(0),
+      requests_suppressed_(0),
+      refresh_frames_(0) {
+}
+
+KeyFrameRequestAggregator::~KeyFrameRequestAggregator() {
+}
+
+void KeyFrameRequestAggregator::SetPolicy(int min_interval_ms,
+                                          bool reference_recovery) {
+  min_interval_ms_ = min_interval_ms;
+  reference_recovery_ = reference_recovery;
+}
+
+KeyFrameRequestAggregator::Action KeyFrameRequestAggregator::OnKeyFrameRequest(
+    uint32_t ssrc, int64_t now_ms, bool refresh_frame_possible) {
+  ++requests_received_;
+  SsrcState& state = ssrc_states_[ssrc];
+  if (state.last_request_ms >= 0 &&
+      state.last_request_ms + min_interval_ms_ > now_ms) {
+    ++requests_suppressed_;
+    return kSuppressRequest;
+  }
+  state.last_request_ms = now_ms;
+  if (reference_recovery_ && refresh_frame_possible && state.received_rpsi) {
+    ++refresh_frames_;
+    return kSendRefreshFrame;
+  }
+  return kSendKeyFrame;
+}
+
+void KeyFrameRequestAggregator::OnReceivedRPSI(uint32_t ssrc) {
+  ssrc_states_[ssrc].received_rpsi = true;
+}
+
+void KeyFrameRequestAggregator::OnSsrcChanged(uint32_t old_ssrc,
+                                              uint32_t new_ssrc) {
+  SsrcStates::iterator it = ssrc_states_.find(old_ssrc);
+  if (it == ssrc_states_.end()) {
+    return;
+  }
+  SsrcState state = it->second;
+  ssrc_states_.erase(it);
+  ssrc_states_[new_ssrc] = state;
+}
+
+void KeyFrameRequestAggregator::Reset() {
+  ssrc_states_.clear();
+}
+
+void KeyFrameRequestAggregator::GetStatistics(
+    unsigned int* requests_received,
+    unsigned int* requests_suppressed,
+    unsigned int* refresh_frames) const {
+  *requests_received = requests_received_;
+  *requests_suppressed = requests_suppressed_;
+  *refresh_frames = refresh_frames_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// KeyFrameRequestAggregator decides how to answer key frame requests from the
+// receivers of a stream. Requests for the same ssrc arriving within a minimum
+// interval are suppressed, since one new key frame serves all receivers. If
+// reference recovery is enabled and a receiver has acknowledged a reference
+// frame with an RPSI, a refresh frame predicted only from acknowledged
+// references is used instead of a full key frame.
+
+#ifndef WEBRTC_VIDEO_ENGINE_KEY_FRAME_REQUEST_AGGREGATOR_H_
+#define WEBRTC_VIDEO_ENGINE_KEY_FRAME_REQUEST_AGGREGATOR_H_
+
+#include <map>
+
+#include "typedefs.h"  // NOLINT
+
+namespace webrtc {
+
+class KeyFrameRequestAggregator {
+ public:
+  enum Action {
+    kSuppressRequest,
+    kSendKeyFrame,
+    kSendRefreshFrame
+  };
+
+  KeyFrameRequestAggregator();
+  ~KeyFrameRequestAggregator();
+
+  // Sets the minimum interval between answered requests for each ssrc and
+  // whether a refresh frame can replace a key frame.
+  void SetPolicy(int min_interval_ms, bool reference_recovery);
+
+  // Returns how to answer a key frame request for |ssrc| received at |now_ms|.
+  // |refresh_frame_possible| tells if the current encoder can produce a
+  // refresh frame, i.e. VP8 with feedback mode on. If not, the request is
+  // answered with a key frame.
+  Action OnKeyFrameRequest(uint32_t ssrc, int64_t now_ms,
+                           bool refresh_frame_possible);
+
+  // Called when a receiver of |ssrc| has acknowledged a reference frame.
+  void OnReceivedRPSI(uint32_t ssrc);
+
+  void OnSsrcChanged(uint32_t old_ssrc, uint32_t new_ssrc);
+
+  // Forgets the state of all ssrcs, the statistics are kept.
+  void Reset();
+
+  void GetStatistics(unsigned int* requests_received,
+                     unsigned int* requests_suppressed,
+                     unsigned int* refresh_frames) const;
+
+ private:
+  struct SsrcState {
+    SsrcState() : last_request_ms(-1), received_rpsi(false) {}
+    int64_t last_request_ms;
+    bool received_rpsi;
+  };
+  typedef std::map<uint32_t, SsrcState> SsrcStates;
+
+  int min_interval_ms_;
+  bool reference_recovery_;
+  SsrcStates ssrc_states_;
+  unsigned int requests_received_;
+  unsigned int requests_suppressed_;
+  unsigned int refresh_frames_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_KEY_FRAME_REQUEST_AGGREGATOR_H_
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file includes unit tests for KeyFrameRequestAggregator.
+#include "video_engine/key_frame_request_aggregator.h"
+
+#include <gtest/gtest.h>
+
+namespace webrtc {
+
+static const uint32_t kSsrc1 = 1234;
+static const uint32_t kSsrc2 = 5678;
+
+class KeyFrameRequestAggregatorTest : public ::testing::Test {
+ protected:
+  void ExpectStatistics(unsigned int received, unsigned int suppressed,
+                        unsigned int refreshes) {
+    unsigned int requests_received = 0;
+    unsigned int requests_suppressed = 0;
+    unsigned int refresh_frames = 0;
+    aggregator_.GetStatistics(&requests_received, &requests_suppressed,
+                              &refresh_frames);
+    EXPECT_EQ(received, requests_received);
+    EXPECT_EQ(suppressed, requests_suppressed);
+    EXPECT_EQ(refreshes, refresh_frames);
+  }
+
+  KeyFrameRequestAggregator aggregator_;
+};
+
+TEST_F(KeyFrameRequestAggregatorTest, SuppressesRequestsWithinInterval) {
+  aggregator_.SetPolicy(1000, false);
+  // A burst of requests from many receivers results in one key frame.
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 0, true));
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_EQ(KeyFrameRequestAggregator::kSuppressRequest,
+              aggregator_.OnKeyFrameRequest(kSsrc1, i * 5, true));
+  }
+  // Other ssrcs are limited separately.
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc2, 500, true));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 1000, true));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSuppressRequest,
+            aggregator_.OnKeyFrameRequest(kSsrc2, 1499, true));
+  ExpectStatistics(103, 100, 0);
+}
+
+TEST_F(KeyFrameRequestAggregatorTest, FirstRequestIsAnswered) {
+  aggregator_.SetPolicy(300, false);
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 0, true));
+  aggregator_.Reset();
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 1, true));
+}
+
+TEST_F(KeyFrameRequestAggregatorTest, RefreshFrameAfterRpsi) {
+  aggregator_.SetPolicy(0, true);
+  // No acknowledged reference yet.
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 0, true));
+  aggregator_.OnReceivedRPSI(kSsrc1);
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendRefreshFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 10, true));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc2, 10, true));
+  aggregator_.SetPolicy(0, false);
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 20, true));
+  ExpectStatistics(4, 0, 1);
+}
+
+TEST_F(KeyFrameRequestAggregatorTest, KeyFrameWhenRefreshIsNotPossible) {
+  aggregator_.SetPolicy(1000, true);
+  aggregator_.OnReceivedRPSI(kSsrc1);
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 0, false));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSuppressRequest,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 500, false));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendRefreshFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 1000, true));
+  ExpectStatistics(3, 1, 1);
+}
+
+TEST_F(KeyFrameRequestAggregatorTest, KeepsStateWhenSsrcChanges) {
+  aggregator_.SetPolicy(1000, true);
+  aggregator_.OnReceivedRPSI(kSsrc1);
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendRefreshFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 0, true));
+  aggregator_.OnSsrcChanged(kSsrc1, kSsrc2);
+  EXPECT_EQ(KeyFrameRequestAggregator::kSuppressRequest,
+            aggregator_.OnKeyFrameRequest(kSsrc2, 500, true));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendRefreshFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc2, 1000, true));
+  EXPECT_EQ(KeyFrameRequestAggregator::kSendKeyFrame,
+            aggregator_.OnKeyFrameRequest(kSsrc1, 1000, true));
+}
+
+}  // namespace webrtc
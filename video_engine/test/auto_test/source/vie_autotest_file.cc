@@ -326,6 +326,19 @@ void ViEAutoTest::ViEFileStandardTest()
             ViETest::Log("Done\n");
         }
 
+        // GetRenderSnapshotJpeg
+        {
+            ViETest::Log("Testing GetRenderSnapshotJpeg(int, ViEPicture)");
+            webrtc::ViEPicture jpegPicture;
+            EXPECT_EQ(0, ptrViEFile->GetRenderSnapshotJpeg(
+                captureId, jpegPicture, 160, 120));
+            EXPECT_EQ(webrtc::kVideoMJPEG, jpegPicture.type);
+            EXPECT_GE(160u, jpegPicture.width);
+            EXPECT_GE(120u, jpegPicture.height);
+            EXPECT_EQ(0, ptrViEFile->FreePicture(jpegPicture));
+            ViETest::Log("Done\n");
+        }
+
         AutoTestSleep(TEST_SPACING);
 
         // GetCaptureDeviceSnapshot
@@ -9,11 +9,14 @@
  */
 
 #include <iostream>  // NOLINT
+#include <vector>
 
 #include "common_types.h"  // NOLINT
+#include "modules/video_coding/codecs/vp8/include/vp8_simulcast_encoder.h"
 #include "video_engine/include/vie_base.h"
 #include "video_engine/include/vie_capture.h"
 #include "video_engine/include/vie_codec.h"
+#include "video_engine/include/vie_external_codec.h"
 #include "video_engine/include/vie_network.h"
 #include "video_engine/include/vie_render.h"
 #include "video_engine/include/vie_rtp_rtcp.h"
@@ -85,6 +88,19 @@ void RuntimeSingleStreamSettings(webrtc::VideoCodec* video_codec) {
   video_codec->simulcastStream[2].minBitrate = 0;
 }
 
+void PrintEncodeStatistics(const webrtc::VP8SimulcastEncoder& encoder) {
+  std::vector<webrtc::EncodeTimeStatistics> layers;
+  webrtc::EncodeTimeStatistics frames;
+  encoder.GetStatistics(&layers, &frames);
+  for (size_t i = 0; i < layers.size(); ++i) {
+    printf("Layer %d: %u frames, encode time avg %u us, max %u us\n",
+           static_cast<int>(i), layers[i].frames, layers[i].average_time_us,
+           layers[i].max_time_us);
+  }
+  printf("Frame latency: %u frames, avg %u us, max %u us\n", frames.frames,
+         frames.average_time_us, frames.max_time_us);
+}
+
 int VideoEngineSimulcastTest(void* window1, void* window2) {
   // *******************************************************
   //  Begin create/initialize Video Engine for testing
@@ -400,6 +416,22 @@ int VideoEngineSimulcastTest(void* window1, void* window2) {
     video_codec.startBitrate = start_rate;
   }
 
+  // Use an external instance of the simulcast encoder to be able to report
+  // its encode times.
+  webrtc::ViEExternalCodec* vie_external_codec =
+      webrtc::ViEExternalCodec::GetInterface(video_engine);
+  if (vie_external_codec == NULL) {
+    printf("ERROR in ViEExternalCodec::GetInterface\n");
+    return -1;
+  }
+  webrtc::VP8SimulcastEncoder* encoder = webrtc::VP8SimulcastEncoder::Create();
+  error = vie_external_codec->RegisterExternalSendCodec(
+      video_channel, video_codec.plType, encoder, false);
+  if (error == -1) {
+    printf("ERROR in ViEExternalCodec::RegisterExternalSendCodec\n");
+    return -1;
+  }
+
   error = vie_codec->SetSendCodec(video_channel, video_codec);
   if (error == -1) {
     printf("ERROR in ViECodec::SetSendCodec\n");
@@ -502,6 +534,7 @@ int VideoEngineSimulcastTest(void* window1, void* window2) {
     if (!str.empty()) {
       int ssrc = atoi(str.c_str());
       if (ssrc == 0) {
+        PrintEncodeStatistics(*encoder);
         // Toggle between simulcast and a single stream with different
         // resolution.
         if (simulcast_mode) {
@@ -540,6 +573,7 @@ int VideoEngineSimulcastTest(void* window1, void* window2) {
       break;
     }
   } while (true);
+  PrintEncodeStatistics(*encoder);
 
   // *******************************************************
   //  Testing finished. Tear down Video Engine
@@ -620,14 +654,23 @@ int VideoEngineSimulcastTest(void* window1, void* window2) {
     }
   }
 
+  error = vie_external_codec->DeRegisterExternalSendCodec(video_channel,
+                                                          video_codec.plType);
+  if (error == -1) {
+    printf("ERROR in ViEExternalCodec::DeRegisterExternalSendCodec\n");
+    return -1;
+  }
+
   error = vie_base->DeleteChannel(video_channel);
   if (error == -1) {
     printf("ERROR in ViEBase::DeleteChannel\n");
     return -1;
   }
+  delete encoder;
 
   int remaining_interfaces = 0;
   remaining_interfaces = vie_codec->Release();
+  remaining_interfaces += vie_external_codec->Release();
   remaining_interfaces += vie_capture->Release();
   remaining_interfaces += vie_rtp_rtcp->Release();
   remaining_interfaces += vie_render->Release();
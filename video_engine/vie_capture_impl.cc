@@ -593,4 +593,56 @@ int ViECaptureImpl::DeregisterObserver(const int capture_id) {
   return 0;
 }
 
+int ViECaptureImpl::GetCaptureBufferStatistics(
+    const int capture_id,
+    CaptureBufferStatistics& statistics) {
+  ViEInputManagerScoped is(*(shared_data_->input_manager()));
+  ViECapturer* vie_capture = is.Capture(capture_id);
+  if (!vie_capture) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), capture_id),
+                 "%s: Capture device %d doesn't exist", __FUNCTION__,
+                 capture_id);
+    shared_data_->SetLastError(kViECaptureDeviceDoesNotExist);
+    return -1;
+  }
+  vie_capture->GetBufferStatistics(&statistics);
+  return 0;
+}
+
+int ViECaptureImpl::GetCaptureDeliveryStatistics(
+    const int capture_id,
+    const int observer_id,
+    CaptureDeliveryStatistics& statistics) {
+  ViEInputManagerScoped is(*(shared_data_->input_manager()));
+  ViECapturer* vie_capture = is.Capture(capture_id);
+  if (!vie_capture) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), capture_id),
+                 "%s: Capture device %d doesn't exist", __FUNCTION__,
+                 capture_id);
+    shared_data_->SetLastError(kViECaptureDeviceDoesNotExist);
+    return -1;
+  }
+  FrameDeliveryStatistics delivery_statistics;
+  if (vie_capture->GetFrameDeliveryStatistics(observer_id,
+                                              &delivery_statistics) != 0) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), capture_id),
+                 "%s: %d is not connected to capture device %d", __FUNCTION__,
+                 observer_id, capture_id);
+    shared_data_->SetLastError(kViECaptureDeviceNotConnected);
+    return -1;
+  }
+  statistics.frames = delivery_statistics.frames;
+  statistics.average_delivery_time_us = 0;
+  if (delivery_statistics.frames > 0) {
+    statistics.average_delivery_time_us = static_cast<unsigned int>(
+        delivery_statistics.total_delivery_time_us /
+        delivery_statistics.frames);
+  }
+  statistics.max_delivery_time_us = delivery_statistics.max_delivery_time_us;
+  return 0;
+}
+
 }  // namespace webrtc
@@ -67,6 +67,12 @@ class ViECaptureImpl
   virtual int RegisterObserver(const int capture_id,
                                ViECaptureObserver& observer);
   virtual int DeregisterObserver(const int capture_id);
+  virtual int GetCaptureBufferStatistics(const int capture_id,
+                                         CaptureBufferStatistics& statistics);
+  virtual int GetCaptureDeliveryStatistics(
+      const int capture_id,
+      const int observer_id,
+      CaptureDeliveryStatistics& statistics);
 
  protected:
   explicit ViECaptureImpl(ViESharedData* shared_data);
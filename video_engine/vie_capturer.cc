@@ -44,6 +44,11 @@ ViECapturer::ViECapturer(int capture_id,
                                                    "ViECaptureThread")),
       capture_event_(*EventWrapper::Create()),
       deliver_event_(*EventWrapper::Create()),
+      captured_frames_head_(0),
+      captured_frames_count_(0),
+      frames_captured_(0),
+      frames_dropped_(0),
+      buffer_allocations_(0),
       effect_filter_(NULL),
       image_proc_module_(NULL),
       image_proc_module_ref_counter_(0),
@@ -52,6 +57,8 @@ ViECapturer::ViECapturer(int capture_id,
       current_brightness_level_(Normal),
       reported_brightness_level_(Normal),
       denoising_enabled_(false),
+      effect_filter_buffer_size_(0),
+      effect_filter_copies_(0),
       observer_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       observer_(NULL),
       encoding_cs_(CriticalSectionWrapper::CreateCriticalSection()),
@@ -254,6 +261,7 @@ WebRtc_Word32 ViECapturer::Start(const CaptureCapability& capture_capability) {
     capability.rawType = requested_capability_.rawType;
     capability.interlaced = requested_capability_.interlaced;
   }
+  AllocateCaptureBuffers(capability.width, capability.height);
   return capture_module_->StartCapture(capability);
 }
 
@@ -274,6 +282,26 @@ const char* ViECapturer::CurrentDeviceName() const {
   return capture_module_->CurrentDeviceName();
 }
 
+void ViECapturer::GetBufferStatistics(CaptureBufferStatistics* statistics) {
+  VideoCaptureBufferStatistics module_statistics;
+  if (capture_module_) {
+    capture_module_->GetBufferStatistics(module_statistics);
+  }
+  unsigned int effect_filter_copies = 0;
+  {
+    CriticalSectionScoped cs(deliver_cs_.get());
+    effect_filter_copies = effect_filter_copies_;
+  }
+  const unsigned int provider_copies = FrameCopies();
+  CriticalSectionScoped cs(capture_cs_.get());
+  statistics->frames_captured = frames_captured_;
+  statistics->frames_dropped = frames_dropped_;
+  statistics->buffer_allocations = buffer_allocations_ +
+      module_statistics.allocations;
+  statistics->frame_copies = module_statistics.copies + effect_filter_copies +
+      provider_copies;
+}
+
 WebRtc_Word32 ViECapturer::SetCaptureDelay(WebRtc_Word32 delay_ms) {
   return capture_module_->SetCaptureDelay(delay_ms);
 }
@@ -353,7 +381,20 @@ void ViECapturer::OnIncomingCapturedFrame(const WebRtc_Word32 capture_id,
   // is slightly off since it's being set when the frame has been received from
   // the camera, and not when the camera actually captured the frame.
   video_frame.set_render_time_ms(video_frame.render_time_ms() - FrameDelay());
-  captured_frame_.SwapFrame(&video_frame);
+  ++frames_captured_;
+  if (captured_frames_count_ == kViECaptureFrameBuffers) {
+    // The capture thread is behind, drop the oldest frame.
+    captured_frames_[captured_frames_head_].ResetSize();
+    captured_frames_head_ = (captured_frames_head_ + 1) %
+        kViECaptureFrameBuffers;
+    --captured_frames_count_;
+    ++frames_dropped_;
+  }
+  const int tail = (captured_frames_head_ + captured_frames_count_) %
+      kViECaptureFrameBuffers;
+  // Hand the buffers of the free slot back to the capture module.
+  captured_frames_[tail].SwapFrame(&video_frame);
+  ++captured_frames_count_;
   capture_event_.Set();
   return;
 }
@@ -549,11 +590,19 @@ bool ViECapturer::ViECaptureThreadFunction(void* obj) {
 bool ViECapturer::ViECaptureProcess() {
   if (capture_event_.Wait(kThreadWaitTimeMs) == kEventSignaled) {
     deliver_cs_->Enter();
-    if (!captured_frame_.IsZeroSize()) {
-      // New I420 frame.
+    while (true) {
       capture_cs_->Enter();
-      deliver_frame_.SwapFrame(&captured_frame_);
-      captured_frame_.ResetSize();
+      if (captured_frames_count_ == 0) {
+        capture_cs_->Leave();
+        break;
+      }
+      // New I420 frame.
+      I420VideoFrame* captured_frame = &captured_frames_[captured_frames_head_];
+      deliver_frame_.SwapFrame(captured_frame);
+      captured_frame->ResetSize();
+      captured_frames_head_ = (captured_frames_head_ + 1) %
+          kViECaptureFrameBuffers;
+      --captured_frames_count_;
       capture_cs_->Leave();
       DeliverI420Frame(&deliver_frame_);
     }
@@ -578,6 +627,33 @@ bool ViECapturer::ViECaptureProcess() {
   return true;
 }
 
+void ViECapturer::AllocateCaptureBuffers(int width, int height) {
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  const int half_width = (width + 1) / 2;
+  const int size_y = width * height;
+  CriticalSectionScoped deliver_cs(deliver_cs_.get());
+  CriticalSectionScoped cs(capture_cs_.get());
+  I420VideoFrame* frames[kViECaptureFrameBuffers + 1];
+  for (int i = 0; i < kViECaptureFrameBuffers; ++i) {
+    frames[i] = &captured_frames_[i];
+  }
+  frames[kViECaptureFrameBuffers] = &deliver_frame_;
+  for (int i = 0; i <= kViECaptureFrameBuffers; ++i) {
+    if (frames[i]->allocated_size(kYPlane) >= size_y) {
+      continue;
+    }
+    // Queued frames keep their content, only empty slots are allocated.
+    if (!frames[i]->IsZeroSize()) {
+      continue;
+    }
+    frames[i]->CreateEmptyFrame(width, height, width, half_width, half_width);
+    frames[i]->ResetSize();
+    ++buffer_allocations_;
+  }
+}
+
 void ViECapturer::DeliverI420Frame(I420VideoFrame* video_frame) {
   // Apply image enhancement and effect filter.
   if (deflicker_frame_stats_) {
@@ -619,9 +695,15 @@ void ViECapturer::DeliverI420Frame(I420VideoFrame* video_frame) {
     unsigned int length = CalcBufferSize(kI420,
                                          video_frame->width(),
                                          video_frame->height());
-    scoped_array<uint8_t> video_buffer(new uint8_t[length]);
-    ExtractBuffer(*video_frame, length, video_buffer.get());
-    effect_filter_->Transform(length, video_buffer.get(),
+    if (length > effect_filter_buffer_size_) {
+      effect_filter_buffer_.reset(new uint8_t[length]);
+      effect_filter_buffer_size_ = length;
+      CriticalSectionScoped cs(capture_cs_.get());
+      ++buffer_allocations_;
+    }
+    ExtractBuffer(*video_frame, length, effect_filter_buffer_.get());
+    ++effect_filter_copies_;
+    effect_filter_->Transform(length, effect_filter_buffer_.get(),
                               video_frame->timestamp(), video_frame->width(),
                               video_frame->height());
   }
@@ -105,6 +105,9 @@ class ViECapturer
   // Information.
   const char* CurrentDeviceName() const;
 
+  // Gets the buffer counters of this capture device.
+  void GetBufferStatistics(CaptureBufferStatistics* statistics);
+
  protected:
   ViECapturer(int capture_id,
               int engine_id,
@@ -171,6 +174,9 @@ class ViECapturer
   void DeliverCodedFrame(VideoFrame* video_frame);
 
  private:
+  // Allocates the capture buffers for frames of |width| x |height|.
+  void AllocateCaptureBuffers(int width, int height);
+
   // Never take capture_cs_ before deliver_cs_!
   scoped_ptr<CriticalSectionWrapper> capture_cs_;
   scoped_ptr<CriticalSectionWrapper> deliver_cs_;
@@ -184,7 +190,16 @@ class ViECapturer
   EventWrapper& capture_event_;
   EventWrapper& deliver_event_;
 
-  I420VideoFrame captured_frame_;
+  // Ring of captured frames waiting for the capture thread, oldest at
+  // |captured_frames_head_|. Captured frames are swapped in and out of the
+  // ring, so the buffers are recycled between the capture module, the ring
+  // and |deliver_frame_| without any copies. Protected by |capture_cs_|.
+  I420VideoFrame captured_frames_[kViECaptureFrameBuffers];
+  int captured_frames_head_;
+  int captured_frames_count_;
+  unsigned int frames_captured_;
+  unsigned int frames_dropped_;
+  unsigned int buffer_allocations_;
   I420VideoFrame deliver_frame_;
   VideoFrame deliver_encoded_frame_;
   VideoFrame encoded_frame_;
@@ -198,6 +213,10 @@ class ViECapturer
   Brightness current_brightness_level_;
   Brightness reported_brightness_level_;
   bool denoising_enabled_;
+  // Buffer for effect filters, protected by |deliver_cs_|.
+  scoped_array<uint8_t> effect_filter_buffer_;
+  unsigned int effect_filter_buffer_size_;
+  unsigned int effect_filter_copies_;
 
   // Statistics observer.
   scoped_ptr<CriticalSectionWrapper> observer_cs_;
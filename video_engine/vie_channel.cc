@@ -77,6 +77,7 @@ ViEChannel::ViEChannel(WebRtc_Word32 channel_id,
           ViEModuleId(engine_id, channel_id), num_socket_threads_)),
 #endif
       vcm_(*VideoCodingModule::Create(ViEModuleId(engine_id, channel_id))),
+      rtp_forwarder_(ViEModuleId(engine_id, channel_id)),
       vie_receiver_(channel_id, &vcm_, remote_bitrate_estimator),
       vie_sender_(channel_id),
       vie_sync_(&vcm_, this),
@@ -126,6 +127,8 @@ ViEChannel::ViEChannel(WebRtc_Word32 channel_id,
 
   rtp_rtcp_.reset(RtpRtcp::CreateRtpRtcp(configuration));
   vie_receiver_.SetRtpRtcpModule(rtp_rtcp_.get());
+  vie_receiver_.SetRtpForwarder(&rtp_forwarder_);
+  rtp_forwarder_.SetRtpRtcpModule(rtp_rtcp_.get());
   vcm_.SetNackSettings(kMaxNackListSize, max_nack_reordering_threshold_);
 }
 
@@ -1288,6 +1291,51 @@ WebRtc_Word32 ViEChannel::StopRTPDump(RTPDirections direction) {
   }
 }
 
+WebRtc_Word32 ViEChannel::StartRTPForwarding(ViEChannel* destination,
+                                             bool decode) {
+  WEBRTC_TRACE(kTraceInfo, kTraceVideo, ViEId(engine_id_, channel_id_),
+               "%s(destination: %d, decode: %d)", __FUNCTION__,
+               destination->channel_id_, decode);
+  if (destination == this) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo, ViEId(engine_id_, channel_id_),
+                 "%s: can't forward to the receiving channel", __FUNCTION__);
+    return -1;
+  }
+  const int destination_id =
+      ViEModuleId(destination->engine_id_, destination->channel_id_);
+  if (!destination->vie_receiver_.SetForwardingSource(&rtp_forwarder_,
+                                                      destination_id)) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo, ViEId(engine_id_, channel_id_),
+                 "%s: destination already receives a forwarded stream",
+                 __FUNCTION__);
+    return -1;
+  }
+  if (rtp_forwarder_.AddDestination(&destination->vie_sender_,
+                                    destination_id,
+                                    destination->rtp_rtcp_.get(),
+                                    decode) != 0) {
+    destination->vie_receiver_.SetForwardingSource(NULL, -1);
+    return -1;
+  }
+  return 0;
+}
+
+WebRtc_Word32 ViEChannel::StopRTPForwarding(ViEChannel* destination) {
+  WEBRTC_TRACE(kTraceInfo, kTraceVideo, ViEId(engine_id_, channel_id_),
+               "%s(destination: %d)", __FUNCTION__, destination->channel_id_);
+  if (rtp_forwarder_.RemoveDestination(&destination->vie_sender_) != 0) {
+    return -1;
+  }
+  // Returns once the destination doesn't pass RTCP to the forwarder.
+  destination->vie_receiver_.SetForwardingSource(NULL, -1);
+  return 0;
+}
+
+void ViEChannel::GetRTPForwardingStatistics(
+    unsigned int* packets_forwarded, unsigned int* bytes_forwarded) const {
+  rtp_forwarder_.GetStatistics(packets_forwarded, bytes_forwarded);
+}
+
 WebRtc_Word32 ViEChannel::SetLocalReceiver(const WebRtc_UWord16 rtp_port,
                                            const WebRtc_UWord16 rtcp_port,
                                            const char* ip_address) {
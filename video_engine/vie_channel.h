@@ -26,6 +26,7 @@
 #include "video_engine/vie_file_recorder.h"
 #include "video_engine/vie_frame_provider_base.h"
 #include "video_engine/vie_receiver.h"
+#include "video_engine/vie_rtp_forwarder.h"
 #include "video_engine/vie_sender.h"
 #include "video_engine/vie_sync_module.h"
 
@@ -188,6 +189,15 @@ class ViEChannel
                              RTPDirections direction);
   WebRtc_Word32 StopRTPDump(RTPDirections direction);
 
+  // Forwards received RTP packets to the transport of |destination|, with the
+  // send SSRC of |destination|, and answers the RTCP feedback |destination|
+  // receives for them. This channel decodes the forwarded packets as long as
+  // one of its destinations was added with |decode| true.
+  WebRtc_Word32 StartRTPForwarding(ViEChannel* destination, bool decode);
+  WebRtc_Word32 StopRTPForwarding(ViEChannel* destination);
+  void GetRTPForwardingStatistics(unsigned int* packets_forwarded,
+                                  unsigned int* bytes_forwarded) const;
+
   // Implements RtcpFeedback.
   // TODO(pwestin) Depricate this functionality.
   virtual void OnApplicationDataReceived(const WebRtc_Word32 id,
@@ -388,6 +398,7 @@ class ViEChannel
   UdpTransport& socket_transport_;
 #endif
   VideoCodingModule& vcm_;
+  ViERtpForwarder rtp_forwarder_;
   ViEReceiver vie_receiver_;
   ViESender vie_sender_;
   ViESyncModule vie_sync_;
@@ -231,6 +231,13 @@ int ViEChannelManager::DeleteChannel(int channel_id) {
     vie_channel = c_it->second;
     channel_map_.erase(c_it);
 
+    // Stop forwarding packets to and from the channel.
+    for (ChannelMap::iterator it = channel_map_.begin();
+         it != channel_map_.end(); ++it) {
+      it->second->StopRTPForwarding(vie_channel);
+      vie_channel->StopRTPForwarding(it->second);
+    }
+
     ReturnChannelId(channel_id);
 
     // Find the encoder object.
@@ -689,6 +689,56 @@ int ViECodecImpl::SendKeyFrame(const int video_channel) {
   return 0;
 }
 
+int ViECodecImpl::SetKeyFrameRequestPolicy(const int video_channel,
+                                           const int min_interval_ms,
+                                           const bool reference_recovery) {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo, ViEId(shared_data_->instance_id()),
+               "%s(video_channel: %d, min_interval_ms: %d, "
+               "reference_recovery: %d)", __FUNCTION__, video_channel,
+               min_interval_ms, reference_recovery);
+  if (min_interval_ms < 0) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: Invalid interval %d", __FUNCTION__, min_interval_ms);
+    shared_data_->SetLastError(kViECodecInvalidArgument);
+    return -1;
+  }
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEEncoder* vie_encoder = cs.Encoder(video_channel);
+  if (!vie_encoder) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: No channel %d", __FUNCTION__, video_channel);
+    shared_data_->SetLastError(kViECodecInvalidChannelId);
+    return -1;
+  }
+  vie_encoder->SetKeyFrameRequestPolicy(min_interval_ms, reference_recovery);
+  return 0;
+}
+
+int ViECodecImpl::GetKeyFrameRequestStatistics(
+    const int video_channel,
+    unsigned int& requests_received,
+    unsigned int& requests_suppressed,
+    unsigned int& refresh_frames) const {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo, ViEId(shared_data_->instance_id()),
+               "%s(video_channel: %d)", __FUNCTION__, video_channel);
+
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEEncoder* vie_encoder = cs.Encoder(video_channel);
+  if (!vie_encoder) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: No channel %d", __FUNCTION__, video_channel);
+    shared_data_->SetLastError(kViECodecInvalidChannelId);
+    return -1;
+  }
+  vie_encoder->GetKeyFrameRequestStatistics(&requests_received,
+                                            &requests_suppressed,
+                                            &refresh_frames);
+  return 0;
+}
+
 int ViECodecImpl::WaitForFirstKeyFrame(const int video_channel,
                                        const bool wait) {
   WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
@@ -712,6 +762,62 @@ int ViECodecImpl::WaitForFirstKeyFrame(const int video_channel,
   return 0;
 }
 
+int ViECodecImpl::SetEncoderPipelineStatus(const int video_channel,
+                                           const bool enable,
+                                           const int queue_size) {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
+               ViEId(shared_data_->instance_id(), video_channel),
+               "%s(video_channel: %d, enable: %d, queue_size: %d)",
+               __FUNCTION__, video_channel, enable, queue_size);
+
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEEncoder* vie_encoder = cs.Encoder(video_channel);
+  if (!vie_encoder) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: No encoder for channel %d", __FUNCTION__,
+                 video_channel);
+    shared_data_->SetLastError(kViECodecInvalidChannelId);
+    return -1;
+  }
+  if (enable && queue_size <= 0) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: Invalid queue size %d", __FUNCTION__, queue_size);
+    shared_data_->SetLastError(kViECodecInvalidArgument);
+    return -1;
+  }
+  if (vie_encoder->SetPipelineStatus(enable, queue_size) != 0) {
+    shared_data_->SetLastError(kViECodecUnknownError);
+    return -1;
+  }
+  return 0;
+}
+
+int ViECodecImpl::GetEncoderPipelineStatistics(
+    const int video_channel,
+    EncoderPipelineStatistics& statistics) const {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
+               ViEId(shared_data_->instance_id(), video_channel),
+               "%s(video_channel: %d)", __FUNCTION__, video_channel);
+
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEEncoder* vie_encoder = cs.Encoder(video_channel);
+  if (!vie_encoder) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: No encoder for channel %d", __FUNCTION__,
+                 video_channel);
+    shared_data_->SetLastError(kViECodecInvalidChannelId);
+    return -1;
+  }
+  if (vie_encoder->PipelineStatistics(&statistics) != 0) {
+    shared_data_->SetLastError(kViECodecUnknownError);
+    return -1;
+  }
+  return 0;
+}
+
 bool ViECodecImpl::CodecValid(const VideoCodec& video_codec) {
   // Check pl_name matches codec_type.
   if (video_codec.codecType == kVideoCodecRED) {
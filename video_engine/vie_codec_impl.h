@@ -66,7 +66,20 @@ class ViECodecImpl
                                       ViEDecoderObserver& observer);
   virtual int DeregisterDecoderObserver(const int video_channel);
   virtual int SendKeyFrame(const int video_channel);
+  virtual int SetKeyFrameRequestPolicy(const int video_channel,
+                                       const int min_interval_ms,
+                                       const bool reference_recovery);
+  virtual int GetKeyFrameRequestStatistics(const int video_channel,
+                                           unsigned int& requests_received,
+                                           unsigned int& requests_suppressed,
+                                           unsigned int& refresh_frames) const;
   virtual int WaitForFirstKeyFrame(const int video_channel, const bool wait);
+  virtual int SetEncoderPipelineStatus(const int video_channel,
+                                       const bool enable,
+                                       const int queue_size = 2);
+  virtual int GetEncoderPipelineStatistics(
+      const int video_channel,
+      EncoderPipelineStatistics& statistics) const;
 
  protected:
   explicit ViECodecImpl(ViESharedData* shared_data);
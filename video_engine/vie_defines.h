@@ -44,6 +44,8 @@ enum { kViECaptureDefaultWidth = 352 };
 enum { kViECaptureDefaultHeight = 288 };
 enum { kViECaptureDefaultFramerate = 30 };
 enum { kViECaptureMaxSnapshotWaitTimeMs = 500 };
+// Captured frames queued for the capture thread before the oldest is dropped.
+enum { kViECaptureFrameBuffers = 3 };
 
 // ViECodec
 enum { kViEMaxCodecWidth = 4096 };
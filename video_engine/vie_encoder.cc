@@ -26,6 +26,7 @@
 #include "video_engine/include/vie_codec.h"
 #include "video_engine/include/vie_image_process.h"
 #include "video_engine/vie_defines.h"
+#include "video_engine/vie_encoder_pipeline.h"
 
 namespace webrtc {
 
@@ -82,6 +83,41 @@ class ViEPacedSenderCallback : public PacedSender::Callback {
   ViEEncoder* owner_;
 };
 
+class ViEPipelineHandler : public ViEEncoderPipeline::Handler {
+ public:
+  explicit ViEPipelineHandler(ViEEncoder* owner)
+      : owner_(owner) {
+  }
+  // Implements ViEEncoderPipeline::Handler.
+  virtual bool PreprocessFrame(I420VideoFrame* frame,
+                               I420VideoFrame** output,
+                               const VideoContentMetrics** content_metrics) {
+    if (!owner_->PreprocessFrame(frame, output)) {
+      return false;
+    }
+    *content_metrics = owner_->vpm_.ContentMetrics();
+    return true;
+  }
+  virtual void EncodeFrame(const I420VideoFrame& frame,
+                           const VideoContentMetrics* content_metrics) {
+    owner_->EncodeFrame(frame, content_metrics);
+  }
+  virtual void SendEncodedFrame(
+      const ViEEncoderPipeline::EncodedFrame& frame) {
+    owner_->default_rtp_rtcp_->SendOutgoingData(
+        frame.frame_type,
+        frame.payload_type,
+        frame.time_stamp,
+        frame.capture_time_ms,
+        frame.payload.empty() ? NULL : &frame.payload[0],
+        static_cast<WebRtc_UWord32>(frame.payload.size()),
+        &frame.fragmentation,
+        frame.has_video_header ? &frame.video_header : NULL);
+  }
+ private:
+  ViEEncoder* owner_;
+};
+
 ViEEncoder::ViEEncoder(WebRtc_Word32 engine_id,
                        WebRtc_Word32 channel_id,
                        WebRtc_UWord32 number_of_cores,
@@ -97,6 +133,8 @@ ViEEncoder::ViEEncoder(WebRtc_Word32 engine_id,
     default_rtp_rtcp_(NULL),
     callback_cs_(CriticalSectionWrapper::CreateCriticalSection()),
     data_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+    pipeline_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+    packetize_pipeline_(NULL),
     bitrate_controller_(bitrate_controller),
     target_delay_ms_(0),
     network_is_transmitting_(true),
@@ -127,6 +165,7 @@ ViEEncoder::ViEEncoder(WebRtc_Word32 engine_id,
   bitrate_observer_.reset(new ViEBitrateObserver(this));
   pacing_callback_.reset(new ViEPacedSenderCallback(this));
   paced_sender_.reset(new PacedSender(pacing_callback_.get(), kInitialPace));
+  pipeline_handler_.reset(new ViEPipelineHandler(this));
 }
 
 bool ViEEncoder::Init() {
@@ -218,6 +257,7 @@ ViEEncoder::~ViEEncoder() {
   WEBRTC_TRACE(webrtc::kTraceMemory, webrtc::kTraceVideo,
                ViEId(engine_id_, channel_id_),
                "ViEEncoder Destructor 0x%p, engine_id: %d", this, engine_id_);
+  SetPipelineStatus(false, 0);
   if (bitrate_controller_) {
     bitrate_controller_->RemoveBitrateObserver(bitrate_observer_.get());
   }
@@ -549,12 +589,32 @@ void ViEEncoder::DeliverFrame(int id,
     }
     default_rtp_rtcp_->SetCSRCs(tempCSRC, (WebRtc_UWord8) num_csrcs);
   }
-  // Pass frame via preprocessor.
+  CriticalSectionScoped cs(pipeline_cs_.get());
+  if (pipeline_.get()) {
+    if (!pipeline_->InsertFrame(*video_frame)) {
+      WEBRTC_TRACE(webrtc::kTraceStream,
+                   webrtc::kTraceVideo,
+                   ViEId(engine_id_, channel_id_),
+                   "%s: Pipeline full, dropping frame %u", __FUNCTION__,
+                   video_frame->timestamp());
+    }
+    return;
+  }
   I420VideoFrame* decimated_frame = NULL;
-  const int ret = vpm_.PreprocessFrame(*video_frame, &decimated_frame);
+  if (!PreprocessFrame(video_frame, &decimated_frame)) {
+    return;
+  }
+  EncodeFrame(*decimated_frame, vpm_.ContentMetrics());
+}
+
+bool ViEEncoder::PreprocessFrame(I420VideoFrame* video_frame,
+                                 I420VideoFrame** decimated_frame) {
+  // Pass frame via preprocessor.
+  *decimated_frame = NULL;
+  const int ret = vpm_.PreprocessFrame(*video_frame, decimated_frame);
   if (ret == 1) {
     // Drop this frame.
-    return;
+    return false;
   }
   if (ret != VPM_OK) {
     WEBRTC_TRACE(webrtc::kTraceError,
@@ -562,12 +622,17 @@ void ViEEncoder::DeliverFrame(int id,
                  ViEId(engine_id_, channel_id_),
                  "%s: Error preprocessing frame %u", __FUNCTION__,
                  video_frame->timestamp());
-    return;
+    return false;
   }
   // Frame was not sampled => use original.
-  if (decimated_frame == NULL)  {
-    decimated_frame = video_frame;
+  if (*decimated_frame == NULL)  {
+    *decimated_frame = video_frame;
   }
+  return true;
+}
+
+void ViEEncoder::EncodeFrame(const I420VideoFrame& video_frame,
+                             const VideoContentMetrics* content_metrics) {
 #ifdef VIDEOCODEC_VP8
   if (vcm_.SendCodec() == webrtc::kVideoCodecVP8) {
     webrtc::CodecSpecificInfo codec_specific_info;
@@ -583,24 +648,24 @@ void ViEEncoder::DeliverFrame(int id,
     has_received_sli_ = false;
     has_received_rpsi_ = false;
 
-    if (vcm_.AddVideoFrame(*decimated_frame,
-                           vpm_.ContentMetrics(),
+    if (vcm_.AddVideoFrame(video_frame,
+                           content_metrics,
                            &codec_specific_info) != VCM_OK) {
       WEBRTC_TRACE(webrtc::kTraceError,
                    webrtc::kTraceVideo,
                    ViEId(engine_id_, channel_id_),
                    "%s: Error encoding frame %u", __FUNCTION__,
-                   video_frame->timestamp());
+                   video_frame.timestamp());
     }
     return;
   }
 #endif
-  if (vcm_.AddVideoFrame(*decimated_frame) != VCM_OK) {
+  if (vcm_.AddVideoFrame(video_frame) != VCM_OK) {
     WEBRTC_TRACE(webrtc::kTraceError,
                  webrtc::kTraceVideo,
                  ViEId(engine_id_, channel_id_),
                  "%s: Error encoding frame %u", __FUNCTION__,
-                 video_frame->timestamp());
+                 video_frame.timestamp());
   }
 }
 
@@ -740,6 +805,50 @@ WebRtc_Word32 ViEEncoder::UpdateProtectionMethod() {
   return 0;
 }
 
+int ViEEncoder::SetPipelineStatus(bool enable, int queue_size) {
+  WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceVideo,
+               ViEId(engine_id_, channel_id_), "%s(%d, %d)", __FUNCTION__,
+               enable, queue_size);
+
+  // Blocks DeliverFrame() until the switch is done, so that no frame passes
+  // the frames still in the pipeline.
+  CriticalSectionScoped cs(pipeline_cs_.get());
+  if (pipeline_.get()) {
+    pipeline_->Stop();
+    {
+      CriticalSectionScoped data_cs(data_cs_.get());
+      packetize_pipeline_ = NULL;
+    }
+    pipeline_.reset();
+  }
+  if (!enable) {
+    return 0;
+  }
+  pipeline_.reset(new ViEEncoderPipeline(ViEId(engine_id_, channel_id_),
+                                         pipeline_handler_.get(),
+                                         queue_size));
+  if (!pipeline_->Start()) {
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo,
+                 ViEId(engine_id_, channel_id_),
+                 "%s: Could not start the encoder pipeline", __FUNCTION__);
+    pipeline_.reset();
+    return -1;
+  }
+  CriticalSectionScoped data_cs(data_cs_.get());
+  packetize_pipeline_ = pipeline_.get();
+  return 0;
+}
+
+int ViEEncoder::PipelineStatistics(
+    EncoderPipelineStatistics* statistics) const {
+  CriticalSectionScoped cs(pipeline_cs_.get());
+  if (!pipeline_.get()) {
+    return -1;
+  }
+  pipeline_->GetStatistics(statistics);
+  return 0;
+}
+
 void ViEEncoder::SetSenderBufferingMode(int target_delay_ms) {
   {
     CriticalSectionScoped cs(data_cs_.get());
@@ -778,6 +887,15 @@ WebRtc_Word32 ViEEncoder::SendData(
                    "%s: Sending key frame, drop next frame", __FUNCTION__);
       drop_next_frame_ = true;
     }
+    if (packetize_pipeline_) {
+      // Packetization and FEC is done on the pipeline thread.
+      packetize_pipeline_->InsertEncodedFrame(frame_type, payload_type,
+                                              time_stamp, capture_time_ms,
+                                              payload_data, payload_size,
+                                              fragmentation_header,
+                                              rtp_video_hdr);
+      return 0;
+    }
   }
 
   // New encoded data, hand over to the rtp module.
@@ -871,8 +989,12 @@ void ViEEncoder::OnReceivedSLI(uint32_t /*ssrc*/,
   has_received_sli_ = true;
 }
 
-void ViEEncoder::OnReceivedRPSI(uint32_t /*ssrc*/,
+void ViEEncoder::OnReceivedRPSI(uint32_t ssrc,
                                 uint64_t picture_id) {
+  {
+    CriticalSectionScoped cs(data_cs_.get());
+    key_frame_requests_.OnReceivedRPSI(ssrc);
+  }
   picture_id_rpsi_ = picture_id;
   has_received_rpsi_ = true;
 }
@@ -882,6 +1004,14 @@ void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
   WEBRTC_TRACE(webrtc::kTraceStateInfo, webrtc::kTraceVideo,
                ViEId(engine_id_, channel_id_), "%s", __FUNCTION__);
 
+  // Only VP8 in feedback mode can recover from an acknowledged reference,
+  // any other encoder has to answer with a key frame.
+  VideoCodec send_codec;
+  const bool refresh_frame_possible =
+      vcm_.SendCodec(&send_codec) == VCM_OK &&
+      send_codec.codecType == kVideoCodecVP8 &&
+      send_codec.codecSpecific.VP8.feedbackModeOn;
+
   int idx = 0;
   {
     CriticalSectionScoped cs(data_cs_.get());
@@ -891,20 +1021,21 @@ void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
                         << ssrc_streams_.size();
       return;
     }
-    std::map<unsigned int, WebRtc_Word64>::iterator time_it =
-        time_last_intra_request_ms_.find(ssrc);
-    if (time_it == time_last_intra_request_ms_.end()) {
-      time_last_intra_request_ms_[ssrc] = 0;
-    }
-
-    WebRtc_Word64 now = TickTime::MillisecondTimestamp();
-    if (time_last_intra_request_ms_[ssrc] + kViEMinKeyRequestIntervalMs > now) {
-      WEBRTC_TRACE(webrtc::kTraceStream, webrtc::kTraceVideo,
-                   ViEId(engine_id_, channel_id_),
-                   "%s: Not encoding new intra due to timing", __FUNCTION__);
-      return;
+    switch (key_frame_requests_.OnKeyFrameRequest(
+        ssrc, TickTime::MillisecondTimestamp(), refresh_frame_possible)) {
+      case KeyFrameRequestAggregator::kSuppressRequest:
+        WEBRTC_TRACE(webrtc::kTraceStream, webrtc::kTraceVideo,
+                     ViEId(engine_id_, channel_id_),
+                     "%s: Not encoding new intra due to timing", __FUNCTION__);
+        return;
+      case KeyFrameRequestAggregator::kSendRefreshFrame:
+        // Recover from the acknowledged reference, the same way as for a
+        // slice loss indication.
+        has_received_sli_ = true;
+        return;
+      case KeyFrameRequestAggregator::kSendKeyFrame:
+        break;
     }
-    time_last_intra_request_ms_[ssrc] = now;
     idx = stream_it->second;
   }
   // Release the critsect before triggering key frame.
@@ -920,15 +1051,7 @@ void ViEEncoder::OnLocalSsrcChanged(uint32_t old_ssrc, uint32_t new_ssrc) {
 
   ssrc_streams_[new_ssrc] = it->second;
   ssrc_streams_.erase(it);
-
-  std::map<unsigned int, int64_t>::iterator time_it =
-      time_last_intra_request_ms_.find(old_ssrc);
-  int64_t last_intra_request_ms = 0;
-  if (time_it != time_last_intra_request_ms_.end()) {
-    last_intra_request_ms = time_it->second;
-    time_last_intra_request_ms_.erase(time_it);
-  }
-  time_last_intra_request_ms_[new_ssrc] = last_intra_request_ms;
+  key_frame_requests_.OnSsrcChanged(old_ssrc, new_ssrc);
 }
 
 bool ViEEncoder::SetSsrcs(const std::list<unsigned int>& ssrcs) {
@@ -943,7 +1066,7 @@ bool ViEEncoder::SetSsrcs(const std::list<unsigned int>& ssrcs) {
 
   CriticalSectionScoped cs(data_cs_.get());
   ssrc_streams_.clear();
-  time_last_intra_request_ms_.clear();
+  key_frame_requests_.Reset();
   int idx = 0;
   for (std::list<unsigned int>::const_iterator it = ssrcs.begin();
        it != ssrcs.end(); ++it, ++idx) {
@@ -953,6 +1076,21 @@ bool ViEEncoder::SetSsrcs(const std::list<unsigned int>& ssrcs) {
   return true;
 }
 
+void ViEEncoder::SetKeyFrameRequestPolicy(int min_interval_ms,
+                                          bool reference_recovery) {
+  CriticalSectionScoped cs(data_cs_.get());
+  key_frame_requests_.SetPolicy(min_interval_ms, reference_recovery);
+}
+
+void ViEEncoder::GetKeyFrameRequestStatistics(
+    unsigned int* requests_received,
+    unsigned int* requests_suppressed,
+    unsigned int* refresh_frames) {
+  CriticalSectionScoped cs(data_cs_.get());
+  key_frame_requests_.GetStatistics(requests_received, requests_suppressed,
+                                    refresh_frames);
+}
+
 // Called from ViEBitrateObserver.
 void ViEEncoder::OnNetworkChanged(const uint32_t bitrate_bps,
                                   const uint8_t fraction_lost,
@@ -21,6 +21,7 @@
 #include "modules/video_coding/main/interface/video_coding_defines.h"
 #include "modules/video_processing/main/interface/video_processing.h"
 #include "system_wrappers/interface/scoped_ptr.h"
+#include "video_engine/key_frame_request_aggregator.h"
 #include "video_engine/vie_defines.h"
 #include "video_engine/vie_file_recorder.h"
 #include "video_engine/vie_frame_provider_base.h"
@@ -36,7 +37,10 @@ class VideoCodingModule;
 class ViEBitrateObserver;
 class ViEEffectFilter;
 class ViEEncoderObserver;
+class ViEEncoderPipeline;
 class ViEPacedSenderCallback;
+class ViEPipelineHandler;
+struct EncoderPipelineStatistics;
 
 class ViEEncoder
     : public RtcpIntraFrameObserver,
@@ -47,6 +51,7 @@ class ViEEncoder
  public:
   friend class ViEBitrateObserver;
   friend class ViEPacedSenderCallback;
+  friend class ViEPipelineHandler;
 
   ViEEncoder(WebRtc_Word32 engine_id,
              WebRtc_Word32 channel_id,
@@ -103,6 +108,11 @@ class ViEEncoder
   virtual void ProviderDestroyed(int id) {
     return;
   }
+  // The frame is only read, apart from setting the RTP timestamp, which is
+  // derived from the render time and is the same for all consumers.
+  virtual bool ModifiesFrame() {
+    return false;
+  }
 
   WebRtc_Word32 SendKeyFrame();
   WebRtc_Word32 SendCodecStatistics(WebRtc_UWord32* num_key_frames,
@@ -118,6 +128,10 @@ class ViEEncoder
   // Buffering mode.
   void SetSenderBufferingMode(int target_delay_ms);
 
+  // Pipelined encoding, see ViECodec::SetEncoderPipelineStatus().
+  int SetPipelineStatus(bool enable, int queue_size);
+  int PipelineStatistics(EncoderPipelineStatistics* statistics) const;
+
   // Implements VCMPacketizationCallback.
   virtual WebRtc_Word32 SendData(
     FrameType frame_type,
@@ -151,6 +165,13 @@ class ViEEncoder
   // Sets SSRCs for all streams.
   bool SetSsrcs(const std::list<unsigned int>& ssrcs);
 
+  // Sets how key frame requests from the remote side are answered, see
+  // KeyFrameRequestAggregator.
+  void SetKeyFrameRequestPolicy(int min_interval_ms, bool reference_recovery);
+  void GetKeyFrameRequestStatistics(unsigned int* requests_received,
+                                    unsigned int* requests_suppressed,
+                                    unsigned int* refresh_frames);
+
   // Effect filter.
   WebRtc_Word32 RegisterEffectFilter(ViEEffectFilter* effect_filter);
 
@@ -174,6 +195,13 @@ class ViEEncoder
   void TimeToSendPacket(uint32_t ssrc, uint16_t sequence_number,
                         int64_t capture_time_ms);
 
+  // Called by ViEPipelineHandler, or directly by DeliverFrame() when the
+  // pipeline is disabled. Returns false if the frame should be dropped.
+  bool PreprocessFrame(I420VideoFrame* video_frame,
+                       I420VideoFrame** decimated_frame);
+  void EncodeFrame(const I420VideoFrame& video_frame,
+                   const VideoContentMetrics* content_metrics);
+
  private:
   bool EncoderPaused() const;
 
@@ -189,13 +217,22 @@ class ViEEncoder
   scoped_ptr<BitrateObserver> bitrate_observer_;
   scoped_ptr<PacedSender> paced_sender_;
   scoped_ptr<ViEPacedSenderCallback> pacing_callback_;
+  // Held while a frame is passed on from DeliverFrame() and while the
+  // pipeline is enabled or disabled, to keep the frames in order.
+  scoped_ptr<CriticalSectionWrapper> pipeline_cs_;
+  scoped_ptr<ViEPipelineHandler> pipeline_handler_;
+  scoped_ptr<ViEEncoderPipeline> pipeline_;
+  // The pipeline SendData() hands the encoded frames to, protected by
+  // |data_cs_|.
+  ViEEncoderPipeline* packetize_pipeline_;
 
   BitrateController* bitrate_controller_;
 
   int target_delay_ms_;
   bool network_is_transmitting_;
   bool encoder_paused_;
-  std::map<unsigned int, int64_t> time_last_intra_request_ms_;
+  // Protected by |data_cs_|.
+  KeyFrameRequestAggregator key_frame_requests_;
   WebRtc_Word32 channels_dropping_delta_frames_;
   bool drop_next_frame_;
 
@@ -0,0 +1,352 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video_engine/vie_encoder_pipeline.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+#include "system_wrappers/interface/tick_util.h"
+#include "system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+// Max time to wait for a new frame before checking if the thread is stopped.
+static const int kThreadWaitTimeMs = 100;
+// Max time to wait for the queued frames to be processed when stopping.
+static const int kStopTimeoutMs = 2000;
+
+ViEEncoderPipeline::EncodedFrame::EncodedFrame()
+    : frame_type(kVideoFrameDelta),
+      payload_type(0),
+      time_stamp(0),
+      capture_time_ms(0),
+      has_video_header(false),
+      insert_time_us(0) {
+  memset(&video_header, 0, sizeof(video_header));
+}
+
+void ViEEncoderPipeline::StageCounters::Update(int64_t queue_time_us,
+                                               int64_t process_time_us) {
+  ++frames;
+  total_queue_time_us += queue_time_us;
+  total_process_time_us += process_time_us;
+  if (process_time_us > max_process_time_us) {
+    max_process_time_us = process_time_us;
+  }
+}
+
+void ViEEncoderPipeline::StageCounters::GetStatistics(
+    EncoderPipelineStageStatistics* statistics) const {
+  statistics->frames = frames;
+  if (frames == 0) {
+    statistics->average_queue_time_us = 0;
+    statistics->average_process_time_us = 0;
+  } else {
+    statistics->average_queue_time_us =
+        static_cast<unsigned int>(total_queue_time_us / frames);
+    statistics->average_process_time_us =
+        static_cast<unsigned int>(total_process_time_us / frames);
+  }
+  statistics->max_process_time_us =
+      static_cast<unsigned int>(max_process_time_us);
+}
+
+ViEEncoderPipeline::ViEEncoderPipeline(int id, Handler* handler,
+                                       int queue_size)
+    : id_(id),
+      handler_(handler),
+      queue_size_(queue_size > 0 ? queue_size : 1),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      preprocess_thread_(ThreadWrapper::CreateThread(PreprocessThreadFunction,
+                                                     this, kHighPriority,
+                                                     "ViEPreprocessThread")),
+      encode_thread_(ThreadWrapper::CreateThread(EncodeThreadFunction, this,
+                                                 kHighPriority,
+                                                 "ViEEncodeThread")),
+      packetize_thread_(ThreadWrapper::CreateThread(PacketizeThreadFunction,
+                                                    this, kHighPriority,
+                                                    "ViEPacketizeThread")),
+      preprocess_event_(EventWrapper::Create()),
+      encode_event_(EventWrapper::Create()),
+      packetize_event_(EventWrapper::Create()),
+      idle_event_(EventWrapper::Create()),
+      started_(false),
+      pending_frames_(0),
+      dropped_frames_(0) {
+}
+
+ViEEncoderPipeline::~ViEEncoderPipeline() {
+  Stop();
+  while (!free_frames_.empty()) {
+    delete free_frames_.front();
+    free_frames_.pop_front();
+  }
+  while (!free_encoded_frames_.empty()) {
+    delete free_encoded_frames_.front();
+    free_encoded_frames_.pop_front();
+  }
+}
+
+bool ViEEncoderPipeline::Start() {
+  unsigned int thread_id = 0;
+  started_ = true;
+  if (!preprocess_thread_->Start(thread_id) ||
+      !encode_thread_->Start(thread_id) ||
+      !packetize_thread_->Start(thread_id)) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo, id_,
+                 "%s: Could not start the pipeline threads", __FUNCTION__);
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+void ViEEncoderPipeline::Stop() {
+  if (!started_) {
+    return;
+  }
+  started_ = false;
+  // Let the frames already accepted reach the network, the encoder and the
+  // receiver expect them.
+  const int64_t stop_time_ms =
+      TickTime::MillisecondTimestamp() + kStopTimeoutMs;
+  crit_->Enter();
+  while (pending_frames_ > 0 &&
+         TickTime::MillisecondTimestamp() < stop_time_ms) {
+    crit_->Leave();
+    idle_event_->Wait(kThreadWaitTimeMs);
+    crit_->Enter();
+  }
+  if (pending_frames_ > 0) {
+    WEBRTC_TRACE(kTraceWarning, kTraceVideo, id_,
+                 "%s: %d frames left in the pipeline", __FUNCTION__,
+                 pending_frames_);
+  }
+  crit_->Leave();
+
+  preprocess_thread_->SetNotAlive();
+  encode_thread_->SetNotAlive();
+  packetize_thread_->SetNotAlive();
+  preprocess_event_->Set();
+  encode_event_->Set();
+  packetize_event_->Set();
+  preprocess_thread_->Stop();
+  encode_thread_->Stop();
+  packetize_thread_->Stop();
+
+  CriticalSectionScoped cs(crit_.get());
+  free_frames_.splice(free_frames_.end(), preprocess_queue_);
+  free_frames_.splice(free_frames_.end(), encode_queue_);
+  free_encoded_frames_.splice(free_encoded_frames_.end(), packetize_queue_);
+  pending_frames_ = 0;
+}
+
+bool ViEEncoderPipeline::InsertFrame(const I420VideoFrame& frame) {
+  QueuedFrame* queued_frame = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (preprocess_queue_.size() >= queue_size_) {
+      ++dropped_frames_;
+      return false;
+    }
+    if (free_frames_.empty()) {
+      queued_frame = new QueuedFrame();
+    } else {
+      queued_frame = free_frames_.front();
+      free_frames_.pop_front();
+    }
+    // The copy is done outside the lock, make sure the slot is taken.
+    ++pending_frames_;
+  }
+  if (queued_frame->frame.CopyFrame(frame) != 0) {
+    CriticalSectionScoped cs(crit_.get());
+    free_frames_.push_back(queued_frame);
+    FrameDone();
+    return false;
+  }
+  queued_frame->insert_time_us = TickTime::MicrosecondTimestamp();
+  {
+    CriticalSectionScoped cs(crit_.get());
+    preprocess_queue_.push_back(queued_frame);
+  }
+  preprocess_event_->Set();
+  return true;
+}
+
+void ViEEncoderPipeline::InsertEncodedFrame(
+    FrameType frame_type,
+    WebRtc_UWord8 payload_type,
+    WebRtc_UWord32 time_stamp,
+    int64_t capture_time_ms,
+    const WebRtc_UWord8* payload_data,
+    WebRtc_UWord32 payload_size,
+    const RTPFragmentationHeader& fragmentation_header,
+    const RTPVideoHeader* rtp_video_hdr) {
+  EncodedFrame* encoded_frame = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (free_encoded_frames_.empty()) {
+      encoded_frame = new EncodedFrame();
+    } else {
+      encoded_frame = free_encoded_frames_.front();
+      free_encoded_frames_.pop_front();
+    }
+  }
+  encoded_frame->frame_type = frame_type;
+  encoded_frame->payload_type = payload_type;
+  encoded_frame->time_stamp = time_stamp;
+  encoded_frame->capture_time_ms = capture_time_ms;
+  encoded_frame->payload.assign(payload_data, payload_data + payload_size);
+  encoded_frame->fragmentation.CopyFrom(fragmentation_header);
+  encoded_frame->has_video_header = (rtp_video_hdr != NULL);
+  if (rtp_video_hdr) {
+    encoded_frame->video_header = *rtp_video_hdr;
+  }
+  encoded_frame->insert_time_us = TickTime::MicrosecondTimestamp();
+  {
+    CriticalSectionScoped cs(crit_.get());
+    packetize_queue_.push_back(encoded_frame);
+    ++pending_frames_;
+  }
+  packetize_event_->Set();
+}
+
+void ViEEncoderPipeline::GetStatistics(
+    EncoderPipelineStatistics* statistics) const {
+  CriticalSectionScoped cs(crit_.get());
+  preprocess_counters_.GetStatistics(&statistics->preprocess);
+  encode_counters_.GetStatistics(&statistics->encode);
+  packetize_counters_.GetStatistics(&statistics->packetize);
+  statistics->dropped_frames = dropped_frames_;
+}
+
+bool ViEEncoderPipeline::PreprocessThreadFunction(void* obj) {
+  return static_cast<ViEEncoderPipeline*>(obj)->PreprocessProcess();
+}
+
+bool ViEEncoderPipeline::EncodeThreadFunction(void* obj) {
+  return static_cast<ViEEncoderPipeline*>(obj)->EncodeProcess();
+}
+
+bool ViEEncoderPipeline::PacketizeThreadFunction(void* obj) {
+  return static_cast<ViEEncoderPipeline*>(obj)->PacketizeProcess();
+}
+
+bool ViEEncoderPipeline::PreprocessProcess() {
+  QueuedFrame* queued_frame = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    // Don't start on a new frame until there is room for it in the encode
+    // queue. New frames then pile up in the preprocess queue, where they are
+    // dropped before any rate decision has been made on them.
+    if (!preprocess_queue_.empty() && encode_queue_.size() < queue_size_) {
+      queued_frame = preprocess_queue_.front();
+      preprocess_queue_.pop_front();
+    }
+  }
+  if (!queued_frame) {
+    preprocess_event_->Wait(kThreadWaitTimeMs);
+    return true;
+  }
+  const int64_t start_time_us = TickTime::MicrosecondTimestamp();
+  I420VideoFrame* output = NULL;
+  const VideoContentMetrics* content_metrics = NULL;
+  bool encode = handler_->PreprocessFrame(&queued_frame->frame, &output,
+                                          &content_metrics);
+  if (encode && output != &queued_frame->frame) {
+    encode = (queued_frame->frame.CopyFrame(*output) == 0);
+  }
+  queued_frame->has_content_metrics = (content_metrics != NULL);
+  if (content_metrics) {
+    queued_frame->content_metrics = *content_metrics;
+  }
+  const int64_t now_us = TickTime::MicrosecondTimestamp();
+
+  CriticalSectionScoped cs(crit_.get());
+  preprocess_counters_.Update(start_time_us - queued_frame->insert_time_us,
+                              now_us - start_time_us);
+  if (!encode) {
+    free_frames_.push_back(queued_frame);
+    FrameDone();
+    return true;
+  }
+  queued_frame->insert_time_us = now_us;
+  encode_queue_.push_back(queued_frame);
+  encode_event_->Set();
+  return true;
+}
+
+bool ViEEncoderPipeline::EncodeProcess() {
+  QueuedFrame* queued_frame = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (!encode_queue_.empty() && packetize_queue_.size() < queue_size_) {
+      queued_frame = encode_queue_.front();
+      encode_queue_.pop_front();
+    }
+  }
+  if (!queued_frame) {
+    encode_event_->Wait(kThreadWaitTimeMs);
+    return true;
+  }
+  const int64_t start_time_us = TickTime::MicrosecondTimestamp();
+  handler_->EncodeFrame(queued_frame->frame,
+                        queued_frame->has_content_metrics ?
+                            &queued_frame->content_metrics : NULL);
+  const int64_t now_us = TickTime::MicrosecondTimestamp();
+
+  CriticalSectionScoped cs(crit_.get());
+  encode_counters_.Update(start_time_us - queued_frame->insert_time_us,
+                          now_us - start_time_us);
+  free_frames_.push_back(queued_frame);
+  FrameDone();
+  // There may be room for the next frame now.
+  preprocess_event_->Set();
+  return true;
+}
+
+bool ViEEncoderPipeline::PacketizeProcess() {
+  EncodedFrame* encoded_frame = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (!packetize_queue_.empty()) {
+      encoded_frame = packetize_queue_.front();
+      packetize_queue_.pop_front();
+    }
+  }
+  if (!encoded_frame) {
+    packetize_event_->Wait(kThreadWaitTimeMs);
+    return true;
+  }
+  const int64_t start_time_us = TickTime::MicrosecondTimestamp();
+  handler_->SendEncodedFrame(*encoded_frame);
+  const int64_t now_us = TickTime::MicrosecondTimestamp();
+
+  CriticalSectionScoped cs(crit_.get());
+  packetize_counters_.Update(start_time_us - encoded_frame->insert_time_us,
+                             now_us - start_time_us);
+  free_encoded_frames_.push_back(encoded_frame);
+  FrameDone();
+  encode_event_->Set();
+  return true;
+}
+
+void ViEEncoderPipeline::FrameDone() {
+  assert(pending_frames_ > 0);
+  if (--pending_frames_ == 0) {
+    idle_event_->Set();
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// ViEEncoderPipeline runs preprocessing, encoding and packetization of the
+// captured frames on one thread each, so that preprocessing of a frame can
+// overlap with encoding of the previous frame and with packetization and FEC
+// of the one before that.
+//
+// Only the queue in front of the preprocessing stage drops frames. The
+// following stages apply back pressure instead: a stage doesn't start on a new
+// frame until the queue after it has room. This keeps every frame that has
+// been seen by the frame rate decimation and the encoder rate control on its
+// way to the network.
+
+#ifndef WEBRTC_VIDEO_ENGINE_VIE_ENCODER_PIPELINE_H_
+#define WEBRTC_VIDEO_ENGINE_VIE_ENCODER_PIPELINE_H_
+
+#include <list>
+#include <vector>
+
+#include "common_video/interface/i420_video_frame.h"
+#include "modules/interface/module_common_types.h"
+#include "system_wrappers/interface/constructor_magic.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "typedefs.h"  // NOLINT
+#include "video_engine/include/vie_codec.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class EventWrapper;
+class ThreadWrapper;
+
+class ViEEncoderPipeline {
+ public:
+  // An encoded frame on its way from the encode stage to the packetization
+  // stage.
+  struct EncodedFrame {
+    EncodedFrame();
+
+    FrameType frame_type;
+    WebRtc_UWord8 payload_type;
+    WebRtc_UWord32 time_stamp;
+    int64_t capture_time_ms;
+    std::vector<WebRtc_UWord8> payload;
+    RTPFragmentationHeader fragmentation;
+    bool has_video_header;
+    RTPVideoHeader video_header;
+    // Time the frame was put in the packetization queue.
+    int64_t insert_time_us;
+  };
+
+  // Does the actual work of the stages. Each method is called on the thread of
+  // its stage.
+  class Handler {
+   public:
+    // Preprocesses |frame|. Returns false if the frame should be dropped,
+    // otherwise sets |*output| to the frame to encode and |*content_metrics|
+    // to its content metrics, or NULL. |*output| is either |frame| or owned by
+    // the handler; it and |*content_metrics| have to stay valid until the next
+    // call.
+    virtual bool PreprocessFrame(
+        I420VideoFrame* frame,
+        I420VideoFrame** output,
+        const VideoContentMetrics** content_metrics) = 0;
+
+    // Encodes |frame|. The encoded output is expected to be handed back with
+    // InsertEncodedFrame() before returning.
+    virtual void EncodeFrame(const I420VideoFrame& frame,
+                             const VideoContentMetrics* content_metrics) = 0;
+
+    // Packetizes and sends |frame|.
+    virtual void SendEncodedFrame(const EncodedFrame& frame) = 0;
+
+   protected:
+    virtual ~Handler() {}
+  };
+
+  // |id| is used for tracing. |queue_size| is the maximum number of frames
+  // waiting in front of each stage.
+  ViEEncoderPipeline(int id, Handler* handler, int queue_size);
+  ~ViEEncoderPipeline();
+
+  bool Start();
+  // Processes the frames already in the pipeline, then stops the threads.
+  // Frames inserted after this call are never processed.
+  void Stop();
+
+  // Queues a copy of |frame| for preprocessing. Returns false if the queue is
+  // full and the frame was dropped.
+  bool InsertFrame(const I420VideoFrame& frame);
+
+  // Queues a copy of an encoded frame for packetization. Called from
+  // Handler::EncodeFrame(). Never blocks or drops since the encoder state has
+  // already moved on.
+  void InsertEncodedFrame(FrameType frame_type,
+                          WebRtc_UWord8 payload_type,
+                          WebRtc_UWord32 time_stamp,
+                          int64_t capture_time_ms,
+                          const WebRtc_UWord8* payload_data,
+                          WebRtc_UWord32 payload_size,
+                          const RTPFragmentationHeader& fragmentation_header,
+                          const RTPVideoHeader* rtp_video_hdr);
+
+  void GetStatistics(EncoderPipelineStatistics* statistics) const;
+
+ private:
+  struct QueuedFrame {
+    QueuedFrame() : has_content_metrics(false), insert_time_us(0) {}
+
+    I420VideoFrame frame;
+    bool has_content_metrics;
+    VideoContentMetrics content_metrics;
+    // Time the frame was put in its current queue.
+    int64_t insert_time_us;
+  };
+
+  struct StageCounters {
+    StageCounters()
+        : frames(0), total_queue_time_us(0), total_process_time_us(0),
+          max_process_time_us(0) {}
+
+    void Update(int64_t queue_time_us, int64_t process_time_us);
+    void GetStatistics(EncoderPipelineStageStatistics* statistics) const;
+
+    unsigned int frames;
+    int64_t total_queue_time_us;
+    int64_t total_process_time_us;
+    int64_t max_process_time_us;
+  };
+
+  static bool PreprocessThreadFunction(void* obj);
+  static bool EncodeThreadFunction(void* obj);
+  static bool PacketizeThreadFunction(void* obj);
+  bool PreprocessProcess();
+  bool EncodeProcess();
+  bool PacketizeProcess();
+
+  // Decrements the number of frames in the pipeline. Must be called with
+  // |crit_| held.
+  void FrameDone();
+
+  const int id_;
+  Handler* handler_;
+  const size_t queue_size_;
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<ThreadWrapper> preprocess_thread_;
+  scoped_ptr<ThreadWrapper> encode_thread_;
+  scoped_ptr<ThreadWrapper> packetize_thread_;
+  scoped_ptr<EventWrapper> preprocess_event_;
+  scoped_ptr<EventWrapper> encode_event_;
+  scoped_ptr<EventWrapper> packetize_event_;
+  // Signaled when the pipeline becomes empty.
+  scoped_ptr<EventWrapper> idle_event_;
+  bool started_;
+
+  // Frames and encoded frames are recycled to avoid allocating a new frame
+  // buffer per frame.
+  std::list<QueuedFrame*> free_frames_;
+  std::list<QueuedFrame*> preprocess_queue_;
+  std::list<QueuedFrame*> encode_queue_;
+  std::list<EncodedFrame*> free_encoded_frames_;
+  std::list<EncodedFrame*> packetize_queue_;
+  // Number of frames and encoded frames that are queued or being processed.
+  int pending_frames_;
+
+  StageCounters preprocess_counters_;
+  StageCounters encode_counters_;
+  StageCounters packetize_counters_;
+  unsigned int dropped_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(ViEEncoderPipeline);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_VIE_ENCODER_PIPELINE_H_
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file includes unit tests for ViEEncoderPipeline.
+#include "video_engine/vie_encoder_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+static const int kWidth = 16;
+static const int kHeight = 16;
+static const int kPayloadSize = 10;
+static const int kEventTimeoutMs = 1000;
+
+class FakePipelineHandler : public ViEEncoderPipeline::Handler {
+ public:
+  FakePipelineHandler()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        preprocess_started_event_(EventWrapper::Create()),
+        release_event_(EventWrapper::Create()),
+        pipeline_(NULL),
+        block_preprocessing_(false),
+        drop_odd_frames_(false) {
+    memset(payload_, 0, sizeof(payload_));
+  }
+  virtual ~FakePipelineHandler() {}
+
+  virtual bool PreprocessFrame(I420VideoFrame* frame,
+                               I420VideoFrame** output,
+                               const VideoContentMetrics** content_metrics) {
+    preprocess_started_event_->Set();
+    if (block_preprocessing_) {
+      release_event_->Wait(kEventTimeoutMs);
+    }
+    *output = frame;
+    *content_metrics = NULL;
+    return !drop_odd_frames_ || frame->timestamp() % 2 == 0;
+  }
+
+  virtual void EncodeFrame(const I420VideoFrame& frame,
+                           const VideoContentMetrics* content_metrics) {
+    RTPFragmentationHeader fragmentation;
+    fragmentation.VerifyAndAllocateFragmentationHeader(1);
+    fragmentation.fragmentationOffset[0] = 0;
+    fragmentation.fragmentationLength[0] = kPayloadSize;
+    pipeline_->InsertEncodedFrame(kVideoFrameDelta, 100, frame.timestamp(),
+                                  frame.render_time_ms(), payload_,
+                                  kPayloadSize, fragmentation, NULL);
+  }
+
+  virtual void SendEncodedFrame(
+      const ViEEncoderPipeline::EncodedFrame& frame) {
+    CriticalSectionScoped cs(crit_.get());
+    EXPECT_EQ(kPayloadSize, static_cast<int>(frame.payload.size()));
+    EXPECT_EQ(1, frame.fragmentation.fragmentationVectorSize);
+    EXPECT_FALSE(frame.has_video_header);
+    sent_time_stamps_.push_back(frame.time_stamp);
+  }
+
+  std::vector<WebRtc_UWord32> SentTimeStamps() {
+    CriticalSectionScoped cs(crit_.get());
+    return sent_time_stamps_;
+  }
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<EventWrapper> preprocess_started_event_;
+  scoped_ptr<EventWrapper> release_event_;
+  ViEEncoderPipeline* pipeline_;
+  bool block_preprocessing_;
+  bool drop_odd_frames_;
+  WebRtc_UWord8 payload_[kPayloadSize];
+  std::vector<WebRtc_UWord32> sent_time_stamps_;
+};
+
+class ViEEncoderPipelineTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    frame_.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  }
+
+  void CreatePipeline(int queue_size) {
+    pipeline_.reset(new ViEEncoderPipeline(0, &handler_, queue_size));
+    handler_.pipeline_ = pipeline_.get();
+    ASSERT_TRUE(pipeline_->Start());
+  }
+
+  bool InsertFrame(WebRtc_UWord32 time_stamp) {
+    frame_.set_timestamp(time_stamp);
+    return pipeline_->InsertFrame(frame_);
+  }
+
+  FakePipelineHandler handler_;
+  scoped_ptr<ViEEncoderPipeline> pipeline_;
+  I420VideoFrame frame_;
+};
+
+TEST_F(ViEEncoderPipelineTest, FramesAreSentInOrder) {
+  const int kNumFrames = 20;
+  CreatePipeline(kNumFrames);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_TRUE(InsertFrame(i));
+  }
+  pipeline_->Stop();
+
+  std::vector<WebRtc_UWord32> sent = handler_.SentTimeStamps();
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), sent.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(static_cast<WebRtc_UWord32>(i), sent[i]);
+  }
+  EncoderPipelineStatistics statistics;
+  pipeline_->GetStatistics(&statistics);
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames),
+            statistics.preprocess.frames);
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames), statistics.encode.frames);
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames),
+            statistics.packetize.frames);
+  EXPECT_EQ(0u, statistics.dropped_frames);
+}
+
+TEST_F(ViEEncoderPipelineTest, PreprocessingDropsAreNotEncoded) {
+  const int kNumFrames = 10;
+  handler_.drop_odd_frames_ = true;
+  CreatePipeline(kNumFrames);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_TRUE(InsertFrame(i));
+  }
+  pipeline_->Stop();
+
+  std::vector<WebRtc_UWord32> sent = handler_.SentTimeStamps();
+  ASSERT_EQ(static_cast<size_t>(kNumFrames / 2), sent.size());
+  for (size_t i = 0; i < sent.size(); ++i) {
+    EXPECT_EQ(2 * i, sent[i]);
+  }
+  EncoderPipelineStatistics statistics;
+  pipeline_->GetStatistics(&statistics);
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames),
+            statistics.preprocess.frames);
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames / 2),
+            statistics.encode.frames);
+  EXPECT_EQ(0u, statistics.dropped_frames);
+}
+
+TEST_F(ViEEncoderPipelineTest, DropsNewFramesWhenFull) {
+  const int kQueueSize = 3;
+  handler_.block_preprocessing_ = true;
+  CreatePipeline(kQueueSize);
+
+  // The first frame is picked up by the preprocessing stage, which blocks.
+  EXPECT_TRUE(InsertFrame(0));
+  ASSERT_EQ(kEventSignaled,
+            handler_.preprocess_started_event_->Wait(kEventTimeoutMs));
+  for (int i = 1; i <= kQueueSize; ++i) {
+    EXPECT_TRUE(InsertFrame(i));
+  }
+  EXPECT_FALSE(InsertFrame(kQueueSize + 1));
+
+  handler_.block_preprocessing_ = false;
+  handler_.release_event_->Set();
+  pipeline_->Stop();
+
+  std::vector<WebRtc_UWord32> sent = handler_.SentTimeStamps();
+  ASSERT_EQ(static_cast<size_t>(kQueueSize + 1), sent.size());
+  for (int i = 0; i <= kQueueSize; ++i) {
+    EXPECT_EQ(static_cast<WebRtc_UWord32>(i), sent[i]);
+  }
+  EncoderPipelineStatistics statistics;
+  pipeline_->GetStatistics(&statistics);
+  EXPECT_EQ(1u, statistics.dropped_frames);
+  EXPECT_EQ(static_cast<unsigned int>(kQueueSize + 1),
+            statistics.packetize.frames);
+}
+
+}  // namespace webrtc
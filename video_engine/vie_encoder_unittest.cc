@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file includes unit tests for ViEEncoder.
+#include "video_engine/vie_encoder.h"
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <list>
+#include <vector>
+
+#include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "modules/utility/interface/process_thread.h"
+#include "modules/video_coding/codecs/interface/video_codec_interface.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+static const unsigned int kSsrc = 1234;
+static const unsigned char kPayloadType = 120;
+
+class NoThreadProcessThread : public ProcessThread {
+ public:
+  virtual WebRtc_Word32 Start() { return 0; }
+  virtual WebRtc_Word32 Stop() { return 0; }
+  virtual WebRtc_Word32 RegisterModule(const Module* module) { return 0; }
+  virtual WebRtc_Word32 DeRegisterModule(const Module* module) { return 0; }
+};
+
+// An encoder with an internal source, which records the frame types it is
+// asked to produce.
+class FrameTypeRecordingEncoder : public VideoEncoder {
+ public:
+  virtual WebRtc_Word32 InitEncode(const VideoCodec* codec_settings,
+                                   WebRtc_Word32 number_of_cores,
+                                   WebRtc_UWord32 max_payload_size) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  virtual WebRtc_Word32 Encode(
+      const I420VideoFrame& input_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const std::vector<VideoFrameType>* frame_types) {
+    if (frame_types && !frame_types->empty()) {
+      frame_types_.push_back((*frame_types)[0]);
+    }
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  virtual WebRtc_Word32 RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  virtual WebRtc_Word32 Release() { return WEBRTC_VIDEO_CODEC_OK; }
+  virtual WebRtc_Word32 SetChannelParameters(WebRtc_UWord32 packet_loss,
+                                             int rtt) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  virtual WebRtc_Word32 SetRates(WebRtc_UWord32 new_bit_rate,
+                                 WebRtc_UWord32 frame_rate) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  std::vector<VideoFrameType> frame_types_;
+};
+
+class ViEEncoderTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    bitrate_controller_.reset(BitrateController::CreateBitrateController());
+    vie_encoder_.reset(new ViEEncoder(1, 1, 1, process_thread_,
+                                      bitrate_controller_.get()));
+    ASSERT_TRUE(vie_encoder_->Init());
+    ASSERT_EQ(0, vie_encoder_->RegisterExternalEncoder(&encoder_,
+                                                       kPayloadType, true));
+  }
+
+  void SetVp8Encoder(bool feedback_mode) {
+    VideoCodec codec;
+    memset(&codec, 0, sizeof(codec));
+    codec.codecType = kVideoCodecVP8;
+    strncpy(codec.plName, "VP8", sizeof(codec.plName));
+    codec.plType = kPayloadType;
+    codec.width = 176;
+    codec.height = 144;
+    codec.startBitrate = 300;
+    codec.minBitrate = 30;
+    codec.maxBitrate = 600;
+    codec.maxFramerate = 30;
+    codec.qpMax = 56;
+    codec.codecSpecific.VP8.feedbackModeOn = feedback_mode;
+    codec.codecSpecific.VP8.numberOfTemporalLayers = 1;
+    ASSERT_EQ(0, vie_encoder_->SetEncoder(codec));
+    std::list<unsigned int> ssrcs;
+    ssrcs.push_back(kSsrc);
+    ASSERT_TRUE(vie_encoder_->SetSsrcs(ssrcs));
+  }
+
+  unsigned int RefreshFrames() {
+    unsigned int received = 0;
+    unsigned int suppressed = 0;
+    unsigned int refresh_frames = 0;
+    vie_encoder_->GetKeyFrameRequestStatistics(&received, &suppressed,
+                                               &refresh_frames);
+    return refresh_frames;
+  }
+
+  NoThreadProcessThread process_thread_;
+  FrameTypeRecordingEncoder encoder_;
+  scoped_ptr<BitrateController> bitrate_controller_;
+  scoped_ptr<ViEEncoder> vie_encoder_;
+};
+
+TEST_F(ViEEncoderTest, PliWithoutFeedbackModeProducesKeyFrame) {
+  SetVp8Encoder(false);
+  vie_encoder_->SetKeyFrameRequestPolicy(0, true);
+  vie_encoder_->OnReceivedRPSI(kSsrc, 1);
+  vie_encoder_->OnReceivedIntraFrameRequest(kSsrc);
+
+  ASSERT_EQ(1u, encoder_.frame_types_.size());
+  EXPECT_EQ(kKeyFrame, encoder_.frame_types_[0]);
+  EXPECT_EQ(0u, RefreshFrames());
+}
+
+TEST_F(ViEEncoderTest, PliWithFeedbackModeProducesRefreshFrame) {
+  SetVp8Encoder(true);
+  vie_encoder_->SetKeyFrameRequestPolicy(0, true);
+  vie_encoder_->OnReceivedRPSI(kSsrc, 1);
+  vie_encoder_->OnReceivedIntraFrameRequest(kSsrc);
+
+  // The refresh frame is encoded from the next captured frame, no key frame
+  // is requested.
+  EXPECT_TRUE(encoder_.frame_types_.empty());
+  EXPECT_EQ(1u, RefreshFrames());
+}
+
+}  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "video_engine/vie_file_impl.h"
 
+#include <string.h>
+
 #include "engine_configurations.h"  // NOLINT
 
 #ifdef WEBRTC_VIDEO_ENGINE_FILE_API
@@ -70,7 +72,8 @@ int ViEFileImpl::Release() {
 }
 
 ViEFileImpl::ViEFileImpl(ViESharedData* shared_data)
-    : shared_data_(shared_data) {
+    : shared_data_(shared_data),
+      jpeg_encoders_crit_(CriticalSectionWrapper::CreateCriticalSection()) {
   WEBRTC_TRACE(kTraceMemory, kTraceVideo, shared_data_->instance_id(),
                "ViEFileImpl::ViEFileImpl() Ctor");
 }
@@ -78,6 +81,9 @@ ViEFileImpl::ViEFileImpl(ViESharedData* shared_data)
 ViEFileImpl::~ViEFileImpl() {
   WEBRTC_TRACE(kTraceMemory, kTraceVideo, shared_data_->instance_id(),
                "ViEFileImpl::~ViEFileImpl() Dtor");
+  for (size_t i = 0; i < jpeg_encoders_.size(); ++i) {
+    delete jpeg_encoders_[i];
+  }
 }
 
 int ViEFileImpl::StartPlayFile(const char* file_nameUTF8,
@@ -563,18 +569,18 @@ int ViEFileImpl::GetRenderSnapshot(const int video_channel,
     return -1;
   }
 
-  // JPEGEncoder writes the jpeg file for you (no control over it) and does
-  // not return you the buffer. Thus, we are not going to be writing to the
-  // disk here.
-  JpegEncoder jpeg_encoder;
-  if (jpeg_encoder.SetFileName(file_nameUTF8) == -1) {
+  JpegEncoder* jpeg_encoder = AcquireJpegEncoder();
+  if (jpeg_encoder->SetFileName(file_nameUTF8) == -1) {
     WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
                  "\tCould not open output file '%s' for writing!",
                  file_nameUTF8);
+    ReleaseJpegEncoder(jpeg_encoder);
     return -1;
   }
 
-  if (jpeg_encoder.Encode(video_frame) == -1) {
+  const int ret = jpeg_encoder->Encode(video_frame);
+  ReleaseJpegEncoder(jpeg_encoder);
+  if (ret != 0) {
     WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
                  "\tCould not encode i420 -> jpeg file '%s' for writing!",
                  file_nameUTF8);
@@ -630,22 +636,21 @@ int ViEFileImpl::GetCaptureDeviceSnapshot(const int capture_id,
     return -1;
   }
 
-  // JPEGEncoder writes the jpeg file for you (no control over it) and does
-  // not return you the buffer Thusly, we are not going to be writing to the
-  // disk here.
-  JpegEncoder jpeg_encoder;
-
-  if (jpeg_encoder.SetFileName(file_nameUTF8) == -1) {
+  JpegEncoder* jpeg_encoder = AcquireJpegEncoder();
+  if (jpeg_encoder->SetFileName(file_nameUTF8) == -1) {
     WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
                  "\tCould not open output file '%s' for writing!",
                  file_nameUTF8);
+    ReleaseJpegEncoder(jpeg_encoder);
     return -1;
   }
-  if (jpeg_encoder.Encode(video_frame) == -1) {
-    WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
-                 "\tCould not encode i420 -> jpeg file '%s' for "
-                 "writing!", file_nameUTF8);
 
+  const int ret = jpeg_encoder->Encode(video_frame);
+  ReleaseJpegEncoder(jpeg_encoder);
+  if (ret != 0) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
+                 "\tCould not encode i420 -> jpeg file '%s' for writing!",
+                 file_nameUTF8);
     return -1;
   }
   return 0;
@@ -681,6 +686,37 @@ int ViEFileImpl::GetCaptureDeviceSnapshot(const int capture_id,
   return 0;
 }
 
+int ViEFileImpl::GetRenderSnapshotJpeg(const int video_channel,
+                                       ViEPicture& picture,
+                                       const int max_width,
+                                       const int max_height) {
+  ViERenderManagerScoped rs(*(shared_data_->render_manager()));
+  ViERenderer* renderer = rs.Renderer(video_channel);
+  if (!renderer) {
+    return -1;
+  }
+
+  I420VideoFrame video_frame;
+  if (renderer->GetLastRenderedFrame(video_channel, video_frame) == -1) {
+    return -1;
+  }
+  return EncodeJpegPicture(video_frame, max_width, max_height, &picture);
+}
+
+int ViEFileImpl::GetCaptureDeviceSnapshotJpeg(const int capture_id,
+                                              ViEPicture& picture,
+                                              const int max_width,
+                                              const int max_height) {
+  I420VideoFrame video_frame;
+  if (GetNextCapturedFrame(capture_id, &video_frame) == -1) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
+                 "Could not gain acces to capture device %d video frame "
+                 "%s:%d", capture_id, __FUNCTION__);
+    return -1;
+  }
+  return EncodeJpegPicture(video_frame, max_width, max_height, &picture);
+}
+
 int ViEFileImpl::FreePicture(ViEPicture& picture) {  // NOLINT
   if (picture.data) {
     free(picture.data);
@@ -888,6 +924,56 @@ WebRtc_Word32 ViEFileImpl::GetNextCapturedFrame(WebRtc_Word32 capture_id,
   return -1;
 }
 
+JpegEncoder* ViEFileImpl::AcquireJpegEncoder() {
+  CriticalSectionScoped cs(jpeg_encoders_crit_.get());
+  if (jpeg_encoders_.empty()) {
+    return new JpegEncoder();
+  }
+  JpegEncoder* jpeg_encoder = jpeg_encoders_.back();
+  jpeg_encoders_.pop_back();
+  return jpeg_encoder;
+}
+
+void ViEFileImpl::ReleaseJpegEncoder(JpegEncoder* jpeg_encoder) {
+  CriticalSectionScoped cs(jpeg_encoders_crit_.get());
+  jpeg_encoders_.push_back(jpeg_encoder);
+}
+
+int ViEFileImpl::EncodeJpegPicture(const I420VideoFrame& video_frame,
+                                   const int max_width,
+                                   const int max_height,
+                                   ViEPicture* picture) {
+  JpegEncoder* jpeg_encoder = AcquireJpegEncoder();
+  EncodedImage encoded_image;
+  int ret = jpeg_encoder->SetMaxResolution(max_width, max_height);
+  if (ret == 0) {
+    ret = jpeg_encoder->Encode(video_frame, &encoded_image);
+  }
+  // Pooled encoders encode file snapshots in their own size.
+  jpeg_encoder->SetMaxResolution(0, 0);
+  ReleaseJpegEncoder(jpeg_encoder);
+  if (ret != 0) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo, shared_data_->instance_id(),
+                 "\tCould not encode i420 -> jpeg");
+    delete [] encoded_image._buffer;
+    return -1;
+  }
+
+  // ViEPicture data is released with free().
+  picture->data = static_cast<WebRtc_UWord8*>(malloc(encoded_image._length));
+  if (!picture->data) {
+    delete [] encoded_image._buffer;
+    return -1;
+  }
+  memcpy(picture->data, encoded_image._buffer, encoded_image._length);
+  delete [] encoded_image._buffer;
+  picture->size = encoded_image._length;
+  picture->width = encoded_image._encodedWidth;
+  picture->height = encoded_image._encodedHeight;
+  picture->type = kVideoMJPEG;
+  return 0;
+}
+
 int ViEFileImpl::StartDebugRecording(int video_channel,
                                      const char* file_name_utf8) {
   ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
@@ -950,7 +1036,7 @@ const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
   if (!video_frame_) {
     return;
   }
-  video_frame_->SwapFrame(video_frame);
+  video_frame_->CopyFrame(*video_frame);
   condition_varaible_->WakeAll();
   return;
 }
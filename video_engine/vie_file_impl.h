@@ -11,6 +11,8 @@
 #ifndef WEBRTC_VIDEO_ENGINE_VIE_FILE_IMPL_H_
 #define WEBRTC_VIDEO_ENGINE_VIE_FILE_IMPL_H_
 
+#include <vector>
+
 #include "system_wrappers/interface/scoped_ptr.h"
 #include "typedefs.h"  // NOLINT
 #include "video_engine/include/vie_file.h"
@@ -23,6 +25,7 @@ namespace webrtc {
 
 class ConditionVariableWrapper;
 class CriticalSectionWrapper;
+class JpegEncoder;
 class ViESharedData;
 
 class ViECaptureSnapshot : public ViEFrameCallback {
@@ -44,6 +47,7 @@ class ViECaptureSnapshot : public ViEFrameCallback {
     return -1;
   }
   virtual void ProviderDestroyed(int id) {}
+  virtual bool ModifiesFrame() { return false; }
 
  private:
   scoped_ptr<CriticalSectionWrapper> crit_;
@@ -106,6 +110,14 @@ class ViEFileImpl
                                        const char* file_nameUTF8);
   virtual int GetCaptureDeviceSnapshot(const int capture_id,
                                        ViEPicture& picture);
+  virtual int GetRenderSnapshotJpeg(const int video_channel,
+                                    ViEPicture& picture,  // NOLINT
+                                    const int max_width,
+                                    const int max_height);
+  virtual int GetCaptureDeviceSnapshotJpeg(const int capture_id,
+                                           ViEPicture& picture,  // NOLINT
+                                           const int max_width,
+                                           const int max_height);
   virtual int SetRenderStartImage(const int video_channel,
                                   const char* file_nameUTF8);
   virtual int SetRenderStartImage(const int video_channel,
@@ -128,7 +140,19 @@ class ViEFileImpl
   WebRtc_Word32 GetNextCapturedFrame(WebRtc_Word32 capture_id,
                                      I420VideoFrame* video_frame);
 
+  // Encoders are kept between snapshots, since creating the compressor costs
+  // about as much as encoding a thumbnail. Snapshots taken in parallel use
+  // separate encoders.
+  JpegEncoder* AcquireJpegEncoder();
+  void ReleaseJpegEncoder(JpegEncoder* jpeg_encoder);
+  int EncodeJpegPicture(const I420VideoFrame& video_frame,
+                        const int max_width,
+                        const int max_height,
+                        ViEPicture* picture);
+
   ViESharedData* shared_data_;
+  scoped_ptr<CriticalSectionWrapper> jpeg_encoders_crit_;
+  std::vector<JpegEncoder*> jpeg_encoders_;
 };
 
 }  // namespace webrtc
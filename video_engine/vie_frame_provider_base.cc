@@ -24,6 +24,11 @@ ViEFrameProviderBase::ViEFrameProviderBase(int Id, int engine_id)
     : id_(Id),
       engine_id_(engine_id),
       provider_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      delivery_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      snapshot_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      snapshot_(new CallbackSnapshot()),
+      delivering_(false),
+      frame_copies_(0),
       frame_delay_(0) {
 }
 
@@ -39,6 +44,10 @@ ViEFrameProviderBase::~ViEFrameProviderBase() {
     (*it)->ProviderDestroyed(id_);
   }
   frame_callbacks_.clear();
+
+  CriticalSectionScoped cs(snapshot_cs_.get());
+  DeleteRetiredSnapshots();
+  delete snapshot_;
 }
 
 int ViEFrameProviderBase::Id() {
@@ -49,37 +58,106 @@ void ViEFrameProviderBase::DeliverFrame(
     I420VideoFrame* video_frame,
     int num_csrcs,
     const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
-#ifdef DEBUG_
-  const TickTime start_process_time = TickTime::Now();
-#endif
-  CriticalSectionScoped cs(provider_cs_.get());
+  CriticalSectionScoped delivery(delivery_cs_.get());
+  CallbackSnapshot* snapshot = NULL;
+  {
+    CriticalSectionScoped cs(snapshot_cs_.get());
+    snapshot = snapshot_;
+    delivering_ = true;
+  }
+  const size_t num_callbacks = snapshot->callbacks.size();
+  if (delivery_times_us_.size() < num_callbacks) {
+    delivery_times_us_.resize(num_callbacks);
+  }
 
-  // Deliver the frame to all registered callbacks.
-  if (frame_callbacks_.size() > 0) {
-    if (frame_callbacks_.size() == 1) {
-      // We don't have to copy the frame.
-      frame_callbacks_.front()->DeliverFrame(id_, video_frame, num_csrcs, CSRC);
-    } else {
-      // Make a copy of the frame for all callbacks.callback
-      for (FrameCallbacks::iterator it = frame_callbacks_.begin();
-           it != frame_callbacks_.end(); ++it) {
-        if (!extra_frame_.get()) {
-          extra_frame_.reset(new I420VideoFrame());
-        }
-        extra_frame_->CopyFrame(*video_frame);
-        (*it)->DeliverFrame(id_, extra_frame_.get(), num_csrcs, CSRC);
+  // Read-only callbacks share the original frame. The callbacks modifying the
+  // frame get a copy, except the last one, which gets the original frame.
+  unsigned int frame_copies = 0;
+  for (size_t i = 0; i < num_callbacks; ++i) {
+    I420VideoFrame* frame = video_frame;
+    if (i >= snapshot->num_read_only && i + 1 < num_callbacks) {
+      if (!extra_frame_.get()) {
+        extra_frame_.reset(new I420VideoFrame());
       }
+      extra_frame_->CopyFrame(*video_frame);
+      ++frame_copies;
+      frame = extra_frame_.get();
     }
+    const WebRtc_Word64 start_us = TickTime::MicrosecondTimestamp();
+    snapshot->callbacks[i]->DeliverFrame(id_, frame, num_csrcs, CSRC);
+    delivery_times_us_[i] =
+        static_cast<unsigned int>(TickTime::MicrosecondTimestamp() - start_us);
   }
-#ifdef DEBUG_
-  const int process_time =
-      static_cast<int>((TickTime::Now() - start_process_time).Milliseconds());
-  if (process_time > 25) {
-    // Warn if the delivery time is too long.
-    WEBRTC_TRACE(kTraceWarning, kTraceVideo, ViEId(engine_id_, id_),
-                 "%s Too long time: %ums", __FUNCTION__, process_time);
+
+  CriticalSectionScoped cs(snapshot_cs_.get());
+  frame_copies_ += frame_copies;
+  for (size_t i = 0; i < num_callbacks; ++i) {
+    // The callback might have been deregistered during the delivery.
+    for (CallbackEntries::iterator it = callback_entries_.begin();
+         it != callback_entries_.end(); ++it) {
+      if (it->callback == snapshot->callbacks[i]) {
+        FrameDeliveryStatistics& statistics = it->statistics;
+        ++statistics.frames;
+        statistics.total_delivery_time_us += delivery_times_us_[i];
+        statistics.max_delivery_time_us =
+            std::max(statistics.max_delivery_time_us, delivery_times_us_[i]);
+        break;
+      }
+    }
+  }
+  delivering_ = false;
+  DeleteRetiredSnapshots();
+}
+
+unsigned int ViEFrameProviderBase::FrameCopies() {
+  CriticalSectionScoped cs(snapshot_cs_.get());
+  return frame_copies_;
+}
+
+int ViEFrameProviderBase::GetFrameDeliveryStatistics(
+    int observer_id, FrameDeliveryStatistics* statistics) {
+  CriticalSectionScoped cs(snapshot_cs_.get());
+  for (CallbackEntries::iterator it = callback_entries_.begin();
+       it != callback_entries_.end(); ++it) {
+    if (it->observer_id == observer_id) {
+      *statistics = it->statistics;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+void ViEFrameProviderBase::UpdateSnapshot() {
+  CallbackSnapshot* snapshot = new CallbackSnapshot();
+  for (FrameCallbacks::iterator it = frame_callbacks_.begin();
+       it != frame_callbacks_.end(); ++it) {
+    if (!(*it)->ModifiesFrame()) {
+      snapshot->callbacks.push_back(*it);
+    }
+  }
+  snapshot->num_read_only = snapshot->callbacks.size();
+  for (FrameCallbacks::iterator it = frame_callbacks_.begin();
+       it != frame_callbacks_.end(); ++it) {
+    if ((*it)->ModifiesFrame()) {
+      snapshot->callbacks.push_back(*it);
+    }
+  }
+
+  CriticalSectionScoped cs(snapshot_cs_.get());
+  retired_snapshots_.push_back(snapshot_);
+  snapshot_ = snapshot;
+  if (!delivering_) {
+    DeleteRetiredSnapshots();
   }
-#endif
+}
+
+void ViEFrameProviderBase::DeleteRetiredSnapshots() {
+  for (std::vector<CallbackSnapshot*>::iterator it =
+           retired_snapshots_.begin();
+       it != retired_snapshots_.end(); ++it) {
+    delete *it;
+  }
+  retired_snapshots_.clear();
 }
 
 void ViEFrameProviderBase::SetFrameDelay(int frame_delay) {
@@ -145,6 +223,13 @@ int ViEFrameProviderBase::RegisterFrameCallback(
       return -1;
     }
     frame_callbacks_.push_back(callback_object);
+    UpdateSnapshot();
+
+    CriticalSectionScoped snapshot_cs(snapshot_cs_.get());
+    CallbackEntry entry;
+    entry.callback = callback_object;
+    entry.observer_id = observer_id;
+    callback_entries_.push_back(entry);
   }
   // Report current capture delay.
   callback_object->DelayChanged(id_, frame_delay_);
@@ -159,17 +244,38 @@ int ViEFrameProviderBase::DeregisterFrameCallback(
   assert(callback_object);
   WEBRTC_TRACE(kTraceInfo, kTraceVideo, ViEId(engine_id_, id_), "%s(0x%p)",
                __FUNCTION__, callback_object);
-  CriticalSectionScoped cs(provider_cs_.get());
+  {
+    CriticalSectionScoped cs(provider_cs_.get());
+    FrameCallbacks::iterator it = std::find(frame_callbacks_.begin(),
+                                            frame_callbacks_.end(),
+                                            callback_object);
+    if (it == frame_callbacks_.end()) {
+      WEBRTC_TRACE(kTraceWarning, kTraceVideo, ViEId(engine_id_, id_),
+                   "%s 0x%p not found", __FUNCTION__, callback_object);
+      return -1;
+    }
+    frame_callbacks_.erase(it);
+    UpdateSnapshot();
 
-  FrameCallbacks::iterator it = std::find(frame_callbacks_.begin(),
-                                          frame_callbacks_.end(),
-                                          callback_object);
-  if (it == frame_callbacks_.end()) {
-    WEBRTC_TRACE(kTraceWarning, kTraceVideo, ViEId(engine_id_, id_),
-                 "%s 0x%p not found", __FUNCTION__, callback_object);
-    return -1;
+    CriticalSectionScoped snapshot_cs(snapshot_cs_.get());
+    for (CallbackEntries::iterator entry = callback_entries_.begin();
+         entry != callback_entries_.end(); ++entry) {
+      if (entry->callback == callback_object) {
+        callback_entries_.erase(entry);
+        break;
+      }
+    }
+  }
+  // Wait for an ongoing delivery to the old snapshot to finish. This returns
+  // directly if called from within the delivery, which is then still using
+  // the snapshot and deletes it when done.
+  {
+    CriticalSectionScoped delivery(delivery_cs_.get());
+    CriticalSectionScoped cs(snapshot_cs_.get());
+    if (!delivering_) {
+      DeleteRetiredSnapshots();
+    }
   }
-  frame_callbacks_.erase(it);
   WEBRTC_TRACE(kTraceInfo, kTraceVideo, ViEId(engine_id_, id_),
                "%s 0x%p deregistered", __FUNCTION__, callback_object);
 
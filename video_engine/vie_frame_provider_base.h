@@ -45,11 +45,34 @@ class ViEFrameCallback {
   // must not be any more calls to the frame provider after this.
   virtual void ProviderDestroyed(int id) = 0;
 
+  // Returns false if DeliverFrame only reads |video_frame|. Such callbacks
+  // share the delivered frame, all other callbacks get a frame of their own.
+  virtual bool ModifiesFrame() { return true; }
+
   virtual ~ViEFrameCallback() {}
 };
 
+// Time spent delivering frames to one ViEFrameCallback.
+struct FrameDeliveryStatistics {
+  FrameDeliveryStatistics()
+      : frames(0),
+        total_delivery_time_us(0),
+        max_delivery_time_us(0) {}
+
+  unsigned int frames;
+  WebRtc_Word64 total_delivery_time_us;
+  unsigned int max_delivery_time_us;
+};
+
 // ViEFrameProviderBase is a base class that will deliver frames to all
 // registered ViEFrameCallbacks.
+//
+// Frames are delivered to a snapshot of the registered callbacks, which is
+// replaced when a callback is registered or deregistered. A delivery never
+// holds |provider_cs_|, so a slow callback doesn't block registration or
+// queries. DeregisterFrameCallback waits for an ongoing delivery to finish,
+// unless called from the delivering thread, so the deregistered callback can
+// be deleted when it returns.
 class ViEFrameProviderBase {
  public:
   ViEFrameProviderBase(int Id, int engine_id);
@@ -69,6 +92,15 @@ class ViEFrameProviderBase {
 
   int NumberOfRegisteredFrameCallbacks();
 
+  // Returns the number of frames copied to deliver a frame to more than one
+  // callback.
+  unsigned int FrameCopies();
+
+  // Gets the delivery statistics of the callback registered with
+  // |observer_id|. Returns -1 if there is no such callback.
+  int GetFrameDeliveryStatistics(int observer_id,
+                                 FrameDeliveryStatistics* statistics);
+
   // FrameCallbackChanged
   // Inherited classes should check for new frame_settings and reconfigure
   // output if possible.
@@ -93,7 +125,42 @@ class ViEFrameProviderBase {
   scoped_ptr<CriticalSectionWrapper> provider_cs_;
 
  private:
+  struct CallbackEntry {
+    ViEFrameCallback* callback;
+    int observer_id;
+    FrameDeliveryStatistics statistics;
+  };
+  typedef std::vector<CallbackEntry> CallbackEntries;
+
+  // The callbacks frames are delivered to. Read-only callbacks are ordered
+  // before the callbacks modifying the frame.
+  struct CallbackSnapshot {
+    CallbackSnapshot() : num_read_only(0) {}
+    std::vector<ViEFrameCallback*> callbacks;
+    size_t num_read_only;
+  };
+
+  // Replaces the current snapshot with one of |frame_callbacks_|. Must be
+  // called with |provider_cs_| held.
+  void UpdateSnapshot();
+  // Deletes the replaced snapshots. Must be called with |snapshot_cs_| held
+  // and no delivery in progress.
+  void DeleteRetiredSnapshots();
+
+  // Serializes the deliveries.
+  scoped_ptr<CriticalSectionWrapper> delivery_cs_;
+  // Protects the snapshots and |callback_entries_|. Never held while calling a
+  // callback.
+  scoped_ptr<CriticalSectionWrapper> snapshot_cs_;
+  CallbackSnapshot* snapshot_;
+  std::vector<CallbackSnapshot*> retired_snapshots_;
+  CallbackEntries callback_entries_;
+  bool delivering_;
+
+  // Only used by the delivering thread.
+  std::vector<unsigned int> delivery_times_us_;
   scoped_ptr<I420VideoFrame> extra_frame_;
+  unsigned int frame_copies_;
   int frame_delay_;
 };
 
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file includes unit tests for ViEFrameProviderBase.
+#include "video_engine/vie_frame_provider_base.h"
+
+#include <gtest/gtest.h>
+
+#include "common_video/interface/i420_video_frame.h"
+
+namespace webrtc {
+
+class TestFrameProvider : public ViEFrameProviderBase {
+ public:
+  TestFrameProvider() : ViEFrameProviderBase(1, 0) {}
+
+  virtual int FrameCallbackChanged() { return 0; }
+
+  void Deliver(I420VideoFrame* video_frame) {
+    DeliverFrame(video_frame);
+  }
+};
+
+class TestFrameCallback : public ViEFrameCallback {
+ public:
+  explicit TestFrameCallback(bool modifies_frame)
+      : modifies_frame_(modifies_frame),
+        last_frame_(NULL),
+        frames_(0),
+        provider_(NULL) {}
+
+  virtual void DeliverFrame(int id,
+                            I420VideoFrame* video_frame,
+                            int num_csrcs,
+                            const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
+    last_frame_ = video_frame;
+    ++frames_;
+    if (provider_) {
+      EXPECT_EQ(0, provider_->DeregisterFrameCallback(this));
+    }
+  }
+  virtual void DelayChanged(int id, int frame_delay) {}
+  virtual int GetPreferedFrameSettings(int* width,
+                                       int* height,
+                                       int* frame_rate) {
+    return -1;
+  }
+  virtual void ProviderDestroyed(int id) {}
+  virtual bool ModifiesFrame() { return modifies_frame_; }
+
+  bool modifies_frame_;
+  I420VideoFrame* last_frame_;
+  int frames_;
+  // Deregisters from |provider_| when a frame is delivered, if set.
+  ViEFrameProviderBase* provider_;
+};
+
+class ViEFrameProviderBaseTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    frame_.CreateEmptyFrame(176, 144, 176, 88, 88);
+  }
+
+  TestFrameProvider provider_;
+  I420VideoFrame frame_;
+};
+
+TEST_F(ViEFrameProviderBaseTest, ReadOnlyCallbacksShareTheFrame) {
+  TestFrameCallback reader1(false);
+  TestFrameCallback reader2(false);
+  TestFrameCallback writer(true);
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(1, &writer));
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(2, &reader1));
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(3, &reader2));
+
+  provider_.Deliver(&frame_);
+  EXPECT_EQ(&frame_, reader1.last_frame_);
+  EXPECT_EQ(&frame_, reader2.last_frame_);
+  EXPECT_EQ(&frame_, writer.last_frame_);
+  EXPECT_EQ(0u, provider_.FrameCopies());
+
+  // A second callback modifying the frame needs a copy.
+  TestFrameCallback writer2(true);
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(4, &writer2));
+  provider_.Deliver(&frame_);
+  EXPECT_EQ(&frame_, reader1.last_frame_);
+  EXPECT_NE(writer.last_frame_, writer2.last_frame_);
+  EXPECT_EQ(1u, provider_.FrameCopies());
+
+  EXPECT_EQ(0, provider_.DeregisterFrameCallback(&writer2));
+  EXPECT_EQ(0, provider_.DeregisterFrameCallback(&reader2));
+  EXPECT_EQ(0, provider_.DeregisterFrameCallback(&reader1));
+  EXPECT_EQ(0, provider_.DeregisterFrameCallback(&writer));
+}
+
+TEST_F(ViEFrameProviderBaseTest, DeregisterDuringDelivery) {
+  TestFrameCallback callback1(true);
+  TestFrameCallback callback2(true);
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(1, &callback1));
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(2, &callback2));
+  callback1.provider_ = &provider_;
+
+  // The ongoing delivery still reaches the second callback.
+  provider_.Deliver(&frame_);
+  EXPECT_EQ(1, callback1.frames_);
+  EXPECT_EQ(1, callback2.frames_);
+  EXPECT_FALSE(provider_.IsFrameCallbackRegistered(&callback1));
+
+  provider_.Deliver(&frame_);
+  EXPECT_EQ(1, callback1.frames_);
+  EXPECT_EQ(2, callback2.frames_);
+  EXPECT_EQ(0, provider_.DeregisterFrameCallback(&callback2));
+}
+
+TEST_F(ViEFrameProviderBaseTest, DeliveryStatistics) {
+  TestFrameCallback callback(true);
+  FrameDeliveryStatistics statistics;
+  EXPECT_EQ(-1, provider_.GetFrameDeliveryStatistics(7, &statistics));
+  EXPECT_EQ(0, provider_.RegisterFrameCallback(7, &callback));
+  for (int i = 0; i < 10; ++i) {
+    provider_.Deliver(&frame_);
+  }
+  EXPECT_EQ(0, provider_.GetFrameDeliveryStatistics(7, &statistics));
+  EXPECT_EQ(10u, statistics.frames);
+  EXPECT_LE(static_cast<WebRtc_Word64>(statistics.max_delivery_time_us),
+            statistics.total_delivery_time_us);
+  EXPECT_EQ(0, provider_.DeregisterFrameCallback(&callback));
+  EXPECT_EQ(-1, provider_.GetFrameDeliveryStatistics(7, &statistics));
+}
+
+}  // namespace webrtc
@@ -19,6 +19,7 @@
 #include "system_wrappers/interface/critical_section_wrapper.h"
 #include "system_wrappers/interface/tick_util.h"
 #include "system_wrappers/interface/trace.h"
+#include "video_engine/vie_rtp_forwarder.h"
 
 namespace webrtc {
 
@@ -28,6 +29,11 @@ ViEReceiver::ViEReceiver(const int32_t channel_id,
     : receive_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       channel_id_(channel_id),
       rtp_rtcp_(NULL),
+      rtp_forwarder_(NULL),
+      forward_packet_(NULL),
+      forward_packet_length_(0),
+      forwarding_source_(NULL),
+      forwarding_destination_id_(-1),
       vcm_(module_vcm),
       remote_bitrate_estimator_(remote_bitrate_estimator),
       external_decryption_(NULL),
@@ -75,6 +81,21 @@ void ViEReceiver::SetRtpRtcpModule(RtpRtcp* module) {
   rtp_rtcp_ = module;
 }
 
+void ViEReceiver::SetRtpForwarder(ViERtpForwarder* forwarder) {
+  rtp_forwarder_ = forwarder;
+}
+
+bool ViEReceiver::SetForwardingSource(ViERtpForwarder* source,
+                                      int destination_id) {
+  CriticalSectionScoped cs(receive_cs_.get());
+  if (source && forwarding_source_) {
+    return false;
+  }
+  forwarding_source_ = source;
+  forwarding_destination_id_ = destination_id;
+  return true;
+}
+
 void ViEReceiver::RegisterSimulcastRtpRtcpModules(
     const std::list<RtpRtcp*>& rtp_modules) {
   CriticalSectionScoped cs(receive_cs_.get());
@@ -133,6 +154,15 @@ WebRtc_Word32 ViEReceiver::OnReceivedPayloadData(
   remote_bitrate_estimator_->IncomingPacket(
       rtp_header->header.ssrc, packet_size,
       TickTime::MillisecondTimestamp(), compensated_timestamp);
+  if (forward_packet_) {
+    // Forwarded once, also when FEC recovers packets from it.
+    rtp_forwarder_->ForwardRTPPacket(forward_packet_, forward_packet_length_);
+    forward_packet_ = NULL;
+  }
+  if (rtp_forwarder_ && !rtp_forwarder_->DecodeForwardedPackets()) {
+    // The packet has been forwarded, no need to decode it.
+    return 0;
+  }
   if (vcm_->IncomingPacket(payload_data, payload_size, *rtp_header) != 0) {
     // Check this...
     return -1;
@@ -184,8 +214,17 @@ int ViEReceiver::InsertRTPPacket(const WebRtc_Word8* rtp_packet,
                            static_cast<WebRtc_UWord16>(received_packet_length));
     }
   }
+  if (rtp_forwarder_ && rtp_forwarder_->Forwarding()) {
+    // Forwarded from OnReceivedPayloadData, once the RTP/RTCP module has
+    // validated the packet.
+    forward_packet_ = received_packet;
+    forward_packet_length_ = received_packet_length;
+  }
   assert(rtp_rtcp_);  // Should be set by owner at construction time.
-  return rtp_rtcp_->IncomingPacket(received_packet, received_packet_length);
+  const int ret = rtp_rtcp_->IncomingPacket(received_packet,
+                                            received_packet_length);
+  forward_packet_ = NULL;
+  return ret;
 }
 
 int ViEReceiver::InsertRTCPPacket(const WebRtc_Word8* rtcp_packet,
@@ -226,6 +265,11 @@ int ViEReceiver::InsertRTCPPacket(const WebRtc_Word8* rtcp_packet,
   }
   {
     CriticalSectionScoped cs(receive_cs_.get());
+    if (forwarding_source_) {
+      // Feedback on the forwarded stream is answered by the source.
+      forwarding_source_->OnDestinationRTCPPacket(
+          forwarding_destination_id_, received_packet, received_packet_length);
+    }
     std::list<RtpRtcp*>::iterator it = rtp_rtcp_simulcast_.begin();
     while (it != rtp_rtcp_simulcast_.end()) {
       RtpRtcp* rtp_rtcp = *it++;
@@ -28,6 +28,7 @@ class RemoteBitrateEstimator;
 class RtpDump;
 class RtpRtcp;
 class VideoCodingModule;
+class ViERtpForwarder;
 
 class ViEReceiver : public UdpTransportData, public RtpData {
  public:
@@ -40,6 +41,15 @@ class ViEReceiver : public UdpTransportData, public RtpData {
 
   void SetRtpRtcpModule(RtpRtcp* module);
 
+  // Received RTP packets are passed to |forwarder| once they've been
+  // validated by the RTP/RTCP module, when it has destinations.
+  void SetRtpForwarder(ViERtpForwarder* forwarder);
+
+  // Passes the RTCP received while this channel is a forwarding destination
+  // to |source|, as destination |destination_id|. Returns false if another
+  // source is already set; NULL clears it.
+  bool SetForwardingSource(ViERtpForwarder* source, int destination_id);
+
   void RegisterSimulcastRtpRtcpModules(const std::list<RtpRtcp*>& rtp_modules);
 
   void StartReceive();
@@ -83,6 +93,12 @@ class ViEReceiver : public UdpTransportData, public RtpData {
   scoped_ptr<CriticalSectionWrapper> receive_cs_;
   const int32_t channel_id_;
   RtpRtcp* rtp_rtcp_;
+  ViERtpForwarder* rtp_forwarder_;
+  // The packet in the RTP/RTCP module, until it has been forwarded.
+  const WebRtc_UWord8* forward_packet_;
+  int forward_packet_length_;
+  ViERtpForwarder* forwarding_source_;
+  int forwarding_destination_id_;
   std::list<RtpRtcp*> rtp_rtcp_simulcast_;
   VideoCodingModule* vcm_;
   RemoteBitrateEstimator* remote_bitrate_estimator_;
@@ -0,0 +1,390 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video_engine/vie_rtp_forwarder.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "common_types.h"  // NOLINT
+#include "modules/rtp_rtcp/interface/rtp_rtcp.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/tick_util.h"
+#include "system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+// Size of the fixed RTP header.
+static const int kRtpHeaderLength = 12;
+// RTP timestamp rate for video.
+static const int kVideoRtpTicksPerMs = 90;
+// RTCP header, and the header of feedback messages (RFC 4585).
+static const int kRtcpHeaderLength = 4;
+static const int kRtcpFeedbackHeaderLength = 12;
+static const uint8_t kRtcpRtpfbPayloadType = 205;
+static const uint8_t kRtcpPsfbPayloadType = 206;
+static const uint8_t kRtcpNackFormat = 1;
+static const uint8_t kRtcpPliFormat = 1;
+static const uint8_t kRtcpFirFormat = 4;
+static const int kRtcpFirItemLength = 8;
+// Viewers' key frame requests are collapsed into one request to the source
+// per interval.
+static const int64_t kMinKeyFrameRequestIntervalMs = 200;
+
+static uint16_t ReadUWord16(const uint8_t* buffer) {
+  return static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t ReadUWord32(const uint8_t* buffer) {
+  return (static_cast<uint32_t>(buffer[0]) << 24) | (buffer[1] << 16) |
+      (buffer[2] << 8) | buffer[3];
+}
+
+static void WriteUWord16(uint8_t* buffer, uint16_t value) {
+  buffer[0] = static_cast<uint8_t>(value >> 8);
+  buffer[1] = static_cast<uint8_t>(value);
+}
+
+static void WriteUWord32(uint8_t* buffer, uint32_t value) {
+  buffer[0] = static_cast<uint8_t>(value >> 24);
+  buffer[1] = static_cast<uint8_t>(value >> 16);
+  buffer[2] = static_cast<uint8_t>(value >> 8);
+  buffer[3] = static_cast<uint8_t>(value);
+}
+
+ViERtpForwarder::ViERtpForwarder(const int32_t channel_id)
+    : channel_id_(channel_id),
+      forward_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      rtp_rtcp_(NULL),
+      source_started_(false),
+      source_ssrc_(0),
+      source_next_sequence_number_(0),
+      last_key_frame_request_ms_(-1),
+      packets_forwarded_(0),
+      bytes_forwarded_(0) {
+}
+
+ViERtpForwarder::~ViERtpForwarder() {
+}
+
+void ViERtpForwarder::SetRtpRtcpModule(RtpRtcp* module) {
+  rtp_rtcp_ = module;
+}
+
+int ViERtpForwarder::AddDestination(Transport* transport, int destination_id,
+                                    RtpRtcp* rtp_rtcp, bool decode) {
+  assert(transport);
+  assert(rtp_rtcp);
+  CriticalSectionScoped cs(forward_cs_.get());
+  for (Destinations::iterator it = destinations_.begin();
+       it != destinations_.end(); ++it) {
+    if (it->transport == transport) {
+      WEBRTC_TRACE(kTraceError, kTraceVideo, channel_id_,
+                   "%s: destination already added", __FUNCTION__);
+      return -1;
+    }
+  }
+  if (history_.empty()) {
+    history_.resize(kSendSidePacketHistorySize);
+  }
+  Destination destination;
+  memset(&destination, 0, sizeof(destination));
+  destination.transport = transport;
+  destination.destination_id = destination_id;
+  destination.rtp_rtcp = rtp_rtcp;
+  destination.decode = decode;
+  destination.anchored = false;
+  destination.last_packet_time_ms = -1;
+  destinations_.push_back(destination);
+  return 0;
+}
+
+int ViERtpForwarder::RemoveDestination(Transport* transport) {
+  CriticalSectionScoped cs(forward_cs_.get());
+  for (Destinations::iterator it = destinations_.begin();
+       it != destinations_.end(); ++it) {
+    if (it->transport == transport) {
+      destinations_.erase(it);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+bool ViERtpForwarder::Forwarding() const {
+  CriticalSectionScoped cs(forward_cs_.get());
+  return !destinations_.empty();
+}
+
+bool ViERtpForwarder::DecodeForwardedPackets() const {
+  CriticalSectionScoped cs(forward_cs_.get());
+  return DecodeLocked();
+}
+
+int ViERtpForwarder::ForwardRTPPacket(const uint8_t* rtp_packet,
+                                      int rtp_packet_length) {
+  if (rtp_packet_length < kRtpHeaderLength ||
+      rtp_packet_length > kViEMaxMtu || (rtp_packet[0] >> 6) != 2) {
+    WEBRTC_TRACE(kTraceWarning, kTraceVideo, channel_id_,
+                 "%s: invalid RTP packet, length %d", __FUNCTION__,
+                 rtp_packet_length);
+    return -1;
+  }
+  const uint16_t sequence_number = ReadUWord16(&rtp_packet[2]);
+  const uint32_t timestamp = ReadUWord32(&rtp_packet[4]);
+  const uint32_t ssrc = ReadUWord32(&rtp_packet[8]);
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  const bool nack_enabled = rtp_rtcp_ && rtp_rtcp_->NACK() != kNackOff;
+  std::vector<uint16_t> missing;
+  bool request_key_frame = false;
+  int num_sent = 0;
+  {
+    CriticalSectionScoped cs(forward_cs_.get());
+    if (destinations_.empty()) {
+      return 0;
+    }
+    if (!UpdateSourceLeg(rtp_packet, rtp_packet_length, sequence_number, ssrc,
+                         nack_enabled, &missing) && rtp_rtcp_) {
+      request_key_frame = AllowKeyFrameRequest(now_ms);
+    }
+    // The payload is copied once, only the header differs between the
+    // destinations.
+    memcpy(packet_buffer_, rtp_packet, rtp_packet_length);
+    for (Destinations::iterator it = destinations_.begin();
+         it != destinations_.end(); ++it) {
+      AnchorDestination(&(*it), sequence_number, timestamp, ssrc, now_ms);
+      WriteHeader(*it, sequence_number, timestamp);
+      const int bytes_sent = it->transport->SendPacket(it->destination_id,
+                                                       packet_buffer_,
+                                                       rtp_packet_length);
+      if (bytes_sent <= 0) {
+        continue;
+      }
+      ++num_sent;
+      ++packets_forwarded_;
+      // Counts what the transport sent, after a possible encryption.
+      bytes_forwarded_ += bytes_sent;
+    }
+  }
+  // The source is called without holding |forward_cs_|.
+  if (!missing.empty()) {
+    rtp_rtcp_->SendNACK(&missing[0], static_cast<uint16_t>(missing.size()));
+  }
+  if (request_key_frame) {
+    rtp_rtcp_->RequestKeyFrame();
+  }
+  return num_sent;
+}
+
+void ViERtpForwarder::OnDestinationRTCPPacket(int destination_id,
+                                              const uint8_t* rtcp_packet,
+                                              int rtcp_packet_length) {
+  bool request_key_frame = false;
+  {
+    CriticalSectionScoped cs(forward_cs_.get());
+    Destinations::iterator destination = destinations_.begin();
+    while (destination != destinations_.end() &&
+           destination->destination_id != destination_id) {
+      ++destination;
+    }
+    if (destination == destinations_.end()) {
+      return;
+    }
+    const uint32_t ssrc = destination->rtp_rtcp->SSRC();
+    const uint8_t* packet = rtcp_packet;
+    int length_left = rtcp_packet_length;
+    // Walks the compound packet, feedback for other streams is ignored.
+    while (length_left >= kRtcpHeaderLength && (packet[0] >> 6) == 2) {
+      const int packet_length = 4 * (ReadUWord16(&packet[2]) + 1);
+      if (packet_length > length_left) {
+        break;
+      }
+      const uint8_t format = packet[0] & 0x1f;
+      const uint8_t payload_type = packet[1];
+      const bool for_destination =
+          packet_length >= kRtcpFeedbackHeaderLength &&
+          ReadUWord32(&packet[8]) == ssrc;
+      if (payload_type == kRtcpRtpfbPayloadType &&
+          format == kRtcpNackFormat && for_destination) {
+        ResendPackets(*destination, &packet[kRtcpFeedbackHeaderLength],
+                      packet_length - kRtcpFeedbackHeaderLength);
+      } else if (payload_type == kRtcpPsfbPayloadType &&
+                 format == kRtcpPliFormat && for_destination) {
+        request_key_frame = true;
+      } else if (payload_type == kRtcpPsfbPayloadType &&
+                 format == kRtcpFirFormat) {
+        // The SSRC of a FIR is in its items.
+        for (int i = kRtcpFeedbackHeaderLength;
+             i + kRtcpFirItemLength <= packet_length;
+             i += kRtcpFirItemLength) {
+          if (ReadUWord32(&packet[i]) == ssrc) {
+            request_key_frame = true;
+          }
+        }
+      }
+      packet += packet_length;
+      length_left -= packet_length;
+    }
+    request_key_frame = request_key_frame && rtp_rtcp_ &&
+        AllowKeyFrameRequest(TickTime::MillisecondTimestamp());
+  }
+  if (request_key_frame) {
+    rtp_rtcp_->RequestKeyFrame();
+  }
+}
+
+void ViERtpForwarder::GetStatistics(unsigned int* packets_forwarded,
+                                    unsigned int* bytes_forwarded) const {
+  CriticalSectionScoped cs(forward_cs_.get());
+  *packets_forwarded = packets_forwarded_;
+  *bytes_forwarded = bytes_forwarded_;
+}
+
+void ViERtpForwarder::AnchorDestination(Destination* destination,
+                                        uint16_t sequence_number,
+                                        uint32_t timestamp,
+                                        uint32_t ssrc,
+                                        int64_t now_ms) {
+  if (!destination->anchored || destination->incoming_ssrc != ssrc) {
+    if (destination->last_packet_time_ms < 0) {
+      // First packet, keep the incoming numbering.
+      destination->sequence_number_offset = 0;
+      destination->timestamp_offset = 0;
+      destination->last_sequence_number = sequence_number - 1;
+      destination->last_timestamp = timestamp;
+    } else {
+      // The incoming stream changed, continue where the previous stream
+      // ended and advance the timestamp by the time since its last packet.
+      const int64_t elapsed_ms = now_ms - destination->last_packet_time_ms;
+      const uint32_t elapsed_ticks = elapsed_ms > 0 ?
+          static_cast<uint32_t>(elapsed_ms * kVideoRtpTicksPerMs) : 1;
+      destination->sequence_number_offset = static_cast<uint16_t>(
+          destination->last_sequence_number + 1 - sequence_number);
+      destination->timestamp_offset =
+          destination->last_timestamp + elapsed_ticks - timestamp;
+    }
+    destination->anchored = true;
+    destination->incoming_ssrc = ssrc;
+  }
+
+  const uint16_t out_sequence_number = static_cast<uint16_t>(
+      sequence_number + destination->sequence_number_offset);
+  const uint32_t out_timestamp = timestamp + destination->timestamp_offset;
+  // Keep track of the newest packet, reordered packets are forwarded as is.
+  if (static_cast<uint16_t>(out_sequence_number -
+                            destination->last_sequence_number) < 0x8000) {
+    destination->last_sequence_number = out_sequence_number;
+  }
+  if (out_timestamp - destination->last_timestamp < 0x80000000) {
+    destination->last_timestamp = out_timestamp;
+  }
+  destination->last_packet_time_ms = now_ms;
+}
+
+void ViERtpForwarder::WriteHeader(const Destination& destination,
+                                  uint16_t sequence_number,
+                                  uint32_t timestamp) {
+  WriteUWord16(&packet_buffer_[2], static_cast<uint16_t>(
+      sequence_number + destination.sequence_number_offset));
+  WriteUWord32(&packet_buffer_[4], timestamp + destination.timestamp_offset);
+  // Read for every packet, the SSRC of the destination can change.
+  WriteUWord32(&packet_buffer_[8], destination.rtp_rtcp->SSRC());
+}
+
+bool ViERtpForwarder::UpdateSourceLeg(const uint8_t* rtp_packet,
+                                      int rtp_packet_length,
+                                      uint16_t sequence_number,
+                                      uint32_t ssrc,
+                                      bool nack_enabled,
+                                      std::vector<uint16_t>* missing) {
+  HistoryPacket& stored = history_[sequence_number % history_.size()];
+  memcpy(stored.data, rtp_packet, rtp_packet_length);
+  stored.length = rtp_packet_length;
+  stored.ssrc = ssrc;
+  stored.sequence_number = sequence_number;
+
+  if (!source_started_ || source_ssrc_ != ssrc) {
+    source_started_ = true;
+    source_ssrc_ = ssrc;
+    source_next_sequence_number_ = sequence_number + 1;
+    return true;
+  }
+  const uint16_t num_missing =
+      static_cast<uint16_t>(sequence_number - source_next_sequence_number_);
+  if (num_missing >= 0x8000) {
+    // Reordered or retransmitted.
+    return true;
+  }
+  source_next_sequence_number_ = sequence_number + 1;
+  if (num_missing == 0 || DecodeLocked()) {
+    // When decoding, the VCM of the receiving channel handles the losses.
+    return true;
+  }
+  if (num_missing > kMaxNackListSize) {
+    return false;
+  }
+  if (nack_enabled) {
+    for (uint16_t i = num_missing; i > 0; --i) {
+      missing->push_back(static_cast<uint16_t>(sequence_number - i));
+    }
+  }
+  return true;
+}
+
+void ViERtpForwarder::ResendPackets(const Destination& destination,
+                                    const uint8_t* fci,
+                                    int fci_length) {
+  if (!destination.anchored) {
+    return;
+  }
+  // Each item NACKs a packet id and the 16 packets after it in a bitmask.
+  for (int i = 0; i + 4 <= fci_length; i += 4) {
+    const uint16_t packet_id = ReadUWord16(&fci[i]);
+    const uint16_t bitmask = ReadUWord16(&fci[i + 2]);
+    for (int bit = -1; bit < 16; ++bit) {
+      if (bit >= 0 && (bitmask & (1 << bit)) == 0) {
+        continue;
+      }
+      const uint16_t sequence_number = static_cast<uint16_t>(
+          packet_id + bit + 1 - destination.sequence_number_offset);
+      const HistoryPacket& stored =
+          history_[sequence_number % history_.size()];
+      if (stored.length == 0 || stored.sequence_number != sequence_number ||
+          stored.ssrc != destination.incoming_ssrc) {
+        continue;
+      }
+      memcpy(packet_buffer_, stored.data, stored.length);
+      WriteHeader(destination, sequence_number, ReadUWord32(&stored.data[4]));
+      destination.transport->SendPacket(destination.destination_id,
+                                        packet_buffer_, stored.length);
+    }
+  }
+}
+
+bool ViERtpForwarder::AllowKeyFrameRequest(int64_t now_ms) {
+  if (last_key_frame_request_ms_ >= 0 &&
+      now_ms - last_key_frame_request_ms_ < kMinKeyFrameRequestIntervalMs) {
+    return false;
+  }
+  last_key_frame_request_ms_ = now_ms;
+  return true;
+}
+
+bool ViERtpForwarder::DecodeLocked() const {
+  for (Destinations::const_iterator it = destinations_.begin();
+       it != destinations_.end(); ++it) {
+    if (it->decode) {
+      return true;
+    }
+  }
+  return destinations_.empty();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// ViERtpForwarder forwards received RTP packets to other transports, with the
+// SSRC, sequence number and timestamp rewritten for each destination. RTCP is
+// not forwarded, it's terminated on each leg: NACKs from a destination are
+// answered from the history of forwarded packets, PLI and FIR become a key
+// frame request to the source, and losses on the source leg are NACKed by the
+// forwarder when the receiving channel doesn't decode the stream.
+
+#ifndef WEBRTC_VIDEO_ENGINE_VIE_RTP_FORWARDER_H_
+#define WEBRTC_VIDEO_ENGINE_VIE_RTP_FORWARDER_H_
+
+#include <list>
+#include <vector>
+
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "typedefs.h"  // NOLINT
+#include "video_engine/vie_defines.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class RtpRtcp;
+class Transport;
+
+class ViERtpForwarder {
+ public:
+  explicit ViERtpForwarder(const int32_t channel_id);
+  ~ViERtpForwarder();
+
+  // |module| receives the forwarded stream, key frames and retransmissions
+  // are requested from the source through it.
+  void SetRtpRtcpModule(RtpRtcp* module);
+
+  // Adds |transport| as a destination. |destination_id| is passed as id to
+  // Transport::SendPacket and identifies the destination in
+  // OnDestinationRTCPPacket. Packets are sent with the SSRC |rtp_rtcp| has
+  // when they are sent. The receiving channel decodes the forwarded packets
+  // as long as one of the destinations was added with |decode| true.
+  int AddDestination(Transport* transport, int destination_id,
+                     RtpRtcp* rtp_rtcp, bool decode);
+  int RemoveDestination(Transport* transport);
+
+  // Returns true if there is at least one destination.
+  bool Forwarding() const;
+
+  // Returns true if there are no destinations, or if a destination asked for
+  // the forwarded packets to be decoded.
+  bool DecodeForwardedPackets() const;
+
+  // Sends |rtp_packet|, which has been validated by the receiving RTP/RTCP
+  // module, to all destinations. Returns the number of destinations the packet
+  // was sent to, or -1 if the packet isn't a valid RTP packet.
+  int ForwardRTPPacket(const uint8_t* rtp_packet, int rtp_packet_length);
+
+  // Handles the (decrypted) RTCP received from the destination
+  // |destination_id|. PLI and FIR request a key frame from the source, NACKed
+  // packets are resent from the history.
+  void OnDestinationRTCPPacket(int destination_id, const uint8_t* rtcp_packet,
+                               int rtcp_packet_length);
+
+  // Number of forwarded packets and bytes sent by the transports, counted once
+  // per destination. Retransmissions aren't counted.
+  void GetStatistics(unsigned int* packets_forwarded,
+                     unsigned int* bytes_forwarded) const;
+
+ private:
+  struct Destination {
+    Transport* transport;
+    int destination_id;
+    RtpRtcp* rtp_rtcp;
+    bool decode;
+    // Set when the first packet is forwarded and when the incoming SSRC
+    // changes, to keep the outgoing sequence numbers and timestamps
+    // continuous.
+    bool anchored;
+    uint32_t incoming_ssrc;
+    uint16_t sequence_number_offset;
+    uint32_t timestamp_offset;
+    uint16_t last_sequence_number;
+    uint32_t last_timestamp;
+    int64_t last_packet_time_ms;
+  };
+  typedef std::list<Destination> Destinations;
+
+  // A forwarded packet as received, indexed by its sequence number.
+  struct HistoryPacket {
+    int length;
+    uint32_t ssrc;
+    uint16_t sequence_number;
+    uint8_t data[kViEMaxMtu];
+  };
+
+  // Updates the numbering of |destination| for an incoming packet.
+  void AnchorDestination(Destination* destination, uint16_t sequence_number,
+                         uint32_t timestamp, uint32_t ssrc, int64_t now_ms);
+  // Writes the header fields of |destination| to |packet_buffer_|, given the
+  // header fields of the incoming packet.
+  void WriteHeader(const Destination& destination, uint16_t sequence_number,
+                   uint32_t timestamp);
+  // Stores the packet and returns the sequence numbers missing on the source
+  // leg in |missing|. Returns false if too many are missing to be NACKed.
+  bool UpdateSourceLeg(const uint8_t* rtp_packet, int rtp_packet_length,
+                       uint16_t sequence_number, uint32_t ssrc,
+                       bool nack_enabled, std::vector<uint16_t>* missing);
+  // Resends the packets NACKed by |destination|, given the FCI of the NACK.
+  void ResendPackets(const Destination& destination, const uint8_t* fci,
+                     int fci_length);
+  // Returns true if a key frame request isn't throttled.
+  bool AllowKeyFrameRequest(int64_t now_ms);
+  bool DecodeLocked() const;
+
+  const int32_t channel_id_;
+  scoped_ptr<CriticalSectionWrapper> forward_cs_;
+  RtpRtcp* rtp_rtcp_;
+  Destinations destinations_;
+  // Allocated when the first destination is added.
+  std::vector<HistoryPacket> history_;
+  bool source_started_;
+  uint32_t source_ssrc_;
+  uint16_t source_next_sequence_number_;
+  int64_t last_key_frame_request_ms_;
+  uint8_t packet_buffer_[kViEMaxMtu];
+  unsigned int packets_forwarded_;
+  unsigned int bytes_forwarded_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_VIE_RTP_FORWARDER_H_
@@ -0,0 +1,415 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file includes unit tests for ViERtpForwarder.
+#include "video_engine/vie_rtp_forwarder.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "common_types.h"  // NOLINT
+#include "modules/rtp_rtcp/mocks/mock_rtp_rtcp.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/sleep.h"
+#include "system_wrappers/interface/tick_util.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace webrtc {
+
+static const int kPacketLength = 1200;
+static const uint32_t kIncomingSsrc = 0x11111111;
+static const uint32_t kSsrc1 = 0x1234;
+static const uint32_t kSsrc2 = 0x5678;
+
+struct RtpHeaderFields {
+  uint16_t sequence_number;
+  uint32_t timestamp;
+  uint32_t ssrc;
+};
+
+class FakeTransport : public Transport {
+ public:
+  FakeTransport()
+      : last_id_(-1), last_length_(0), extra_bytes_(0), count_only_(false) {}
+
+  virtual int SendPacket(int channel, const void* data, int len) {
+    last_id_ = channel;
+    last_length_ = len;
+    if (!count_only_) {
+      const uint8_t* packet = static_cast<const uint8_t*>(data);
+      RtpHeaderFields header;
+      header.sequence_number = (packet[2] << 8) | packet[3];
+      header.timestamp = (packet[4] << 24) | (packet[5] << 16) |
+          (packet[6] << 8) | packet[7];
+      header.ssrc = (packet[8] << 24) | (packet[9] << 16) |
+          (packet[10] << 8) | packet[11];
+      headers_.push_back(header);
+      last_payload_byte_ = packet[len - 1];
+    }
+    // Like an encrypting transport when |extra_bytes_| isn't 0.
+    return len + extra_bytes_;
+  }
+
+  virtual int SendRTCPPacket(int channel, const void* data, int len) {
+    ADD_FAILURE() << "RTCP must not be forwarded";
+    return len;
+  }
+
+  int last_id_;
+  int last_length_;
+  int extra_bytes_;
+  uint8_t last_payload_byte_;
+  bool count_only_;
+  std::vector<RtpHeaderFields> headers_;
+};
+
+// The SSRC of a destination's send stream, read without going through gmock.
+class FakeRtpRtcp : public NiceMock<MockRtpRtcp> {
+ public:
+  explicit FakeRtpRtcp(uint32_t ssrc) : ssrc_(ssrc) {}
+  virtual WebRtc_UWord32 SSRC() const { return ssrc_; }
+  uint32_t ssrc_;
+};
+
+class ViERtpForwarderTest : public ::testing::Test {
+ protected:
+  ViERtpForwarderTest()
+      : forwarder_(0),
+        destination1_(kSsrc1),
+        destination2_(kSsrc2) {
+    memset(packet_, 0, sizeof(packet_));
+    packet_[0] = 0x80;
+    packet_[1] = 100;
+    packet_[kPacketLength - 1] = 0x5a;
+    ON_CALL(source_, NACK()).WillByDefault(Return(kNackRtcp));
+    forwarder_.SetRtpRtcpModule(&source_);
+  }
+
+  void SetHeader(uint16_t sequence_number, uint32_t timestamp, uint32_t ssrc) {
+    packet_[2] = static_cast<uint8_t>(sequence_number >> 8);
+    packet_[3] = static_cast<uint8_t>(sequence_number);
+    for (int i = 0; i < 4; ++i) {
+      packet_[4 + i] = static_cast<uint8_t>(timestamp >> (24 - 8 * i));
+      packet_[8 + i] = static_cast<uint8_t>(ssrc >> (24 - 8 * i));
+    }
+  }
+
+  int Forward(uint16_t sequence_number, uint32_t timestamp, uint32_t ssrc) {
+    SetHeader(sequence_number, timestamp, ssrc);
+    return forwarder_.ForwardRTPPacket(packet_, kPacketLength);
+  }
+
+  // Builds an RTCP feedback message of |format| and |payload_type| for
+  // |media_ssrc|, followed by |fci|.
+  static std::vector<uint8_t> FeedbackMessage(
+      uint8_t format, uint8_t payload_type, uint32_t media_ssrc,
+      const std::vector<uint8_t>& fci) {
+    std::vector<uint8_t> packet(12, 0);
+    packet[0] = 0x80 | format;
+    packet[1] = payload_type;
+    const size_t words = (packet.size() + fci.size()) / 4 - 1;
+    packet[2] = static_cast<uint8_t>(words >> 8);
+    packet[3] = static_cast<uint8_t>(words);
+    for (int i = 0; i < 4; ++i) {
+      packet[8 + i] = static_cast<uint8_t>(media_ssrc >> (24 - 8 * i));
+    }
+    packet.insert(packet.end(), fci.begin(), fci.end());
+    return packet;
+  }
+
+  void ReceiveRtcp(int destination_id, const std::vector<uint8_t>& rtcp) {
+    forwarder_.OnDestinationRTCPPacket(destination_id, &rtcp[0],
+                                       static_cast<int>(rtcp.size()));
+  }
+
+  ViERtpForwarder forwarder_;
+  NiceMock<MockRtpRtcp> source_;
+  FakeRtpRtcp destination1_;
+  FakeRtpRtcp destination2_;
+  uint8_t packet_[kPacketLength];
+};
+
+TEST_F(ViERtpForwarderTest, RewritesSsrcPerDestination) {
+  FakeTransport transport1;
+  FakeTransport transport2;
+  EXPECT_FALSE(forwarder_.Forwarding());
+  EXPECT_EQ(0, Forward(1000, 90000, kIncomingSsrc));
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport1, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport2, 2, &destination2_,
+                                         false));
+  EXPECT_EQ(-1, forwarder_.AddDestination(&transport2, 2, &destination2_,
+                                          false));
+  EXPECT_TRUE(forwarder_.Forwarding());
+
+  EXPECT_EQ(2, Forward(1000, 90000, kIncomingSsrc));
+  EXPECT_EQ(2, Forward(1001, 93000, kIncomingSsrc));
+  ASSERT_EQ(2u, transport1.headers_.size());
+  ASSERT_EQ(2u, transport2.headers_.size());
+  EXPECT_EQ(1, transport1.last_id_);
+  EXPECT_EQ(2, transport2.last_id_);
+  EXPECT_EQ(kPacketLength, transport1.last_length_);
+  EXPECT_EQ(0x5a, transport2.last_payload_byte_);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(kSsrc1, transport1.headers_[i].ssrc);
+    EXPECT_EQ(kSsrc2, transport2.headers_[i].ssrc);
+    EXPECT_EQ(1000 + i, transport1.headers_[i].sequence_number);
+    EXPECT_EQ(1000 + i, transport2.headers_[i].sequence_number);
+    EXPECT_EQ(90000u + 3000 * i, transport2.headers_[i].timestamp);
+  }
+
+  unsigned int packets = 0;
+  unsigned int bytes = 0;
+  forwarder_.GetStatistics(&packets, &bytes);
+  EXPECT_EQ(4u, packets);
+  EXPECT_EQ(4u * kPacketLength, bytes);
+
+  EXPECT_EQ(0, forwarder_.RemoveDestination(&transport1));
+  EXPECT_EQ(-1, forwarder_.RemoveDestination(&transport1));
+  EXPECT_EQ(1, Forward(1002, 96000, kIncomingSsrc));
+  EXPECT_EQ(2u, transport1.headers_.size());
+  EXPECT_EQ(3u, transport2.headers_.size());
+}
+
+TEST_F(ViERtpForwarderTest, UsesTheCurrentSsrcOfTheDestination) {
+  FakeTransport transport;
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(1, Forward(1000, 90000, kIncomingSsrc));
+  destination1_.ssrc_ = 0x4321;
+  EXPECT_EQ(1, Forward(1001, 93000, kIncomingSsrc));
+  ASSERT_EQ(2u, transport.headers_.size());
+  EXPECT_EQ(kSsrc1, transport.headers_[0].ssrc);
+  EXPECT_EQ(0x4321u, transport.headers_[1].ssrc);
+}
+
+TEST_F(ViERtpForwarderTest, CountsTheBytesSentByTheTransport) {
+  FakeTransport transport;
+  transport.extra_bytes_ = 10;
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(1, Forward(1000, 90000, kIncomingSsrc));
+  unsigned int packets = 0;
+  unsigned int bytes = 0;
+  forwarder_.GetStatistics(&packets, &bytes);
+  EXPECT_EQ(1u, packets);
+  EXPECT_EQ(kPacketLength + 10u, bytes);
+}
+
+TEST_F(ViERtpForwarderTest, ContinuesNumberingWhenIncomingStreamChanges) {
+  FakeTransport transport;
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(1, Forward(65535, 0xffffff00, kIncomingSsrc));
+  EXPECT_EQ(1, Forward(0, 0x00000100, kIncomingSsrc));
+  // A reordered packet keeps its relative position.
+  EXPECT_EQ(1, Forward(65534, 0xfffffe00, kIncomingSsrc));
+  // New incoming stream with unrelated numbering.
+  EXPECT_EQ(1, Forward(20, 5000, 0x22222222));
+  EXPECT_EQ(1, Forward(21, 8000, 0x22222222));
+  ASSERT_EQ(5u, transport.headers_.size());
+  EXPECT_EQ(65535, transport.headers_[0].sequence_number);
+  EXPECT_EQ(0, transport.headers_[1].sequence_number);
+  EXPECT_EQ(65534, transport.headers_[2].sequence_number);
+  EXPECT_EQ(1, transport.headers_[3].sequence_number);
+  EXPECT_EQ(2, transport.headers_[4].sequence_number);
+  // The new stream continues after the last timestamp of the old stream.
+  const uint32_t timestamp_diff =
+      transport.headers_[3].timestamp - transport.headers_[1].timestamp;
+  EXPECT_GT(timestamp_diff, 0u);
+  EXPECT_LT(timestamp_diff, 0x80000000u);
+  EXPECT_EQ(3000u,
+            transport.headers_[4].timestamp - transport.headers_[3].timestamp);
+  for (size_t i = 0; i < transport.headers_.size(); ++i) {
+    EXPECT_EQ(kSsrc1, transport.headers_[i].ssrc);
+  }
+}
+
+TEST_F(ViERtpForwarderTest, DropsInvalidPackets) {
+  FakeTransport transport;
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(-1, forwarder_.ForwardRTPPacket(packet_, 11));
+  EXPECT_EQ(-1, forwarder_.ForwardRTPPacket(packet_, kViEMaxMtu + 1));
+  packet_[0] = 0x40;
+  EXPECT_EQ(-1, forwarder_.ForwardRTPPacket(packet_, kPacketLength));
+  EXPECT_TRUE(transport.headers_.empty());
+}
+
+TEST_F(ViERtpForwarderTest, DecodesWhileADestinationAsksForIt) {
+  FakeTransport transport1;
+  FakeTransport transport2;
+  EXPECT_TRUE(forwarder_.DecodeForwardedPackets());
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport1, 1, &destination1_,
+                                         true));
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport2, 2, &destination2_,
+                                         false));
+  EXPECT_TRUE(forwarder_.DecodeForwardedPackets());
+  EXPECT_EQ(0, forwarder_.RemoveDestination(&transport1));
+  EXPECT_FALSE(forwarder_.DecodeForwardedPackets());
+  EXPECT_EQ(0, forwarder_.RemoveDestination(&transport2));
+  EXPECT_TRUE(forwarder_.DecodeForwardedPackets());
+}
+
+TEST_F(ViERtpForwarderTest, AnswersNackFromTheHistory) {
+  FakeTransport transport1;
+  FakeTransport transport2;
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport1, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport2, 2, &destination2_,
+                                         false));
+  for (int i = 0; i < 5; ++i) {
+    packet_[kPacketLength - 1] = static_cast<uint8_t>(i);
+    EXPECT_EQ(2, Forward(100 + i, 90000 + 3000 * i, kIncomingSsrc));
+  }
+
+  // NACK of 101, and of 103 in the bitmask.
+  std::vector<uint8_t> fci;
+  fci.push_back(0);
+  fci.push_back(101);
+  fci.push_back(0);
+  fci.push_back(0x02);
+  ReceiveRtcp(2, FeedbackMessage(1, 205, kSsrc2, fci));
+  ASSERT_EQ(7u, transport2.headers_.size());
+  EXPECT_EQ(101, transport2.headers_[5].sequence_number);
+  EXPECT_EQ(93000u, transport2.headers_[5].timestamp);
+  EXPECT_EQ(kSsrc2, transport2.headers_[5].ssrc);
+  EXPECT_EQ(103, transport2.headers_[6].sequence_number);
+  EXPECT_EQ(3, transport2.last_payload_byte_);
+  EXPECT_EQ(5u, transport1.headers_.size());
+
+  // A NACK for another SSRC or a packet that wasn't forwarded isn't answered.
+  ReceiveRtcp(1, FeedbackMessage(1, 205, kSsrc2, fci));
+  fci[1] = 200;
+  ReceiveRtcp(2, FeedbackMessage(1, 205, kSsrc2, fci));
+  EXPECT_EQ(5u, transport1.headers_.size());
+  EXPECT_EQ(7u, transport2.headers_.size());
+
+  // Retransmissions aren't counted as forwarded.
+  unsigned int packets = 0;
+  unsigned int bytes = 0;
+  forwarder_.GetStatistics(&packets, &bytes);
+  EXPECT_EQ(10u, packets);
+}
+
+TEST_F(ViERtpForwarderTest, RequestsKeyFrameOnPliAndFir) {
+  FakeTransport transport;
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(1, Forward(100, 90000, kIncomingSsrc));
+
+  // A PLI for another SSRC is ignored, requests following closely are
+  // collapsed into one.
+  EXPECT_CALL(source_, RequestKeyFrame()).Times(1);
+  ReceiveRtcp(1, FeedbackMessage(1, 206, kSsrc2, std::vector<uint8_t>()));
+  ReceiveRtcp(1, FeedbackMessage(1, 206, kSsrc1, std::vector<uint8_t>()));
+  ReceiveRtcp(1, FeedbackMessage(1, 206, kSsrc1, std::vector<uint8_t>()));
+  // Unknown destination.
+  ReceiveRtcp(2, FeedbackMessage(1, 206, kSsrc1, std::vector<uint8_t>()));
+  ::testing::Mock::VerifyAndClearExpectations(&source_);
+
+  // FIR, with the SSRC in the item.
+  std::vector<uint8_t> fci(8, 0);
+  fci[2] = static_cast<uint8_t>(kSsrc1 >> 8);
+  fci[3] = static_cast<uint8_t>(kSsrc1);
+  SleepMs(250);
+  EXPECT_CALL(source_, RequestKeyFrame()).Times(1);
+  ReceiveRtcp(1, FeedbackMessage(4, 206, 0, fci));
+}
+
+// Records the sequence numbers passed to SendNACK.
+class NackRecorder {
+ public:
+  WebRtc_Word32 SendNACK(const WebRtc_UWord16* list,
+                         const WebRtc_UWord16 size) {
+    sequence_numbers_.insert(sequence_numbers_.end(), list, list + size);
+    return 0;
+  }
+  std::vector<uint16_t> sequence_numbers_;
+};
+
+TEST_F(ViERtpForwarderTest, NacksSourceLossesWhenNotDecoding) {
+  FakeTransport transport;
+  NackRecorder recorder;
+  EXPECT_CALL(source_, SendNACK(_, _))
+      .WillRepeatedly(Invoke(&recorder, &NackRecorder::SendNACK));
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         false));
+  EXPECT_EQ(1, Forward(65534, 90000, kIncomingSsrc));
+  EXPECT_EQ(1, Forward(2, 93000, kIncomingSsrc));
+  ASSERT_EQ(3u, recorder.sequence_numbers_.size());
+  EXPECT_EQ(65535, recorder.sequence_numbers_[0]);
+  EXPECT_EQ(0, recorder.sequence_numbers_[1]);
+  EXPECT_EQ(1, recorder.sequence_numbers_[2]);
+  // The retransmission is forwarded, and doesn't cause another NACK.
+  EXPECT_EQ(1, Forward(0, 90000, kIncomingSsrc));
+  EXPECT_EQ(3u, recorder.sequence_numbers_.size());
+
+  // Too many losses to be NACKed.
+  EXPECT_CALL(source_, RequestKeyFrame()).Times(1);
+  EXPECT_EQ(1, Forward(2 + kMaxNackListSize + 2, 96000, kIncomingSsrc));
+  EXPECT_EQ(3u, recorder.sequence_numbers_.size());
+}
+
+TEST_F(ViERtpForwarderTest, LeavesSourceLossesToTheDecoder) {
+  FakeTransport transport;
+  EXPECT_CALL(source_, SendNACK(_, _)).Times(0);
+  EXPECT_CALL(source_, RequestKeyFrame()).Times(0);
+  EXPECT_EQ(0, forwarder_.AddDestination(&transport, 1, &destination1_,
+                                         true));
+  EXPECT_EQ(1, Forward(100, 90000, kIncomingSsrc));
+  EXPECT_EQ(1, Forward(105, 93000, kIncomingSsrc));
+  EXPECT_EQ(1, Forward(2000, 96000, kIncomingSsrc));
+}
+
+// Measures the number of forwarded packets per second on one thread.
+TEST_F(ViERtpForwarderTest, ForwardingThroughputBenchmark) {
+  const int kNumDestinations[] = { 1, 10, 100 };
+  const int kNumPackets = 20000;
+  for (size_t n = 0; n < sizeof(kNumDestinations) / sizeof(int); ++n) {
+    ViERtpForwarder forwarder(0);
+    std::vector<FakeTransport> transports(kNumDestinations[n]);
+    std::vector<FakeRtpRtcp*> destinations;
+    for (size_t i = 0; i < transports.size(); ++i) {
+      transports[i].count_only_ = true;
+      destinations.push_back(new FakeRtpRtcp(i + 1));
+      EXPECT_EQ(0, forwarder.AddDestination(&transports[i], i,
+                                            destinations[i], false));
+    }
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < kNumPackets; ++i) {
+      SetHeader(static_cast<uint16_t>(i), i / 10 * 3000, kIncomingSsrc);
+      forwarder.ForwardRTPPacket(packet_, kPacketLength);
+    }
+    const int64_t elapsed_us =
+        TickTime::MicrosecondTimestamp() - start_us + 1;
+    unsigned int packets = 0;
+    unsigned int bytes = 0;
+    forwarder.GetStatistics(&packets, &bytes);
+    EXPECT_EQ(static_cast<unsigned int>(kNumPackets * kNumDestinations[n]),
+              packets);
+    printf("Forwarded %d packets to %d destinations: %.0f packets/s\n",
+           kNumPackets, kNumDestinations[n], 1e6 * packets / elapsed_us);
+    for (size_t i = 0; i < destinations.size(); ++i) {
+      delete destinations[i];
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -966,6 +966,76 @@ int ViERTP_RTCPImpl::StopRTPDump(const int video_channel,
   return 0;
 }
 
+int ViERTP_RTCPImpl::StartRTPForwarding(const int video_channel,
+                                        const int destination_channel,
+                                        const bool decode) {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
+               ViEId(shared_data_->instance_id(), video_channel),
+               "%s(channel: %d, destination_channel: %d, decode: %d)",
+               __FUNCTION__, video_channel, destination_channel, decode);
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEChannel* vie_channel = cs.Channel(video_channel);
+  ViEChannel* destination = cs.Channel(destination_channel);
+  if (!vie_channel || !destination) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: Channel %d or %d doesn't exist", __FUNCTION__,
+                 video_channel, destination_channel);
+    shared_data_->SetLastError(kViERtpRtcpInvalidChannelId);
+    return -1;
+  }
+  if (vie_channel->StartRTPForwarding(destination, decode) != 0) {
+    shared_data_->SetLastError(kViERtpRtcpUnknownError);
+    return -1;
+  }
+  return 0;
+}
+
+int ViERTP_RTCPImpl::StopRTPForwarding(const int video_channel,
+                                       const int destination_channel) {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
+               ViEId(shared_data_->instance_id(), video_channel),
+               "%s(channel: %d, destination_channel: %d)", __FUNCTION__,
+               video_channel, destination_channel);
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEChannel* vie_channel = cs.Channel(video_channel);
+  ViEChannel* destination = cs.Channel(destination_channel);
+  if (!vie_channel || !destination) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: Channel %d or %d doesn't exist", __FUNCTION__,
+                 video_channel, destination_channel);
+    shared_data_->SetLastError(kViERtpRtcpInvalidChannelId);
+    return -1;
+  }
+  if (vie_channel->StopRTPForwarding(destination) != 0) {
+    shared_data_->SetLastError(kViERtpRtcpUnknownError);
+    return -1;
+  }
+  return 0;
+}
+
+int ViERTP_RTCPImpl::GetRTPForwardingStatistics(
+    const int video_channel,
+    unsigned int& packets_forwarded,
+    unsigned int& bytes_forwarded) const {
+  WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
+               ViEId(shared_data_->instance_id(), video_channel),
+               "%s(channel: %d)", __FUNCTION__, video_channel);
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEChannel* vie_channel = cs.Channel(video_channel);
+  if (!vie_channel) {
+    WEBRTC_TRACE(kTraceError, kTraceVideo,
+                 ViEId(shared_data_->instance_id(), video_channel),
+                 "%s: Channel %d doesn't exist", __FUNCTION__, video_channel);
+    shared_data_->SetLastError(kViERtpRtcpInvalidChannelId);
+    return -1;
+  }
+  vie_channel->GetRTPForwardingStatistics(&packets_forwarded,
+                                          &bytes_forwarded);
+  return 0;
+}
+
 int ViERTP_RTCPImpl::RegisterRTPObserver(const int video_channel,
                                          ViERTPObserver& observer) {
   WEBRTC_TRACE(kTraceApiCall, kTraceVideo,
@@ -113,6 +113,14 @@ class ViERTP_RTCPImpl
                            const char file_nameUTF8[1024],
                            RTPDirections direction);
   virtual int StopRTPDump(const int video_channel, RTPDirections direction);
+  virtual int StartRTPForwarding(const int video_channel,
+                                 const int destination_channel,
+                                 const bool decode);
+  virtual int StopRTPForwarding(const int video_channel,
+                                const int destination_channel);
+  virtual int GetRTPForwardingStatistics(const int video_channel,
+                                         unsigned int& packets_forwarded,
+                                         unsigned int& bytes_forwarded) const;
   virtual int RegisterRTPObserver(const int video_channel,
                                   ViERTPObserver& observer);
   virtual int DeregisterRTPObserver(const int video_channel);
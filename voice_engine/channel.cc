@@ -13,6 +13,7 @@
 #include "webrtc/modules/audio_device/include/audio_device.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/utility/interface/audio_frame_operations.h"
+#include "webrtc/modules/utility/interface/decoded_audio_cache.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/modules/utility/interface/rtp_dump.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -1023,7 +1024,8 @@ Channel::RecordFileEnded(const WebRtc_Word32 id)
 Channel::Channel(const WebRtc_Word32 channelId,
                  const WebRtc_UWord32 instanceId) :
     _fileCritSect(*CriticalSectionWrapper::CreateCriticalSection()),
-    _callbackCritSect(*CriticalSectionWrapper::CreateCriticalSection()),
+    _callbackCritSect(*CriticalSectionWrapper::CreateCriticalSection(
+        "voe::Channel callbacks")),
     _instanceId(instanceId),
     _channelId(channelId),
     _audioCodingModule(*AudioCodingModule::Create(
@@ -1040,6 +1042,7 @@ Channel::Channel(const WebRtc_Word32 channelId,
     _inputFilePlayerPtr(NULL),
     _outputFilePlayerPtr(NULL),
     _outputFileRecorderPtr(NULL),
+    _decodedAudioCache(DecodedAudioCache::GetInstance()),
     // Avoid conflict with other channels by adding 1024 - 1026,
     // won't use as much as 1024 channels.
     _inputFilePlayerId(VoEModuleId(instanceId, channelId) + 1024),
@@ -1111,6 +1114,7 @@ Channel::Channel(const WebRtc_Word32 channelId,
     _connectionObserverPtr(NULL),
     _countAliveDetections(0),
     _countDeadDetections(0),
+    _statisticsPublishing(false),
     _outputSpeechType(AudioFrame::kNormalSpeech),
     _averageDelayMs(0),
     _previousSequenceNumber(0),
@@ -1126,6 +1130,8 @@ Channel::Channel(const WebRtc_Word32 channelId,
     _inbandDtmfQueue.ResetDtmf();
     _inbandDtmfGenerator.Init();
     _outputAudioLevel.Clear();
+    memset(&_statisticsSnapshot, 0, sizeof(_statisticsSnapshot));
+    _statisticsSnapshot.channel = _channelId;
 
     RtpRtcp::Configuration configuration;
     configuration.id = VoEModuleId(instanceId, channelId);
@@ -1195,6 +1201,7 @@ Channel::~Channel()
             _outputFileRecorderPtr = NULL;
         }
     }
+    DecodedAudioCache::ReturnInstance();
 
     // The order to safely shutdown modules in a channel is:
     // 1. De-register callbacks in modules
@@ -3284,8 +3291,9 @@ int Channel::StartPlayingFileLocally(const char* fileName,
             _outputFilePlayerPtr = NULL;
         }
 
-        _outputFilePlayerPtr = FilePlayer::CreateFilePlayer(
-            _outputFilePlayerId, (const FileFormats)format);
+        _outputFilePlayerPtr = FilePlayer::CreateCachedFilePlayer(
+            _outputFilePlayerId, (const FileFormats)format,
+            _decodedAudioCache);
 
         if (_outputFilePlayerPtr == NULL)
         {
@@ -3571,8 +3579,8 @@ int Channel::StartPlayingFileAsMicrophone(const char* fileName,
     }
 
     // Create the instance
-    _inputFilePlayerPtr = FilePlayer::CreateFilePlayer(
-        _inputFilePlayerId, (const FileFormats)format);
+    _inputFilePlayerPtr = FilePlayer::CreateCachedFilePlayer(
+        _inputFilePlayerId, (const FileFormats)format, _decodedAudioCache);
 
     if (_inputFilePlayerPtr == NULL)
     {
@@ -4998,21 +5006,7 @@ int Channel::GetRemoteRTCPReportBlocks(
 int
 Channel::GetRTPStatistics(CallStatistics& stats)
 {
-    WebRtc_UWord8 fraction_lost(0);
-    WebRtc_UWord32 cum_lost(0);
-    WebRtc_UWord32 ext_max(0);
-    WebRtc_UWord32 jitter(0);
-    WebRtc_UWord32 max_jitter(0);
-
-    // --- Part one of the final structure (four values)
-
-    // The jitter statistics is updated for each received RTP packet and is
-    // based on received packets.
-    if (_rtpRtcpModule->StatisticsRTP(&fraction_lost,
-                                     &cum_lost,
-                                     &ext_max,
-                                     &jitter,
-                                     &max_jitter) != 0)
+    if (!ReadRTPStatistics(stats))
     {
         _engineStatisticsPtr->SetLastError(
             VE_CANNOT_RETRIEVE_RTP_STAT, kTraceWarning,
@@ -5020,11 +5014,6 @@ Channel::GetRTPStatistics(CallStatistics& stats)
             "RTP/RTCP module");
     }
 
-    stats.fractionLost = fraction_lost;
-    stats.cumulativeLost = cum_lost;
-    stats.extendedMax = ext_max;
-    stats.jitterSamples = jitter;
-
     WEBRTC_TRACE(kTraceStateInfo, kTraceVoice,
                  VoEId(_instanceId, _channelId),
                  "GetRTPStatistics() => fractionLost=%lu, cumulativeLost=%lu,"
@@ -5032,49 +5021,76 @@ Channel::GetRTPStatistics(CallStatistics& stats)
                  stats.fractionLost, stats.cumulativeLost, stats.extendedMax,
                  stats.jitterSamples);
 
-    // --- Part two of the final structure (one value)
-
-    WebRtc_UWord16 RTT(0);
-    RTCPMethod method = _rtpRtcpModule->RTCP();
-    if (method == kRtcpOff)
+    if (_rtpRtcpModule->RTCP() == kRtcpOff)
     {
         WEBRTC_TRACE(kTraceWarning, kTraceVoice,
                      VoEId(_instanceId, _channelId),
                      "GetRTPStatistics() RTCP is disabled => valid RTT "
                      "measurements cannot be retrieved");
-    } else
+    } else if (_rtpRtcpModule->RemoteSSRC() == 0)
     {
-        // The remote SSRC will be zero if no RTP packet has been received.
-        WebRtc_UWord32 remoteSSRC = _rtpRtcpModule->RemoteSSRC();
-        if (remoteSSRC > 0)
-        {
-            WebRtc_UWord16 avgRTT(0);
-            WebRtc_UWord16 maxRTT(0);
-            WebRtc_UWord16 minRTT(0);
-
-            if (_rtpRtcpModule->RTT(remoteSSRC, &RTT, &avgRTT, &minRTT, &maxRTT)
-                != 0)
-            {
-                WEBRTC_TRACE(kTraceWarning, kTraceVoice,
-                             VoEId(_instanceId, _channelId),
-                             "GetRTPStatistics() failed to retrieve RTT from "
-                             "the RTP/RTCP module");
-            }
-        } else
-        {
-            WEBRTC_TRACE(kTraceWarning, kTraceVoice,
-                         VoEId(_instanceId, _channelId),
-                         "GetRTPStatistics() failed to measure RTT since no "
-                         "RTP packets have been received yet");
-        }
+        WEBRTC_TRACE(kTraceWarning, kTraceVoice,
+                     VoEId(_instanceId, _channelId),
+                     "GetRTPStatistics() failed to measure RTT since no "
+                     "RTP packets have been received yet");
     }
 
-    stats.rttMs = static_cast<int> (RTT);
-
     WEBRTC_TRACE(kTraceStateInfo, kTraceVoice,
                  VoEId(_instanceId, _channelId),
                  "GetRTPStatistics() => rttMs=%d", stats.rttMs);
 
+    WEBRTC_TRACE(kTraceStateInfo, kTraceVoice,
+                 VoEId(_instanceId, _channelId),
+                 "GetRTPStatistics() => bytesSent=%d, packetsSent=%d,"
+                 " bytesReceived=%d, packetsReceived=%d)",
+                 stats.bytesSent, stats.packetsSent, stats.bytesReceived,
+                 stats.packetsReceived);
+
+    return 0;
+}
+
+// Doesn't trace or set the last error, since it's also called for the
+// statistics snapshots. Returns false if the RTP/RTCP module has no receive
+// statistics.
+bool
+Channel::ReadRTPStatistics(CallStatistics& stats)
+{
+    WebRtc_UWord8 fraction_lost(0);
+    WebRtc_UWord32 cum_lost(0);
+    WebRtc_UWord32 ext_max(0);
+    WebRtc_UWord32 jitter(0);
+    WebRtc_UWord32 max_jitter(0);
+
+    // --- Part one of the final structure (four values)
+
+    // The jitter statistics is updated for each received RTP packet and is
+    // based on received packets.
+    const bool statisticsRead = _rtpRtcpModule->StatisticsRTP(&fraction_lost,
+                                                              &cum_lost,
+                                                              &ext_max,
+                                                              &jitter,
+                                                              &max_jitter) == 0;
+
+    stats.fractionLost = fraction_lost;
+    stats.cumulativeLost = cum_lost;
+    stats.extendedMax = ext_max;
+    stats.jitterSamples = jitter;
+
+    // --- Part two of the final structure (one value)
+
+    WebRtc_UWord16 RTT(0);
+    // The remote SSRC will be zero if no RTP packet has been received.
+    WebRtc_UWord32 remoteSSRC = _rtpRtcpModule->RemoteSSRC();
+    if (_rtpRtcpModule->RTCP() != kRtcpOff && remoteSSRC > 0)
+    {
+        WebRtc_UWord16 avgRTT(0);
+        WebRtc_UWord16 maxRTT(0);
+        WebRtc_UWord16 minRTT(0);
+        _rtpRtcpModule->RTT(remoteSSRC, &RTT, &avgRTT, &minRTT, &maxRTT);
+    }
+
+    stats.rttMs = static_cast<int> (RTT);
+
     // --- Part three of the final structure (four values)
 
     WebRtc_UWord32 bytesSent(0);
@@ -5082,30 +5098,17 @@ Channel::GetRTPStatistics(CallStatistics& stats)
     WebRtc_UWord32 bytesReceived(0);
     WebRtc_UWord32 packetsReceived(0);
 
-    if (_rtpRtcpModule->DataCountersRTP(&bytesSent,
-                                       &packetsSent,
-                                       &bytesReceived,
-                                       &packetsReceived) != 0)
-    {
-        WEBRTC_TRACE(kTraceWarning, kTraceVoice,
-                     VoEId(_instanceId, _channelId),
-                     "GetRTPStatistics() failed to retrieve RTP datacounters =>"
-                     " output will not be complete");
-    }
+    _rtpRtcpModule->DataCountersRTP(&bytesSent,
+                                    &packetsSent,
+                                    &bytesReceived,
+                                    &packetsReceived);
 
     stats.bytesSent = bytesSent;
     stats.packetsSent = packetsSent;
     stats.bytesReceived = bytesReceived;
     stats.packetsReceived = packetsReceived;
 
-    WEBRTC_TRACE(kTraceStateInfo, kTraceVoice,
-                 VoEId(_instanceId, _channelId),
-                 "GetRTPStatistics() => bytesSent=%d, packetsSent=%d,"
-                 " bytesReceived=%d, packetsReceived=%d)",
-                 stats.bytesSent, stats.packetsSent, stats.bytesReceived,
-                 stats.packetsReceived);
-
-    return 0;
+    return statisticsRead;
 }
 
 int Channel::SetFECStatus(bool enable, int redPayloadtype) {
@@ -5596,6 +5599,20 @@ Channel::GetNetworkStatistics(NetworkStatistics& stats)
 {
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::GetNetworkStatistics()");
+    // While snapshots are published, NetEQ is only read by the publisher,
+    // since reading it resets the rates.
+    ChannelStatisticsSnapshot snapshot;
+    if (ReadStatisticsSnapshot(snapshot))
+    {
+        stats = snapshot.network;
+        return 0;
+    }
+    return ReadNetworkStatistics(stats);
+}
+
+int
+Channel::ReadNetworkStatistics(NetworkStatistics& stats)
+{
     ACMNetworkStatistics acm_stats;
     int return_value = _audioCodingModule.NetworkStatistics(&acm_stats);
     if (return_value >= 0) {
@@ -6000,6 +6017,63 @@ Channel::GetDeadOrAliveCounters(int& countDead, int& countAlive) const
     return 0;
 }
 
+void
+Channel::PublishStatistics(WebRtc_Word64 nowMs)
+{
+    ChannelStatisticsSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.channel = _channelId;
+    snapshot.timestampMs = nowMs;
+    ReadRTPStatistics(snapshot.rtp);
+    ReadNetworkStatistics(snapshot.network);
+
+    // Readers retry while the sequence is odd or has changed.
+    ++_statisticsSequence;
+    _statisticsSnapshot = snapshot;
+    _statisticsPublishing = true;
+    ++_statisticsSequence;
+}
+
+void
+Channel::StopPublishingStatistics()
+{
+    ++_statisticsSequence;
+    _statisticsPublishing = false;
+    ++_statisticsSequence;
+}
+
+void
+Channel::GetStatisticsSnapshot(ChannelStatisticsSnapshot& snapshot)
+{
+    ReadStatisticsSnapshot(snapshot);
+}
+
+// Returns true if the snapshots are being published.
+bool
+Channel::ReadStatisticsSnapshot(ChannelStatisticsSnapshot& snapshot)
+{
+    WebRtc_Word32 sequence = _statisticsSequence.AcquireLoad();
+    while (true)
+    {
+        if (sequence % 2 == 0)
+        {
+            snapshot = _statisticsSnapshot;
+            const bool publishing = _statisticsPublishing;
+            const WebRtc_Word32 sequenceAfter =
+                _statisticsSequence.AcquireLoad();
+            if (sequenceAfter == sequence)
+            {
+                return publishing;
+            }
+            sequence = sequenceAfter;
+        }
+        else
+        {
+            sequence = _statisticsSequence.AcquireLoad();
+        }
+    }
+}
+
 WebRtc_Word32
 Channel::SendPacketRaw(const void *data, int len, bool RTCP)
 {
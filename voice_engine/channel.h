@@ -18,10 +18,12 @@
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
 #include "webrtc/modules/utility/interface/file_player.h"
 #include "webrtc/modules/utility/interface/file_recorder.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/voice_engine/dtmf_inband.h"
 #include "webrtc/voice_engine/dtmf_inband_queue.h"
 #include "webrtc/voice_engine/include/voe_audio_processing.h"
+#include "webrtc/voice_engine/include/voe_call_report.h"
 #include "webrtc/voice_engine/include/voe_network.h"
 #include "webrtc/voice_engine/level_indicator.h"
 #include "webrtc/voice_engine/shared_data.h"
@@ -37,6 +39,7 @@
 namespace webrtc
 {
 class CriticalSectionWrapper;
+class DecodedAudioCache;
 class ProcessThread;
 class AudioDeviceModule;
 class RtpRtcp;
@@ -240,6 +243,12 @@ public:
     int ResetRTCPStatistics();
     int GetRoundTripTimeSummary(StatVal& delaysMs) const;
     int GetDeadOrAliveCounters(int& countDead, int& countAlive) const;
+    // Called by the statistics publisher only.
+    void PublishStatistics(WebRtc_Word64 nowMs);
+    // Called once the statistics publisher has stopped.
+    void StopPublishingStatistics();
+    // Doesn't take any lock, retries while a snapshot is being published.
+    void GetStatisticsSnapshot(ChannelStatisticsSnapshot& snapshot);
 
     // VoENetEqStats
     int GetNetworkStatistics(NetworkStatistics& stats);
@@ -494,6 +503,9 @@ private:
                                    const int mixingFrequency);
     WebRtc_Word32 GetPlayoutTimeStamp(WebRtc_UWord32& playoutTimestamp);
     void UpdateDeadOrAliveCounters(bool alive);
+    bool ReadRTPStatistics(CallStatistics& stats);
+    int ReadNetworkStatistics(NetworkStatistics& stats);
+    bool ReadStatisticsSnapshot(ChannelStatisticsSnapshot& snapshot);
     WebRtc_Word32 SendPacketRaw(const void *data, int len, bool RTCP);
     WebRtc_Word32 UpdatePacketDelay(const WebRtc_UWord32 timestamp,
                                     const WebRtc_UWord16 sequenceNumber);
@@ -524,6 +536,8 @@ private:
     FilePlayer* _inputFilePlayerPtr;
     FilePlayer* _outputFilePlayerPtr;
     FileRecorder* _outputFileRecorderPtr;
+    // Shares the decoded files between the players of all channels.
+    DecodedAudioCache* _decodedAudioCache;
     int _inputFilePlayerId;
     int _outputFilePlayerId;
     int _outputFileRecorderId;
@@ -602,6 +616,11 @@ private:
     VoEConnectionObserver* _connectionObserverPtr;
     WebRtc_UWord32 _countAliveDetections;
     WebRtc_UWord32 _countDeadDetections;
+    // VoECallReport
+    // Odd while the snapshot or the publishing state is being written.
+    Atomic32 _statisticsSequence;
+    ChannelStatisticsSnapshot _statisticsSnapshot;
+    bool _statisticsPublishing;
     AudioFrame::SpeechType _outputSpeechType;
     // VoEVideoSync
     WebRtc_UWord32 _averageDelayMs;
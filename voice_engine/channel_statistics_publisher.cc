@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/channel_statistics_publisher.h"
+
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/voice_engine/channel.h"
+#include "webrtc/voice_engine/channel_manager.h"
+
+namespace webrtc {
+namespace voe {
+
+namespace {
+
+const int64_t kPublishIntervalMs = 1000;
+
+}  // namespace
+
+ChannelStatisticsPublisher::ChannelStatisticsPublisher(
+    ChannelManager* channel_manager)
+    : channel_manager_(channel_manager),
+      last_publish_time_ms_(0) {
+}
+
+ChannelStatisticsPublisher::~ChannelStatisticsPublisher() {}
+
+int32_t ChannelStatisticsPublisher::TimeUntilNextProcess() {
+  if (last_publish_time_ms_ == 0) {
+    return 0;
+  }
+  const int64_t elapsed_ms =
+      TickTime::MillisecondTimestamp() - last_publish_time_ms_;
+  return elapsed_ms >= kPublishIntervalMs ?
+      0 : static_cast<int32_t>(kPublishIntervalMs - elapsed_ms);
+}
+
+int32_t ChannelStatisticsPublisher::Process() {
+  last_publish_time_ms_ = TickTime::MillisecondTimestamp();
+  // Only holds the channel list shared, like the media threads.
+  ScopedChannel sc(*channel_manager_);
+  void* iterator = NULL;
+  for (Channel* channel = sc.GetFirstChannel(iterator); channel != NULL;
+       channel = sc.GetNextChannel(iterator)) {
+    channel->PublishStatistics(last_publish_time_ms_);
+  }
+  return 0;
+}
+
+}  // namespace voe
+}  // namespace webrtc
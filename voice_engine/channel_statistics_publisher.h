@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2013 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VOICE_ENGINE_CHANNEL_STATISTICS_PUBLISHER_H_
+#define WEBRTC_VOICE_ENGINE_CHANNEL_STATISTICS_PUBLISHER_H_
+
+#include "webrtc/modules/interface/module.h"
+#include "webrtc/system_wrappers/interface/constructor_magic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace voe {
+
+class ChannelManager;
+
+// Publishes a statistics snapshot of every channel once per second when run
+// by a process thread, so that the snapshots can be read without taking the
+// locks of the channels.
+class ChannelStatisticsPublisher : public Module {
+ public:
+  explicit ChannelStatisticsPublisher(ChannelManager* channel_manager);
+  virtual ~ChannelStatisticsPublisher();
+
+  // Implements Module.
+  virtual int32_t TimeUntilNextProcess();
+  virtual int32_t Process();
+
+ private:
+  ChannelManager* channel_manager_;
+  // 0 until the first snapshot, which is taken right away.
+  int64_t last_publish_time_ms_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChannelStatisticsPublisher);
+};
+
+}  // namespace voe
+}  // namespace webrtc
+
+#endif  // WEBRTC_VOICE_ENGINE_CHANNEL_STATISTICS_PUBLISHER_H_
@@ -15,6 +15,7 @@
 //  - Round Trip Time (RTT) statistics.
 //  - Dead-or-Alive connection summary.
 //  - Generation of call reports to text files.
+//  - Periodic snapshots of the RTP and network statistics of all channels.
 //
 // Usage example, omitting error checking:
 //
@@ -35,11 +36,25 @@
 #define WEBRTC_VOICE_ENGINE_VOE_CALL_REPORT_H
 
 #include "common_types.h"
+#include "voe_rtp_rtcp.h"  // CallStatistics
 
 namespace webrtc {
 
 class VoiceEngine;
 
+// Statistics of a channel, as published at the last snapshot.
+struct ChannelStatisticsSnapshot
+{
+    int channel;
+    // Time of the snapshot in milliseconds, 0 before the first snapshot.
+    WebRtc_Word64 timestampMs;
+    // As returned by VoERTP_RTCP::GetRTCPStatistics().
+    CallStatistics rtp;
+    // NetEQ network statistics. The rates cover the time since the previous
+    // snapshot.
+    NetworkStatistics network;
+};
+
 // VoECallReport
 class WEBRTC_DLLEXPORT VoECallReport
 {
@@ -77,6 +92,22 @@ public:
     // of all the statistics that can be obtained by the call report sub-API.
     virtual int WriteReportToFile(const char* fileNameUTF8) = 0;
 
+    // Enables or disables snapshots of the statistics of all channels. The
+    // snapshots are taken once per second on the module process thread, and
+    // can be read without waiting for the channels. Reading NetEQ resets its
+    // rates, so while snapshots are enabled, the network statistics returned
+    // by VoENetEqStats are those of the last snapshot.
+    virtual int SetStatisticsSnapshotStatus(bool enable) = 0;
+
+    // Gets the last statistics snapshot of |channel|.
+    virtual int GetStatisticsSnapshot(int channel,
+                                      ChannelStatisticsSnapshot& snapshot) = 0;
+
+    // Copies the last statistics snapshots of up to |maxSnapshots| channels
+    // into |snapshots| in one pass. Returns the number of snapshots copied.
+    virtual int GetStatisticsSnapshots(ChannelStatisticsSnapshot* snapshots,
+                                       int maxSnapshots) = 0;
+
 protected:
     VoECallReport() { }
     virtual ~VoECallReport() { }
@@ -44,6 +44,18 @@ namespace webrtc {
 
 class VoiceEngine;
 
+// Files played by name are decoded once and shared by the players of all
+// channels in the process, as long as they fit in the memory bound of the
+// cache. Other files are streamed.
+struct FileCacheStatistics
+{
+    int hits;         // Playbacks of files that were already decoded.
+    int misses;       // Playbacks of files that weren't decoded yet.
+    int rejected;     // Playbacks that streamed the file instead.
+    int numFiles;     // Decoded files in use.
+    int memoryBytes;  // Memory used by the decoded files.
+};
+
 class WEBRTC_DLLEXPORT VoEFile
 {
 public:
@@ -148,6 +160,10 @@ public:
     // Gets the current played position of a file on a specific |channel|.
     virtual int GetPlaybackPosition(int channel, int& positionMs) = 0;
 
+    // Gets statistics of the decoded files shared by all channels. The cache
+    // and its counters live as long as a VoiceEngine exists in the process.
+    virtual int GetFileCacheStatistics(FileCacheStatistics& stats) = 0;
+
     virtual int ConvertPCMToWAV(const char* fileNameInUTF8,
                                 const char* fileNameOutUTF8) = 0;
 
@@ -32,7 +32,9 @@ public:
     virtual int Release() = 0;
 
     // Get the "in-call" statistics from NetEQ.
-    // The statistics are reset after the query.
+    // The statistics are reset after the query. While statistics snapshots
+    // are enabled through VoECallReport, the statistics of the last snapshot
+    // are returned instead.
     virtual int GetNetworkStatistics(int channel, NetworkStatistics& stats) = 0;
 
 protected:
@@ -13,6 +13,7 @@
 #include "audio_processing.h"
 #include "critical_section_wrapper.h"
 #include "channel.h"
+#include "decoded_audio_cache.h"
 #include "output_mixer.h"
 #include "trace.h"
 #include "transmit_mixer.h"
@@ -31,6 +32,7 @@ SharedData::SharedData() :
     _audioDevicePtr(NULL),
     audioproc_(NULL),
     _moduleProcessThreadPtr(ProcessThread::CreateProcessThread()),
+    _decodedAudioCache(DecodedAudioCache::GetInstance()),
     _externalRecording(false),
     _externalPlayout(false)
 {
@@ -57,6 +59,7 @@ SharedData::~SharedData()
     }
     delete _apiCritPtr;
     ProcessThread::DestroyProcessThread(_moduleProcessThreadPtr);
+    DecodedAudioCache::ReturnInstance();
     Trace::ReturnTrace();
 }
 
@@ -23,6 +23,7 @@ class ProcessThread;
 
 namespace webrtc {
 class CriticalSectionWrapper;
+class DecodedAudioCache;
 
 namespace voe {
 
@@ -48,6 +49,7 @@ public:
     bool ext_playout() const { return _externalPlayout; }
     void set_ext_playout(bool value) { _externalPlayout = value; }
     ProcessThread* process_thread() { return _moduleProcessThreadPtr; }
+    DecodedAudioCache* decoded_audio_cache() { return _decodedAudioCache; }
     AudioDeviceModule::AudioLayer audio_device_layer() const {
       return _audioDeviceLayer;
     }
@@ -73,6 +75,9 @@ protected:
     TransmitMixer* _transmitMixerPtr;
     scoped_ptr<AudioProcessing> audioproc_;
     ProcessThread* _moduleProcessThreadPtr;
+    // Referenced for the lifetime of the engine, so that the cache and its
+    // statistics outlive the channels playing files.
+    DecodedAudioCache* _decodedAudioCache;
 
     bool _externalRecording;
     bool _externalPlayout;
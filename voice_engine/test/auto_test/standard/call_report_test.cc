@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include "after_streaming_fixture.h"
 #include "testsupport/fileutils.h"
 
@@ -86,3 +88,63 @@ TEST_F(CallReportTest, WriteReportToFileSucceedsWithCorrectFilename) {
 
   EXPECT_EQ(0, voe_call_report_->WriteReportToFile(report_filename.c_str()));
 }
+
+TEST_F(CallReportTest, StatisticsSnapshotsAreEmptyUntilEnabled) {
+  webrtc::ChannelStatisticsSnapshot snapshot;
+  EXPECT_EQ(0, voe_call_report_->GetStatisticsSnapshot(channel_, snapshot));
+  EXPECT_EQ(channel_, snapshot.channel);
+  EXPECT_EQ(0, snapshot.timestampMs);
+  EXPECT_EQ(-1, voe_call_report_->GetStatisticsSnapshot(channel_ + 1,
+                                                        snapshot));
+}
+
+TEST_F(CallReportTest, StatisticsSnapshotsArePublishedWhileEnabled) {
+  EXPECT_EQ(0, voe_call_report_->SetStatisticsSnapshotStatus(true));
+  Sleep(2500);
+
+  webrtc::ChannelStatisticsSnapshot snapshots[2];
+  EXPECT_EQ(1, voe_call_report_->GetStatisticsSnapshots(snapshots, 2));
+  EXPECT_EQ(channel_, snapshots[0].channel);
+  EXPECT_GT(snapshots[0].timestampMs, 0);
+  EXPECT_GT(snapshots[0].rtp.packetsReceived, 0);
+
+  webrtc::CallStatistics stats;
+  EXPECT_EQ(0, voe_rtp_rtcp_->GetRTCPStatistics(channel_, stats));
+  EXPECT_GE(stats.packetsReceived, snapshots[0].rtp.packetsReceived);
+
+  EXPECT_EQ(0, voe_call_report_->SetStatisticsSnapshotStatus(false));
+  webrtc::ChannelStatisticsSnapshot snapshot;
+  EXPECT_EQ(0, voe_call_report_->GetStatisticsSnapshot(channel_, snapshot));
+  Sleep(1200);
+  webrtc::ChannelStatisticsSnapshot later_snapshot;
+  EXPECT_EQ(0, voe_call_report_->GetStatisticsSnapshot(channel_,
+                                                       later_snapshot));
+  EXPECT_EQ(snapshot.timestampMs, later_snapshot.timestampMs);
+}
+
+TEST_F(CallReportTest, NetworkStatisticsComeFromSnapshotWhileEnabled) {
+  EXPECT_EQ(0, voe_call_report_->SetStatisticsSnapshotStatus(true));
+  Sleep(1500);
+
+  webrtc::ChannelStatisticsSnapshot snapshot;
+  webrtc::ChannelStatisticsSnapshot later_snapshot;
+  webrtc::NetworkStatistics stats;
+  // Retries if a snapshot is published in between.
+  do {
+    EXPECT_EQ(0, voe_call_report_->GetStatisticsSnapshot(channel_, snapshot));
+    EXPECT_EQ(0, voe_neteq_stats_->GetNetworkStatistics(channel_, stats));
+    EXPECT_EQ(0, voe_call_report_->GetStatisticsSnapshot(channel_,
+                                                         later_snapshot));
+  } while (snapshot.timestampMs != later_snapshot.timestampMs);
+  EXPECT_GT(snapshot.timestampMs, 0);
+  EXPECT_EQ(0, memcmp(&snapshot.network, &stats, sizeof(stats)));
+
+  EXPECT_EQ(0, voe_call_report_->SetStatisticsSnapshotStatus(false));
+}
+
+TEST_F(CallReportTest, GetStatisticsSnapshotsFailsOnBadInput) {
+  EXPECT_EQ(-1, voe_call_report_->GetStatisticsSnapshots(NULL, 1));
+  webrtc::ChannelStatisticsSnapshot snapshot;
+  EXPECT_EQ(-1, voe_call_report_->GetStatisticsSnapshots(&snapshot, -1));
+  EXPECT_EQ(0, voe_call_report_->GetStatisticsSnapshots(&snapshot, 0));
+}
@@ -87,3 +87,48 @@ TEST_F(FileTest, ManualRecordPlayoutToWavFileForThreeSecondsAndPlayback) {
 
   EXPECT_EQ(0, voe_file_->StopPlayingFileAsMicrophone(channel_));
 }
+
+TEST_F(FileTest, PlayingAFileOnTwoChannelsDecodesItOnce) {
+  std::string filename = webrtc::test::OutputPath() + "file_cache_test.pcm";
+  FILE* file = fopen(filename.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  // One second of 16 kHz audio.
+  const short samples[160] = { 0 };
+  for (int i = 0; i < 100; ++i) {
+    fwrite(samples, sizeof(samples[0]), 160, file);
+  }
+  fclose(file);
+
+  int second_channel = voe_base_->CreateChannel();
+  EXPECT_EQ(0, voe_base_->StartPlayout(second_channel));
+  webrtc::FileCacheStatistics before;
+  EXPECT_EQ(0, voe_file_->GetFileCacheStatistics(before));
+
+  EXPECT_EQ(0, voe_file_->StartPlayingFileLocally(
+      channel_, filename.c_str(), true));
+  EXPECT_EQ(0, voe_file_->StartPlayingFileLocally(
+      second_channel, filename.c_str(), true));
+  Sleep(500);
+
+  webrtc::FileCacheStatistics after;
+  EXPECT_EQ(0, voe_file_->GetFileCacheStatistics(after));
+  EXPECT_EQ(before.misses + 1, after.misses);
+  EXPECT_EQ(before.hits + 1, after.hits);
+  EXPECT_EQ(before.numFiles + 1, after.numFiles);
+  // The file is cached at its own rate, 16 kHz.
+  EXPECT_EQ(before.memoryBytes + 100 * 160 * 2, after.memoryBytes);
+
+  EXPECT_EQ(0, voe_file_->StopPlayingFileLocally(channel_));
+  EXPECT_EQ(0, voe_file_->StopPlayingFileLocally(second_channel));
+  EXPECT_EQ(0, voe_file_->GetFileCacheStatistics(after));
+  EXPECT_EQ(before.numFiles, after.numFiles);
+  EXPECT_EQ(before.memoryBytes, after.memoryBytes);
+
+  EXPECT_EQ(0, voe_base_->StopPlayout(second_channel));
+  EXPECT_EQ(0, voe_base_->DeleteChannel(second_channel));
+  // The engine keeps the cache, so the counters survive the channels.
+  EXPECT_EQ(0, voe_file_->GetFileCacheStatistics(after));
+  EXPECT_EQ(before.misses + 1, after.misses);
+  EXPECT_EQ(before.hits + 1, after.hits);
+  remove(filename.c_str());
+}
@@ -14,6 +14,7 @@
 #include "channel.h"
 #include "channel_manager.h"
 #include "critical_section_wrapper.h"
+#include "decoded_audio_cache.h"
 #include "event_wrapper.h"
 #include "statistics.h"
 #include "trace.h"
@@ -164,6 +165,7 @@ TransmitMixer::TransmitMixer(const WebRtc_UWord32 instanceId) :
     _filePlayerPtr(NULL),
     _fileRecorderPtr(NULL),
     _fileCallRecorderPtr(NULL),
+    _decodedAudioCache(DecodedAudioCache::GetInstance()),
     // Avoid conflict with other channels by adding 1024 - 1026,
     // won't use as much as 1024 channels.
     _filePlayerId(instanceId + 1024),
@@ -236,6 +238,7 @@ TransmitMixer::~TransmitMixer()
             _filePlayerPtr = NULL;
         }
     }
+    DecodedAudioCache::ReturnInstance();
     delete &_critSect;
     delete &_callbackCritSect;
 }
@@ -509,8 +512,9 @@ int TransmitMixer::StartPlayingFileAsMicrophone(const char* fileName,
 
     // Dynamically create the instance
     _filePlayerPtr
-        = FilePlayer::CreateFilePlayer(_filePlayerId,
-                                       (const FileFormats) format);
+        = FilePlayer::CreateCachedFilePlayer(_filePlayerId,
+                                             (const FileFormats) format,
+                                             _decodedAudioCache);
 
     if (_filePlayerPtr == NULL)
     {
@@ -25,6 +25,7 @@
 namespace webrtc {
 
 class AudioProcessing;
+class DecodedAudioCache;
 class ProcessThread;
 class VoEExternalMedia;
 class VoEMediaProcess;
@@ -197,6 +198,7 @@ private:
     FilePlayer* _filePlayerPtr;
     FileRecorder* _fileRecorderPtr;
     FileRecorder* _fileCallRecorderPtr;
+    DecodedAudioCache* _decodedAudioCache;
     int _filePlayerId;
     int _fileRecorderId;
     int _fileCallRecorderId;
@@ -12,6 +12,7 @@
 
 #include "audio_processing.h"
 #include "channel.h"
+#include "channel_statistics_publisher.h"
 #include "critical_section_wrapper.h"
 #include "file_wrapper.h"
 #include "trace.h"
@@ -39,7 +40,8 @@ VoECallReport* VoECallReport::GetInterface(VoiceEngine* voiceEngine)
 #ifdef WEBRTC_VOICE_ENGINE_CALL_REPORT_API
 
 VoECallReportImpl::VoECallReportImpl(voe::SharedData* shared) :
-    _file(*FileWrapper::Create()), _shared(shared)
+    _file(*FileWrapper::Create()), _shared(shared),
+    _statisticsPublisherPtr(NULL)
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_shared->instance_id(), -1),
                  "VoECallReportImpl() - ctor");
@@ -49,6 +51,7 @@ VoECallReportImpl::~VoECallReportImpl()
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_shared->instance_id(), -1),
                  "~VoECallReportImpl() - dtor");
+    SetStatisticsSnapshotStatus(false);
     delete &_file;
 }
 
@@ -406,6 +409,102 @@ int VoECallReportImpl::WriteReportToFile(const char* fileNameUTF8)
     return 0;
 }
 
+int VoECallReportImpl::SetStatisticsSnapshotStatus(bool enable)
+{
+    WEBRTC_TRACE(kTraceApiCall, kTraceVoice, VoEId(_shared->instance_id(), -1),
+                 "SetStatisticsSnapshotStatus(enable=%d)", enable);
+    CriticalSectionScoped cs(_shared->crit_sec());
+
+    if (enable == (_statisticsPublisherPtr != NULL))
+    {
+        return 0;
+    }
+    if (enable)
+    {
+        _statisticsPublisherPtr = new voe::ChannelStatisticsPublisher(
+            &_shared->channel_manager());
+        if (_shared->process_thread()->RegisterModule(_statisticsPublisherPtr)
+            != 0)
+        {
+            _shared->SetLastError(VE_INVALID_OPERATION, kTraceError,
+                "SetStatisticsSnapshotStatus() failed to register the "
+                "statistics publisher");
+            delete _statisticsPublisherPtr;
+            _statisticsPublisherPtr = NULL;
+            return -1;
+        }
+        return 0;
+    }
+    // Returns once the publisher isn't running.
+    _shared->process_thread()->DeRegisterModule(_statisticsPublisherPtr);
+    delete _statisticsPublisherPtr;
+    _statisticsPublisherPtr = NULL;
+
+    // NetEQ statistics are read from NetEQ again.
+    voe::ScopedChannel sc(_shared->channel_manager());
+    void* iterator = NULL;
+    for (voe::Channel* channelPtr = sc.GetFirstChannel(iterator);
+         channelPtr != NULL;
+         channelPtr = sc.GetNextChannel(iterator))
+    {
+        channelPtr->StopPublishingStatistics();
+    }
+    return 0;
+}
+
+int VoECallReportImpl::GetStatisticsSnapshot(
+    int channel, ChannelStatisticsSnapshot& snapshot)
+{
+    WEBRTC_TRACE(kTraceApiCall, kTraceVoice, VoEId(_shared->instance_id(), -1),
+                 "GetStatisticsSnapshot(channel=%d)", channel);
+
+    if (!_shared->statistics().Initialized())
+    {
+        _shared->SetLastError(VE_NOT_INITED, kTraceError);
+        return -1;
+    }
+    voe::ScopedChannel sc(_shared->channel_manager(), channel);
+    voe::Channel* channelPtr = sc.ChannelPtr();
+    if (channelPtr == NULL)
+    {
+        _shared->SetLastError(VE_CHANNEL_NOT_VALID, kTraceError,
+            "GetStatisticsSnapshot() failed to locate channel");
+        return -1;
+    }
+    channelPtr->GetStatisticsSnapshot(snapshot);
+    return 0;
+}
+
+int VoECallReportImpl::GetStatisticsSnapshots(
+    ChannelStatisticsSnapshot* snapshots, int maxSnapshots)
+{
+    WEBRTC_TRACE(kTraceApiCall, kTraceVoice, VoEId(_shared->instance_id(), -1),
+                 "GetStatisticsSnapshots(maxSnapshots=%d)", maxSnapshots);
+
+    if (!_shared->statistics().Initialized())
+    {
+        _shared->SetLastError(VE_NOT_INITED, kTraceError);
+        return -1;
+    }
+    if (snapshots == NULL || maxSnapshots < 0)
+    {
+        _shared->SetLastError(VE_INVALID_ARGUMENT, kTraceError,
+            "GetStatisticsSnapshots() invalid snapshot array");
+        return -1;
+    }
+    // One pass over the channel list, without taking any channel lock.
+    voe::ScopedChannel sc(_shared->channel_manager());
+    void* iterator = NULL;
+    int numSnapshots = 0;
+    for (voe::Channel* channelPtr = sc.GetFirstChannel(iterator);
+         channelPtr != NULL && numSnapshots < maxSnapshots;
+         channelPtr = sc.GetNextChannel(iterator))
+    {
+        channelPtr->GetStatisticsSnapshot(snapshots[numSnapshots++]);
+    }
+    return numSnapshots;
+}
+
 #endif  // WEBRTC_VOICE_ENGINE_CALL_REPORT_API
 
 } // namespace webrtc
@@ -20,6 +20,10 @@ namespace webrtc
 {
 class FileWrapper;
 
+namespace voe {
+class ChannelStatisticsPublisher;
+}
+
 class VoECallReportImpl: public VoECallReport
 {
 public:
@@ -35,6 +39,14 @@ public:
 
     virtual int WriteReportToFile(const char* fileNameUTF8);
 
+    virtual int SetStatisticsSnapshotStatus(bool enable);
+
+    virtual int GetStatisticsSnapshot(int channel,
+                                      ChannelStatisticsSnapshot& snapshot);
+
+    virtual int GetStatisticsSnapshots(ChannelStatisticsSnapshot* snapshots,
+                                       int maxSnapshots);
+
 protected:
     VoECallReportImpl(voe::SharedData* shared);
     virtual ~VoECallReportImpl();
@@ -50,6 +62,8 @@ private:
 
     FileWrapper& _file;
     voe::SharedData* _shared;
+    // Set while statistics snapshots are enabled.
+    voe::ChannelStatisticsPublisher* _statisticsPublisherPtr;
 };
 
 } // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include "channel.h"
 #include "critical_section_wrapper.h"
+#include "decoded_audio_cache.h"
 #include "file_wrapper.h"
 #include "media_file.h"
 #include "output_mixer.h"
@@ -1353,6 +1354,22 @@ int VoEFileImpl::GetPlaybackPosition(int channel, int& positionMs)
     return channelPtr->GetLocalPlayoutPosition(positionMs);
 }
 
+int VoEFileImpl::GetFileCacheStatistics(FileCacheStatistics& stats)
+{
+    WEBRTC_TRACE(kTraceApiCall, kTraceVoice, VoEId(_shared->instance_id(), -1),
+                 "GetFileCacheStatistics()");
+
+    DecodedAudioCacheStats cacheStats;
+    _shared->decoded_audio_cache()->GetStats(&cacheStats);
+
+    stats.hits = cacheStats.hits;
+    stats.misses = cacheStats.misses;
+    stats.rejected = cacheStats.rejected;
+    stats.numFiles = cacheStats.num_entries;
+    stats.memoryBytes = static_cast<int>(cacheStats.memory_bytes);
+    return 0;
+}
+
 #endif  // #ifdef WEBRTC_VOICE_ENGINE_FILE_API
 
 }  // namespace webrtc
@@ -127,6 +127,8 @@ public:
 
     virtual int GetPlaybackPosition(int channel, int& positionMs);
 
+    virtual int GetFileCacheStatistics(FileCacheStatistics& stats);
+
 protected:
     VoEFileImpl(voe::SharedData* shared);
     virtual ~VoEFileImpl();